@@ -0,0 +1,83 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Micro-benchmark for asynchronous file reads. The IO service hands the read
+// buffer to the isolate as external typed data, so the cost of a large read
+// should be dominated by the read itself.
+
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+abstract class FileReadBenchmark extends AsyncBenchmarkBase {
+  final int size;
+  late Directory tempDir;
+  late File file;
+
+  FileReadBenchmark(String method, this.size)
+      : super('FileRead.$method.${size ~/ 1024}KB');
+
+  @override
+  Future<void> setup() async {
+    tempDir = await Directory.systemTemp.createTemp('FileRead');
+    file = File('${tempDir.path}/data');
+    final bytes = Uint8List(size);
+    for (int i = 0; i < size; i++) {
+      bytes[i] = i;
+    }
+    await file.writeAsBytes(bytes, flush: true);
+  }
+
+  @override
+  Future<void> teardown() async {
+    await tempDir.delete(recursive: true);
+  }
+}
+
+class ReadBenchmark extends FileReadBenchmark {
+  late RandomAccessFile randomAccessFile;
+
+  ReadBenchmark(int size) : super('Read', size);
+
+  @override
+  Future<void> setup() async {
+    await super.setup();
+    randomAccessFile = await file.open();
+  }
+
+  @override
+  Future<void> teardown() async {
+    await randomAccessFile.close();
+    await super.teardown();
+  }
+
+  @override
+  Future<void> run() async {
+    await randomAccessFile.setPosition(0);
+    final bytes = await randomAccessFile.read(size);
+    if (bytes.length != size) throw 'Unexpected length: ${bytes.length}';
+  }
+}
+
+class ReadAsBytesBenchmark extends FileReadBenchmark {
+  ReadAsBytesBenchmark(int size) : super('ReadAsBytes', size);
+
+  @override
+  Future<void> run() async {
+    final bytes = await file.readAsBytes();
+    if (bytes.length != size) throw 'Unexpected length: ${bytes.length}';
+  }
+}
+
+Future<void> main() async {
+  const sizes = [64 * 1024, 1024 * 1024, 16 * 1024 * 1024];
+  final benchmarks = <FileReadBenchmark>[
+    for (final size in sizes) ReadBenchmark(size),
+    for (final size in sizes) ReadAsBytesBenchmark(size),
+  ];
+  for (final benchmark in benchmarks) {
+    await benchmark.report();
+  }
+}
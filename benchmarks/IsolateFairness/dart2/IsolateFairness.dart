@@ -0,0 +1,132 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures how long an isolate with a single pending message waits for a
+// thread while more isolates than the isolate group's thread pool can run at
+// once process long bursts of messages.
+//
+// Each configuration in [kConfigurations] is measured in a child process
+// running with its VM flags.
+
+// @dart=2.9
+
+import 'dart:async';
+import 'dart:io';
+import 'dart:isolate';
+
+// More busy isolates than the default limit of concurrently running mutator
+// threads per isolate group.
+const int kBusyIsolates = 16;
+const int kBurstSize = 200;
+const int kWorkMicros = 50;
+const Duration kBurstPause = Duration(milliseconds: 5);
+const int kPings = 2000;
+const Duration kPingInterval = Duration(milliseconds: 1);
+
+// The VM flags of each measured configuration, by result name.
+const Map<String, List<String>> kConfigurations = {
+  'IsolateFairness': <String>[],
+  'IsolateFairnessTimeSliced': <String>['--isolate_time_slice_micros=1000'],
+};
+
+void spin(int micros) {
+  final sw = Stopwatch()..start();
+  while (sw.elapsedMicroseconds < micros) {}
+}
+
+// Repeatedly sends itself a burst of messages which each keep it busy for
+// [kWorkMicros].
+void busy(SendPort readyPort) {
+  final port = RawReceivePort();
+  int pending = 0;
+  void burst() {
+    pending = kBurstSize;
+    for (int i = 0; i < kBurstSize; i++) {
+      port.sendPort.send(i);
+    }
+  }
+
+  port.handler = (_) {
+    spin(kWorkMicros);
+    if (--pending == 0) {
+      Timer(kBurstPause, burst);
+    }
+  };
+  burst();
+  readyPort.send(null);
+}
+
+void echo(SendPort replyPort) {
+  final port = RawReceivePort();
+  port.handler = (message) {
+    (message as SendPort).send(null);
+  };
+  replyPort.send(port.sendPort);
+}
+
+Future<Isolate> spawnAndWait<T>(void Function(SendPort) entryPoint,
+    void Function(T) onReady) async {
+  final port = ReceivePort();
+  final isolate = await Isolate.spawn(entryPoint, port.sendPort);
+  onReady(await port.first as T);
+  return isolate;
+}
+
+Future<void> measure(String name) async {
+  SendPort echoPort;
+  final echoIsolate =
+      await spawnAndWait<SendPort>(echo, (port) => echoPort = port);
+  final busyIsolates = <Isolate>[
+    for (int i = 0; i < kBusyIsolates; i++)
+      await spawnAndWait<Null>(busy, (_) {}),
+  ];
+
+  final replies = ReceivePort();
+  final replyIterator = StreamIterator<dynamic>(replies);
+  final latencies = <int>[];
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < kPings; i++) {
+    final start = sw.elapsedMicroseconds;
+    echoPort.send(replies.sendPort);
+    await replyIterator.moveNext();
+    latencies.add(sw.elapsedMicroseconds - start);
+    await Future.delayed(kPingInterval);
+  }
+  replies.close();
+
+  for (final isolate in busyIsolates) {
+    isolate.kill(priority: Isolate.immediate);
+  }
+  echoIsolate.kill(priority: Isolate.immediate);
+
+  latencies.sort();
+  final length = latencies.length;
+  final avg = latencies.fold<int>(0, (a, b) => a + b) / length;
+  print('$name.PingAvg(RunTimeRaw): ${avg / 1000} ms.');
+  for (final percentile in [50, 90, 99]) {
+    final value = latencies[percentile * length ~/ 100];
+    print('$name.PingPercentile$percentile(RunTimeRaw): ${value / 1000} ms.');
+  }
+  print('$name.PingMax(RunTimeRaw): ${latencies.last / 1000} ms.');
+}
+
+Future<void> main(List<String> args) async {
+  if (args.isNotEmpty) {
+    return measure(args.single);
+  }
+  for (final name in kConfigurations.keys) {
+    final result = await Process.run(Platform.executable, [
+      ...Platform.executableArguments,
+      ...kConfigurations[name],
+      Platform.script.toFilePath(),
+      name,
+    ]);
+    if (result.exitCode != 0) {
+      print(result.stdout);
+      print(result.stderr);
+      throw 'Child process failed: ${result.exitCode}';
+    }
+    stdout.write(result.stdout);
+  }
+}
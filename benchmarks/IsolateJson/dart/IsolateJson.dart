@@ -103,6 +103,60 @@ class SyncJsonDecodingBenchmark extends BenchmarkBase {
   final int iterations;
 }
 
+// Sends a lookup table to a long-lived worker isolate, which acknowledges
+// every message. With --share-deeply-immutable-objects, deeply immutable
+// tables are passed by reference, so their send cost should not depend on
+// their size.
+class SendLookupTableBenchmark {
+  SendLookupTableBenchmark(this.name, {required this.table});
+
+  Future<void> report() async {
+    final port = ReceivePort();
+    final inbox = StreamIterator<dynamic>(port);
+    await Isolate.spawn(lookupTableIsolate, port.sendPort);
+    await inbox.moveNext();
+    final worker = inbox.current as SendPort;
+
+    final stopwatch = Stopwatch()..start();
+    // Benchmark harness counts 10 iterations as one.
+    for (int i = 0; i < 10; i++) {
+      worker.send(table);
+      await inbox.moveNext();
+    }
+    print('$name(RunTime): ${stopwatch.elapsedMicroseconds} us.');
+
+    worker.send(null);
+    port.close();
+  }
+
+  final String name;
+  final Map<String, Object> table;
+}
+
+Future<void> lookupTableIsolate(SendPort replyPort) async {
+  final port = ReceivePort();
+  replyPort.send(port.sendPort);
+  await for (final table in port) {
+    if (table == null) break;
+    replyPort.send((table as Map).length);
+  }
+  port.close();
+}
+
+Map<String, Object> createLookupTable(int size) {
+  final table = <String, Object>{};
+  for (int i = 0; i < size; i++) {
+    table['key$i'] = ['value$i', 'alias$i'];
+  }
+  return table;
+}
+
+Map<String, Object> createImmutableLookupTable(int size) {
+  return Map<String, Object>.unmodifiable(createLookupTable(size).map(
+      (key, value) =>
+          MapEntry(key, List<String>.unmodifiable(value as List<String>))));
+}
+
 class BenchmarkConfig {
   BenchmarkConfig(this.suffix, this.sample);
 
@@ -158,4 +212,14 @@ Future<void> main() async {
           .report();
     }
   }
+
+  for (final size in <int>[1000, 10000, 100000]) {
+    final suffix = '${size ~/ 1000}K';
+    await SendLookupTableBenchmark('IsolateJson.SendMutableTable$suffix',
+            table: createLookupTable(size))
+        .report();
+    await SendLookupTableBenchmark('IsolateJson.SendImmutableTable$suffix',
+            table: createImmutableLookupTable(size))
+        .report();
+  }
 }
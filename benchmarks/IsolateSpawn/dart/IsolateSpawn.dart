@@ -9,7 +9,7 @@ import 'dart:math';
 import 'package:compiler/src/dart2js.dart' as dart2js_main;
 
 class SpawnLatency {
-  SpawnLatency(this.name);
+  SpawnLatency(this.name, this.entryPoint);
 
   Future<ResultMessageLatency> run() async {
     final completerResult = Completer();
@@ -21,7 +21,7 @@ class SpawnLatency {
       });
     final beforeSpawn = DateTime.now();
     await Isolate.spawn(
-        isolateCompiler, StartMessageLatency(receivePort.sendPort, beforeSpawn),
+        entryPoint, StartMessageLatency(receivePort.sendPort, beforeSpawn),
         onExit: onExitReceivePort.sendPort,
         onError: onExitReceivePort.sendPort);
     final afterSpawn = DateTime.now();
@@ -67,6 +67,7 @@ class SpawnLatency {
   }
 
   final String name;
+  final Future<void> Function(StartMessageLatency) entryPoint;
   late RawReceivePort receivePort;
 }
 
@@ -158,6 +159,17 @@ Future<void> isolateCompiler(StartMessageLatency start) async {
           timeFinishRunningCodeUs.difference(start.spawned).inMicroseconds));
 }
 
+// Does no work, so that the latencies are dominated by the cost of spawning
+// (and tearing down) the isolate itself.
+Future<void> isolateEmpty(StartMessageLatency start) async {
+  final timeRunningCodeUs =
+      DateTime.now().difference(start.spawned).inMicroseconds;
+  start.sendPort.send(ResultMessageLatency(
+      timeToStartRunningCodeUs: timeRunningCodeUs,
+      timeToFinishRunningCodeUs: timeRunningCodeUs));
+}
+
 Future<void> main() async {
-  await SpawnLatency('IsolateSpawn.Dart2JS').report();
+  await SpawnLatency('IsolateSpawn.Empty', isolateEmpty).report();
+  await SpawnLatency('IsolateSpawn.Dart2JS', isolateCompiler).report();
 }
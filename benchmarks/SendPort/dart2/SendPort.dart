@@ -176,6 +176,62 @@ class SendPortBenchmark {
   }
 }
 
+// Measures how many small messages an isolate can receive per unit of time
+// when they arrive in bursts, i.e. when the receiving isolate's message queue
+// is rarely empty.
+class SendPortThroughputBenchmark {
+  static const int burstSize = 1000;
+
+  final BenchmarkConfig config;
+  RawReceivePort port;
+  Completer<void> burstDone;
+  int remaining = 0;
+
+  double usPerMessage = 0.0;
+
+  SendPortThroughputBenchmark(this.config);
+
+  // Runs warmup phase, runs benchmark and reports result.
+  Future report() async {
+    port = RawReceivePort((_) {
+      if (--remaining == 0) burstDone.complete();
+    });
+
+    // Warmup for 200 ms.
+    await measureFor(const Duration(milliseconds: 200));
+
+    // Run benchmark for 2 seconds.
+    //
+    // Sets [usPerMessage] as side-effect.
+    await measureFor(const Duration(seconds: 2));
+
+    // Report result.
+    print('SendPort.Throughput.${config.name}(RunTimeRaw): '
+        '$usPerMessage us.');
+
+    port.close();
+  }
+
+  Future measureFor(Duration duration) async {
+    final durationInMicroseconds = duration.inMicroseconds;
+    final sendPort = port.sendPort;
+    final sw = Stopwatch()..start();
+
+    int numberOfMessages = 0;
+    do {
+      burstDone = Completer<void>();
+      remaining = burstSize;
+      for (int i = 0; i < burstSize; i++) {
+        sendPort.send(config.data);
+      }
+      await burstDone.future;
+      numberOfMessages += burstSize;
+    } while (sw.elapsedMicroseconds < durationInMicroseconds);
+
+    usPerMessage = sw.elapsedMicroseconds / numberOfMessages;
+  }
+}
+
 class TreeNode {
   @pragma('vm:entry-point') // Prevent tree shaking of this field.
   final TreeNode left;
@@ -262,4 +318,14 @@ Future<void> main(args) async {
   for (final config in configs) {
     await SendPortBenchmark(config).report();
   }
+
+  final throughputConfigs = <BenchmarkConfig>[
+    BenchmarkConfig('Nop', 1),
+    BenchmarkConfig('Json.400B', json400BDecoded),
+    BenchmarkConfig('BinaryTree.2', generateBinaryTreeOfDepth(2)),
+  ];
+
+  for (final config in throughputConfigs) {
+    await SendPortThroughputBenchmark(config).report();
+  }
 }
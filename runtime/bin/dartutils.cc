@@ -936,19 +936,28 @@ Dart_CObject* CObject::NewNativePointer(intptr_t ptr,
   return cobject;
 }
 
-Dart_CObject* CObject::NewIOBuffer(int64_t length) {
+static Dart_CObject* NewIOBufferHelper(int64_t length, bool zero_fill) {
   // Make sure that we do not have an integer overflow here. Actual check
   // against max elements will be done at the time of writing, as the constant
   // is not part of the public API.
   if ((length < 0) || (length > kIntptrMax)) {
     return NULL;
   }
-  uint8_t* data = IOBuffer::Allocate(static_cast<intptr_t>(length));
+  const intptr_t size = static_cast<intptr_t>(length);
+  uint8_t* data = zero_fill ? IOBuffer::Allocate(size)
+                            : IOBuffer::AllocateUninitialized(size);
   if (data == NULL) {
     return NULL;
   }
-  return NewExternalUint8Array(static_cast<intptr_t>(length), data, data,
-                               IOBuffer::Finalizer);
+  return CObject::NewExternalUint8Array(size, data, data, IOBuffer::Finalizer);
+}
+
+Dart_CObject* CObject::NewIOBuffer(int64_t length) {
+  return NewIOBufferHelper(length, /*zero_fill=*/true);
+}
+
+Dart_CObject* CObject::NewUninitializedIOBuffer(int64_t length) {
+  return NewIOBufferHelper(length, /*zero_fill=*/false);
 }
 
 void CObject::ShrinkIOBuffer(Dart_CObject* cobject, int64_t new_length) {
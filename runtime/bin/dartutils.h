@@ -355,6 +355,10 @@ class CObject {
                                         Dart_HandleFinalizer callback);
 
   static Dart_CObject* NewIOBuffer(int64_t length);
+  // Like [NewIOBuffer], but the contents are not zero-filled. The buffer is
+  // handed to the receiving isolate without copying, so every byte which is
+  // not overwritten has to be removed with [ShrinkIOBuffer] before posting.
+  static Dart_CObject* NewUninitializedIOBuffer(int64_t length);
   static void ShrinkIOBuffer(Dart_CObject* cobject, int64_t new_length);
   static void FreeIOBufferData(Dart_CObject* object);
 
@@ -1248,7 +1248,9 @@ CObject* File::ReadRequest(const CObjectArray& request) {
     return CObject::FileClosedError();
   }
   const int64_t length = CObjectInt32OrInt64ToInt64(request[1]);
-  Dart_CObject* io_buffer = CObject::NewIOBuffer(length);
+  // The buffer is filled by the read and shrunk to the bytes actually read,
+  // so it does not need to be zero-filled first.
+  Dart_CObject* io_buffer = CObject::NewUninitializedIOBuffer(length);
   if (io_buffer == NULL) {
     return CObject::NewOSError();
   }
@@ -1260,7 +1262,8 @@ CObject* File::ReadRequest(const CObjectArray& request) {
   }
 
   // Possibly shrink the used malloc() storage if the actual number of bytes is
-  // significantly lower.
+  // significantly lower. The external typed data is adopted by the receiving
+  // isolate without copying.
   CObject::ShrinkIOBuffer(io_buffer, bytes_read);
 
   auto external_array = new CObjectExternalUint8Array(io_buffer);
@@ -1283,7 +1286,9 @@ CObject* File::ReadIntoRequest(const CObjectArray& request) {
     return CObject::FileClosedError();
   }
   const int64_t length = CObjectInt32OrInt64ToInt64(request[1]);
-  Dart_CObject* io_buffer = CObject::NewIOBuffer(length);
+  // The buffer is filled by the read and shrunk to the bytes actually read,
+  // so it does not need to be zero-filled first.
+  Dart_CObject* io_buffer = CObject::NewUninitializedIOBuffer(length);
   if (io_buffer == NULL) {
     return CObject::NewOSError();
   }
@@ -1295,7 +1300,8 @@ CObject* File::ReadIntoRequest(const CObjectArray& request) {
   }
 
   // Possibly shrink the used malloc() storage if the actual number of bytes is
-  // significantly lower.
+  // significantly lower. The external typed data is adopted by the receiving
+  // isolate without copying.
   CObject::ShrinkIOBuffer(io_buffer, bytes_read);
 
   auto external_array = new CObjectExternalUint8Array(io_buffer);
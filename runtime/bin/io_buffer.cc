@@ -31,6 +31,11 @@ uint8_t* IOBuffer::Allocate(intptr_t size) {
   return static_cast<uint8_t*>(calloc(size, sizeof(uint8_t)));
 }
 
+uint8_t* IOBuffer::AllocateUninitialized(intptr_t size) {
+  // Avoid malloc(0) returning nullptr, see the comment in [Reallocate].
+  return static_cast<uint8_t*>(malloc(size > 0 ? size : 1));
+}
+
 uint8_t* IOBuffer::Reallocate(uint8_t* buffer, intptr_t new_size) {
   if (new_size == 0) {
     // The call to `realloc()` below has a corner case if the new size is 0:
@@ -20,6 +20,11 @@ class IOBuffer {
   // Allocate IO buffer storage.
   static uint8_t* Allocate(intptr_t size);
 
+  // Allocate IO buffer storage without zero-filling it. Only use this if the
+  // whole buffer is overwritten (or shrunk to the overwritten part) before it
+  // becomes visible to Dart code.
+  static uint8_t* AllocateUninitialized(intptr_t size);
+
   // Reallocate IO buffer storage.
   static uint8_t* Reallocate(uint8_t* buffer, intptr_t new_size);
 
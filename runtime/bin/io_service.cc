@@ -54,8 +54,13 @@ void IOServiceCallback(Dart_Port dest_port_id, Dart_CObject* message) {
   Dart_PostCObject(reply_port_id, result.AsApiCObject());
 }
 
+// Each isolate used to spread its requests over up to 32 serial ports. Use
+// that as the default for the concurrent port of an isolate.
+intptr_t IOService::max_concurrency_ = 32;
+
 Dart_Port IOService::GetServicePort() {
-  return Dart_NewNativePort("IOService", IOServiceCallback, true);
+  return Dart_NewConcurrentNativePort("IOService", IOServiceCallback,
+                                      max_concurrency_);
 }
 
 void FUNCTION_NAME(IOService_NewServicePort)(Dart_NativeArguments args) {
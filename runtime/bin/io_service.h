@@ -67,9 +67,16 @@ class IOService {
  public:
   enum { IO_SERVICE_REQUEST_LIST(DECLARE_REQUEST) };
 
+  // Returns a new IO service port. Each isolate uses a single port, whose
+  // requests are handled on up to [max_concurrency] threads at a time.
   static Dart_Port GetServicePort();
 
+  static intptr_t max_concurrency() { return max_concurrency_; }
+  static void set_max_concurrency(intptr_t value) { max_concurrency_ = value; }
+
  private:
+  static intptr_t max_concurrency_;
+
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(IOService);
 };
@@ -11,6 +11,11 @@
 #include "bin/dartdev_isolate.h"
 #include "bin/error_exit.h"
 #include "bin/file_system_watcher.h"
+#if defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/io_service_no_ssl.h"
+#else
+#include "bin/io_service.h"
+#endif
 #include "bin/options.h"
 #include "bin/platform.h"
 #include "bin/utils.h"
@@ -86,6 +91,17 @@ DFE* Options::dfe_ = NULL;
 DEFINE_STRING_OPTION_CB(dfe, { Options::dfe()->set_frontend_filename(value); });
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+DEFINE_STRING_OPTION_CB(io_service_max_concurrency, {
+  char* end = nullptr;
+  const int64_t max_concurrency = strtoll(value, &end, 10);
+  if ((*end != '\0') || (max_concurrency <= 0)) {
+    Syslog::PrintErr(
+        "Invalid value for option io_service_max_concurrency: '%s'\n", value);
+    return false;
+  }
+  IOService::set_max_concurrency(max_concurrency);
+});
+
 static void hot_reload_test_mode_callback(CommandLineOptions* vm_options) {
   // Identity reload.
   vm_options->AddArgument("--identity_reload");
@@ -244,6 +260,9 @@ void Options::PrintUsage() {
 "  The path to a directory that dart:io calls will treat as the root of the\n"
 "  filesystem.\n"
 #endif  // defined(DART_HOST_OS_LINUX) || defined(DART_HOST_OS_ANDROID)
+"--io-service-max-concurrency=<n>\n"
+"  The maximum number of asynchronous dart:io operations, like file\n"
+"  operations, which an isolate performs at the same time (default 32).\n"
 "\n"
 "The following options are only used for VM development and may\n"
 "be changed in any future version:\n");
@@ -72,9 +72,17 @@ void TestCaseBase::RunTest() {
 void Benchmark::RunBenchmark() {
   if ((run_filter == kAllBenchmarks) ||
       (strcmp(run_filter, this->name()) == 0)) {
-    this->Run();
+    this->RunRepetitions();
     Syslog::Print("%s(%s): %" Pd64 "\n", this->name(), this->score_kind(),
                   this->score());
+    if (this->scores().length() > 1) {
+      const BenchmarkStatistics stats = this->Statistics();
+      Syslog::Print("%s(%s) statistics: mean %.1f +- %.1f (95%% CI, %.2f%%), "
+                    "stddev %.1f, min %" Pd64 ", max %" Pd64 ", n %" Pd "\n",
+                    this->name(), this->score_kind(), stats.mean, stats.ci95,
+                    (stats.mean != 0.0) ? 100.0 * stats.ci95 / stats.mean : 0.0,
+                    stats.stddev, stats.min, stats.max, stats.count);
+    }
     run_matches++;
   } else if (run_filter == kList) {
     Syslog::Print("%s Pass\n", this->name());
@@ -86,7 +94,8 @@ static void PrintUsage() {
   Syslog::PrintErr(
       "Usage: one of the following\n"
       "  run_vm_tests --list\n"
-      "  run_vm_tests [--dfe=<snapshot file name>] --benchmarks\n"
+      "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] "
+      "--benchmarks\n"
       "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] <test name>\n"
       "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] <benchmark "
       "name>\n");
@@ -344,17 +353,17 @@ static int Main(int argc, const char** argv) {
     ShiftArgs(&argc, argv);
   }
 
-  if (arg_pos == argc - 1 && strcmp(argv[arg_pos], "--benchmarks") == 0) {
-    // "--benchmarks" is the last argument.
+  if (strcmp(argv[argc - 1], "--benchmarks") == 0) {
+    // "--benchmarks" is the last argument, the rest are vm flags.
     run_filter = kAllBenchmarks;
   } else {
     // Last argument is the test name, the rest are vm flags.
     run_filter = argv[argc - 1];
-    // Remove the first value (executable) from the arguments and
-    // exclude the last argument which is the test name.
-    dart_argc = argc - 2;
-    dart_argv = &argv[1];
   }
+  // Remove the first value (executable) from the arguments and
+  // exclude the last argument which is the test name or "--benchmarks".
+  dart_argc = argc - 2;
+  dart_argv = &argv[1];
 
   bin::TimerUtils::InitOnce();
   bin::Process::Init();
@@ -33,6 +33,15 @@
  * message send and returned when the VM invokes the
  * Dart_HandleFinalizer callback; a non-NULL callback must be provided.
  *
+ * Bulk data, such as a batch of records, is best sent in columnar form: a
+ * kArray holding one kTypedData or kExternalTypedData column per field,
+ * rather than a kArray holding a kArray per record. Each column is written
+ * to the message as one contiguous block and arrives as one typed data list,
+ * created with a single copy (or, for kExternalTypedData, without copying).
+ * Every element of a kArray is instead serialized and allocated as a
+ * separate object. Strings can be sent as a kUint8 column of their UTF-8
+ * bytes and a column of end offsets.
+ *
  * Note that Dart_CObject_kNativePointer is intended for internal use by
  * dart:io implementation and has no connection to dart:ffi Pointer class.
  * It represents a pointer to a native resource of a known type.
@@ -165,6 +174,29 @@ DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
                                          bool handle_concurrently);
 /* TODO(turnidge): Currently handle_concurrently is ignored. */
 
+/**
+ * Creates a new native port whose messages are dispatched to the provided
+ * native message handler on up to 'max_concurrency' threads at a time.
+ *
+ * Messages which arrive while 'max_concurrency' messages are being handled
+ * are queued until a thread becomes available. Queued messages are picked up
+ * in the order they arrived, but may complete in any order, so the handler
+ * must be safe to call concurrently.
+ *
+ * \param name The name of this port in debugging messages.
+ * \param handler The C handler to run when messages arrive on the port.
+ * \param max_concurrency The maximum number of messages handled at the same
+ *   time. Must be positive. A value of 1 handles messages one at a time, like
+ *   Dart_NewNativePort.
+ *
+ * \return If successful, returns the port id for the native port.  In
+ *   case of error, returns ILLEGAL_PORT.
+ */
+DART_EXPORT Dart_Port
+Dart_NewConcurrentNativePort(const char* name,
+                             Dart_NativeMessageHandler handler,
+                             intptr_t max_concurrency);
+
 /**
  * Closes the native port with the given id.
  *
@@ -482,11 +482,67 @@ DART_EXPORT int64_t
 Dart_IsolateGroupHeapGlobalUsedMetric(Dart_IsolateGroup group);  // Byte
 DART_EXPORT int64_t
 Dart_IsolateGroupHeapGlobalUsedMaxMetric(Dart_IsolateGroup group);  // Byte
+/* Bytes allocated since the group was created, as of the last GC. */
+DART_EXPORT int64_t
+Dart_IsolateGroupHeapAllocatedMetric(Dart_IsolateGroup group);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateGroupGCScavengeCountMetric(Dart_IsolateGroup group);  // Counter
+/* Total scavenge pause time. */
+DART_EXPORT int64_t
+Dart_IsolateGroupGCScavengeTimeMetric(Dart_IsolateGroup group);  // Microsecond
+/* Bytes copied by scavenges, including promoted bytes. */
+DART_EXPORT int64_t
+Dart_IsolateGroupGCScavengeCopiedMetric(Dart_IsolateGroup group);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateGroupGCScavengePromotedMetric(Dart_IsolateGroup group);  // Byte
+/* Old-space pauses: mark-sweep, mark-compact and start of concurrent mark. */
+DART_EXPORT int64_t
+Dart_IsolateGroupGCMarkSweepCountMetric(Dart_IsolateGroup group);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateGroupGCMarkSweepTimeMetric(Dart_IsolateGroup group);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
 
+/**
+ * A histogram of durations in microseconds.
+ *
+ * buckets[0] counts durations of 0us, buckets[i] counts durations in
+ * [2^(i-1), 2^i) us and the last bucket counts all longer durations.
+ *
+ * Histograms are updated without locks, so a histogram read while it is being
+ * updated may count an update in some fields only.
+ */
+#define DART_METRIC_HISTOGRAM_BUCKETS 24
+typedef struct {
+  int64_t count;
+  int64_t sum;
+  int64_t max;
+  int64_t buckets[DART_METRIC_HISTOGRAM_BUCKETS];
+} Dart_MetricHistogram;
+
+/**
+ * Copy histograms gathered for an isolate group. These can be called from any
+ * thread, and are available in PRODUCT builds.
+ */
+/* Scavenge pauses. */
+DART_EXPORT void Dart_IsolateGroupGCScavengePauseHistogram(
+    Dart_IsolateGroup group,
+    Dart_MetricHistogram* histogram);
+/* Old-space pauses: mark-sweep, mark-compact and start of concurrent mark. */
+DART_EXPORT void Dart_IsolateGroupGCMarkSweepPauseHistogram(
+    Dart_IsolateGroup group,
+    Dart_MetricHistogram* histogram);
+/* Time from requesting a safepoint until all threads have reached it. */
+DART_EXPORT void Dart_IsolateGroupTimeToSafepointHistogram(
+    Dart_IsolateGroup group,
+    Dart_MetricHistogram* histogram);
+/* Pauses for writing heap snapshots. */
+DART_EXPORT void Dart_IsolateGroupHeapSnapshotPauseHistogram(
+    Dart_IsolateGroup group,
+    Dart_MetricHistogram* histogram);
+
 /*
  * ========
  * UserTags
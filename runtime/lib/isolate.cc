@@ -2,6 +2,7 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+#include <atomic>
 #include <memory>
 #include <utility>
 
@@ -16,6 +17,7 @@
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
 #include "vm/hash_table.h"
+#include "vm/isolate_pool.h"
 #include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/message_handler.h"
@@ -87,6 +89,24 @@ DEFINE_NATIVE_ENTRY(RawReceivePortImpl_setActive, 0, 2) {
   return Object::null();
 }
 
+DEFINE_NATIVE_ENTRY(RawReceivePortImpl_nextBatchMessage, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, entry, arguments->NativeArgAt(0));
+  ASSERT(entry.Length() == 2);
+  std::unique_ptr<Message> message =
+      isolate->message_handler()->DequeueBatchMessage();
+  if (message == nullptr) {
+    return Bool::False().ptr();
+  }
+  const Object& msg = Object::Handle(zone, ReadMessage(thread, message.get()));
+  if (msg.IsError()) {
+    Exceptions::PropagateError(Error::Cast(msg));
+    UNREACHABLE();
+  }
+  entry.SetAt(0, Integer::Handle(zone, Integer::New(message->dest_port())));
+  entry.SetAt(1, msg);
+  return Bool::True().ptr();
+}
+
 DEFINE_NATIVE_ENTRY(SendPortImpl_get_id, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
   return Integer::New(port.Id());
@@ -153,7 +173,10 @@ static ObjectPtr ValidateMessageObject(Zone* zone,
           working_set_(working_set) {}
 
     void VisitObject(ObjectPtr obj) {
-      if (!obj->IsHeapObject() || obj->untag()->IsCanonical()) {
+      if (!obj->IsHeapObject() || obj->untag()->IsCanonical() ||
+          obj->untag()->IsImmutable()) {
+        // Immutable objects are either deeply immutable or unmodifiable
+        // typed data views, neither of which can reference illegal objects.
         return;
       }
       if (visited_->GetValueExclusive(obj) == 1) {
@@ -329,6 +352,30 @@ static ObjectPtr ValidateMessageObject(Zone* zone,
   return obj.ptr();
 }
 
+// Map.unmodifiable has just copied the owned collection, so checking a few
+// objects per entry keeps the traversal proportional to that copy.
+static const intptr_t kDeeplyImmutableObjectsPerSlot = 4;
+static const intptr_t kDeeplyImmutableMinObjects = 64;
+
+DEFINE_NATIVE_ENTRY(Internal_makeDeeplyImmutable, 0, 2) {
+  GET_NATIVE_ARGUMENT(Instance, obj, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, owns_object, arguments->NativeArgAt(1));
+  const intptr_t cid = obj.GetClassId();
+  const bool is_owned_collection =
+      owns_object.value() &&
+      (cid == kLinkedHashMapCid || cid == kLinkedHashSetCid);
+  intptr_t max_objects = kDeeplyImmutableMinObjects;
+  if (is_owned_collection) {
+    max_objects += kDeeplyImmutableObjectsPerSlot *
+                   Smi::Value(LinkedHashBase::Cast(obj).used_data());
+  }
+  return Bool::Get(MakeDeeplyImmutable(
+                       thread, obj,
+                       is_owned_collection ? obj : Object::null_object(),
+                       max_objects))
+      .ptr();
+}
+
 // TODO(http://dartbug.com/47777): Add support for Finalizers.
 DEFINE_NATIVE_ENTRY(Isolate_exit_, 0, 2) {
   GET_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
@@ -997,6 +1044,8 @@ DEFINE_NATIVE_ENTRY(Isolate_spawnFunction, 0, 10) {
 
   isolate->group()->thread_pool()->Run<SpawnIsolateTask>(isolate,
                                                          std::move(state));
+  // Later spawns take their isolate from the pool, if enabled.
+  isolate->group()->isolate_pool()->ScheduleRefill();
   return Object::null();
 }
 
@@ -1310,4 +1359,106 @@ DEFINE_NATIVE_ENTRY(TransferableTypedData_materialize, 0, 1) {
   return typed_data.ptr();
 }
 
+DEFINE_NATIVE_ENTRY(SharedTypedData_allocate, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, length_obj, arguments->NativeArgAt(0));
+  const int64_t length = length_obj.AsInt64Value();
+  const int64_t kMaxBytes =
+      ExternalTypedData::MaxElements(kExternalTypedDataUint8ArrayCid);
+  if (length < 0 || length > kMaxBytes) {
+    Exceptions::ThrowRangeError("lengthInBytes", length_obj, 0, kMaxBytes);
+  }
+  // calloc() returns memory suitably aligned for the 64-bit atomics below.
+  uint8_t* data = reinterpret_cast<uint8_t*>(::calloc(length, 1));
+  if (data == nullptr && length != 0) {
+    const Instance& exception = Instance::Handle(
+        thread->isolate_group()->object_store()->out_of_memory());
+    Exceptions::Throw(thread, exception);
+    UNREACHABLE();
+  }
+  const ExternalTypedData& typed_data = ExternalTypedData::Handle(
+      ExternalTypedData::New(kExternalTypedDataUint8ArrayCid, data, length,
+                             thread->heap()->SpaceForExternal(length)));
+  // The finalizer runs once no isolate of the group refers to the buffer
+  // anymore, since all of them share the same heap.
+  FinalizablePersistentHandle::New(thread->isolate_group(), typed_data,
+                                   /* peer= */ data,
+                                   &ExternalTypedDataFinalizer, length,
+                                   /*auto_delete=*/true);
+  typed_data.SetShared();
+  return typed_data.ptr();
+}
+
+// Returns the address of the 64-bit slot at [byte_offset_obj] in [data],
+// throwing if it is out of bounds or misaligned.
+//
+// On 64-bit targets the atomic loads, stores and fetch-adds are recognized
+// methods which the compiler lowers to machine instructions, so these natives
+// are only reached on 32-bit targets and for compare-and-swap.
+static std::atomic<int64_t>* SharedTypedDataSlot(
+    const ExternalTypedData& data,
+    const Integer& byte_offset_obj) {
+  static_assert(sizeof(std::atomic<int64_t>) == sizeof(int64_t),
+                "Atomic slots must not have a different layout");
+  const int64_t byte_offset = byte_offset_obj.AsInt64Value();
+  const intptr_t max_offset =
+      data.LengthInBytes() - static_cast<intptr_t>(sizeof(int64_t));
+  if (byte_offset < 0 || byte_offset > max_offset) {
+    Exceptions::ThrowRangeError("byteOffset", byte_offset_obj, 0, max_offset);
+  }
+  if ((byte_offset % sizeof(int64_t)) != 0) {
+    const auto& error = String::Handle(String::NewFormatted(
+        "Offset in bytes (%" Pd64 ") must be a multiple of %" Pd "",
+        byte_offset, static_cast<intptr_t>(sizeof(int64_t))));
+    Exceptions::ThrowArgumentError(error);
+  }
+  // External data never moves, so the address stays valid across safepoints.
+  return reinterpret_cast<std::atomic<int64_t>*>(data.DataAddr(byte_offset));
+}
+
+DEFINE_NATIVE_ENTRY(SharedTypedData_atomicLoad, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(ExternalTypedData, data,
+                               arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, byte_offset, arguments->NativeArgAt(1));
+  auto slot = SharedTypedDataSlot(data, byte_offset);
+  return Integer::New(slot->load(std::memory_order_acquire));
+}
+
+DEFINE_NATIVE_ENTRY(SharedTypedData_atomicStore, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(ExternalTypedData, data,
+                               arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, byte_offset, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, value, arguments->NativeArgAt(2));
+  auto slot = SharedTypedDataSlot(data, byte_offset);
+  slot->store(value.AsInt64Value(), std::memory_order_release);
+  return Object::null();
+}
+
+DEFINE_NATIVE_ENTRY(SharedTypedData_atomicCompareAndSwap, 0, 4) {
+  GET_NON_NULL_NATIVE_ARGUMENT(ExternalTypedData, data,
+                               arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, byte_offset, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, expected, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, new_value, arguments->NativeArgAt(3));
+  auto slot = SharedTypedDataSlot(data, byte_offset);
+  int64_t previous = expected.AsInt64Value();
+  // On failure [previous] is updated to the current value.
+  slot->compare_exchange_strong(previous, new_value.AsInt64Value(),
+                                std::memory_order_acq_rel,
+                                std::memory_order_acquire);
+  return Integer::New(previous);
+}
+
+DEFINE_NATIVE_ENTRY(SharedTypedData_atomicFetchAdd, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(ExternalTypedData, data,
+                               arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, byte_offset, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, delta, arguments->NativeArgAt(2));
+  auto slot = SharedTypedDataSlot(data, byte_offset);
+  // Performed on unsigned values so that overflow wraps around.
+  auto unsigned_slot = reinterpret_cast<std::atomic<uint64_t>*>(slot);
+  const uint64_t previous = unsigned_slot->fetch_add(
+      static_cast<uint64_t>(delta.AsInt64Value()), std::memory_order_acq_rel);
+  return Integer::New(static_cast<int64_t>(previous));
+}
+
 }  // namespace dart
@@ -0,0 +1,52 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:observatory/service_io.dart';
+import 'package:test/test.dart';
+
+import 'test_helper.dart';
+
+fib(n) {
+  if (n < 0) return 0;
+  if (n == 0) return 1;
+  return fib(n - 1) + fib(n - 2);
+}
+
+testeeDo() {
+  print("Testee doing something.");
+  fib(30);
+  print("Testee did something.");
+}
+
+Future checkSamples(Isolate isolate) async {
+  final result = await isolate.invokeRpcNoUpgrade('getCpuSamples', {});
+  expect(result['type'], equals('CpuSamples'));
+
+  // Machines without a PMU (e.g. most VMs) fall back to timer interrupts.
+  final event = result['_sampleEvent'];
+  expect(event, isIn(['cache-misses', 'timer']));
+  if (event == 'cache-misses') {
+    expect(result['_sampleEventPeriod'], equals(100));
+  } else {
+    expect(result.containsKey('_sampleEventPeriod'), isFalse);
+  }
+
+  final samples = result['samples'];
+  expect(samples.length, greaterThan(0), reason: "Should have samples");
+  expect(samples.first['stack'], isA<List>());
+}
+
+var tests = <IsolateTest>[
+  (Isolate i) => checkSamples(i),
+];
+
+var vmArgs = [
+  '--profiler=true',
+  '--profile-vm=false', // So this also works with KBC.
+  '--profile-event=cache-misses',
+  '--profile-event-period=100',
+];
+
+main(args) async =>
+    runIsolateTests(args, tests, testeeBefore: testeeDo, extraArgs: vmArgs);
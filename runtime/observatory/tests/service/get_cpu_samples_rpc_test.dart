@@ -23,6 +23,7 @@ Future checkSamples(Isolate isolate) async {
   final result =
       await isolate.invokeRpcNoUpgrade('getCpuSamples', {'_code': true});
   expect(result['type'], equals('CpuSamples'));
+  expect(result['_sampleEvent'], equals('timer'));
 
   final isString = isA<String>();
   final isInt = isA<int>();
@@ -0,0 +1,55 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:observatory/service_io.dart';
+import 'package:test/test.dart';
+
+import 'test_helper.dart';
+
+var tests = <VMTest>[
+  (VM vm) async {
+    var params = {
+      'isolateId': vm.isolates.first.id,
+    };
+    var result =
+        await vm.invokeRpcNoUpgrade('_getIsolateMemoryBreakdown', params);
+    expect(result['type'], equals('_IsolateMemoryBreakdown'));
+    expect(result['isolate'], isPositive);
+    expect(result['messageHandler'], isPositive);
+    expect(result['fieldTableLength'], isPositive);
+    expect(result['fieldTable'],
+        greaterThanOrEqualTo(result['fieldTableLength']));
+    expect(result['queuedMessageCount'], greaterThanOrEqualTo(0));
+    var sum = 0;
+    for (var key in [
+      'isolate',
+      'mutatorThread',
+      'fieldTable',
+      'messageHandler',
+      'queuedMessages',
+      'exceptionHandlerCaches',
+      'forwardTables',
+      'regexpBacktrackingStack',
+      'debugger',
+      'objectIdRing',
+    ]) {
+      expect(result[key], greaterThanOrEqualTo(0));
+      sum += result[key] as int;
+    }
+    expect(result['total'], equals(sum));
+  },
+
+  // Plausible isolate id, not found.
+  (VM vm) async {
+    var params = {
+      'isolateId': 'isolates/9999999999',
+    };
+    var result =
+        await vm.invokeRpcNoUpgrade('_getIsolateMemoryBreakdown', params);
+    expect(result['type'], equals('Sentinel'));
+    expect(result['kind'], equals('Collected'));
+  },
+];
+
+main(args) async => runVMTests(args, tests);
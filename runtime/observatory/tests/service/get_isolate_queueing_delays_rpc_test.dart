@@ -0,0 +1,61 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:isolate';
+
+import 'package:observatory/service_io.dart';
+import 'package:test/test.dart';
+
+import 'test_helper.dart';
+
+const int kMessages = 100;
+
+Future<void> sendMessages() async {
+  final port = ReceivePort();
+  int received = 0;
+  for (int i = 0; i < kMessages; i++) {
+    port.sendPort.send(i);
+  }
+  await for (final _ in port) {
+    if (++received == kMessages) {
+      port.close();
+    }
+  }
+}
+
+void expectHistogram(Map histogram) {
+  final buckets = histogram['buckets'] as List;
+  expect(buckets.length, equals(32));
+  expect(buckets.fold<int>(0, (a, b) => a + (b as int)),
+      equals(histogram['count']));
+  expect(histogram['maxMicros'], greaterThanOrEqualTo(histogram['p99Micros']));
+  expect(histogram['p99Micros'], greaterThanOrEqualTo(histogram['p90Micros']));
+  expect(histogram['p90Micros'], greaterThanOrEqualTo(histogram['p50Micros']));
+  expect(histogram['totalMicros'], greaterThanOrEqualTo(0));
+}
+
+var tests = <IsolateTest>[
+  (Isolate isolate) async {
+    var params = {
+      'reset': true,
+    };
+    var result =
+        await isolate.invokeRpcNoUpgrade('_getIsolateQueueingDelays', params);
+    expect(result['type'], equals('_QueueingDelays'));
+    expect(result['timeSliceYields'], greaterThanOrEqualTo(0));
+    expectHistogram(result['normal']);
+    expectHistogram(result['oob']);
+    // The service requests themselves are OOB messages.
+    expect(result['oob']['count'], isPositive);
+    expect(result['normal']['count'], greaterThanOrEqualTo(kMessages));
+
+    // The histograms were reset by the previous request.
+    result = await isolate.invokeRpcNoUpgrade('_getIsolateQueueingDelays', {});
+    expect(result['normal']['count'], lessThan(kMessages));
+    expect(result['oob']['count'], isPositive);
+  },
+];
+
+main(args) async =>
+    runIsolateTests(args, tests, testeeBefore: sendMessages);
@@ -0,0 +1,99 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=
+// VMOptions=--optimization_counter_threshold=10 --no-background-compilation
+
+// A SharedTypedData sent to isolates of the same group aliases the same
+// memory, and its atomic operations can be used to coordinate between them.
+// The second configuration also runs the atomics in optimized code.
+
+import "dart:_internal" show SharedTypedData;
+import "dart:async";
+import "dart:isolate";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int kIsolates = 4;
+const int kIncrements = 1000;
+
+// Layout of the buffer shared with the workers.
+const int kCounterOffset = 0;
+const int kLockOffset = 8;
+const int kFirstMarkerOffset = 16;
+const int kFirstPayloadOffset = kFirstMarkerOffset + 8 * kIsolates;
+const int kLength = kFirstPayloadOffset + kIsolates;
+
+void worker(List args) {
+  final shared = args[0] as SharedTypedData;
+  final index = args[1] as int;
+  for (int i = 0; i < kIncrements; i++) {
+    shared.atomicFetchAdd(kCounterOffset, 1);
+  }
+  // Only one worker wins the lock.
+  shared.atomicCompareAndSwap(kLockOffset, 0, index + 1);
+  // A plain write through a view, published by the atomic store below.
+  shared.buffer.asUint8List()[kFirstPayloadOffset + index] = 42;
+  shared.atomicStore(kFirstMarkerOffset + 8 * index, 1);
+}
+
+void testSharedBetweenIsolates() async {
+  final shared = SharedTypedData(kLength);
+  Expect.equals(kLength, shared.lengthInBytes);
+  Expect.isTrue(shared.buffer.asUint8List().every((byte) => byte == 0));
+
+  final exits = <Future>[];
+  for (int i = 0; i < kIsolates; i++) {
+    final exitPort = ReceivePort();
+    await Isolate.spawn(worker, [shared, i], onExit: exitPort.sendPort);
+    exits.add(exitPort.first);
+  }
+  await Future.wait(exits);
+
+  Expect.equals(kIsolates * kIncrements, shared.atomicLoad(kCounterOffset));
+  final winner = shared.atomicLoad(kLockOffset);
+  Expect.isTrue(winner >= 1 && winner <= kIsolates);
+  final bytes = shared.buffer.asUint8List();
+  for (int i = 0; i < kIsolates; i++) {
+    Expect.equals(1, shared.atomicLoad(kFirstMarkerOffset + 8 * i));
+    Expect.equals(42, bytes[kFirstPayloadOffset + i]);
+  }
+}
+
+void testAtomics() {
+  final shared = SharedTypedData(16);
+  shared.atomicStore(8, -1);
+  Expect.equals(-1, shared.atomicLoad(8));
+  Expect.equals(-1, shared.buffer.asInt64List()[1]);
+
+  Expect.equals(-1, shared.atomicCompareAndSwap(8, 0, 5));
+  Expect.equals(-1, shared.atomicLoad(8));
+  Expect.equals(-1, shared.atomicCompareAndSwap(8, -1, 5));
+  Expect.equals(5, shared.atomicLoad(8));
+
+  Expect.equals(5, shared.atomicFetchAdd(8, 10));
+  Expect.equals(15, shared.atomicFetchAdd(8, -20));
+  Expect.equals(-5, shared.atomicLoad(8));
+
+  // Wraps around on overflow.
+  shared.atomicStore(0, 0x7fffffffffffffff);
+  shared.atomicFetchAdd(0, 1);
+  Expect.equals(-0x8000000000000000, shared.atomicLoad(0));
+
+  Expect.throwsRangeError(() => shared.atomicLoad(16));
+  Expect.throwsRangeError(() => shared.atomicLoad(-8));
+  Expect.throwsArgumentError(() => shared.atomicStore(4, 0));
+  Expect.throwsRangeError(() => SharedTypedData(-1));
+  Expect.throwsRangeError(() => SharedTypedData(0).atomicLoad(0));
+}
+
+main() async {
+  asyncStart();
+  for (int i = 0; i < 20; i++) {
+    testAtomics();
+  }
+  await testSharedBetweenIsolates();
+  asyncEnd();
+}
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+# for details. All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+
+# Converts a trace written by --timeline_recorder=binary into the Chrome trace
+# event format, which can be loaded into chrome://tracing or Perfetto.
+#
+# The binary format is documented with TimelineBinaryTrace in
+# runtime/vm/timeline.h. Traces have to be converted on a machine with the
+# same byte order as the one which recorded them.
+
+import json
+import struct
+import sys
+from optparse import OptionParser
+
+MAGIC = b"DARTTLB1"
+
+THREAD = 1
+STRING = 2
+EVENT = 3
+DROPPED = 4
+
+PRE_SERIALIZED_ARGS = 1
+
+# Indexed by TimelineEvent::EventType.
+PHASES = [None, "B", "E", "X", "i", "b", "n", "e", "C", "s", "t", "f", "M"]
+DURATION = 3
+INSTANT = 4
+FLOW_END = 11
+HAS_ID = (5, 6, 7, 9, 10, 11)
+
+
+class Reader(object):
+
+    def __init__(self, data, start, end):
+        self.data = data
+        self.pos = start
+        self.end = end
+
+    def read(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > self.end:
+            raise ValueError("Truncated record")
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values
+
+    def read_bytes(self, length):
+        if self.pos + length > self.end:
+            raise ValueError("Truncated record")
+        result = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return result.decode("utf-8", "replace")
+
+    def read_string(self, table):
+        (string_id,) = self.read("=I")
+        if string_id != 0:
+            return table[string_id]
+        (length,) = self.read("=I")
+        return self.read_bytes(length)
+
+
+def ConvertEvent(reader, table, pid):
+    event_type, flags, argc = reader.read("=BBH")
+    category = reader.read_string(table)
+    label = reader.read_string(table)
+    (tid, isolate_id, isolate_group_id, timestamp0, timestamp1,
+     thread_timestamp0, thread_timestamp1) = reader.read("=qqQqqqq")
+    args = {}
+    for _ in range(argc):
+        name = reader.read_string(table)
+        args[name] = reader.read_string(table)
+
+    event = {
+        "name": label,
+        "cat": category,
+        "tid": tid,
+        "pid": pid,
+        "ts": timestamp0,
+        "ph": PHASES[event_type],
+    }
+    if thread_timestamp0 != -1:
+        event["tts"] = thread_timestamp0
+    if event_type == DURATION:
+        event["dur"] = timestamp1 - timestamp0
+        if thread_timestamp0 != -1:
+            event["tdur"] = thread_timestamp1 - thread_timestamp0
+    elif event_type == INSTANT:
+        event["s"] = "p"
+    if event_type == FLOW_END:
+        event["bp"] = "e"
+    if event_type in HAS_ID:
+        event["id"] = "%x" % (timestamp1 & 0xffffffffffffffff)
+    if flags & PRE_SERIALIZED_ARGS:
+        args = json.loads(args["Dart Arguments"])
+    if isolate_id != 0:
+        args["isolateId"] = "isolates/%d" % isolate_id
+    if isolate_group_id != 0:
+        args["isolateGroupId"] = "isolateGroups/%d" % isolate_group_id
+    event["args"] = args
+    return event
+
+
+def Convert(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise ValueError("Not a binary timeline trace")
+    (pid,) = struct.unpack_from("=Q", data, len(MAGIC))
+    events = []
+    tables = {}
+    dropped = 0
+    pos = len(MAGIC) + 8
+    while pos < len(data):
+        buffer_id, length = struct.unpack_from("=II", data, pos)
+        pos += 8
+        chunk_end = pos + length
+        if chunk_end > len(data):
+            raise ValueError("Truncated chunk")
+        table = tables.setdefault(buffer_id, {})
+        while pos < chunk_end:
+            record_length, kind = struct.unpack_from("=IB", data, pos)
+            if record_length < 5 or pos + record_length > chunk_end:
+                raise ValueError("Malformed record")
+            reader = Reader(data, pos + 5, pos + record_length)
+            if kind == THREAD:
+                (tid,) = reader.read("=q")
+                name = reader.read_string(table)
+                if name:
+                    events.append({
+                        "name": "thread_name",
+                        "ph": "M",
+                        "pid": pid,
+                        "tid": tid,
+                        "args": {
+                            "name": "%s (%d)" % (name, tid),
+                            "mode": "basic"
+                        },
+                    })
+            elif kind == STRING:
+                (string_id,) = reader.read("=I")
+                table[string_id] = reader.read_bytes(reader.end - reader.pos)
+            elif kind == EVENT:
+                events.append(ConvertEvent(reader, table, pid))
+            elif kind == DROPPED:
+                dropped += reader.read("=Q")[0]
+            pos += record_length
+    return events, dropped
+
+
+def Main():
+    parser = OptionParser(usage="usage: %prog [options] trace.bin")
+    parser.add_option("--output",
+                      action="store",
+                      type="string",
+                      help="output file name, defaults to stdout")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.print_help()
+        return 1
+
+    with open(args[0], "rb") as f:
+        events, dropped = Convert(f.read())
+    if dropped > 0:
+        sys.stderr.write("warning: the recorder dropped %d events\n" % dropped)
+    if options.output:
+        with open(options.output, "w") as f:
+            json.dump(events, f)
+    else:
+        json.dump(events, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(Main())
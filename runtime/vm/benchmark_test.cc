@@ -4,6 +4,8 @@
 
 #include "vm/benchmark_test.h"
 
+#include <math.h>
+
 #include "bin/builtin.h"
 #include "bin/file.h"
 #include "bin/isolate_data.h"
@@ -18,14 +20,33 @@
 #include "vm/app_snapshot.h"
 #include "vm/dart_api_impl.h"
 #include "vm/datastream.h"
+#include "vm/hash_map.h"
+#include "vm/heap/freelist.h"
+#include "vm/json_writer.h"
 #include "vm/message_snapshot.h"
 #include "vm/stack_frame.h"
+#include "vm/symbols.h"
 #include "vm/timer.h"
+#include "vm/virtual_memory.h"
 
 using dart::bin::File;
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            benchmark_repetitions,
+            1,
+            "Number of times each benchmark is run and scored.");
+DEFINE_FLAG(int,
+            benchmark_warmup,
+            0,
+            "Number of times each benchmark is run before it is scored.");
+DEFINE_FLAG(charp,
+            benchmark_json,
+            nullptr,
+            "Write the scores of the benchmarks and their statistics as JSON "
+            "to this file.");
+
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
@@ -37,6 +58,141 @@ void Benchmark::RunAll(const char* executable) {
     benchmark->RunBenchmark();
     benchmark = benchmark->next_;
   }
+  if (FLAG_benchmark_json != nullptr) {
+    WriteJSON(FLAG_benchmark_json);
+  }
+}
+
+void Benchmark::RunRepetitions() {
+  for (intptr_t i = 0; i < FLAG_benchmark_warmup; i++) {
+    Run();
+  }
+  scores_.Clear();
+  const intptr_t repetitions = Utils::Maximum(FLAG_benchmark_repetitions, 1);
+  for (intptr_t i = 0; i < repetitions; i++) {
+    Run();
+    scores_.Add(score_);
+  }
+  set_score(static_cast<int64_t>(Statistics().median));
+}
+
+// Two-sided critical values of Student's t-distribution for a confidence of
+// 95%, by degrees of freedom.
+static const double kStudentT95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+static int CompareScores(const int64_t* a, const int64_t* b) {
+  return (*a < *b) ? -1 : ((*a > *b) ? 1 : 0);
+}
+
+BenchmarkStatistics BenchmarkStatistics::Compute(const int64_t* scores,
+                                                 intptr_t count) {
+  BenchmarkStatistics stats;
+  stats.count = count;
+  if (count == 0) {
+    return stats;
+  }
+
+  MallocGrowableArray<int64_t> sorted(count);
+  double sum = 0.0;
+  for (intptr_t i = 0; i < count; i++) {
+    sorted.Add(scores[i]);
+    sum += scores[i];
+  }
+  sorted.Sort(CompareScores);
+  stats.mean = sum / count;
+  stats.min = sorted[0];
+  stats.max = sorted[count - 1];
+  if ((count % 2) == 0) {
+    stats.median = (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+  } else {
+    stats.median = sorted[count / 2];
+  }
+  if (count < 2) {
+    return stats;
+  }
+
+  double squares = 0.0;
+  for (intptr_t i = 0; i < count; i++) {
+    const double deviation = scores[i] - stats.mean;
+    squares += deviation * deviation;
+  }
+  stats.stddev = sqrt(squares / (count - 1));
+  const intptr_t degrees_of_freedom = count - 1;
+  // Beyond the table the t-distribution is close to the normal distribution.
+  const double t =
+      (degrees_of_freedom <= static_cast<intptr_t>(ARRAY_SIZE(kStudentT95)))
+          ? kStudentT95[degrees_of_freedom - 1]
+          : 1.96;
+  stats.ci95 = t * stats.stddev / sqrt(static_cast<double>(count));
+  return stats;
+}
+
+void Benchmark::WriteJSON(const char* path) {
+  JSONWriter writer;
+  writer.OpenObject();
+  writer.OpenArray("benchmarks");
+  for (Benchmark* benchmark = first_; benchmark != nullptr;
+       benchmark = benchmark->next_) {
+    if (benchmark->scores_.is_empty()) {
+      continue;  // Not selected.
+    }
+    const BenchmarkStatistics stats = benchmark->Statistics();
+    writer.OpenObject();
+    writer.PrintProperty("name", benchmark->name());
+    writer.PrintProperty("kind", benchmark->score_kind());
+    writer.OpenArray("scores");
+    for (intptr_t i = 0; i < benchmark->scores_.length(); i++) {
+      writer.PrintValue64(benchmark->scores_[i]);
+    }
+    writer.CloseArray();
+    writer.PrintProperty("mean", stats.mean);
+    writer.PrintProperty("median", stats.median);
+    writer.PrintProperty("stddev", stats.stddev);
+    writer.PrintProperty("ci95", stats.ci95);
+    writer.PrintProperty64("min", stats.min);
+    writer.PrintProperty64("max", stats.max);
+    writer.CloseObject();
+  }
+  writer.CloseArray();
+  writer.CloseObject();
+
+  char* buffer = nullptr;
+  intptr_t length = 0;
+  writer.Steal(&buffer, &length);
+  File* file = File::Open(nullptr, path, File::kWriteTruncate);
+  if (file == nullptr) {
+    OS::PrintErr("Failed to open benchmark output file %s\n", path);
+  } else {
+    bin::RefCntReleaseScope<File> rs(file);
+    if (!file->WriteFully(buffer, length)) {
+      OS::PrintErr("Failed to write benchmark output file %s\n", path);
+    }
+  }
+  free(buffer);
+}
+
+VM_UNIT_TEST_CASE(BenchmarkStatistics) {
+  const int64_t kScores[] = {12, 10, 11, 13, 9};
+  BenchmarkStatistics stats =
+      BenchmarkStatistics::Compute(kScores, ARRAY_SIZE(kScores));
+  EXPECT_EQ(5, stats.count);
+  EXPECT_FLOAT_EQ(11.0, stats.mean, 1e-9);
+  EXPECT_FLOAT_EQ(11.0, stats.median, 1e-9);
+  EXPECT_FLOAT_EQ(sqrt(2.5), stats.stddev, 1e-9);
+  EXPECT_FLOAT_EQ(2.776 * sqrt(2.5) / sqrt(5.0), stats.ci95, 1e-9);
+  EXPECT_EQ(9, stats.min);
+  EXPECT_EQ(13, stats.max);
+
+  stats = BenchmarkStatistics::Compute(kScores, 2);
+  EXPECT_FLOAT_EQ(11.0, stats.median, 1e-9);
+
+  stats = BenchmarkStatistics::Compute(kScores, 1);
+  EXPECT_FLOAT_EQ(12.0, stats.median, 1e-9);
+  EXPECT_FLOAT_EQ(0.0, stats.ci95, 1e-9);
 }
 
 //
@@ -245,6 +401,128 @@ BENCHMARK(DartStringAccess) {
   benchmark->set_score(elapsed_time);
 }
 
+// Dart code shared by the string benchmarks below. [run] performs [op] on
+// one-byte strings from 8 bytes to 1MB, processing about the same number of
+// characters for every size.
+static const char* kStringBenchmarkScript = R"(
+const sizes = [8, 64, 512, 4 * 1024, 32 * 1024, 256 * 1024, 1024 * 1024];
+const charactersPerSize = 16 * 1024 * 1024;
+
+String makeString(int length, int last) {
+  final codeUnits = List<int>.filled(length, 0x61);
+  codeUnits[length - 1] = last;
+  return String.fromCharCodes(codeUnits);
+}
+
+int run(int op) {
+  int result = 0;
+  for (final size in sizes) {
+    final a = makeString(size, 0x62);
+    final b = makeString(size, 0x62);
+    final needle = makeString(8, 0x62);
+    final iterations = charactersPerSize ~/ size;
+    for (int i = 0; i < iterations; i++) {
+      switch (op) {
+        case 0:
+          if (a == b) result++;
+          break;
+        case 1:
+          result += a.indexOf('b');
+          break;
+        case 2:
+          result += a.indexOf(needle);
+          break;
+      }
+    }
+  }
+  return result;
+})";
+
+static void RunStringBenchmark(Benchmark* benchmark, intptr_t op) {
+  Dart_Handle lib = TestCase::LoadTestScript(kStringBenchmarkScript, nullptr);
+  EXPECT_VALID(lib);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(op);
+
+  // Warmup first to avoid compilation jitters.
+  Dart_Handle result = Dart_Invoke(lib, NewString("run"), 1, args);
+  EXPECT_VALID(result);
+
+  Timer timer;
+  timer.Start();
+  result = Dart_Invoke(lib, NewString("run"), 1, args);
+  EXPECT_VALID(result);
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+//
+// Measure equality, single character and substring search of one-byte
+// strings.
+//
+BENCHMARK(StringEquality) {
+  RunStringBenchmark(benchmark, 0);
+}
+
+BENCHMARK(StringIndexOfCharacter) {
+  RunStringBenchmark(benchmark, 1);
+}
+
+BENCHMARK(StringIndexOfSubstring) {
+  RunStringBenchmark(benchmark, 2);
+}
+
+//
+// Measure how fast regexps with a literal prefix scan multi-megabyte inputs
+// with few candidate positions.
+//
+BENCHMARK(RegExpLiteralPrefixScan) {
+  const char* kScriptChars = R"(
+final log = () {
+  final buffer = StringBuffer();
+  for (int i = 0; i < 40000; i++) {
+    buffer.write('$i GET /index.html HTTP/1.1 200 OK ');
+  }
+  buffer.write('ERROR: disk full (code 28)');
+  return buffer.toString();
+}();
+
+int benchmark(int count) {
+  final regexps = [
+    RegExp(r'ERROR: (\w+) full'),
+    RegExp(r'code (\d+)'),
+    RegExp(r'POST /\S+'),
+  ];
+  int result = 0;
+  for (int i = 0; i < count; i++) {
+    for (final regexp in regexps) {
+      final match = regexp.firstMatch(log);
+      if (match != null) result += match.start;
+    }
+  }
+  return result;
+})";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, nullptr);
+  EXPECT_VALID(lib);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(5);
+
+  // Warmup first to avoid compilation jitters.
+  Dart_Handle result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+
+  args[0] = Dart_NewInteger(20);
+  Timer timer;
+  timer.Start();
+  result = Dart_Invoke(lib, NewString("benchmark"), 1, args);
+  EXPECT_VALID(result);
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 static void vmservice_resolver(Dart_NativeArguments args) {}
 
 static Dart_NativeFunction NativeResolver(Dart_Handle name,
@@ -603,6 +881,221 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+// Telemetry-like records of a timestamp, a value, a code and a name, as
+// posted by native code with Dart_PostCObject.
+static const intptr_t kCObjectRecordCount = 100000;
+static const intptr_t kCObjectRecordNameLength = 8;
+
+static void CObjectRecordName(intptr_t i, char* buffer) {
+  Utils::SNPrint(buffer, kCObjectRecordNameLength + 1, "sensor%02" Pd, i % 16);
+}
+
+static void BenchmarkApiMessage(Thread* thread,
+                                Benchmark* benchmark,
+                                Dart_CObject* root) {
+  const intptr_t kLoopCount = 20;
+  Timer timer;
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    std::unique_ptr<Message> message = WriteApiMessage(
+        zone.GetZone(), root, ILLEGAL_PORT, Message::kNormalPriority);
+
+    // Read object back from the snapshot.
+    ReadMessage(thread, message.get());
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+// One array per record.
+BENCHMARK(PostCObjectRecordArrays) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  const intptr_t kFieldCount = 4;
+  Dart_CObject* records =
+      zone.GetZone()->Alloc<Dart_CObject>(kCObjectRecordCount);
+  Dart_CObject** record_ptrs =
+      zone.GetZone()->Alloc<Dart_CObject*>(kCObjectRecordCount);
+  Dart_CObject* fields =
+      zone.GetZone()->Alloc<Dart_CObject>(kFieldCount * kCObjectRecordCount);
+  Dart_CObject** field_ptrs =
+      zone.GetZone()->Alloc<Dart_CObject*>(kFieldCount * kCObjectRecordCount);
+  for (intptr_t i = 0; i < kCObjectRecordCount; i++) {
+    Dart_CObject* record_fields = &fields[kFieldCount * i];
+    record_fields[0].type = Dart_CObject_kInt64;
+    record_fields[0].value.as_int64 = 1650000000000000 + i;
+    record_fields[1].type = Dart_CObject_kDouble;
+    record_fields[1].value.as_double = i * 0.5;
+    record_fields[2].type = Dart_CObject_kInt32;
+    record_fields[2].value.as_int32 = i % 7;
+    record_fields[3].type = Dart_CObject_kString;
+    record_fields[3].value.as_string =
+        zone.GetZone()->Alloc<char>(kCObjectRecordNameLength + 1);
+    CObjectRecordName(i, record_fields[3].value.as_string);
+    for (intptr_t j = 0; j < kFieldCount; j++) {
+      field_ptrs[kFieldCount * i + j] = &record_fields[j];
+    }
+    records[i].type = Dart_CObject_kArray;
+    records[i].value.as_array.length = kFieldCount;
+    records[i].value.as_array.values = &field_ptrs[kFieldCount * i];
+    record_ptrs[i] = &records[i];
+  }
+  Dart_CObject root;
+  root.type = Dart_CObject_kArray;
+  root.value.as_array.length = kCObjectRecordCount;
+  root.value.as_array.values = record_ptrs;
+  BenchmarkApiMessage(thread, benchmark, &root);
+}
+
+static void SetTypedDataColumn(Dart_CObject* column,
+                               Dart_TypedData_Type type,
+                               intptr_t length,
+                               void* values) {
+  column->type = Dart_CObject_kTypedData;
+  column->value.as_typed_data.type = type;
+  column->value.as_typed_data.length = length;
+  column->value.as_typed_data.values = reinterpret_cast<uint8_t*>(values);
+}
+
+// One typed data column per field. The names are stored as the UTF-8 bytes
+// of all names and the end offset of each name.
+BENCHMARK(PostCObjectRecordColumns) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  int64_t* timestamps = zone.GetZone()->Alloc<int64_t>(kCObjectRecordCount);
+  double* values = zone.GetZone()->Alloc<double>(kCObjectRecordCount);
+  int32_t* codes = zone.GetZone()->Alloc<int32_t>(kCObjectRecordCount);
+  uint8_t* names = zone.GetZone()->Alloc<uint8_t>(
+      kCObjectRecordCount * kCObjectRecordNameLength + 1);
+  int32_t* name_ends = zone.GetZone()->Alloc<int32_t>(kCObjectRecordCount);
+  intptr_t names_length = 0;
+  for (intptr_t i = 0; i < kCObjectRecordCount; i++) {
+    timestamps[i] = 1650000000000000 + i;
+    values[i] = i * 0.5;
+    codes[i] = i % 7;
+    CObjectRecordName(i, reinterpret_cast<char*>(&names[names_length]));
+    names_length += kCObjectRecordNameLength;
+    name_ends[i] = names_length;
+  }
+  const intptr_t kColumnCount = 5;
+  Dart_CObject columns[kColumnCount];
+  SetTypedDataColumn(&columns[0], Dart_TypedData_kInt64, kCObjectRecordCount,
+                     timestamps);
+  SetTypedDataColumn(&columns[1], Dart_TypedData_kFloat64,
+                     kCObjectRecordCount, values);
+  SetTypedDataColumn(&columns[2], Dart_TypedData_kInt32, kCObjectRecordCount,
+                     codes);
+  SetTypedDataColumn(&columns[3], Dart_TypedData_kUint8, names_length, names);
+  SetTypedDataColumn(&columns[4], Dart_TypedData_kInt32, kCObjectRecordCount,
+                     name_ends);
+  Dart_CObject* column_ptrs[kColumnCount];
+  for (intptr_t i = 0; i < kColumnCount; i++) {
+    column_ptrs[i] = &columns[i];
+  }
+  Dart_CObject root;
+  root.type = Dart_CObject_kArray;
+  root.value.as_array.length = kColumnCount;
+  root.value.as_array.values = column_ptrs;
+  BenchmarkApiMessage(thread, benchmark, &root);
+}
+
+BENCHMARK(ZoneAllocation) {
+  TransitionNativeToVM transition(thread);
+  const intptr_t kLoopCount = 1000;
+  const intptr_t kAllocationCount = 10000;
+  Timer timer;
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    for (intptr_t j = 0; j < kAllocationCount; j++) {
+      // 8, 32, 128 and 512 bytes.
+      zone.GetZone()->Alloc<uint8_t>(8 << (j & 6));
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+BENCHMARK(SymbolsLookup) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  const intptr_t kSymbolCount = 1000;
+  const intptr_t kLoopCount = 100;
+  const char** names = zone.GetZone()->Alloc<const char*>(kSymbolCount);
+  String& symbol = String::Handle();
+  for (intptr_t i = 0; i < kSymbolCount; i++) {
+    names[i] = OS::SCreate(zone.GetZone(), "benchmarkSymbol%" Pd, i);
+    symbol = Symbols::New(thread, names[i]);
+  }
+  Timer timer;
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    for (intptr_t j = 0; j < kSymbolCount; j++) {
+      symbol = Symbols::New(thread, names[j]);
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+BENCHMARK(IntMapInsertLookup) {
+  TransitionNativeToVM transition(thread);
+  const intptr_t kLoopCount = 100;
+  const intptr_t kKeyCount = 10000;
+  intptr_t found = 0;
+  Timer timer;
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    StackZone zone(thread);
+    IntMap<intptr_t> map(zone.GetZone());
+    for (intptr_t key = 1; key <= kKeyCount; key++) {
+      map.Insert(key * 31, key);
+    }
+    for (intptr_t key = 1; key <= kKeyCount; key++) {
+      if (map.Lookup(key * 31) == key) {
+        found++;
+      }
+    }
+  }
+  timer.Stop();
+  EXPECT_EQ(kLoopCount * kKeyCount, found);
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+BENCHMARK(FreeListAllocateFree) {
+  const intptr_t kBlobSize = 1 * MB;
+  const intptr_t kLoopCount = 1000;
+  const intptr_t kAllocationCount = 4096;
+  std::unique_ptr<VirtualMemory> region(
+      VirtualMemory::Allocate(kBlobSize, /*is_executable=*/false,
+                              /*is_compressed=*/false, "benchmark"));
+  FreeList free_list;
+  free_list.Free(region->start(), kBlobSize);
+  std::unique_ptr<uword[]> addresses(new uword[kAllocationCount]);
+  Timer timer;
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    // Small objects of mixed sizes, which take about a third of the region.
+    for (intptr_t j = 0; j < kAllocationCount; j++) {
+      const intptr_t size = kObjectAlignment * (1 + (j % 8));
+      addresses[j] = free_list.TryAllocate(size, /*is_protected=*/false);
+      RELEASE_ASSERT(addresses[j] != 0);
+    }
+    for (intptr_t j = 0; j < kAllocationCount; j++) {
+      const intptr_t size = kObjectAlignment * (1 + (j % 8));
+      free_list.Free(addresses[j], size);
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
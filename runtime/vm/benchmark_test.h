@@ -9,6 +9,7 @@
 
 #include "vm/dart.h"
 #include "vm/globals.h"
+#include "vm/growable_array.h"
 #include "vm/isolate.h"
 #include "vm/malloc_hooks.h"
 #include "vm/object.h"
@@ -19,6 +20,9 @@ namespace dart {
 
 DECLARE_FLAG(int, code_heap_size);
 DECLARE_FLAG(int, old_gen_growth_space_ratio);
+DECLARE_FLAG(int, benchmark_repetitions);
+DECLARE_FLAG(int, benchmark_warmup);
+DECLARE_FLAG(charp, benchmark_json);
 
 namespace bin {
 // Snapshot pieces if we link in a snapshot, otherwise initialized to NULL.
@@ -57,6 +61,22 @@ inline Dart_Handle NewString(const char* str) {
   return Dart_NewStringFromCString(str);
 }
 
+// Summary statistics of the scores of the repetitions of a benchmark.
+struct BenchmarkStatistics {
+  intptr_t count = 0;
+  double mean = 0.0;
+  double median = 0.0;
+  // Sample standard deviation.
+  double stddev = 0.0;
+  // Half-width of the 95% confidence interval of the mean, from Student's
+  // t-distribution. 0 for fewer than two scores.
+  double ci95 = 0.0;
+  int64_t min = 0;
+  int64_t max = 0;
+
+  static BenchmarkStatistics Compute(const int64_t* scores, intptr_t count);
+};
+
 class Benchmark {
  public:
   typedef void(RunEntry)(Benchmark* benchmark);
@@ -86,6 +106,17 @@ class Benchmark {
   void Run() { (*run_)(this); }
   void RunBenchmark();
 
+  // Runs the benchmark --benchmark_warmup times without keeping the score,
+  // then --benchmark_repetitions times. The score is set to the median of the
+  // repetitions.
+  void RunRepetitions();
+  const MallocGrowableArray<int64_t>& scores() const { return scores_; }
+  BenchmarkStatistics Statistics() const {
+    return BenchmarkStatistics::Compute(scores_.data(), scores_.length());
+  }
+
+  // Runs the benchmarks selected by run_vm_tests and, with --benchmark_json,
+  // writes the scores of those which ran to a file.
   static void RunAll(const char* executable);
   static void SetExecutable(const char* arg) { executable_ = arg; }
   static const char* Executable() { return executable_; }
@@ -96,6 +127,8 @@ class Benchmark {
   }
 
  private:
+  static void WriteJSON(const char* path);
+
   static Benchmark* first_;
   static Benchmark* tail_;
   static const char* executable_;
@@ -104,6 +137,7 @@ class Benchmark {
   const char* name_;
   const char* score_kind_;
   int64_t score_;
+  MallocGrowableArray<int64_t> scores_;
   Dart_Isolate isolate_;
   Benchmark* next_;
 
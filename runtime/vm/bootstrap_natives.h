@@ -61,6 +61,7 @@ namespace dart {
   V(RawReceivePortImpl_get_sendport, 1)                                        \
   V(RawReceivePortImpl_closeInternal, 1)                                       \
   V(RawReceivePortImpl_setActive, 2)                                           \
+  V(RawReceivePortImpl_nextBatchMessage, 1)                                    \
   V(SendPortImpl_get_id, 1)                                                    \
   V(SendPortImpl_get_hashcode, 1)                                              \
   V(SendPortImpl_sendInternal_, 2)                                             \
@@ -128,6 +129,7 @@ namespace dart {
   V(StringBase_joinReplaceAllResult, 4)                                        \
   V(StringBuffer_createStringFromUint16Array, 3)                               \
   V(OneByteString_substringUnchecked, 3)                                       \
+  V(OneByteString_indexOf, 3)                                                  \
   V(OneByteString_allocateFromOneByteList, 3)                                  \
   V(TwoByteString_allocateFromTwoByteList, 3)                                  \
   V(String_getHashCode, 1)                                                     \
@@ -337,6 +339,7 @@ namespace dart {
   V(Internal_writeHeapSnapshotToFile, 1)                                       \
   V(Internal_makeListFixedLength, 1)                                           \
   V(Internal_makeFixedListUnmodifiable, 1)                                     \
+  V(Internal_makeDeeplyImmutable, 2)                                           \
   V(Internal_extractTypeArguments, 2)                                          \
   V(Internal_prependTypeArguments, 4)                                          \
   V(Internal_boundsCheckForPartialInstantiation, 2)                            \
@@ -416,7 +419,12 @@ namespace dart {
   V(DartApiDLMinorVersion, 0)                                                  \
   V(DartNativeApiFunctionPointer, 1)                                           \
   V(TransferableTypedData_factory, 2)                                          \
-  V(TransferableTypedData_materialize, 1)
+  V(TransferableTypedData_materialize, 1)                                      \
+  V(SharedTypedData_allocate, 1)                                               \
+  V(SharedTypedData_atomicLoad, 2)                                             \
+  V(SharedTypedData_atomicStore, 3)                                            \
+  V(SharedTypedData_atomicCompareAndSwap, 4)                                   \
+  V(SharedTypedData_atomicFetchAdd, 3)
 
 // List of bootstrap native entry points used in the dart:mirror library.
 #define MIRRORS_BOOTSTRAP_NATIVE_LIST(V)                                       \
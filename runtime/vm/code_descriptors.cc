@@ -798,6 +798,60 @@ void CodeSourceMapReader::DumpSourcePositions(uword start) {
   THR_Print("}\n");
 }
 
+void CodeSourceMapReader::GetSourcePositionIntervals(
+    GrowableArray<SourcePositionInterval>* intervals) {
+  GrowableArray<const Function*> function_stack;
+  GrowableArray<TokenPosition> token_positions;
+  NoSafepointScope no_safepoint;
+  ReadStream stream(map_.Data(), map_.Length());
+
+  int32_t current_pc_offset = 0;
+  function_stack.Add(&root_);
+  token_positions.Add(InitialPosition());
+
+  while (stream.PendingBytes() > 0) {
+    int32_t arg;
+    const uint8_t opcode = CodeSourceMapOps::Read(&stream, &arg);
+    switch (opcode) {
+      case CodeSourceMapOps::kChangePosition: {
+        const TokenPosition& old_token =
+            token_positions[token_positions.length() - 1];
+        token_positions[token_positions.length() - 1] =
+            TokenPosition::Deserialize(
+                Utils::AddWithWrapAround(arg, old_token.Serialize()));
+        break;
+      }
+      case CodeSourceMapOps::kAdvancePC: {
+        SourcePositionInterval interval = {current_pc_offset,
+                                           function_stack.Last(),
+                                           token_positions.Last()};
+        intervals->Add(interval);
+        current_pc_offset += arg;
+        break;
+      }
+      case CodeSourceMapOps::kPushFunction: {
+        function_stack.Add(
+            &Function::Handle(Function::RawCast(functions_.At(arg))));
+        token_positions.Add(InitialPosition());
+        break;
+      }
+      case CodeSourceMapOps::kPopFunction: {
+        // We never pop the root function.
+        ASSERT(function_stack.length() > 1);
+        ASSERT(token_positions.length() > 1);
+        function_stack.RemoveLast();
+        token_positions.RemoveLast();
+        break;
+      }
+      case CodeSourceMapOps::kNullCheck: {
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
 intptr_t CodeSourceMapReader::GetNullCheckNameIndexAt(int32_t pc_offset) {
   NoSafepointScope no_safepoint;
   ReadStream stream(map_.Data(), map_.Length());
@@ -336,6 +336,14 @@ class CodeSourceMapReader : public ValueObject {
                       const Function& root)
       : map_(map), functions_(functions), root_(root) {}
 
+  // The innermost function and its position for the instructions from
+  // |pc_offset| up to the start of the next interval.
+  struct SourcePositionInterval {
+    int32_t pc_offset;
+    const Function* function;
+    TokenPosition token_pos;
+  };
+
   void GetInlinedFunctionsAt(int32_t pc_offset,
                              GrowableArray<const Function*>* function_stack,
                              GrowableArray<TokenPosition>* token_positions);
@@ -343,6 +351,11 @@ class CodeSourceMapReader : public ValueObject {
   void DumpInlineIntervals(uword start);
   void DumpSourcePositions(uword start);
 
+  // Appends the source position intervals of the code in increasing order of
+  // their PC offsets.
+  void GetSourcePositionIntervals(
+      GrowableArray<SourcePositionInterval>* intervals);
+
   intptr_t GetNullCheckNameIndexAt(int32_t pc_offset);
 
  private:
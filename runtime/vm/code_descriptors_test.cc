@@ -121,6 +121,62 @@ class A {
   EXPECT(!result.IsError());
 }
 
+TEST_CASE(CodeSourceMap_SourcePositionIntervals) {
+  const char* kScriptChars = R"(
+class A {
+  static int foo(int a, int b) {
+    var c = a + b;
+    return c * 2;
+  }
+})";
+  TestCase::LoadTestScript(kScriptChars, nullptr);
+  TransitionNativeToVM transition(thread);
+
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  const String& name = String::Handle(String::New(TestCase::url()));
+  const Library& lib = Library::Handle(Library::LookupLibrary(thread, name));
+  EXPECT(!lib.IsNull());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  const auto& error = cls.EnsureIsFinalized(thread);
+  EXPECT(error == Error::null());
+  const Function& function = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  EXPECT(CompilerTest::TestCompileFunction(function));
+  const Code& code = Code::Handle(function.CurrentCode());
+
+  const CodeSourceMap& map = CodeSourceMap::Handle(code.code_source_map());
+  const Array& functions = Array::Handle(code.inlined_id_to_function());
+  CodeSourceMapReader reader(map, functions, function);
+  GrowableArray<CodeSourceMapReader::SourcePositionInterval> intervals;
+  reader.GetSourcePositionIntervals(&intervals);
+
+  // The intervals cover the code in order, and the body of |foo| is
+  // attributed to the lines it was written on.
+  EXPECT(intervals.length() > 0);
+  EXPECT_EQ(0, intervals[0].pc_offset);
+  const Script& script = Script::Handle(function.script());
+  bool saw_addition = false;
+  bool saw_multiplication = false;
+  for (intptr_t i = 0; i < intervals.length(); i++) {
+    if (i > 0) {
+      EXPECT_LT(intervals[i - 1].pc_offset, intervals[i].pc_offset);
+    }
+    EXPECT(intervals[i].pc_offset < code.Size());
+    EXPECT(intervals[i].function->ptr() == function.ptr());
+    intptr_t line = -1;
+    intptr_t column = -1;
+    if (script.GetTokenLocation(intervals[i].token_pos, &line, &column)) {
+      EXPECT(line >= 3 && line <= 6);
+      saw_addition = saw_addition || (line == 4);
+      saw_multiplication = saw_multiplication || (line == 5);
+    }
+  }
+  EXPECT(saw_addition);
+  EXPECT(saw_multiplication);
+}
+
 ISOLATE_UNIT_TEST_CASE(DescriptorList_TokenPositions) {
   DescriptorList* descriptors = new DescriptorList(thread->zone());
   ASSERT(descriptors != NULL);
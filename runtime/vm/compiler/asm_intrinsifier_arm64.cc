@@ -2002,7 +2002,7 @@ void AsmIntrinsifier::AllocateTwoByteString(Assembler* assembler,
 static void StringEquality(Assembler* assembler,
                            Label* normal_ir_body,
                            intptr_t string_cid) {
-  Label is_true, is_false, loop;
+  Label is_true, is_false;
   __ ldr(R0, Address(SP, 1 * target::kWordSize));  // This.
   __ ldr(R1, Address(SP, 0 * target::kWordSize));  // Other.
 
@@ -2022,7 +2022,9 @@ static void StringEquality(Assembler* assembler,
   __ b(&is_false, NE);
 
   // Check contents, no fall-through possible.
-  // TODO(zra): try out other sequences.
+  // Compare 16 bytes per iteration with ldp, then the remaining bytes one at
+  // a time. Equality does not depend on the character width, so two-byte
+  // strings are compared as bytes as well.
   ASSERT((string_cid == kOneByteStringCid) ||
          (string_cid == kTwoByteStringCid));
   const intptr_t offset = (string_cid == kOneByteStringCid)
@@ -2031,26 +2033,31 @@ static void StringEquality(Assembler* assembler,
   __ AddImmediate(R0, offset - kHeapObjectTag);
   __ AddImmediate(R1, offset - kHeapObjectTag);
   __ SmiUntag(R2);
-  __ Bind(&loop);
+  if (string_cid == kTwoByteStringCid) {
+    __ LslImmediate(R2, R2, 1);
+  }
+  Label wide_loop, byte_loop;
+  __ Bind(&wide_loop);
+  __ CompareImmediate(R2, 2 * target::kWordSize);
+  __ b(&byte_loop, LT);
+  __ ldp(R3, R4, Address(R0, 2 * target::kWordSize, Address::PairPostIndex));
+  __ ldp(R5, R6, Address(R1, 2 * target::kWordSize, Address::PairPostIndex));
+  __ AddImmediate(R2, -2 * target::kWordSize);
+  __ eor(R3, R3, Operand(R5));
+  __ eor(R4, R4, Operand(R6));
+  __ orr(R3, R3, Operand(R4));
+  __ cbnz(&is_false, R3);
+  __ b(&wide_loop);
+
+  __ Bind(&byte_loop);
   __ AddImmediate(R2, -1);
   __ CompareRegisters(R2, ZR);
   __ b(&is_true, LT);
-  if (string_cid == kOneByteStringCid) {
-    __ ldr(R3, Address(R0), kUnsignedByte);
-    __ ldr(R4, Address(R1), kUnsignedByte);
-    __ AddImmediate(R0, 1);
-    __ AddImmediate(R1, 1);
-  } else if (string_cid == kTwoByteStringCid) {
-    __ ldr(R3, Address(R0), kUnsignedTwoBytes);
-    __ ldr(R4, Address(R1), kUnsignedTwoBytes);
-    __ AddImmediate(R0, 2);
-    __ AddImmediate(R1, 2);
-  } else {
-    UNIMPLEMENTED();
-  }
+  __ ldr(R3, Address(R0, 1, Address::PostIndex), kUnsignedByte);
+  __ ldr(R4, Address(R1, 1, Address::PostIndex), kUnsignedByte);
   __ cmp(R3, Operand(R4));
   __ b(&is_false, NE);
-  __ b(&loop);
+  __ b(&byte_loop);
 
   __ Bind(&is_true);
   __ LoadObject(R0, CastHandle<Object>(TrueObject()));
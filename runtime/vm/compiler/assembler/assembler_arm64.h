@@ -1157,6 +1157,17 @@ class Assembler : public AssemblerBase {
     // rn = address
     EmitLoadStoreExclusive(STXR, rs, rn, rt, size);
   }
+  // Like ldxr, but with acquire semantics.
+  void ldaxr(Register rt, Register rn, OperandSize size = kEightBytes) {
+    EmitLoadStoreExclusive(LDAXR, R31, rn, rt, size);
+  }
+  // Like stxr, but with release semantics.
+  void stlxr(Register rs,
+             Register rt,
+             Register rn,
+             OperandSize size = kEightBytes) {
+    EmitLoadStoreExclusive(STLXR, rs, rn, rt, size);
+  }
   void clrex() {
     const int32_t encoding = static_cast<int32_t>(CLREX);
     Emit(encoding);
@@ -1042,6 +1042,41 @@ ASSEMBLER_TEST_RUN(Semaphore, test) {
       "ret\n");
 }
 
+ASSEMBLER_TEST_GENERATE(OrderedSemaphore, assembler) {
+  __ SetupDartSP();
+  __ movz(R0, Immediate(40), 0);
+  __ movz(R1, Immediate(42), 0);
+  __ Push(R0);
+  Label retry;
+  __ Bind(&retry);
+  __ ldaxr(R0, SP);
+  __ stlxr(TMP, R1, SP);  // IP == 0, success
+  __ cmp(TMP, Operand(0));
+  __ b(&retry, NE);  // NE if context switch occurred between ldrex and strex.
+  __ Pop(R0);        // 42
+  __ RestoreCSP();
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(OrderedSemaphore, test) {
+  EXPECT(test != NULL);
+  typedef intptr_t (*OrderedSemaphore)() DART_UNUSED;
+  EXPECT_EQ(42, EXECUTE_TEST_CODE_INT64(OrderedSemaphore, test->entry()));
+  EXPECT_DISASSEMBLY(
+      "mov sp, csp\n"
+      "sub csp, csp, #0x1000\n"
+      "movz r0, #0x28\n"
+      "movz r1, #0x2a\n"
+      "str r0, [sp, #-8]!\n"
+      "ldaxr r0, sp\n"
+      "stlxr tmp, r1, sp\n"
+      "cmp tmp, #0x0\n"
+      "bne -12\n"
+      "ldr r0, [sp], #8 !\n"
+      "mov csp, sp\n"
+      "ret\n");
+}
+
 ASSEMBLER_TEST_GENERATE(FailedSemaphore, assembler) {
   __ SetupDartSP();
   __ movz(R0, Immediate(40), 0);
@@ -379,6 +379,7 @@ class Assembler : public AssemblerBase {
   RA(Q, cmpxchgq, 0xB1, 0x0F)
   RR(L, cmpxchgl, 0xB1, 0x0F)
   RR(Q, cmpxchgq, 0xB1, 0x0F)
+  AR(Q, xaddq, 0xC1, 0x0F)
   RA(Q, movzxb, 0xB6, 0x0F)
   RR(Q, movzxb, 0xB6, 0x0F)
   RA(Q, movzxw, 0xB7, 0x0F)
@@ -895,6 +896,13 @@ class Assembler : public AssemblerBase {
     cmpxchgl(address, reg);
   }
 
+  // Atomically adds [reg] to the quadword at [address] and leaves the previous
+  // value of the quadword in [reg].
+  void LockXaddq(const Address& address, Register reg) {
+    lock();
+    xaddq(address, reg);
+  }
+
   void PushRegisters(const RegisterSet& registers);
   void PopRegisters(const RegisterSet& registers);
 
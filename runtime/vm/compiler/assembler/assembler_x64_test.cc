@@ -3012,6 +3012,32 @@ ASSEMBLER_TEST_RUN(CompareSwapNEQ32, test) {
       "ret\n");
 }
 
+ASSEMBLER_TEST_GENERATE(FetchAdd, assembler) {
+  __ movq(RAX, Immediate(5));
+  __ pushq(RAX);
+  __ movq(RCX, Immediate(3));
+  // Adds 3 to the stack slot and leaves its previous value in RCX.
+  __ LockXaddq(Address(RSP, 0), RCX);
+  __ popq(RAX);
+  __ shlq(RCX, Immediate(8));
+  __ orq(RAX, RCX);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(FetchAdd, test) {
+  typedef int64_t (*FetchAddCode)();
+  EXPECT_EQ(0x508, reinterpret_cast<FetchAddCode>(test->entry())());
+  EXPECT_DISASSEMBLY(
+      "movl rax,5\n"
+      "push rax\n"
+      "movl rcx,3\n"
+      "lock xaddq rcx,[rsp]\n"
+      "pop rax\n"
+      "shlq rcx,8\n"
+      "orq rax,rcx\n"
+      "ret\n");
+}
+
 ASSEMBLER_TEST_GENERATE(Exchange, assembler) {
   __ movq(RAX, Immediate(kLargeConstant));
   __ movq(RDX, Immediate(kAnotherLargeConstant));
@@ -792,7 +792,7 @@ void ARM64Decoder::DecodeLoadRegLiteral(Instr* instr) {
 
 void ARM64Decoder::DecodeLoadStoreExclusive(Instr* instr) {
   if (instr->Bit(32) != 1 || instr->Bit(21) != 0 ||
-      instr->Bit(23) != instr->Bit(15)) {
+      (instr->Bit(23) == 1 && instr->Bit(15) == 0)) {
     Unknown(instr);
   }
 
@@ -803,6 +803,8 @@ void ARM64Decoder::DecodeLoadStoreExclusive(Instr* instr) {
     const bool is_load_acquire = !is_exclusive && is_ordered;
     if (is_load_acquire) {
       Format(instr, "ldar'sz 'rt, 'rn");
+    } else if (is_ordered) {
+      Format(instr, "ldaxr'sz 'rt, 'rn");
     } else {
       Format(instr, "ldxr'sz 'rt, 'rn");
     }
@@ -810,6 +812,8 @@ void ARM64Decoder::DecodeLoadStoreExclusive(Instr* instr) {
     const bool is_store_release = !is_exclusive && is_ordered;
     if (is_store_release) {
       Format(instr, "stlr'sz 'rt, 'rn");
+    } else if (is_ordered) {
+      Format(instr, "stlxr'sz 'rs, 'rt, 'rn");
     } else {
       Format(instr, "stxr'sz 'rs, 'rt, 'rn");
     }
@@ -1572,8 +1572,9 @@ int DisassemblerX64::TwoByteOpcodeInstruction(uint8_t* data) {
 
   } else if (opcode == 0xBE || opcode == 0xBF || opcode == 0xB6 ||
              opcode == 0xB7 || opcode == 0xAF || opcode == 0xB0 ||
-             opcode == 0xB1 || opcode == 0xBC || opcode == 0xBD) {
-    // Size-extending moves, IMUL, cmpxchg, BSF, BSR.
+             opcode == 0xB1 || opcode == 0xBC || opcode == 0xBD ||
+             opcode == 0xC1) {
+    // Size-extending moves, IMUL, cmpxchg, BSF, BSR, xadd.
     current += PrintOperands(mnemonic, REG_OPER_OP_ORDER, current);
   } else if ((opcode & 0xF0) == 0x90) {
     // SETcc: Set byte on condition. Needs pointer to beginning of instruction.
@@ -1637,6 +1638,8 @@ const char* DisassemblerX64::TwoByteMnemonic(uint8_t opcode) {
       return "cvtsi2s";
     case 0x31:
       return "rdtsc";
+    case 0xC1:
+      return "xadd";
     default:
       return NULL;
   }
@@ -812,6 +812,19 @@ void ConstantPropagator::VisitUtf8Scan(Utf8ScanInstr* instr) {
   SetValue(instr, non_constant_);
 }
 
+void ConstantPropagator::VisitAtomicLoadInt64(AtomicLoadInt64Instr* instr) {
+  SetValue(instr, non_constant_);
+}
+
+void ConstantPropagator::VisitAtomicStoreInt64(AtomicStoreInt64Instr* instr) {
+  // Nothing to do.
+}
+
+void ConstantPropagator::VisitAtomicFetchAddInt64(
+    AtomicFetchAddInt64Instr* instr) {
+  SetValue(instr, non_constant_);
+}
+
 void ConstantPropagator::VisitLoadIndexed(LoadIndexedInstr* instr) {
   const Object& array_obj = instr->array()->definition()->constant_value();
   const Object& index_obj = instr->index()->definition()->constant_value();
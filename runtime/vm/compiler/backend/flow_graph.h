@@ -421,6 +421,12 @@ class FlowGraph : public ZoneAllocated {
   // Mark this flow graph as huge and disable certain optimizations.
   void mark_huge_method() { huge_method_ = true; }
 
+  // Returns true if this flow graph is compiled by the cheaper JIT tier
+  // (see CompilerPass::RunFastTierPipeline). Code produced by that tier counts
+  // invocations and is eventually reoptimized with the full pipeline.
+  bool is_fast_tier() const { return fast_tier_; }
+  void mark_fast_tier() { fast_tier_ = true; }
+
   PrologueInfo prologue_info() const { return prologue_info_; }
 
   // Computes the loop hierarchy of the flow graph on demand.
@@ -656,6 +662,7 @@ class FlowGraph : public ZoneAllocated {
   bool licm_allowed_;
   bool unmatched_representations_allowed_ = true;
   bool huge_method_ = false;
+  bool fast_tier_ = false;
 
   const PrologueInfo prologue_info_;
 
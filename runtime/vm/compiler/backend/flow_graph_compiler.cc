@@ -16,6 +16,7 @@
 #include "vm/compiler/cha.h"
 #include "vm/compiler/intrinsifier.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/jit/jit_warmup_cache.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
 #include "vm/deopt_instructions.h"
@@ -62,6 +63,7 @@ DECLARE_FLAG(charp, deoptimize_filter);
 DECLARE_FLAG(bool, intrinsify);
 DECLARE_FLAG(int, regexp_optimization_counter_threshold);
 DECLARE_FLAG(int, reoptimization_counter_threshold);
+DECLARE_FLAG(int, fast_tier_reoptimization_threshold);
 DECLARE_FLAG(int, stacktrace_every);
 DECLARE_FLAG(charp, stacktrace_filter);
 DECLARE_FLAG(int, gc_every);
@@ -214,6 +216,11 @@ void FlowGraphCompiler::InitCompiler() {
   catch_entry_moves_maps_builder_ = new (zone()) CatchEntryMovesMapBuilder();
 #endif
   block_info_.Clear();
+  // Code produced by the fast tier is always reoptimized once it gets hot.
+  if (is_optimizing() && flow_graph().is_fast_tier() &&
+      !flow_graph().IsCompiledForOsr()) {
+    may_reoptimize_ = true;
+  }
   // Initialize block info and search optimized (non-OSR) code for calls
   // indicating a non-leaf routine and calls without IC data indicating
   // possible reoptimization.
@@ -2143,7 +2150,9 @@ const ICData* FlowGraphCompiler::GetOrAddStaticCallICData(
 
 intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
   intptr_t threshold;
-  if (is_optimizing()) {
+  if (is_optimizing() && flow_graph().is_fast_tier()) {
+    threshold = FLAG_fast_tier_reoptimization_threshold;
+  } else if (is_optimizing()) {
     threshold = FLAG_reoptimization_counter_threshold;
   } else if (parsed_function_.function().IsIrregexpFunction()) {
     threshold = FLAG_regexp_optimization_counter_threshold;
@@ -2158,6 +2167,15 @@ intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
     if (threshold > FLAG_optimization_counter_threshold) {
       threshold = FLAG_optimization_counter_threshold;
     }
+    // Functions which were optimized by previous runs of the program only
+    // need enough invocations to collect type feedback.
+    if (JitWarmupCache::IsEnabled()) {
+      const intptr_t cached_threshold =
+          JitWarmupCache::OptimizationThresholdFor(parsed_function().function());
+      if (cached_threshold >= 0 && cached_threshold < threshold) {
+        threshold = cached_threshold;
+      }
+    }
   }
 
   // Threshold = 0 doesn't make sense because we increment the counter before
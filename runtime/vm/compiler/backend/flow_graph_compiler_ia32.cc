@@ -392,8 +392,10 @@ void FlowGraphCompiler::EmitFrameEntry() {
     __ LoadObject(function_reg, function);
 
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function. Code produced by the
+    // fast tier is the exception: it counts invocations like unoptimized
+    // code so that hot functions get reoptimized by the full pipeline.
+    if (!is_optimizing() || flow_graph().is_fast_tier()) {
       __ incl(compiler::FieldAddress(function_reg,
                                      Function::usage_counter_offset()));
     }
@@ -6539,6 +6539,38 @@ void BitCastInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
 #endif  // !defined(TARGET_ARCH_ARM) && !defined(TARGET_ARCH_ARM64) &&         \
         // !defined(TARGET_ARCH_RISCV32) && !defined(TARGET_ARCH_RISCV64)
 
+#if defined(TARGET_ARCH_IS_32_BIT)
+
+LocationSummary* AtomicLoadInt64Instr::MakeLocationSummary(Zone* zone,
+                                                           bool opt) const {
+  UNREACHABLE();
+}
+
+void AtomicLoadInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  UNREACHABLE();
+}
+
+LocationSummary* AtomicStoreInt64Instr::MakeLocationSummary(Zone* zone,
+                                                            bool opt) const {
+  UNREACHABLE();
+}
+
+void AtomicStoreInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  UNREACHABLE();
+}
+
+LocationSummary* AtomicFetchAddInt64Instr::MakeLocationSummary(
+    Zone* zone,
+    bool opt) const {
+  UNREACHABLE();
+}
+
+void AtomicFetchAddInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  UNREACHABLE();
+}
+
+#endif  // defined(TARGET_ARCH_IS_32_BIT)
+
 Representation FfiCallInstr::RequiredInputRepresentation(intptr_t idx) const {
   if (idx < TargetAddressIndex()) {
     // All input handles are passed as Tagged values on the stack to
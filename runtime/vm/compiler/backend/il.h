@@ -507,6 +507,9 @@ struct InstrAttrs {
   M(StringToCharCode, kNoGC)                                                   \
   M(OneByteStringFromCharCode, kNoGC)                                          \
   M(Utf8Scan, kNoGC)                                                           \
+  M(AtomicLoadInt64, kNoGC)                                                    \
+  M(AtomicStoreInt64, kNoGC)                                                   \
+  M(AtomicFetchAddInt64, kNoGC)                                                \
   M(InvokeMathCFunction, kNoGC)                                                \
   M(TruncDivMod, kNoGC)                                                        \
   /*We could be more precise about when these 2 instructions can trigger GC.*/ \
@@ -6546,6 +6549,130 @@ class Utf8ScanInstr : public TemplateDefinition<5, NoThrow> {
   DISALLOW_COPY_AND_ASSIGN(Utf8ScanInstr);
 };
 
+// Atomic accesses to the 64-bit integer at [base] + [offset], where [base]
+// is the untagged data address of an external typed data (which never moves)
+// and [offset] is an unboxed, already validated, 8-byte aligned offset.
+//
+// Only supported on 64-bit targets.
+class AtomicLoadInt64Instr : public TemplateDefinition<2, NoThrow> {
+ public:
+  // Loads with acquire semantics.
+  AtomicLoadInt64Instr(Value* base, Value* offset) {
+    SetInputAt(kBasePos, base);
+    SetInputAt(kOffsetPos, offset);
+  }
+
+  enum { kBasePos = 0, kOffsetPos = 1 };
+
+  DECLARE_INSTRUCTION(AtomicLoadInt64)
+
+  Value* base() const { return inputs_[kBasePos]; }
+  Value* offset() const { return inputs_[kOffsetPos]; }
+
+  virtual Representation RequiredInputRepresentation(intptr_t idx) const {
+    ASSERT(idx == kBasePos || idx == kOffsetPos);
+    return idx == kBasePos ? kUntagged : kUnboxedIntPtr;
+  }
+
+  virtual Representation representation() const { return kUnboxedInt64; }
+
+  virtual CompileType ComputeType() const { return CompileType::Int(); }
+  // Other isolates may write to the same memory at any time.
+  virtual bool HasUnknownSideEffects() const { return true; }
+  virtual bool ComputeCanDeoptimize() const { return false; }
+
+  virtual SpeculativeMode SpeculativeModeOfInput(intptr_t index) const {
+    return kNotSpeculative;
+  }
+
+  virtual bool AttributesEqual(const Instruction& other) const { return true; }
+
+  DECLARE_EMPTY_SERIALIZATION(AtomicLoadInt64Instr, TemplateDefinition)
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AtomicLoadInt64Instr);
+};
+
+class AtomicStoreInt64Instr : public TemplateInstruction<3, NoThrow> {
+ public:
+  // Stores with release semantics.
+  AtomicStoreInt64Instr(Value* base, Value* offset, Value* value) {
+    SetInputAt(kBasePos, base);
+    SetInputAt(kOffsetPos, offset);
+    SetInputAt(kValuePos, value);
+  }
+
+  enum { kBasePos = 0, kOffsetPos = 1, kValuePos = 2 };
+
+  DECLARE_INSTRUCTION(AtomicStoreInt64)
+
+  Value* base() const { return inputs_[kBasePos]; }
+  Value* offset() const { return inputs_[kOffsetPos]; }
+  Value* value() const { return inputs_[kValuePos]; }
+
+  virtual Representation RequiredInputRepresentation(intptr_t idx) const {
+    ASSERT(idx >= kBasePos && idx <= kValuePos);
+    if (idx == kBasePos) return kUntagged;
+    return idx == kOffsetPos ? kUnboxedIntPtr : kUnboxedInt64;
+  }
+
+  virtual bool HasUnknownSideEffects() const { return true; }
+  virtual bool ComputeCanDeoptimize() const { return false; }
+
+  virtual SpeculativeMode SpeculativeModeOfInput(intptr_t index) const {
+    return kNotSpeculative;
+  }
+
+  virtual bool AttributesEqual(const Instruction& other) const { return true; }
+
+  DECLARE_EMPTY_SERIALIZATION(AtomicStoreInt64Instr, TemplateInstruction)
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AtomicStoreInt64Instr);
+};
+
+class AtomicFetchAddInt64Instr : public TemplateDefinition<3, NoThrow> {
+ public:
+  // Adds [value] with acquire-release semantics, wrapping around on overflow,
+  // and returns the previous value.
+  AtomicFetchAddInt64Instr(Value* base, Value* offset, Value* value) {
+    SetInputAt(kBasePos, base);
+    SetInputAt(kOffsetPos, offset);
+    SetInputAt(kValuePos, value);
+  }
+
+  enum { kBasePos = 0, kOffsetPos = 1, kValuePos = 2 };
+
+  DECLARE_INSTRUCTION(AtomicFetchAddInt64)
+
+  Value* base() const { return inputs_[kBasePos]; }
+  Value* offset() const { return inputs_[kOffsetPos]; }
+  Value* value() const { return inputs_[kValuePos]; }
+
+  virtual Representation RequiredInputRepresentation(intptr_t idx) const {
+    ASSERT(idx >= kBasePos && idx <= kValuePos);
+    if (idx == kBasePos) return kUntagged;
+    return idx == kOffsetPos ? kUnboxedIntPtr : kUnboxedInt64;
+  }
+
+  virtual Representation representation() const { return kUnboxedInt64; }
+
+  virtual CompileType ComputeType() const { return CompileType::Int(); }
+  virtual bool HasUnknownSideEffects() const { return true; }
+  virtual bool ComputeCanDeoptimize() const { return false; }
+
+  virtual SpeculativeMode SpeculativeModeOfInput(intptr_t index) const {
+    return kNotSpeculative;
+  }
+
+  virtual bool AttributesEqual(const Instruction& other) const { return true; }
+
+  DECLARE_EMPTY_SERIALIZATION(AtomicFetchAddInt64Instr, TemplateDefinition)
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AtomicFetchAddInt64Instr);
+};
+
 class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
  public:
   StoreIndexedInstr(Value* array,
@@ -1968,6 +1968,78 @@ void Utf8ScanInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   }
 }
 
+#if XLEN == 64
+LocationSummary* AtomicLoadInt64Instr::MakeLocationSummary(Zone* zone,
+                                                           bool opt) const {
+  const intptr_t kNumInputs = 2;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  summary->set_out(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicLoadInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register address = locs()->temp(0).reg();
+  const Register result = locs()->out(0).reg();
+  __ add(address, base, offset);
+  __ LoadAcquire(result, address);
+}
+
+LocationSummary* AtomicStoreInt64Instr::MakeLocationSummary(Zone* zone,
+                                                            bool opt) const {
+  const intptr_t kNumInputs = 3;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_in(kValuePos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicStoreInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register value = locs()->in(kValuePos).reg();
+  const Register address = locs()->temp(0).reg();
+  __ add(address, base, offset);
+  __ StoreRelease(value, address);
+}
+
+LocationSummary* AtomicFetchAddInt64Instr::MakeLocationSummary(
+    Zone* zone,
+    bool opt) const {
+  const intptr_t kNumInputs = 3;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_in(kValuePos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  summary->set_out(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicFetchAddInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register value = locs()->in(kValuePos).reg();
+  const Register address = locs()->temp(0).reg();
+  const Register result = locs()->out(0).reg();
+  __ add(address, base, offset);
+  __ amoaddd(result, value, compiler::Address(address),
+             std::memory_order_acq_rel);
+}
+#endif  // XLEN == 64
+
 LocationSummary* LoadUntaggedInstr::MakeLocationSummary(Zone* zone,
                                                         bool opt) const {
   const intptr_t kNumInputs = 1;
@@ -1699,6 +1699,76 @@ void Utf8ScanInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   }
 }
 
+LocationSummary* AtomicLoadInt64Instr::MakeLocationSummary(Zone* zone,
+                                                           bool opt) const {
+  const intptr_t kNumInputs = 2;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  summary->set_out(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicLoadInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register address = locs()->temp(0).reg();
+  const Register result = locs()->out(0).reg();
+  __ leaq(address, compiler::Address(base, offset, TIMES_1, 0));
+  __ LoadAcquire(result, address);
+}
+
+LocationSummary* AtomicStoreInt64Instr::MakeLocationSummary(Zone* zone,
+                                                            bool opt) const {
+  const intptr_t kNumInputs = 3;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_in(kValuePos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicStoreInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register value = locs()->in(kValuePos).reg();
+  const Register address = locs()->temp(0).reg();
+  __ leaq(address, compiler::Address(base, offset, TIMES_1, 0));
+  __ StoreRelease(value, address);
+}
+
+LocationSummary* AtomicFetchAddInt64Instr::MakeLocationSummary(
+    Zone* zone,
+    bool opt) const {
+  const intptr_t kNumInputs = 3;
+  const intptr_t kNumTemps = 1;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  summary->set_in(kBasePos, Location::RequiresRegister());
+  summary->set_in(kOffsetPos, Location::RequiresRegister());
+  summary->set_in(kValuePos, Location::RequiresRegister());
+  summary->set_temp(0, Location::RequiresRegister());
+  summary->set_out(0, Location::RequiresRegister());
+  return summary;
+}
+
+void AtomicFetchAddInt64Instr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  const Register base = locs()->in(kBasePos).reg();
+  const Register offset = locs()->in(kOffsetPos).reg();
+  const Register value = locs()->in(kValuePos).reg();
+  const Register address = locs()->temp(0).reg();
+  const Register result = locs()->out(0).reg();
+  __ leaq(address, compiler::Address(base, offset, TIMES_1, 0));
+  __ movq(result, value);
+  __ LockXaddq(compiler::Address(address, 0), result);
+}
+
 LocationSummary* LoadUntaggedInstr::MakeLocationSummary(Zone* zone,
                                                         bool opt) const {
   const intptr_t kNumInputs = 1;
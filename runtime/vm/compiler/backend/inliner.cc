@@ -18,6 +18,7 @@
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/compiler/jit/jit_function_stats.h"
 #include "vm/flags.h"
 #include "vm/kernel.h"
 #include "vm/longjump.h"
@@ -1025,6 +1026,10 @@ class CallSiteInliner : public ValueObject {
       thread()->compiler_timings()->RecordInliningStatsByOutcome(success,
                                                                  timer);
     }
+    if (auto* const stats = thread()->compiler_state().jit_stats()) {
+      stats->inlining_attempts++;
+      if (success) stats->inlined_calls++;
+    }
     return success;
   }
 
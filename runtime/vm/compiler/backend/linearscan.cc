@@ -106,7 +106,8 @@ FlowGraphAllocator::FlowGraphAllocator(const FlowGraph& flow_graph,
       quad_spill_slots_(),
       untagged_spill_slots_(),
       cpu_spill_slot_count_(0),
-      intrinsic_mode_(intrinsic_mode) {
+      intrinsic_mode_(intrinsic_mode),
+      fast_mode_(flow_graph.is_fast_tier()) {
   for (intptr_t i = 0; i < vreg_count_; i++) {
     live_ranges_.Add(NULL);
   }
@@ -612,12 +613,16 @@ void FlowGraphAllocator::BuildLiveRanges() {
     if (block->IsLoopHeader()) {
       ASSERT(loop_info != nullptr);
       current_interference_set = nullptr;
-      for (BitVector::Iterator it(liveness_.GetLiveInSetAt(i)); !it.Done();
-           it.Advance()) {
-        LiveRange* range = GetLiveRange(it.Current());
-        intptr_t loop_end = extra_loop_info_[loop_info->id()]->end;
-        if (HasOnlyUnconstrainedUsesInLoop(range, loop_end)) {
-          range->MarkHasOnlyUnconstrainedUsesInLoop(loop_info->id());
+      // Only used to find cheap eviction candidates for loop phis, which the
+      // fast tier does not look for.
+      if (!fast_mode_) {
+        for (BitVector::Iterator it(liveness_.GetLiveInSetAt(i)); !it.Done();
+             it.Advance()) {
+          LiveRange* range = GetLiveRange(it.Current());
+          intptr_t loop_end = extra_loop_info_[loop_info->id()]->end;
+          if (HasOnlyUnconstrainedUsesInLoop(range, loop_end)) {
+            range->MarkHasOnlyUnconstrainedUsesInLoop(loop_info->id());
+          }
         }
       }
     }
@@ -1894,7 +1899,11 @@ LiveRange* FlowGraphAllocator::SplitBetween(LiveRange* range,
   BlockEntryInstr* split_block_entry = BlockEntryAt(to);
   ASSERT(split_block_entry == InstructionAt(to)->GetBlock());
 
-  if (from < GetLifetimePosition(split_block_entry)) {
+  if (fast_mode_ && (from < GetLifetimePosition(split_block_entry))) {
+    // Interval [from, to) spans multiple blocks: split at the start of the
+    // last one without looking for an enclosing loop header.
+    split_pos = GetLifetimePosition(split_block_entry);
+  } else if (from < GetLifetimePosition(split_block_entry)) {
     // Interval [from, to) spans multiple blocks.
 
     // If the last block is inside a loop, prefer splitting at the outermost
@@ -2292,7 +2301,7 @@ bool FlowGraphAllocator::AllocateFreeRegister(LiveRange* unallocated) {
   // searching for a candidate that does not interfere with phis on the back
   // edge.
   LoopInfo* loop_info = BlockEntryAt(unallocated->Start())->loop_info();
-  if ((unallocated->vreg() >= 0) && (loop_info != nullptr) &&
+  if (!fast_mode_ && (unallocated->vreg() >= 0) && (loop_info != nullptr) &&
       (free_until >= extra_loop_info_[loop_info->id()]->end) &&
       extra_loop_info_[loop_info->id()]->backedge_interference->Contains(
           unallocated->vreg())) {
@@ -2439,7 +2448,8 @@ void FlowGraphAllocator::AllocateAnyRegister(LiveRange* unallocated) {
   UsePosition* register_use =
       unallocated->finger()->FirstRegisterUse(unallocated->Start());
   if ((register_use == NULL) &&
-      !(unallocated->is_loop_phi() && HasCheapEvictionCandidate(unallocated))) {
+      (fast_mode_ || !unallocated->is_loop_phi() ||
+       !HasCheapEvictionCandidate(unallocated))) {
     Spill(unallocated);
     return;
   }
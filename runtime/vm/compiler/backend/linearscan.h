@@ -369,6 +369,11 @@ class FlowGraphAllocator : public ValueObject {
 
   const bool intrinsic_mode_;
 
+  // Allocating for the fast tier (see FlowGraph::is_fast_tier): the loop
+  // heuristics which reduce moves on back edges and at loop headers are
+  // skipped in favour of allocation speed.
+  const bool fast_mode_;
+
   DISALLOW_COPY_AND_ASSIGN(FlowGraphAllocator);
 };
 
@@ -1636,7 +1636,14 @@ void LICM::Optimize() {
 void DelayAllocations::Optimize(FlowGraph* graph) {
   // Go through all Allocation instructions and move them down to their
   // dominant use when doing so is sound.
+  //
+  // Stores which initialize the allocated object right after the allocation
+  // are moved together with it. This sinks allocations which only escape on
+  // some paths (e.g. into an error or a logging call) into the escaping
+  // branch: load forwarding has already replaced loads from such objects
+  // with the stored values, so the remaining paths only use those values.
   DirectChainedHashMap<IdentitySetKeyValueTrait<Instruction*>> moved;
+  GrowableArray<Instruction*> initializing_stores;
   for (BlockIterator block_it = graph->reverse_postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
     BlockEntryInstr* block = block_it.Current();
@@ -1646,10 +1653,17 @@ void DelayAllocations::Optimize(FlowGraph* graph) {
       Definition* def = instr_it.Current()->AsDefinition();
       if (def != nullptr && def->IsAllocation() && def->env() == nullptr &&
           !moved.HasKey(def)) {
-        Instruction* use = DominantUse(def);
+        CollectInitializingStores(def, &initializing_stores);
+        Instruction* use = DominantUse(def, initializing_stores);
         if (use != nullptr && !use->IsPhi() && IsOneTimeUse(use, def)) {
           instr_it.RemoveCurrentFromGraph();
           def->InsertBefore(use);
+          Instruction* last = def;
+          for (auto* const store : initializing_stores) {
+            store->RemoveFromGraph();
+            store->InsertAfter(last);
+            last = store;
+          }
           moved.Insert(def);
         }
       }
@@ -1657,14 +1671,53 @@ void DelayAllocations::Optimize(FlowGraph* graph) {
   }
 }
 
-Instruction* DelayAllocations::DominantUse(Definition* def) {
+void DelayAllocations::CollectInitializingStores(
+    Definition* def,
+    GrowableArray<Instruction*>* stores) {
+  stores->Clear();
+
+  // Only the stores into [def] which precede any other use of [def] in its
+  // block are considered initializing: nothing can observe the object before
+  // its first other use, so these stores can move together with it.
+  for (Instruction* instr = def->next(); instr != nullptr;
+       instr = instr->next()) {
+    if (instr->env() != nullptr) {
+      for (Environment::DeepIterator it(instr->env()); !it.Done();
+           it.Advance()) {
+        if (it.CurrentValue()->definition() == def) return;
+      }
+    }
+    bool is_initializing_store = false;
+    if (auto* const store = instr->AsStoreField()) {
+      is_initializing_store = (store->instance()->definition() == def) &&
+                              (store->value()->definition() != def);
+    } else if (auto* const store = instr->AsStoreIndexed()) {
+      is_initializing_store = (store->array()->definition() == def) &&
+                              (store->index()->definition() != def) &&
+                              (store->value()->definition() != def);
+    }
+    if (is_initializing_store && instr->env() == nullptr) {
+      stores->Add(instr);
+      continue;
+    }
+    for (intptr_t i = 0; i < instr->InputCount(); i++) {
+      if (instr->InputAt(i)->definition() == def) return;
+    }
+  }
+}
+
+Instruction* DelayAllocations::DominantUse(
+    Definition* def,
+    const GrowableArray<Instruction*>& ignored_uses) {
   // Find the use that dominates all other uses.
 
   // Collect all uses.
   DirectChainedHashMap<IdentitySetKeyValueTrait<Instruction*>> uses;
   for (Value::Iterator it(def->input_use_list()); !it.Done(); it.Advance()) {
     Instruction* use = it.Current()->instruction();
-    uses.Insert(use);
+    if (!ignored_uses.Contains(use)) {
+      uses.Insert(use);
+    }
   }
   for (Value::Iterator it(def->env_use_list()); !it.Done(); it.Advance()) {
     Instruction* use = it.Current()->instruction();
@@ -144,13 +144,19 @@ class LICM : public ValueObject {
   FlowGraph* const flow_graph_;
 };
 
-// Move allocations down to their first use. Improves write barrier elimination.
+// Move allocations (together with the stores initializing them) down to their
+// first use. Improves write barrier elimination and avoids allocating objects
+// which only escape on rarely taken paths.
 class DelayAllocations : public AllStatic {
  public:
   static void Optimize(FlowGraph* graph);
 
  private:
-  static Instruction* DominantUse(Definition* def);
+  static void CollectInitializingStores(Definition* def,
+                                        GrowableArray<Instruction*>* stores);
+  static Instruction* DominantUse(
+      Definition* def,
+      const GrowableArray<Instruction*>& ignored_uses);
   static bool IsOneTimeUse(Instruction* use, Definition* def);
 };
 
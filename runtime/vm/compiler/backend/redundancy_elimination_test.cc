@@ -1423,6 +1423,61 @@ ISOLATE_UNIT_TEST_CASE(DelayAllocations_DontDelayIntoLoop) {
   EXPECT(call->Receiver()->definition() == allocate);
 }
 
+ISOLATE_UNIT_TEST_CASE(DelayAllocations_SinkIntoEscapingBranch) {
+  const char* kScript = R"(
+    class Point {
+      final int x, y;
+      Point(this.x, this.y);
+    }
+
+    @pragma('vm:never-inline')
+    void report(Object o) {
+      print(o);
+    }
+
+    int test(int a, int b) {
+      final p = Point(a, b);
+      if (a > b) {
+        report(p);
+        return 0;
+      }
+      return p.x + p.y;
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "test"));
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  auto entry = flow_graph->graph_entry()->normal_entry();
+
+  // The allocation and its initializing stores are only executed on the
+  // path where the object escapes into report().
+  AllocateObjectInstr* allocate;
+  StoreFieldInstr* store1;
+  StoreFieldInstr* store2;
+  StaticCallInstr* call;
+
+  ILMatcher cursor(flow_graph, entry, true, ParallelMovesHandling::kSkip);
+  RELEASE_ASSERT(cursor.TryMatch({
+      kMoveGlob,
+      kMatchAndMoveBranchTrue,
+      kMoveGlob,
+      {kMatchAndMoveAllocateObject, &allocate},
+      {kMatchAndMoveStoreField, &store1},
+      {kMatchAndMoveStoreField, &store2},
+      {kMatchAndMoveStaticCall, &call},
+  }));
+
+  EXPECT(store1->instance()->definition() == allocate);
+  EXPECT(!store1->ShouldEmitStoreBarrier());
+  EXPECT(store2->instance()->definition() == allocate);
+  EXPECT(!store2->ShouldEmitStoreBarrier());
+  EXPECT(strcmp(call->function().UserVisibleNameCString(), "report") == 0);
+  EXPECT(call->ArgumentAt(0) == allocate);
+}
+
 ISOLATE_UNIT_TEST_CASE(CheckStackOverflowElimination_NoInterruptsPragma) {
   const char* kScript = R"(
     @pragma('vm:unsafe:no-interrupts')
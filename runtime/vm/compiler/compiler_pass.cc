@@ -17,6 +17,7 @@
 #include "vm/compiler/backend/type_propagator.h"
 #include "vm/compiler/call_specializer.h"
 #include "vm/compiler/compiler_timings.h"
+#include "vm/compiler/jit/jit_function_stats.h"
 #include "vm/compiler/write_barrier_elimination.h"
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
@@ -226,6 +227,8 @@ void CompilerPass::Run(CompilerPassState* state) const {
       TIMELINE_DURATION(thread, CompilerVerbose, name());
       {
         COMPILER_TIMINGS_PASS_TIMER_SCOPE(thread, id());
+        JitCompilationStats::PassScope stats_scope(
+            CompilerState::Current().jit_stats(), state, id());
         repeat = DoBody(state);
       }
       thread->CheckForSafepoint();
@@ -397,6 +400,43 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   return pass_state->flow_graph();
 }
 
+FlowGraph* CompilerPass::RunFastTierPipeline(PipelineMode mode,
+                                             CompilerPassState* pass_state) {
+  ASSERT(mode == kJIT);
+  INVOKE_PASS(ComputeSSA);
+  INVOKE_PASS(ApplyICData);
+  INVOKE_PASS(TryOptimizePatterns);
+  INVOKE_PASS(SetOuterInliningId);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(ApplyClassIds);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(BranchSimplify);
+  INVOKE_PASS(IfConvert);
+  INVOKE_PASS(ConstantPropagation);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(SelectRepresentations);
+  INVOKE_PASS(CSE);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(TryCatchOptimization);
+  INVOKE_PASS(EliminateEnvironments);
+  INVOKE_PASS(EliminateDeadPhis);
+  // Currently DCE assumes that EliminateEnvironments has already been run,
+  // so it should not be lifted earlier than that pass.
+  INVOKE_PASS(DCE);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(SelectRepresentations_Final);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(EliminateStackOverflowChecks);
+  INVOKE_PASS(EliminateWriteBarriers);
+  INVOKE_PASS(FinalizeGraph);
+  INVOKE_PASS(Canonicalize);
+  INVOKE_PASS(AllocateRegisters);
+  INVOKE_PASS(ReorderBlocks);
+  return pass_state->flow_graph();
+}
+
 FlowGraph* CompilerPass::RunPipelineWithPasses(
     CompilerPassState* state,
     std::initializer_list<CompilerPass::Id> passes) {
@@ -176,6 +176,17 @@ class CompilerPass {
       CompilerPassState* state,
       std::initializer_list<CompilerPass::Id> passes);
 
+  // Cheaper JIT pipeline used for huge functions (see
+  // --fast_tier_min_code_size).
+  //
+  // Skips inlining and the loop and range based optimizations, which dominate
+  // compilation time for large graphs, and allocates registers without the
+  // loop heuristics of the linear scan allocator. Code produced by this
+  // pipeline is reoptimized with [RunPipeline] once it becomes hot.
+  DART_WARN_UNUSED_RESULT
+  static FlowGraph* RunFastTierPipeline(PipelineMode mode,
+                                        CompilerPassState* state);
+
   // Pipeline which is used for "force-optimized" functions.
   //
   // Must not include speculative or inter-procedural optimizations.
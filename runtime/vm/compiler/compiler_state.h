@@ -20,6 +20,7 @@ namespace dart {
 class CompilerPass;
 struct CompilerPassState;
 class Function;
+struct JitCompilationStats;
 class LocalScope;
 class LocalVariable;
 class SlotCache;
@@ -119,6 +120,11 @@ class CompilerState : public ThreadStackResource {
   const CompilerPass* pass() const { return pass_; }
   const CompilerPassState* pass_state() const { return pass_state_; }
 
+  // Statistics of the current JIT compilation for --jit_function_stats, or
+  // null.
+  JitCompilationStats* jit_stats() const { return jit_stats_; }
+  void set_jit_stats(JitCompilationStats* stats) { jit_stats_ = stats; }
+
   void ReportCrash();
 
  private:
@@ -146,6 +152,7 @@ class CompilerState : public ThreadStackResource {
   const Function* function_ = nullptr;
   const CompilerPass* pass_ = nullptr;
   const CompilerPassState* pass_state_ = nullptr;
+  JitCompilationStats* jit_stats_ = nullptr;
 
   CompilerState* previous_;
 };
@@ -46,12 +46,18 @@
   V(BuildDecisionGraph)                                                        \
   V(PrepareGraphs)
 
+#define JIT_TIMERS_LIST(V)                                                     \
+  V(CompileUnoptimized)                                                        \
+  V(CompileOptimizedFastTier)                                                  \
+  V(CompileOptimizedFullTier)
+
 // Note: COMPILER_PASS_LIST must be the first element of the list below because
 // we expect that pass ids are the same as ids of corresponding timers.
 #define COMPILER_TIMERS_LIST(V)                                                \
   COMPILER_PASS_LIST(V)                                                        \
   PRECOMPILER_TIMERS_LIST(V)                                                   \
   INLINING_TIMERS_LIST(V)                                                      \
+  JIT_TIMERS_LIST(V)                                                           \
   V(BuildGraph)                                                                \
   V(EmitCode)                                                                  \
   V(FinalizeCode)
@@ -125,7 +131,9 @@ class CompilerTimings : public MallocAllocated {
     }
   }
 
-  void Print();
+  // Prints all non-empty timers as "<title> took: <total>" followed by the
+  // breakdown.
+  void Print(const char* title = "Precompilation");
 
  private:
   void PrintTimers(Zone* zone,
@@ -615,6 +615,30 @@ Fragment BaseFlowGraphBuilder::Utf8Scan() {
   return Fragment(scan);
 }
 
+Fragment BaseFlowGraphBuilder::AtomicLoadInt64() {
+  Value* offset = Pop();
+  Value* base = Pop();
+  auto load = new (Z) AtomicLoadInt64Instr(base, offset);
+  Push(load);
+  return Fragment(load);
+}
+
+Fragment BaseFlowGraphBuilder::AtomicStoreInt64() {
+  Value* value = Pop();
+  Value* offset = Pop();
+  Value* base = Pop();
+  return Fragment(new (Z) AtomicStoreInt64Instr(base, offset, value));
+}
+
+Fragment BaseFlowGraphBuilder::AtomicFetchAddInt64() {
+  Value* value = Pop();
+  Value* offset = Pop();
+  Value* base = Pop();
+  auto fetch_add = new (Z) AtomicFetchAddInt64Instr(base, offset, value);
+  Push(fetch_add);
+  return Fragment(fetch_add);
+}
+
 Fragment BaseFlowGraphBuilder::StoreStaticField(TokenPosition position,
                                                 const Field& field) {
   return Fragment(new (Z) StoreStaticFieldInstr(MayCloneField(Z, field), Pop(),
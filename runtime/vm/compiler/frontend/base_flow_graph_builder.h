@@ -312,6 +312,9 @@ class BaseFlowGraphBuilder {
   Fragment MemoryCopy(classid_t src_cid, classid_t dest_cid);
   Fragment TailCall(const Code& code);
   Fragment Utf8Scan();
+  Fragment AtomicLoadInt64();
+  Fragment AtomicStoreInt64();
+  Fragment AtomicFetchAddInt64();
 
   intptr_t GetNextDeoptId() {
     intptr_t deopt_id = thread_->compiler_state().GetNextDeoptId();
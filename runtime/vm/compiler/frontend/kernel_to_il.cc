@@ -1047,6 +1047,15 @@ bool FlowGraphBuilder::IsRecognizedMethodForFlowGraph(
       return true;
 #else
       return false;
+#endif
+    case MethodRecognizer::kSharedTypedDataAtomicLoad:
+    case MethodRecognizer::kSharedTypedDataAtomicStore:
+    case MethodRecognizer::kSharedTypedDataAtomicFetchAdd:
+      // 32-bit targets use the natives instead.
+#if defined(TARGET_ARCH_IS_64_BIT)
+      return true;
+#else
+      return false;
 #endif
     default:
       return false;
@@ -1258,6 +1267,51 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfRecognizedMethod(
       body += Utf8Scan();
       body += Box(kUnboxedIntPtr);
       break;
+    case MethodRecognizer::kSharedTypedDataAtomicLoad:
+    case MethodRecognizer::kSharedTypedDataAtomicStore:
+    case MethodRecognizer::kSharedTypedDataAtomicFetchAdd: {
+      // The SharedTypedData methods calling these have already checked that
+      // the offset is in range and 8-byte aligned, and the data is an
+      // external Uint8List whose backing store never moves.
+      const bool has_value =
+          kind != MethodRecognizer::kSharedTypedDataAtomicLoad;
+      ASSERT_EQUAL(function.NumParameters(), has_value ? 3 : 2);
+      LocalVariable* arg_data = parsed_function_->RawParameterVariable(0);
+      LocalVariable* arg_offset = parsed_function_->RawParameterVariable(1);
+
+      body += LoadLocal(arg_offset);
+      body += CheckNullOptimized(String::ZoneHandle(Z, function.name()));
+      LocalVariable* arg_offset_not_null = MakeTemporary();
+      LocalVariable* arg_value_not_null = nullptr;
+      if (has_value) {
+        body += LoadLocal(parsed_function_->RawParameterVariable(2));
+        body += CheckNullOptimized(String::ZoneHandle(Z, function.name()));
+        arg_value_not_null = MakeTemporary();
+      }
+
+      body += LoadLocal(arg_data);
+      body += CheckNullOptimized(String::ZoneHandle(Z, function.name()));
+      // No GC from here til the atomic access.
+      body += LoadUntagged(compiler::target::PointerBase::data_offset());
+      body += LoadLocal(arg_offset_not_null);
+      body += UnboxTruncate(kUnboxedIntPtr);
+      if (has_value) {
+        body += LoadLocal(arg_value_not_null);
+        body += UnboxTruncate(kUnboxedInt64);
+      }
+      if (kind == MethodRecognizer::kSharedTypedDataAtomicLoad) {
+        body += AtomicLoadInt64();
+        body += Box(kUnboxedInt64);
+      } else if (kind == MethodRecognizer::kSharedTypedDataAtomicStore) {
+        body += AtomicStoreInt64();
+        body += NullConstant();
+      } else {
+        body += AtomicFetchAddInt64();
+        body += Box(kUnboxedInt64);
+      }
+      // Drop [arg_offset] and [arg_value].
+      body += DropTempsPreserveTop(has_value ? 2 : 1);
+    } break;
     case MethodRecognizer::kFfiAbi:
       ASSERT_EQUAL(function.NumParameters(), 0);
       body += IntConstant(static_cast<int64_t>(compiler::ffi::TargetAbi()));
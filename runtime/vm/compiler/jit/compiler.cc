@@ -22,9 +22,12 @@
 #include "vm/compiler/cha.h"
 #include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/compiler_state.h"
+#include "vm/compiler/compiler_timings.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/compiler/jit/jit_function_stats.h"
+#include "vm/compiler/jit/jit_warmup_cache.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
 #include "vm/deopt_instructions.h"
@@ -82,6 +85,27 @@ DEFINE_FLAG(bool,
             false,
             "Trace only optimizing compiler operations.");
 DEFINE_FLAG(bool, trace_bailout, false, "Print bailout from ssa compiler.");
+DEFINE_FLAG(int,
+            fast_tier_min_code_size,
+            20000,
+            "Optimize functions whose unoptimized code is at least this many "
+            "bytes with the cheaper fast tier pipeline first (0 to disable).");
+DEFINE_FLAG(int,
+            fast_tier_reoptimization_threshold,
+            4000,
+            "Invocation count after which code produced by the fast tier is "
+            "reoptimized with the full pipeline.");
+DEFINE_FLAG(int,
+            fast_tier_max_call_count,
+            100000,
+            "Optimize functions with the full pipeline right away once a call "
+            "site of their unoptimized code was executed this many times (0 "
+            "for no limit).");
+DEFINE_FLAG(bool,
+            print_jit_compiler_timings,
+            false,
+            "Print per-tier and per-pass timings of background compilation "
+            "on isolate group shutdown.");
 
 DECLARE_FLAG(bool, trace_failed_optimization_attempts);
 
@@ -468,6 +492,41 @@ CodePtr CompileParsedFunctionHelper::FinalizeCompilation(
   return code.ptr();
 }
 
+// Returns true if a call site of the unoptimized code of [function] was
+// executed at least [limit] times.
+static bool HasHotCallSite(const Function& function, intptr_t limit) {
+  const Array& ic_data_array = Array::Handle(function.ic_data_array());
+  if (ic_data_array.IsNull()) return false;
+  ICData& ic_data = ICData::Handle();
+  for (intptr_t i = Function::ICDataArrayIndices::kFirstICData;
+       i < ic_data_array.Length(); i++) {
+    ic_data ^= ic_data_array.At(i);
+    if (ic_data.AggregateCount() >= limit) return true;
+  }
+  return false;
+}
+
+// Huge functions spend most of their optimization time in inlining and the
+// loop based passes. The first optimized version of such a function is
+// produced by the fast tier, which is reoptimized with the full pipeline only
+// if the function stays hot (see FLAG_fast_tier_reoptimization_threshold).
+// Functions whose call sites are already very hot (typically loops) would be
+// reoptimized right away, so they skip the fast tier.
+static bool ShouldUseFastTier(const Function& function, intptr_t osr_id) {
+  if (FLAG_fast_tier_min_code_size <= 0) return false;
+  if (osr_id != Compiler::kNoOSRDeoptId) return false;
+  if (function.ForceOptimize() || function.IsIrregexpFunction()) return false;
+  if (function.HasOptimizedCode()) return false;
+  if (!function.HasCode()) return false;
+  const Code& unoptimized_code = Code::Handle(function.unoptimized_code());
+  if (unoptimized_code.IsNull() ||
+      unoptimized_code.Size() < FLAG_fast_tier_min_code_size) {
+    return false;
+  }
+  return FLAG_fast_tier_max_call_count <= 0 ||
+         !HasHotCallSite(function, FLAG_fast_tier_max_call_count);
+}
+
 // Return null if bailed out.
 CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
   ASSERT(!FLAG_precompiled_mode);
@@ -492,6 +551,22 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
   // suppression, since we don't restart optimization.
   SpeculativeInliningPolicy speculative_policy(/*enable_suppression=*/false);
 
+  const bool fast_tier = optimized() && ShouldUseFastTier(function, osr_id());
+  if (optimized() && FLAG_trace_compiler) {
+    THR_Print("--> '%s' compiled with the %s tier\n",
+              function.ToFullyQualifiedCString(), fast_tier ? "fast" : "full");
+  }
+  CompilerTimings::Scope tier_timer(
+      thread(), !optimized() ? CompilerTimings::kCompileUnoptimized
+                : fast_tier  ? CompilerTimings::kCompileOptimizedFastTier
+                             : CompilerTimings::kCompileOptimizedFullTier);
+
+  // Accumulated across the attempts of this compilation.
+  JitCompilationStats stats;
+  const bool record_stats = JitFunctionStats::IsEnabled();
+  const int64_t start_micros =
+      record_stats ? OS::GetCurrentMonotonicMicros() : 0;
+
   Code* volatile result = &Code::ZoneHandle(zone);
   while (!done) {
     *result = Code::null();
@@ -503,6 +578,9 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       CompilerState compiler_state(thread(), /*is_aot=*/false, optimized(),
                                    CompilerState::ShouldTrace(function));
       compiler_state.set_function(function);
+      if (record_stats) {
+        compiler_state.set_jit_stats(&stats);
+      }
 
       {
         // Extract type feedback before the graph is built, as the graph
@@ -529,8 +607,18 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         }
 
         TIMELINE_DURATION(thread(), CompilerVerbose, "BuildFlowGraph");
+        COMPILER_TIMINGS_TIMER_SCOPE(thread(), BuildGraph);
+        const int64_t build_start_micros =
+            record_stats ? OS::GetCurrentMonotonicMicros() : 0;
         flow_graph = pipeline->BuildFlowGraph(
             zone, parsed_function(), ic_data_array, osr_id(), optimized());
+        if (record_stats) {
+          stats.build_graph_micros +=
+              OS::GetCurrentMonotonicMicros() - build_start_micros;
+        }
+      }
+      if (fast_tier) {
+        flow_graph->mark_fast_tier();
       }
 
       const bool print_flow_graph =
@@ -552,6 +640,7 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       CompilerPassState pass_state(thread(), flow_graph, &speculative_policy);
       pass_state.reorder_blocks = reorder_blocks;
+      stats.pass_state = &pass_state;
 
       if (function.ForceOptimize()) {
         ASSERT(optimized());
@@ -564,7 +653,13 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         JitCallSpecializer call_specializer(flow_graph, &speculative_policy);
         pass_state.call_specializer = &call_specializer;
 
-        flow_graph = CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+        if (fast_tier) {
+          flow_graph = CompilerPass::RunFastTierPipeline(CompilerPass::kJIT,
+                                                         &pass_state);
+        } else {
+          flow_graph =
+              CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+        }
       }
 
       ASSERT(pass_state.inline_id_to_function.length() ==
@@ -628,6 +723,11 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         // Must be called outside of safepoint.
         Code::NotifyCodeObservers(function, *result, optimized());
 
+        if (JitWarmupCache::IsEnabled() && optimized() &&
+            osr_id() == Compiler::kNoOSRDeoptId) {
+          JitWarmupCache::RecordOptimizedCode(function);
+        }
+
         if (FLAG_disassemble && FlowGraphPrinter::ShouldPrint(function)) {
           Disassembler::DisassembleCode(function, *result, optimized());
         } else if (FLAG_disassemble_optimized && optimized() &&
@@ -669,6 +769,18 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       }
     }
   }
+  if (record_stats) {
+    JitFunctionStats::Tier tier = JitFunctionStats::kUnoptimized;
+    if (osr_id() != Compiler::kNoOSRDeoptId) {
+      tier = JitFunctionStats::kOptimizedOSR;
+    } else if (optimized()) {
+      tier = fast_tier ? JitFunctionStats::kOptimizedFastTier
+                       : JitFunctionStats::kOptimizedFullTier;
+    }
+    JitFunctionStats::RecordCompilation(
+        function, tier, OS::GetCurrentMonotonicMicros() - start_micros, stats,
+        *result);
+  }
   return result->ptr();
 }
 
@@ -1104,11 +1216,14 @@ BackgroundCompiler::BackgroundCompiler(IsolateGroup* isolate_group)
       function_queue_(new BackgroundCompilationQueue()),
       running_(false),
       done_(true),
-      disabled_depth_(0) {}
+      disabled_depth_(0),
+      timings_(FLAG_print_jit_compiler_timings ? new CompilerTimings()
+                                               : nullptr) {}
 
 // Fields all deleted in ::Stop; here clear them.
 BackgroundCompiler::~BackgroundCompiler() {
   delete function_queue_;
+  delete timings_;
 }
 
 void BackgroundCompiler::Run() {
@@ -1131,8 +1246,10 @@ void BackgroundCompiler::Run() {
     }
     if (element != nullptr) {
       delete element;
+      thread->set_compiler_timings(timings_);
       Compiler::CompileOptimizedFunction(thread, function,
                                          Compiler::kNoOSRDeoptId);
+      thread->set_compiler_timings(nullptr);
 
       // If an optimizable method is not optimized, put it back on
       // the background queue (unless it was passed to foreground).
@@ -1207,6 +1324,13 @@ void BackgroundCompiler::Stop() {
 
   SafepointMonitorLocker ml(&monitor_);
   StopLocked(thread, &ml);
+
+  if (timings_ != nullptr) {
+    StackZone stack_zone(thread);
+    timings_->Print("Background compilation");
+    delete timings_;
+    timings_ = nullptr;
+  }
 }
 
 void BackgroundCompiler::StopLocked(Thread* thread,
@@ -18,6 +18,7 @@ class BackgroundCompilationQueue;
 class Class;
 class Code;
 class CompilationWorkQueue;
+class CompilerTimings;
 class FlowGraph;
 class Function;
 class IndirectGotoInstr;
@@ -163,6 +164,8 @@ class BackgroundCompiler {
   bool running_;            // While true, will try to read queue and compile.
   bool done_;               // True if the thread is done.
   int16_t disabled_depth_;
+  // Accumulated across all compilations when --print_jit_compiler_timings.
+  CompilerTimings* timings_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(BackgroundCompiler);
 };
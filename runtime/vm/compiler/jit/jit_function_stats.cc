@@ -0,0 +1,254 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/jit/jit_function_stats.h"
+
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/json_stream.h"
+#include "vm/object.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            jit_function_stats,
+            false,
+            "Record per-function JIT compilation statistics (compile time per "
+            "pass, code size, inlining and deoptimizations).");
+DEFINE_FLAG(int,
+            jit_function_stats_print_limit,
+            20,
+            "Number of functions with the largest compile time printed on exit "
+            "when --jit_function_stats is on. A negative value prints all.");
+
+namespace {
+
+#define DEFINE_NAME(Name) #Name,
+const char* pass_names[] = {COMPILER_PASS_LIST(DEFINE_NAME)};
+#undef DEFINE_NAME
+
+const char* tier_names[] = {"unoptimized", "fastTier", "fullTier", "osr"};
+static_assert(ARRAY_SIZE(tier_names) == JitFunctionStats::kNumTiers,
+              "Missing tier names");
+
+struct Record {
+  char* name = nullptr;
+  intptr_t compilations[JitFunctionStats::kNumTiers] = {};
+  intptr_t bailouts = 0;
+  int64_t compile_micros = 0;
+  int64_t build_graph_micros = 0;
+  int64_t pass_micros[CompilerPass::kNumPasses] = {};
+  intptr_t unoptimized_code_size = 0;
+  intptr_t optimized_code_size = 0;
+  intptr_t inlining_attempts = 0;
+  intptr_t inlined_calls = 0;
+  intptr_t deoptimizations = 0;
+};
+
+using RecordMap = MallocDirectChainedHashMap<CStringIntMapKeyValueTrait>;
+
+}  // namespace
+
+// All records, guarded by [records_mutex_]. [record_ids_] maps the name of a
+// function to the index of its record in [records_].
+static Mutex* records_mutex_ = nullptr;
+static MallocGrowableArray<Record*>* records_ = nullptr;
+static RecordMap* record_ids_ = nullptr;
+
+static void DeleteRecordsLocked() {
+  for (intptr_t i = 0; i < records_->length(); i++) {
+    free(records_->At(i)->name);
+    delete records_->At(i);
+  }
+  records_->Clear();
+  record_ids_->Clear();
+}
+
+static Record* LookupOrAddRecordLocked(const char* name) {
+  const intptr_t id = record_ids_->LookupValue(name);
+  if (id != CStringIntMapKeyValueTrait::kNoValue) {
+    return records_->At(id);
+  }
+  Record* record = new Record();
+  record->name = Utils::StrDup(name);
+  record_ids_->Insert({record->name, records_->length()});
+  records_->Add(record);
+  return record;
+}
+
+static int CompareByCompileTime(Record* const* a, Record* const* b) {
+  if ((*a)->compile_micros != (*b)->compile_micros) {
+    return (*a)->compile_micros > (*b)->compile_micros ? -1 : 1;
+  }
+  return strcmp((*a)->name, (*b)->name);
+}
+
+static void SortedRecordsLocked(MallocGrowableArray<Record*>* sorted) {
+  for (intptr_t i = 0; i < records_->length(); i++) {
+    sorted->Add(records_->At(i));
+  }
+  sorted->Sort(CompareByCompileTime);
+}
+
+void JitFunctionStats::Init() {
+  ASSERT(records_mutex_ == nullptr);
+  // Always allocated, so the flag can be turned on after startup.
+  records_mutex_ = new Mutex(NOT_IN_PRODUCT("JitFunctionStats"));
+  records_ = new MallocGrowableArray<Record*>();
+  record_ids_ = new RecordMap();
+}
+
+void JitFunctionStats::Cleanup() {
+  if (records_mutex_ == nullptr) return;
+  if (IsEnabled() && FLAG_jit_function_stats_print_limit != 0) {
+    Print(FLAG_jit_function_stats_print_limit);
+  }
+  {
+    MutexLocker ml(records_mutex_);
+    DeleteRecordsLocked();
+  }
+  delete records_;
+  records_ = nullptr;
+  delete record_ids_;
+  record_ids_ = nullptr;
+  delete records_mutex_;
+  records_mutex_ = nullptr;
+}
+
+void JitFunctionStats::RecordCompilation(const Function& function,
+                                         Tier tier,
+                                         int64_t elapsed_micros,
+                                         const JitCompilationStats& stats,
+                                         const Code& code) {
+  if (!IsEnabled() || records_mutex_ == nullptr) return;
+  const char* name = function.ToFullyQualifiedCString();
+  const intptr_t code_size = code.IsNull() ? 0 : code.Size();
+
+  MutexLocker ml(records_mutex_);
+  Record* record = LookupOrAddRecordLocked(name);
+  record->compilations[tier]++;
+  record->compile_micros += elapsed_micros;
+  record->build_graph_micros += stats.build_graph_micros;
+  for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+    record->pass_micros[i] += stats.pass_micros[i];
+  }
+  record->inlining_attempts += stats.inlining_attempts;
+  record->inlined_calls += stats.inlined_calls;
+  if (code.IsNull()) {
+    record->bailouts++;
+  } else if (tier == kUnoptimized) {
+    record->unoptimized_code_size = code_size;
+  } else if (tier != kOptimizedOSR) {
+    // OSR code is only used by the frame it was compiled for.
+    record->optimized_code_size = code_size;
+  }
+}
+
+void JitFunctionStats::RecordDeoptimization(const Function& function) {
+  if (!IsEnabled() || records_mutex_ == nullptr) return;
+  const char* name = function.ToFullyQualifiedCString();
+  MutexLocker ml(records_mutex_);
+  LookupOrAddRecordLocked(name)->deoptimizations++;
+}
+
+void JitFunctionStats::PrintJSON(JSONStream* stream, bool reset) {
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_JITFunctionStats");
+  jsobj.AddProperty("enabled", IsEnabled());
+  JSONArray functions(&jsobj, "functions");
+  if (records_mutex_ == nullptr) return;
+
+  MutexLocker ml(records_mutex_);
+  MallocGrowableArray<Record*> sorted;
+  SortedRecordsLocked(&sorted);
+  for (intptr_t i = 0; i < sorted.length(); i++) {
+    const Record& record = *sorted[i];
+    JSONObject function(&functions);
+    function.AddProperty("name", record.name);
+    {
+      JSONObject compilations(&function, "compilations");
+      for (intptr_t tier = 0; tier < kNumTiers; tier++) {
+        compilations.AddProperty(tier_names[tier], record.compilations[tier]);
+      }
+    }
+    function.AddProperty("bailouts", record.bailouts);
+    function.AddProperty64("compileMicros", record.compile_micros);
+    function.AddProperty64("buildGraphMicros", record.build_graph_micros);
+    {
+      JSONObject passes(&function, "passMicros");
+      for (intptr_t pass = 0; pass < CompilerPass::kNumPasses; pass++) {
+        if (record.pass_micros[pass] != 0) {
+          passes.AddProperty64(pass_names[pass], record.pass_micros[pass]);
+        }
+      }
+    }
+    function.AddProperty("unoptimizedCodeSize", record.unoptimized_code_size);
+    function.AddProperty("optimizedCodeSize", record.optimized_code_size);
+    function.AddProperty("inliningAttempts", record.inlining_attempts);
+    function.AddProperty("inlinedCalls", record.inlined_calls);
+    function.AddProperty("deoptimizations", record.deoptimizations);
+  }
+  if (reset) {
+    DeleteRecordsLocked();
+  }
+}
+
+void JitFunctionStats::Print(intptr_t limit) {
+  if (records_mutex_ == nullptr) return;
+  MutexLocker ml(records_mutex_);
+  MallocGrowableArray<Record*> sorted;
+  SortedRecordsLocked(&sorted);
+  if (limit < 0 || limit > sorted.length()) {
+    limit = sorted.length();
+  }
+
+  OS::PrintErr("JIT function stats: %" Pd " of %" Pd
+               " functions by compile time\n",
+               limit, sorted.length());
+  for (intptr_t i = 0; i < limit; i++) {
+    const Record& record = *sorted[i];
+    OS::PrintErr("%10.3f ms  %s\n",
+                 MicrosecondsToMilliseconds(record.compile_micros),
+                 record.name);
+    OS::PrintErr(
+        "    compilations %" Pd "/%" Pd "/%" Pd "/%" Pd
+        " (unoptimized/fast/full/osr), %" Pd " bailouts, %" Pd " deopts\n",
+        record.compilations[kUnoptimized],
+        record.compilations[kOptimizedFastTier],
+        record.compilations[kOptimizedFullTier],
+        record.compilations[kOptimizedOSR], record.bailouts,
+        record.deoptimizations);
+    OS::PrintErr("    code %" Pd "/%" Pd
+                 " bytes (unoptimized/optimized), inlined %" Pd " of %" Pd
+                 " calls\n",
+                 record.unoptimized_code_size, record.optimized_code_size,
+                 record.inlined_calls, record.inlining_attempts);
+
+    // The three most expensive passes.
+    intptr_t top[3] = {-1, -1, -1};
+    for (intptr_t pass = 0; pass < CompilerPass::kNumPasses; pass++) {
+      if (record.pass_micros[pass] == 0) continue;
+      for (intptr_t j = 0; j < 3; j++) {
+        if (top[j] == -1 ||
+            record.pass_micros[pass] > record.pass_micros[top[j]]) {
+          for (intptr_t k = 2; k > j; k--) {
+            top[k] = top[k - 1];
+          }
+          top[j] = pass;
+          break;
+        }
+      }
+    }
+    OS::PrintErr("    graph building %.3f ms",
+                 MicrosecondsToMilliseconds(record.build_graph_micros));
+    for (intptr_t j = 0; j < 3 && top[j] != -1; j++) {
+      OS::PrintErr(", %s %.3f ms", pass_names[top[j]],
+                   MicrosecondsToMilliseconds(record.pass_micros[top[j]]));
+    }
+    OS::PrintErr("\n");
+  }
+}
+
+}  // namespace dart
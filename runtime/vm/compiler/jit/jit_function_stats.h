@@ -0,0 +1,115 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_JIT_FUNCTION_STATS_H_
+#define RUNTIME_VM_COMPILER_JIT_JIT_FUNCTION_STATS_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/flags.h"
+#include "vm/os.h"
+
+namespace dart {
+
+class Code;
+class Function;
+class JSONStream;
+
+DECLARE_FLAG(bool, jit_function_stats);
+
+// What a single JIT compilation of a function spent its time on. Attached to
+// the CompilerState of the compilation while --jit_function_stats is on.
+struct JitCompilationStats {
+  int64_t build_graph_micros = 0;
+  // Time of the passes run on the graph of the compiled function (the one of
+  // [pass_state]), indexed by CompilerPass::Id. Passes run on the graphs of
+  // inlined callees are part of the enclosing Inlining pass.
+  int64_t pass_micros[CompilerPass::kNumPasses] = {};
+  const CompilerPassState* pass_state = nullptr;
+
+  intptr_t inlining_attempts = 0;
+  intptr_t inlined_calls = 0;
+
+  // Adds the time of a compiler pass to the current compilation, if any.
+  class PassScope : public ValueObject {
+   public:
+    PassScope(JitCompilationStats* stats,
+              const CompilerPassState* pass_state,
+              intptr_t pass_id)
+        : stats_((stats != nullptr && stats->pass_state == pass_state)
+                     ? stats
+                     : nullptr),
+          pass_id_(pass_id),
+          start_micros_(stats_ != nullptr ? OS::GetCurrentMonotonicMicros()
+                                          : 0) {}
+    ~PassScope() {
+      if (stats_ != nullptr) {
+        stats_->pass_micros[pass_id_] +=
+            OS::GetCurrentMonotonicMicros() - start_micros_;
+      }
+    }
+
+   private:
+    JitCompilationStats* const stats_;
+    const intptr_t pass_id_;
+    const int64_t start_micros_;
+
+    DISALLOW_COPY_AND_ASSIGN(PassScope);
+  };
+};
+
+// Per-function accounting of JIT compilations (enabled with
+// --jit_function_stats): how often each function was compiled by each tier,
+// where the compile time went, the size of the resulting code, how many calls
+// were inlined and how often the optimized code was deoptimized.
+//
+// Records are keyed by the fully qualified function name and shared by all
+// isolate groups of the process. They can be queried with the
+// _getJITFunctionStats service RPC and the functions with the largest total
+// compile time are printed when the VM shuts down.
+class JitFunctionStats : public AllStatic {
+ public:
+  enum Tier {
+    kUnoptimized,
+    kOptimizedFastTier,
+    kOptimizedFullTier,
+    kOptimizedOSR,
+    kNumTiers,
+  };
+
+  static void Init();
+
+  // Prints the records (see --jit_function_stats_print_limit) and releases
+  // them.
+  static void Cleanup();
+
+  static bool IsEnabled() { return FLAG_jit_function_stats; }
+
+  // Records a compilation of [function] which took [elapsed_micros] and
+  // produced [code], which is null if the compilation bailed out or its
+  // result was discarded.
+  static void RecordCompilation(const Function& function,
+                                Tier tier,
+                                int64_t elapsed_micros,
+                                const JitCompilationStats& stats,
+                                const Code& code);
+
+  // Records that an optimized frame of [function] was deoptimized.
+  static void RecordDeoptimization(const Function& function);
+
+  // Prints all records as a _JITFunctionStats object, sorted by total compile
+  // time, and drops them if [reset] is true.
+  static void PrintJSON(JSONStream* stream, bool reset);
+
+  // Prints the [limit] functions with the largest total compile time.
+  static void Print(intptr_t limit);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_JIT_FUNCTION_STATS_H_
@@ -0,0 +1,267 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/jit/jit_warmup_cache.h"
+
+#include "platform/text_buffer.h"
+#include "vm/dart.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/log.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+#include "vm/version.h"
+
+namespace dart {
+
+DEFINE_FLAG(charp,
+            jit_warmup_cache,
+            nullptr,
+            "Read the set of functions optimized by previous runs from the "
+            "given file, optimize them early and write the file back on exit.");
+DEFINE_FLAG(int,
+            jit_warmup_cache_threshold,
+            200,
+            "Optimization counter threshold used for functions found in the "
+            "JIT warmup cache.");
+DEFINE_FLAG(bool,
+            trace_jit_warmup_cache,
+            false,
+            "Trace JIT warmup cache lookups and updates.");
+
+DECLARE_FLAG(int, max_deoptimization_counter_threshold);
+
+static constexpr const char* kHeaderPrefix = "# dart-jit-warmup-cache v2 ";
+
+// Maps "<source fingerprint>:<qualified name>" to the deoptimization count of
+// the function. Keys are malloc()ed and owned by the map.
+using EntryMap = MallocDirectChainedHashMap<CStringIntMapKeyValueTrait>;
+
+// Entries read at startup by [JitWarmupCache::Load]. Not modified while
+// functions are compiled.
+static EntryMap* loaded_entries_ = nullptr;
+
+// Entries produced by this run, guarded by [recorded_entries_mutex_].
+static EntryMap* recorded_entries_ = nullptr;
+static Mutex* recorded_entries_mutex_ = nullptr;
+
+static void EnsureEntries() {
+  if (loaded_entries_ != nullptr) return;
+  loaded_entries_ = new EntryMap();
+  recorded_entries_ = new EntryMap();
+  recorded_entries_mutex_ = new Mutex(NOT_IN_PRODUCT("JitWarmupCache"));
+}
+
+static void DeleteEntries(EntryMap* map) {
+  if (map == nullptr) return;
+  auto it = map->GetIterator();
+  while (auto* pair = it.Next()) {
+    free(const_cast<char*>(pair->key));
+  }
+  delete map;
+}
+
+static char* KeyFor(const Function& function) {
+  return Utils::SCreate("%08" Px32 ":%s",
+                        static_cast<uint32_t>(function.SourceFingerprint()),
+                        function.ToFullyQualifiedCString());
+}
+
+// Parses a single "<key> <deopts>" line, where <key> itself is
+// "<fingerprint>:<qualified name>" and may contain spaces.
+static bool ParseLine(char* line, EntryMap* map) {
+  char* deopts_start = strrchr(line, ' ');
+  if (deopts_start == nullptr) return false;
+  *deopts_start++ = '\0';
+
+  char* end = nullptr;
+  const intptr_t deoptimization_count = strtol(deopts_start, &end, 10);
+  if (end == deopts_start || *end != '\0') return false;
+  if (deoptimization_count < 0) return false;
+  if (strchr(line, ':') == nullptr) return false;
+
+  if (auto* pair = map->Lookup(line)) {
+    pair->value = deoptimization_count;
+  } else {
+    map->Insert({Utils::StrDup(line), deoptimization_count});
+  }
+  return true;
+}
+
+void JitWarmupCache::Init() {
+  if (!IsEnabled()) return;
+  ASSERT(loaded_entries_ == nullptr && recorded_entries_ == nullptr);
+  EnsureEntries();
+
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.");
+    return;
+  }
+  void* file = file_open(FLAG_jit_warmup_cache, /*write=*/false);
+  if (file == nullptr) {
+    // Cold start: the file will be created on exit.
+    return;
+  }
+  uint8_t* data = nullptr;
+  intptr_t length = -1;
+  file_read(&data, &length, file);
+  file_close(file);
+  if (data == nullptr || length <= 0) {
+    free(data);
+    return;
+  }
+
+  // Make the buffer a NUL terminated string.
+  char* contents = reinterpret_cast<char*>(realloc(data, length + 1));
+  contents[length] = '\0';
+  const intptr_t count = Load(contents);
+  free(contents);
+
+  if (FLAG_trace_jit_warmup_cache) {
+    if (count < 0) {
+      OS::PrintErr("JIT warmup cache %s was written by a different VM\n",
+                   FLAG_jit_warmup_cache);
+    } else {
+      OS::PrintErr("JIT warmup cache: loaded %" Pd " entries from %s\n",
+                   count, FLAG_jit_warmup_cache);
+    }
+  }
+}
+
+intptr_t JitWarmupCache::Load(char* contents) {
+  EnsureEntries();
+  DeleteEntries(loaded_entries_);
+  loaded_entries_ = new EntryMap();
+
+  // Split the contents into lines.
+  char* line = contents;
+  char* next = strchr(line, '\n');
+  if (next != nullptr) *next++ = '\0';
+  const char* expected_hash = Version::SnapshotString();
+  const intptr_t prefix_length = strlen(kHeaderPrefix);
+  if ((strncmp(line, kHeaderPrefix, prefix_length) != 0) ||
+      (strcmp(line + prefix_length, expected_hash) != 0)) {
+    return -1;
+  }
+
+  intptr_t line_number = 1;
+  while (next != nullptr) {
+    line = next;
+    next = strchr(line, '\n');
+    if (next != nullptr) *next++ = '\0';
+    line_number++;
+    if (*line == '\0') continue;
+    if (!ParseLine(line, loaded_entries_)) {
+      OS::PrintErr("warning: Malformed JIT warmup cache entry at %s:%" Pd "\n",
+                   FLAG_jit_warmup_cache != nullptr ? FLAG_jit_warmup_cache
+                                                    : "<buffer>",
+                   line_number);
+    }
+  }
+  return loaded_entries_->Size();
+}
+
+void JitWarmupCache::Save(BaseTextBuffer* buffer) {
+  buffer->Printf("%s%s\n", kHeaderPrefix, Version::SnapshotString());
+  if (loaded_entries_ == nullptr) return;
+
+  MutexLocker ml(recorded_entries_mutex_);
+  // Entries loaded at startup which were not re-optimized in this run (e.g.
+  // the run was shorter or took different paths) are kept, so that a cache
+  // is not lost after a single short-lived run.
+  auto loaded = loaded_entries_->GetIterator();
+  while (auto* pair = loaded.Next()) {
+    if (!recorded_entries_->HasKey(pair->key)) {
+      buffer->Printf("%s %" Pd "\n", pair->key, pair->value);
+    }
+  }
+  auto recorded = recorded_entries_->GetIterator();
+  while (auto* pair = recorded.Next()) {
+    buffer->Printf("%s %" Pd "\n", pair->key, pair->value);
+  }
+}
+
+void JitWarmupCache::Cleanup() {
+  if (recorded_entries_ == nullptr) return;
+
+  auto file_open = Dart::file_open_callback();
+  auto file_write = Dart::file_write_callback();
+  auto file_close = Dart::file_close_callback();
+  void* file = nullptr;
+  if ((file_open != nullptr) && (file_write != nullptr) &&
+      (file_close != nullptr)) {
+    file = file_open(FLAG_jit_warmup_cache, /*write=*/true);
+  }
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to write JIT warmup cache: %s\n",
+                 FLAG_jit_warmup_cache);
+  } else {
+    TextBuffer buffer(4 * KB);
+    Save(&buffer);
+    file_write(buffer.buffer(), buffer.length(), file);
+    file_close(file);
+    if (FLAG_trace_jit_warmup_cache) {
+      OS::PrintErr("JIT warmup cache: wrote %" Pd " new entries to %s\n",
+                   recorded_entries_->Size(), FLAG_jit_warmup_cache);
+    }
+  }
+  Clear();
+}
+
+void JitWarmupCache::Clear() {
+  DeleteEntries(loaded_entries_);
+  loaded_entries_ = nullptr;
+  DeleteEntries(recorded_entries_);
+  recorded_entries_ = nullptr;
+  delete recorded_entries_mutex_;
+  recorded_entries_mutex_ = nullptr;
+}
+
+intptr_t JitWarmupCache::OptimizationThresholdFor(const Function& function) {
+  if (loaded_entries_ == nullptr || loaded_entries_->IsEmpty()) return -1;
+  if (!function.IsOptimizable() || function.IsIrregexpFunction()) return -1;
+
+  char* key = KeyFor(function);
+  auto* pair = loaded_entries_->Lookup(key);
+  free(key);
+  if (pair == nullptr) return -1;
+
+  // Functions which kept deoptimizing in the previous run would most likely
+  // deoptimize again if optimized early with little feedback.
+  if (pair->value >= FLAG_max_deoptimization_counter_threshold / 2) {
+    return -1;
+  }
+  if (FLAG_trace_jit_warmup_cache) {
+    THR_Print("JIT warmup cache: hit for '%s'\n",
+              function.ToFullyQualifiedCString());
+  }
+  return FLAG_jit_warmup_cache_threshold;
+}
+
+void JitWarmupCache::RecordOptimizedCode(const Function& function) {
+  if (recorded_entries_ == nullptr) return;
+  if (function.ForceOptimize() || function.IsIrregexpFunction()) return;
+
+  const intptr_t deoptimization_count = function.deoptimization_counter();
+  char* key = KeyFor(function);
+
+  MutexLocker ml(recorded_entries_mutex_);
+  if (auto* pair = recorded_entries_->Lookup(key)) {
+    pair->value = deoptimization_count;
+    free(key);
+  } else {
+    recorded_entries_->Insert({key, deoptimization_count});
+  }
+  if (FLAG_trace_jit_warmup_cache) {
+    THR_Print("JIT warmup cache: recorded '%s'\n",
+              function.ToFullyQualifiedCString());
+  }
+}
+
+}  // namespace dart
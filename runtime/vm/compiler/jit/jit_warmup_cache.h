@@ -0,0 +1,71 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_JIT_WARMUP_CACHE_H_
+#define RUNTIME_VM_COMPILER_JIT_JIT_WARMUP_CACHE_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+class BaseTextBuffer;
+class Function;
+
+DECLARE_FLAG(charp, jit_warmup_cache);
+
+// An opt-in, on-disk record of the functions which ended up optimized during
+// previous runs of the same program (enabled with --jit_warmup_cache=<file>).
+//
+// Entries are keyed by the function's fully qualified name and its kernel
+// source fingerprint, so editing a function invalidates its entry. Each entry
+// also records how often the function had been deoptimized when it was last
+// optimized. The whole file is additionally tagged with the VM snapshot hash.
+//
+// The cache does not store machine code: optimized code embeds CHA and field
+// guard assumptions which can only be validated against the live program.
+// Instead, unoptimized code for a cached function is emitted with a much lower
+// optimization threshold (--jit_warmup_cache_threshold), so the function is
+// queued for (background) optimization as soon as it has collected enough type
+// feedback. The resulting code then registers its dependencies and is
+// invalidated through the usual deoptimization machinery.
+class JitWarmupCache : public AllStatic {
+ public:
+  // Loads the cache file named by --jit_warmup_cache, if any.
+  static void Init();
+
+  // Writes the functions optimized during this run back to the cache file and
+  // releases the in-memory tables.
+  static void Cleanup();
+
+  // Replaces the loaded entries with the ones in [contents], the NUL
+  // terminated contents of a cache file, which is modified in place. Returns
+  // the number of entries read, or -1 if the file was written by a different
+  // VM.
+  static intptr_t Load(char* contents);
+
+  // Appends the contents of the cache file to [buffer]: the entries recorded
+  // by this run and the loaded entries which were not recorded again.
+  static void Save(BaseTextBuffer* buffer);
+
+  // Releases the in-memory tables without writing them.
+  static void Clear();
+
+  static bool IsEnabled() { return FLAG_jit_warmup_cache != nullptr; }
+
+  // Returns the optimization threshold to use for unoptimized code of
+  // [function], or -1 if the cache has no (valid) entry for it.
+  static intptr_t OptimizationThresholdFor(const Function& function);
+
+  // Records that optimized code was installed for [function].
+  static void RecordOptimizedCode(const Function& function);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_JIT_WARMUP_CACHE_H_
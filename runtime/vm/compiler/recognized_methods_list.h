@@ -310,6 +310,10 @@ namespace dart {
   V(::, _asExternalTypedDataDouble, FfiAsExternalTypedDataDouble, 0x40cdd9e1)  \
   V(::, _getNativeField, GetNativeField, 0xa0139b85)                           \
   V(::, reachabilityFence, ReachabilityFence, 0x730f2b7f)                      \
+  V(SharedTypedData, _atomicLoad, SharedTypedDataAtomicLoad, 0xf6df39fb)       \
+  V(SharedTypedData, _atomicStore, SharedTypedDataAtomicStore, 0x569b4313)     \
+  V(SharedTypedData, _atomicFetchAdd, SharedTypedDataAtomicFetchAdd,           \
+    0x2e7329da)                                                                \
   V(_Utf8Decoder, _scan, Utf8DecoderScan, 0xf296c901)                          \
   V(_Future, timeout, FutureTimeout, 0xbc736ef8)                               \
   V(Future, wait, FutureWait, 0x764434e5)                                      \
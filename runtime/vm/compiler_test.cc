@@ -4,18 +4,30 @@
 
 #include "vm/compiler/jit/compiler.h"
 #include "platform/assert.h"
+#include "platform/text_buffer.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compiler/jit/jit_function_stats.h"
+#include "vm/compiler/jit/jit_warmup_cache.h"
 #include "vm/dart_api_impl.h"
+#include "vm/dart_entry.h"
 #include "vm/heap/safepoint.h"
+#include "vm/json_stream.h"
 #include "vm/kernel_isolate.h"
 #include "vm/object.h"
 #include "vm/symbols.h"
 #include "vm/thread_pool.h"
 #include "vm/unit_test.h"
+#include "vm/version.h"
 
 namespace dart {
 
+DECLARE_FLAG(int, fast_tier_max_call_count);
+DECLARE_FLAG(int, fast_tier_min_code_size);
+DECLARE_FLAG(int, fast_tier_reoptimization_threshold);
+DECLARE_FLAG(int, jit_warmup_cache_threshold);
+DECLARE_FLAG(int, max_deoptimization_counter_threshold);
+
 ISOLATE_UNIT_TEST_CASE(CompileFunction) {
   const char* kScriptChars =
       "class A {\n"
@@ -127,6 +139,253 @@ ISOLATE_UNIT_TEST_CASE(CompileFunctionOnHelperThread) {
   EXPECT(func.HasCode());
 }
 
+// Loads [script] and returns its finalized class A.
+static ClassPtr LoadTestClassA(Thread* thread, const char* script) {
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(script, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  const Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  EXPECT(cls.EnsureIsFinalized(thread) == Error::null());
+  return cls.ptr();
+}
+
+static const char* kWarmupCacheTestScript =
+    "class A {\n"
+    "  static foo() { return 1; }\n"
+    "  static bar() { return 2; }\n"
+    "  static baz() { return 3; }\n"
+    "  static qux() { return 4; }\n"
+    "}\n";
+
+static FunctionPtr LookupStatic(const Class& cls, const char* name) {
+  const Function& function = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New(name))));
+  EXPECT(!function.IsNull());
+  return function.ptr();
+}
+
+// Formats a cache entry for [function] with the given fingerprint.
+static const char* WarmupCacheLine(const Function& function,
+                                   uint32_t fingerprint,
+                                   intptr_t deopts) {
+  return OS::SCreate(Thread::Current()->zone(), "%08" Px32 ":%s %" Pd "\n",
+                     fingerprint, function.ToFullyQualifiedCString(), deopts);
+}
+
+static const char* WarmupCacheLine(const Function& function, intptr_t deopts) {
+  return WarmupCacheLine(
+      function, static_cast<uint32_t>(function.SourceFingerprint()), deopts);
+}
+
+ISOLATE_UNIT_TEST_CASE(JitWarmupCache_Load) {
+  const Class& cls =
+      Class::Handle(LoadTestClassA(thread, kWarmupCacheTestScript));
+  const Function& foo = Function::Handle(LookupStatic(cls, "foo"));
+  const Function& bar = Function::Handle(LookupStatic(cls, "bar"));
+  const Function& baz = Function::Handle(LookupStatic(cls, "baz"));
+  const Function& qux = Function::Handle(LookupStatic(cls, "qux"));
+  Zone* zone = thread->zone();
+
+  // Files written by a different VM are ignored.
+  char* contents = OS::SCreate(zone, "# dart-jit-warmup-cache v2 other\n%s",
+                               WarmupCacheLine(foo, 0));
+  EXPECT_EQ(-1, JitWarmupCache::Load(contents));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(foo));
+
+  // Malformed lines are skipped, as are entries of functions which were
+  // edited since (different fingerprint) or which kept deoptimizing.
+  contents = OS::SCreate(
+      zone, "# dart-jit-warmup-cache v2 %s\n%sgarbage\n%s%s%s",
+      Version::SnapshotString(), WarmupCacheLine(foo, 0),
+      WarmupCacheLine(bar, FLAG_max_deoptimization_counter_threshold),
+      WarmupCacheLine(baz, static_cast<uint32_t>(baz.SourceFingerprint()) + 1,
+                      0),
+      OS::SCreate(zone, "%08" Px32 ":%s x\n",
+                  static_cast<uint32_t>(qux.SourceFingerprint()),
+                  qux.ToFullyQualifiedCString()));
+  EXPECT_EQ(3, JitWarmupCache::Load(contents));
+  EXPECT_EQ(FLAG_jit_warmup_cache_threshold,
+            JitWarmupCache::OptimizationThresholdFor(foo));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(bar));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(baz));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(qux));
+  JitWarmupCache::Clear();
+}
+
+ISOLATE_UNIT_TEST_CASE(JitWarmupCache_SaveLoad) {
+  const Class& cls =
+      Class::Handle(LoadTestClassA(thread, kWarmupCacheTestScript));
+  const Function& foo = Function::Handle(LookupStatic(cls, "foo"));
+  const Function& bar = Function::Handle(LookupStatic(cls, "bar"));
+  const Function& baz = Function::Handle(LookupStatic(cls, "baz"));
+  Zone* zone = thread->zone();
+
+  char* contents =
+      OS::SCreate(zone, "# dart-jit-warmup-cache v2 %s\n%s",
+                  Version::SnapshotString(), WarmupCacheLine(foo, 0));
+  EXPECT_EQ(1, JitWarmupCache::Load(contents));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(bar));
+  JitWarmupCache::RecordOptimizedCode(bar);
+
+  // The saved file keeps the loaded entry and adds the recorded one.
+  TextBuffer buffer(KB);
+  JitWarmupCache::Save(&buffer);
+  JitWarmupCache::Clear();
+  EXPECT_SUBSTRING(WarmupCacheLine(foo, 0), buffer.buffer());
+  EXPECT_SUBSTRING(WarmupCacheLine(bar, 0), buffer.buffer());
+
+  contents = OS::SCreate(zone, "%s", buffer.buffer());
+  EXPECT_EQ(2, JitWarmupCache::Load(contents));
+  EXPECT_EQ(FLAG_jit_warmup_cache_threshold,
+            JitWarmupCache::OptimizationThresholdFor(foo));
+  EXPECT_EQ(FLAG_jit_warmup_cache_threshold,
+            JitWarmupCache::OptimizationThresholdFor(bar));
+  EXPECT_EQ(-1, JitWarmupCache::OptimizationThresholdFor(baz));
+  JitWarmupCache::Clear();
+}
+
+// Returns the value of the first integer property [name] in [json].
+static int64_t JsonIntProperty(const char* json, const char* name) {
+  const char* key = OS::SCreate(Thread::Current()->zone(), "\"%s\":", name);
+  const char* property = strstr(json, key);
+  EXPECT(property != nullptr);
+  if (property == nullptr) return -1;
+  return strtoll(property + strlen(key), nullptr, 10);
+}
+
+ISOLATE_UNIT_TEST_CASE(JitFunctionStats) {
+  SetFlagScope<bool> sfs(&FLAG_jit_function_stats, true);
+  const Class& cls =
+      Class::Handle(LoadTestClassA(thread, kWarmupCacheTestScript));
+  const Function& func = Function::Handle(LookupStatic(cls, "foo"));
+
+  // Drop the records of the functions compiled while loading the script.
+  {
+    JSONStream js;
+    JitFunctionStats::PrintJSON(&js, /*reset=*/true);
+  }
+
+  EXPECT(CompilerTest::TestCompileFunction(func));
+  const Object& result =
+      Object::Handle(Compiler::CompileOptimizedFunction(thread, func));
+  EXPECT(result.IsCode());
+  EXPECT(func.HasOptimizedCode());
+
+  JSONStream js;
+  JitFunctionStats::PrintJSON(&js, /*reset=*/true);
+  const char* json = js.ToCString();
+  EXPECT_SUBSTRING("\"type\":\"_JITFunctionStats\"", json);
+  EXPECT_SUBSTRING(
+      "_A_foo\",\"compilations\":{\"unoptimized\":1,\"fastTier\":0,"
+      "\"fullTier\":1,\"osr\":0},\"bailouts\":0",
+      json);
+  EXPECT_SUBSTRING("\"deoptimizations\":0}", json);
+  EXPECT(JsonIntProperty(json, "unoptimizedCodeSize") > 0);
+  EXPECT(JsonIntProperty(json, "optimizedCodeSize") > 0);
+  // Only passes which took time are listed, but the optimizing pipeline
+  // always has some.
+  EXPECT_SUBSTRING("\"passMicros\":{\"", json);
+
+  JSONStream empty;
+  JitFunctionStats::PrintJSON(&empty, /*reset=*/false);
+  EXPECT_SUBSTRING("\"functions\":[]", empty.ToCString());
+}
+
+#if !defined(PRODUCT)
+static FunctionPtr LoadFastTierTestFunction(Thread* thread) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static bar(x) => x + 1;\n"
+      "  static foo(x) => bar(x) * 2;\n"
+      "}\n";
+  const Class& cls = Class::Handle(LoadTestClassA(thread, kScriptChars));
+  const Function& func = Function::Handle(LookupStatic(cls, "foo"));
+  EXPECT(CompilerTest::TestCompileFunction(func));
+  return func.ptr();
+}
+
+static void InvokeFastTierTestFunction(const Function& func, intptr_t count) {
+  const Array& args = Array::Handle(Array::New(1));
+  args.SetAt(0, Smi::Handle(Smi::New(3)));
+  Object& result = Object::Handle();
+  for (intptr_t i = 0; i < count; i++) {
+    result = DartEntry::InvokeFunction(func, args);
+    EXPECT(result.IsSmi());
+    EXPECT_EQ(8, Smi::Cast(result).Value());
+  }
+}
+
+// Returns the _JITFunctionStats recorded since the last call.
+static const char* TakeJitFunctionStats() {
+  JSONStream js;
+  JitFunctionStats::PrintJSON(&js, /*reset=*/true);
+  return Thread::Current()->zone()->MakeCopyOfString(js.ToCString());
+}
+
+ISOLATE_UNIT_TEST_CASE(FastTier_Reoptimization) {
+  SetFlagScope<bool> sfs(&FLAG_background_compilation, false);
+  SetFlagScope<bool> sfs2(&FLAG_jit_function_stats, true);
+  SetFlagScope<int> sfs3(&FLAG_fast_tier_min_code_size, 1);
+  SetFlagScope<int> sfs4(&FLAG_fast_tier_reoptimization_threshold, 10);
+  const Function& func = Function::Handle(LoadFastTierTestFunction(thread));
+  InvokeFastTierTestFunction(func, 1);
+  TakeJitFunctionStats();
+
+  const Object& result =
+      Object::Handle(Compiler::CompileOptimizedFunction(thread, func));
+  EXPECT(result.IsCode());
+  EXPECT(func.HasOptimizedCode());
+  EXPECT_SUBSTRING(
+      "_A_foo\",\"compilations\":{\"unoptimized\":0,\"fastTier\":1,"
+      "\"fullTier\":0,\"osr\":0}",
+      TakeJitFunctionStats());
+
+  // The fast tier code counts its invocations and is reoptimized by the full
+  // pipeline once it reaches --fast_tier_reoptimization_threshold.
+  func.SetUsageCounter(0);
+  InvokeFastTierTestFunction(func, 9);
+  EXPECT_SUBSTRING("\"functions\":[]", TakeJitFunctionStats());
+  InvokeFastTierTestFunction(func, 2);
+  EXPECT(func.HasOptimizedCode());
+  EXPECT_SUBSTRING(
+      "_A_foo\",\"compilations\":{\"unoptimized\":0,\"fastTier\":0,"
+      "\"fullTier\":1,\"osr\":0}",
+      TakeJitFunctionStats());
+
+  // The full tier code does not count invocations.
+  InvokeFastTierTestFunction(func, 20);
+  EXPECT_SUBSTRING("\"functions\":[]", TakeJitFunctionStats());
+}
+
+ISOLATE_UNIT_TEST_CASE(FastTier_HotCallSite) {
+  SetFlagScope<bool> sfs(&FLAG_background_compilation, false);
+  SetFlagScope<bool> sfs2(&FLAG_jit_function_stats, true);
+  SetFlagScope<int> sfs3(&FLAG_fast_tier_min_code_size, 1);
+  SetFlagScope<int> sfs4(&FLAG_fast_tier_max_call_count, 5);
+  const Function& func = Function::Handle(LoadFastTierTestFunction(thread));
+
+  // The call to bar was executed more than --fast_tier_max_call_count times,
+  // so foo is optimized by the full tier right away.
+  InvokeFastTierTestFunction(func, 10);
+  TakeJitFunctionStats();
+  const Object& result =
+      Object::Handle(Compiler::CompileOptimizedFunction(thread, func));
+  EXPECT(result.IsCode());
+  EXPECT(func.HasOptimizedCode());
+  EXPECT_SUBSTRING(
+      "_A_foo\",\"compilations\":{\"unoptimized\":0,\"fastTier\":0,"
+      "\"fullTier\":1,\"osr\":0}",
+      TakeJitFunctionStats());
+}
+#endif  // !defined(PRODUCT)
+
 ISOLATE_UNIT_TEST_CASE(RegenerateAllocStubs) {
   const char* kScriptChars =
       "class A {\n"
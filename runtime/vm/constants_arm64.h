@@ -761,6 +761,8 @@ enum LoadStoreExclusiveOp {
   LoadStoreExclusiveFixed = B27,
   LDXR = LoadStoreExclusiveFixed | B22,
   STXR = LoadStoreExclusiveFixed,
+  LDAXR = LoadStoreExclusiveFixed | B22 | B15,
+  STLXR = LoadStoreExclusiveFixed | B15,
   LDAR = LoadStoreExclusiveFixed | B23 | B22 | B15,
   STLR = LoadStoreExclusiveFixed | B23 | B15,
 };
@@ -11,6 +11,10 @@
 #include "vm/code_observers.h"
 #include "vm/compiler/runtime_offsets_extracted.h"
 #include "vm/compiler/runtime_offsets_list.h"
+#if !defined(DART_PRECOMPILED_RUNTIME)
+#include "vm/compiler/jit/jit_function_stats.h"
+#include "vm/compiler/jit/jit_warmup_cache.h"
+#endif
 #include "vm/cpu.h"
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
@@ -328,6 +332,10 @@ char* Dart::DartInit(const Dart_InitializeParams* params) {
   StoreBuffer::Init();
   MarkingStack::Init();
   TargetCPUFeatures::Init();
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  JitWarmupCache::Init();
+  JitFunctionStats::Init();
+#endif
 
 #if defined(USING_SIMULATOR)
   Simulator::Init();
@@ -688,6 +696,13 @@ char* Dart::Cleanup() {
   // before shutting down the thread pool.
   WaitForIsolateShutdown();
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // All isolate groups (and their background compilers) are gone, so the set
+  // of optimized functions is final.
+  JitWarmupCache::Cleanup();
+  JitFunctionStats::Cleanup();
+#endif
+
 #if !defined(PRODUCT)
   {
     // IMPORTANT: the code below enters VM isolate so that Metric::Cleanup could
@@ -1247,6 +1247,22 @@ VM_METRIC_LIST(VM_METRIC_API)
 ISOLATE_GROUP_METRIC_LIST(ISOLATE_GROUP_METRIC_API)
 #undef ISOLATE_GROUP_METRIC_API
 
+#define ISOLATE_GROUP_HISTOGRAM_API(variable, name)                            \
+  DART_EXPORT void Dart_IsolateGroup##variable##Histogram(                     \
+      Dart_IsolateGroup isolate_group, Dart_MetricHistogram* histogram) {      \
+    if (isolate_group == nullptr) {                                            \
+      FATAL1("%s expects argument 'isolate_group' to be non-null.",            \
+             CURRENT_FUNC);                                                    \
+    }                                                                          \
+    if (histogram == nullptr) {                                                \
+      FATAL1("%s expects argument 'histogram' to be non-null.", CURRENT_FUNC); \
+    }                                                                          \
+    IsolateGroup* group = reinterpret_cast<IsolateGroup*>(isolate_group);      \
+    group->Get##variable##Histogram()->Read(histogram);                        \
+  }
+ISOLATE_GROUP_HISTOGRAM_LIST(ISOLATE_GROUP_HISTOGRAM_API)
+#undef ISOLATE_GROUP_HISTOGRAM_API
+
 #if !defined(PRODUCT)
 #define ISOLATE_METRIC_API(type, variable, name, unit)                         \
   DART_EXPORT int64_t Dart_Isolate##variable##Metric(Dart_Isolate isolate) {   \
@@ -8243,6 +8243,85 @@ TEST_CASE(DartAPI_PostCObject_DoesNotRunFinalizerOnFailure) {
   free(my_str);  // Never a double-free.
 }
 
+static intptr_t external_reply_finalized = 0;
+
+static void ExternalReplyFinalizer(void* isolate_callback_data, void* peer) {
+  free(peer);
+  external_reply_finalized++;
+}
+
+TEST_CASE(DartAPI_PostCObject_ExternalTypedDataIsNotCopied) {
+  const char* kScriptChars =
+      "import 'dart:isolate';\n"
+      "import 'dart:typed_data';\n"
+      "var received;\n"
+      "SendPort openPort() {\n"
+      "  var receivePort = new RawReceivePort();\n"
+      "  receivePort.handler = (message) {\n"
+      "    receivePort.close();\n"
+      "    received = message;\n"
+      "  };\n"
+      "  return receivePort.sendPort;\n"
+      "}\n"
+      "int sum() => (received as Uint8List).fold(0, (a, b) => a + b);\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle send_port = Dart_Invoke(lib, NewString("openPort"), 0, NULL);
+  EXPECT_VALID(send_port);
+  Dart_Port port_id = ILLEGAL_PORT;
+  EXPECT_VALID(Dart_SendPortGetId(send_port, &port_id));
+
+  // Large enough that a copy would have to go to old space.
+  const intptr_t kLength = 1 * MB;
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    data[i] = 1;
+  }
+  Dart_CObject message;
+  message.type = Dart_CObject_kExternalTypedData;
+  message.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  message.value.as_external_typed_data.length = kLength;
+  message.value.as_external_typed_data.data = data;
+  message.value.as_external_typed_data.peer = data;
+  message.value.as_external_typed_data.callback = ExternalReplyFinalizer;
+  EXPECT(Dart_PostCObject(port_id, &message));
+
+  Dart_Handle result = Dart_RunLoop();
+  EXPECT_VALID(result);
+  result = Dart_Invoke(lib, NewString("sum"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t sum = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &sum));
+  EXPECT_EQ(kLength, sum);
+
+  // The receiver adopted the posted buffer instead of copying it.
+  Dart_EnterScope();
+  {
+    Dart_Handle received = Dart_GetField(lib, NewString("received"));
+    EXPECT_VALID(received);
+    EXPECT_EQ(Dart_TypedData_kUint8,
+              Dart_GetTypeOfExternalTypedData(received));
+    Dart_TypedData_Type type;
+    void* received_data = NULL;
+    intptr_t received_length = 0;
+    EXPECT_VALID(Dart_TypedDataAcquireData(received, &type, &received_data,
+                                           &received_length));
+    EXPECT_EQ(data, received_data);
+    EXPECT_EQ(kLength, received_length);
+    EXPECT_VALID(Dart_TypedDataReleaseData(received));
+  }
+  Dart_ExitScope();
+
+  // Ownership moved to the receiving isolate, which finalizes the buffer once
+  // it is no longer reachable.
+  EXPECT_VALID(Dart_SetField(lib, NewString("received"), Dart_Null()));
+  EXPECT_EQ(0, external_reply_finalized);
+  {
+    TransitionNativeToVM transition(thread);
+    GCTestHelper::CollectAllGarbage();
+  }
+  EXPECT_EQ(1, external_reply_finalized);
+}
+
 VM_UNIT_TEST_CASE(DartAPI_NewNativePort) {
   // Create a port with a bogus handler.
   Dart_Port error_port = Dart_NewNativePort("Foo", NULL, true);
@@ -8302,6 +8381,49 @@ VM_UNIT_TEST_CASE(DartAPI_NewNativePort) {
   EXPECT(Dart_CloseNativePort(port_id2));
 }
 
+static std::atomic<intptr_t> concurrent_port_in_flight = {0};
+static std::atomic<intptr_t> concurrent_port_max_in_flight = {0};
+static std::atomic<intptr_t> concurrent_port_handled = {0};
+
+static void NewConcurrentNativePort_handler(Dart_Port dest_port_id,
+                                            Dart_CObject* message) {
+  EXPECT_NOTNULL(message);
+  EXPECT_EQ(Dart_CObject_kInt32, message->type);
+  const intptr_t in_flight = concurrent_port_in_flight.fetch_add(1) + 1;
+  intptr_t max_in_flight = concurrent_port_max_in_flight.load();
+  while (in_flight > max_in_flight &&
+         !concurrent_port_max_in_flight.compare_exchange_weak(max_in_flight,
+                                                              in_flight)) {
+  }
+  // Keep the worker busy, so that further messages have to queue up.
+  OS::SleepMicros(1000);
+  concurrent_port_in_flight.fetch_sub(1);
+  concurrent_port_handled.fetch_add(1);
+}
+
+VM_UNIT_TEST_CASE(DartAPI_NewConcurrentNativePort) {
+  EXPECT_EQ(ILLEGAL_PORT, Dart_NewConcurrentNativePort("Foo", NULL, 2));
+  EXPECT_EQ(ILLEGAL_PORT, Dart_NewConcurrentNativePort(
+                              "Foo", NewConcurrentNativePort_handler, 0));
+
+  const intptr_t kMaxConcurrency = 3;
+  const intptr_t kMessages = 50;
+  Dart_Port port_id = Dart_NewConcurrentNativePort(
+      "Concurrent", NewConcurrentNativePort_handler, kMaxConcurrency);
+  EXPECT_NE(ILLEGAL_PORT, port_id);
+  for (intptr_t i = 0; i < kMessages; i++) {
+    EXPECT(Dart_PostInteger(port_id, i));
+  }
+  while (concurrent_port_handled.load() < kMessages) {
+    OS::Sleep(1);
+  }
+  EXPECT_EQ(0, concurrent_port_in_flight.load());
+  EXPECT_LE(concurrent_port_max_in_flight.load(), kMaxConcurrency);
+  EXPECT_GE(concurrent_port_max_in_flight.load(), 1);
+
+  EXPECT(Dart_CloseNativePort(port_id));
+}
+
 static void NewNativePort_sendInteger123(Dart_Port dest_port_id,
                                          Dart_CObject* message) {
   // Gets a send port message.
@@ -733,6 +733,26 @@ ObjectPtr DartLibraryCalls::HandleMessage(Dart_Port port_id,
   return handler.ptr();
 }
 
+ObjectPtr DartLibraryCalls::HandleMessages(Dart_Port port_id,
+                                           const Instance& message) {
+  auto* const thread = Thread::Current();
+  auto* const zone = thread->zone();
+  auto* const isolate = thread->isolate();
+  auto* const object_store = thread->isolate_group()->object_store();
+  const auto& function =
+      Function::Handle(zone, object_store->handle_messages_function());
+  ASSERT(!function.IsNull());
+  Array& args =
+      Array::Handle(zone, isolate->isolate_object_store()->dart_args_2());
+  ASSERT(!args.IsNull());
+  args.SetAt(0, Integer::Handle(zone, Integer::New(port_id)));
+  args.SetAt(1, message);
+  DebuggerSetResumeIfStepping(isolate);
+  const Object& result =
+      Object::Handle(zone, DartEntry::InvokeFunction(function, args));
+  return result.ptr();
+}
+
 ObjectPtr DartLibraryCalls::HandleFinalizerMessage(
     const FinalizerBase& finalizer) {
   if (FLAG_trace_finalizers) {
@@ -292,6 +292,12 @@ class DartLibraryCalls : public AllStatic {
   // handler for this port id.
   static ObjectPtr HandleMessage(Dart_Port port_id, const Instance& message);
 
+  // Handles [message] like [HandleMessage] and then the further messages of
+  // the current batch (see MessageHandler::DequeueBatchMessage).
+  //
+  // Returns null on success, an ErrorPtr on failure.
+  static ObjectPtr HandleMessages(Dart_Port port_id, const Instance& message);
+
   // Invokes the finalizer to run its callbacks.
   static ObjectPtr HandleFinalizerMessage(const FinalizerBase& finalizer);
 
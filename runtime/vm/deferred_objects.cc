@@ -8,6 +8,7 @@
 
 #include "vm/code_patcher.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/jit/jit_function_stats.h"
 #include "vm/deopt_instructions.h"
 #include "vm/flags.h"
 #include "vm/object.h"
@@ -173,6 +174,7 @@ void DeferredPcMarker::Materialize(DeoptContext* deopt_context) {
   // function occurring in the optimized frame.
   if (deopt_context->deoptimizing_code()) {
     function.set_deoptimization_counter(function.deoptimization_counter() + 1);
+    JitFunctionStats::RecordDeoptimization(function);
   }
   if (FLAG_trace_deoptimization || FLAG_trace_deoptimization_verbose) {
     THR_Print("Deoptimizing '%s' (count %d)\n",
@@ -78,7 +78,8 @@ void NativeCallbackTrampolines::AllocateTrampoline() {
                                /*prologue_offset=*/0,
                                /*size=*/assembler.CodeSize(),
                                /*optimized=*/false,  // not really relevant
-                               &comments);
+                               &comments,
+                               /*code=*/nullptr);
     }
 #endif
 #if !defined(PRODUCT) || defined(FORCE_INCLUDE_DISASSEMBLER)
@@ -8,6 +8,7 @@
 #include "vm/flags.h"
 #include "vm/growable_array.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/safepoint.h"
 #include "vm/object.h"
 #include "vm/object_graph.h"
 #include "vm/object_store.h"
@@ -59,7 +60,7 @@ bool FieldTable::Register(const Field& field, intptr_t expected_field_id) {
 
   if (free_head_ < 0) {
     bool grown_backing_store = false;
-    if (top_ == capacity_) {
+    if (NeedsToGrowForRegister()) {
       const intptr_t new_capacity = capacity_ + kCapacityIncrement;
       Grow(new_capacity);
       grown_backing_store = true;
@@ -102,6 +103,11 @@ void FieldTable::AllocateIndex(intptr_t index) {
 
 void FieldTable::Grow(intptr_t new_capacity) {
   ASSERT(new_capacity > capacity_);
+  // The mutator of [isolate_] accesses the table without synchronization
+  // through Thread::field_table_values_, so it must be stopped.
+  DEBUG_ASSERT(isolate_ == nullptr ||
+               isolate_->group()->safepoint_handler()->IsOwnedByTheThread(
+                   Thread::Current()));
 
   auto old_table = table_;
   auto new_table = static_cast<ObjectPtr*>(
@@ -128,12 +134,21 @@ FieldTable* FieldTable::Clone(Isolate* for_isolate) {
       IsolateGroup::Current()->program_lock()->IsCurrentThreadReader());
 
   FieldTable* clone = new FieldTable(for_isolate);
-  auto new_table =
-      static_cast<ObjectPtr*>(malloc(capacity_ * sizeof(ObjectPtr)));  // NOLINT
-  memmove(new_table, table_, capacity_ * sizeof(ObjectPtr));
   ASSERT(clone->table_ == nullptr);
+  // Only copy the used part of the table: the unused capacity of the initial
+  // field table would otherwise be duplicated in every isolate. A small spare
+  // capacity lets the first static fields registered after a spawn avoid
+  // growing every clone inside a safepoint (see
+  // IsolateGroup::RegisterStaticField).
+  const intptr_t capacity = top_ + kCloneSpareCapacity;
+  auto new_table =
+      static_cast<ObjectPtr*>(malloc(capacity * sizeof(ObjectPtr)));  // NOLINT
+  memmove(new_table, table_, top_ * sizeof(ObjectPtr));
+  for (intptr_t i = top_; i < capacity; i++) {
+    new_table[i] = ObjectPtr();
+  }
   clone->table_ = new_table;
-  clone->capacity_ = capacity_;
+  clone->capacity_ = capacity;
   clone->top_ = top_;
   clone->free_head_ = free_head_;
   return clone;
@@ -51,6 +51,10 @@ class FieldTable {
   // Returns whether registering this field caused a growth in the backing
   // store.
   bool Register(const Field& field, intptr_t expected_field_id = -1);
+  // Returns whether the next call to [Register] will grow the backing store.
+  bool NeedsToGrowForRegister() const {
+    return free_head_ < 0 && top_ == capacity_;
+  }
   void AllocateIndex(intptr_t index);
 
   // Static field elements are being freed only during isolate reload
@@ -93,6 +97,7 @@ class FieldTable {
 
   static const int kInitialCapacity = 512;
   static const int kCapacityIncrement = 256;
+  static const int kCloneSpareCapacity = 64;
 
  private:
   friend class GCMarker;
@@ -529,10 +529,7 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
 
     // Some Code objects may have been collected so invalidate handler cache.
     thread->isolate_group()->ForEachIsolate(
-        [&](Isolate* isolate) {
-          isolate->handler_info_cache()->Clear();
-          isolate->catch_entry_moves_cache()->Clear();
-        },
+        [&](Isolate* isolate) { isolate->ClearHandlerCaches(); },
         /*at_safepoint=*/true);
     last_gc_was_old_space_ = true;
     assume_scavenge_will_fail_ = false;
@@ -1015,6 +1012,16 @@ void Heap::RecordBeforeGC(GCType type, GCReason reason) {
   stats_.before_.new_ = new_space_.GetCurrentUsage();
   stats_.before_.old_ = old_space_.GetCurrentUsage();
   stats_.before_.store_buffer_ = isolate_group_->store_buffer()->Size();
+
+  // Everything allocated since the last GC is still counted as used. Old
+  // space may shrink in between due to concurrent sweeping.
+  const intptr_t allocated_in_words =
+      Utils::Maximum<intptr_t>(
+          stats_.before_.new_.used_in_words - new_used_after_gc_in_words_, 0) +
+      Utils::Maximum<intptr_t>(
+          stats_.before_.old_.used_in_words - old_used_after_gc_in_words_, 0);
+  Metric* allocated = isolate_group_->GetHeapAllocatedMetric();
+  allocated->set_value(allocated->value() + allocated_in_words * kWordSize);
 }
 
 static double AvgCollectionPeriod(int64_t run_time, intptr_t collections) {
@@ -1025,6 +1032,31 @@ static double AvgCollectionPeriod(int64_t run_time, intptr_t collections) {
          static_cast<double>(collections);
 }
 
+void Heap::UpdateGCMetrics(int64_t pause_micros) {
+  IsolateGroup* group = isolate_group_;
+  if ((stats_.type_ == GCType::kScavenge) ||
+      (stats_.type_ == GCType::kEvacuate)) {
+    group->GetGCScavengeCountMetric()->increment();
+    Metric* time = group->GetGCScavengeTimeMetric();
+    time->set_value(time->value() + pause_micros);
+    group->GetGCScavengePauseHistogram()->Add(pause_micros);
+    // Survivors are copied within new space or promoted to old space.
+    const ScavengeStats& stats = new_space_.last_stats();
+    Metric* copied = group->GetGCScavengeCopiedMetric();
+    copied->set_value(
+        copied->value() +
+        (stats.UsedAfterInWords() + stats.PromotedInWords()) * kWordSize);
+    Metric* promoted = group->GetGCScavengePromotedMetric();
+    promoted->set_value(promoted->value() +
+                        stats.PromotedInWords() * kWordSize);
+  } else {
+    group->GetGCMarkSweepCountMetric()->increment();
+    Metric* time = group->GetGCMarkSweepTimeMetric();
+    time->set_value(time->value() + pause_micros);
+    group->GetGCMarkSweepPauseHistogram()->Add(pause_micros);
+  }
+}
+
 void Heap::RecordAfterGC(GCType type) {
   stats_.after_.micros_ = OS::GetCurrentMonotonicMicros();
   int64_t delta = stats_.after_.micros_ - stats_.before_.micros_;
@@ -1038,6 +1070,9 @@ void Heap::RecordAfterGC(GCType type) {
   stats_.after_.new_ = new_space_.GetCurrentUsage();
   stats_.after_.old_ = old_space_.GetCurrentUsage();
   stats_.after_.store_buffer_ = isolate_group_->store_buffer()->Size();
+  new_used_after_gc_in_words_ = stats_.after_.new_.used_in_words;
+  old_used_after_gc_in_words_ = stats_.after_.old_.used_in_words;
+  UpdateGCMetrics(delta);
 #ifndef PRODUCT
   // For now we'll emit the same GC events on all isolates.
   if (Service::gc_stream.enabled()) {
@@ -48,6 +48,7 @@ class Heap {
     kCanonicalHashes,
     kObjectIds,
     kLoadingUnits,
+    kHeapSamples,
     kNumWeakSelectors
   };
 
@@ -225,6 +226,11 @@ class Heap {
     return GetWeakEntry(raw_obj, kLoadingUnits);
   }
 
+  // Associate the id of a heap profile sample with a sampled object.
+  void SetHeapSampleId(ObjectPtr raw_obj, intptr_t sample_id) {
+    SetWeakEntry(raw_obj, kHeapSamples, sample_id);
+  }
+
   // Used by the GC algorithms to propagate weak entries.
   intptr_t GetWeakEntry(ObjectPtr raw_obj, WeakSelector sel) const;
   void SetWeakEntry(ObjectPtr raw_obj, WeakSelector sel, intptr_t val);
@@ -345,6 +351,8 @@ class Heap {
   // GC stats collection.
   void RecordBeforeGC(GCType type, GCReason reason);
   void RecordAfterGC(GCType type);
+  // Updates the GC metrics of the isolate group after a pause.
+  void UpdateGCMetrics(int64_t pause_micros);
   void PrintStats();
   void PrintStatsToTimeline(TimelineEventScope* event, GCReason reason);
 
@@ -365,6 +373,9 @@ class Heap {
 
   // GC stats collection.
   GCStats stats_;
+  // Used words after the last GC, to count the allocations in between.
+  intptr_t new_used_after_gc_in_words_ = 0;
+  intptr_t old_used_after_gc_in_words_ = 0;
 
   RelaxedAtomic<Dart_PerformanceMode> mode_ = {Dart_PerformanceMode_Default};
 
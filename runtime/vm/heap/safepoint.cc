@@ -5,12 +5,35 @@
 #include "vm/heap/safepoint.h"
 
 #include "vm/heap/heap.h"
+#include "vm/isolate.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/stack_frame.h"
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
+#include "vm/timeline.h"
 
 namespace dart {
 
 DEFINE_FLAG(bool, trace_safepoint, false, "Trace Safepoint logic.");
+DEFINE_FLAG(int,
+            slow_safepoint_micros,
+            0,
+            "Print the last thread to check in, and its Dart stack, for "
+            "safepoint operations which wait longer than this many "
+            "microseconds for threads to check in. 0 disables.");
+
+static const char* SafepointLevelToCString(SafepointLevel level) {
+  switch (level) {
+    case SafepointLevel::kGC:
+      return "GC";
+    case SafepointLevel::kGCAndDeopt:
+      return "GCAndDeopt";
+    default:
+      UNREACHABLE();
+      return nullptr;
+  }
+}
 
 SafepointOperationScope::SafepointOperationScope(Thread* T,
                                                  SafepointLevel level)
@@ -79,6 +102,7 @@ void SafepointHandler::SafepointThreads(Thread* T, SafepointLevel level) {
   ASSERT(T->execution_state() == Thread::kThreadInVM);
   ASSERT(T->current_safepoint_level() >= level);
 
+  int64_t start;
   {
     MonitorLocker tl(threads_lock());
 
@@ -109,11 +133,33 @@ void SafepointHandler::SafepointThreads(Thread* T, SafepointLevel level) {
     handlers_[level]->SetSafepointInProgress(T);
 
     // Ensure a thread is at a safepoint or notify it to get to one.
+    start = OS::GetCurrentMonotonicMicros();
     handlers_[level]->NotifyThreadsToGetToSafepointLevel(T);
   }
 
   // Now wait for all threads that are not already at a safepoint to check-in.
-  handlers_[level]->WaitUntilThreadsReachedSafepointLevel();
+  {
+#if defined(SUPPORT_TIMELINE)
+    TimelineBeginEndScope tbes(T, Timeline::GetGCStream(), "WaitForSafepoint");
+#endif
+    LevelHandler* handler = handlers_[level];
+    handler->WaitUntilThreadsReachedSafepointLevel();
+    const int64_t micros = OS::GetCurrentMonotonicMicros() - start;
+    isolate_group_->GetTimeToSafepointHistogram()->Add(micros);
+#if defined(SUPPORT_TIMELINE)
+    if (tbes.enabled()) {
+      tbes.SetNumArguments(3);
+      tbes.CopyArgument(0, "level", SafepointLevelToCString(level));
+      tbes.FormatArgument(1, "threads", "%" Pd32,
+                          handler->num_threads_requested_);
+      tbes.CopyArgument(2, "lastThread", handler->straggler_name_);
+    }
+#endif
+    if ((FLAG_slow_safepoint_micros > 0) &&
+        (micros >= FLAG_slow_safepoint_micros)) {
+      handler->PrintStraggler(T, micros);
+    }
+  }
 
   AcquireLowerLevelSafepoints(T, level);
 }
@@ -136,6 +182,9 @@ void SafepointHandler::AssertWeDoNotOwnLowerLevelSafepoints(
 void SafepointHandler::LevelHandler::NotifyThreadsToGetToSafepointLevel(
     Thread* T) {
   ASSERT(num_threads_not_parked_ == 0);
+  request_micros_ = OS::GetCurrentMonotonicMicros();
+  straggler_name_[0] = '\0';
+  straggler_frame_count_ = 0;
   for (auto current = isolate_group()->thread_registry()->active_list();
        current != nullptr; current = current->next()) {
     MonitorLocker tl(current->thread_lock());
@@ -151,6 +200,7 @@ void SafepointHandler::LevelHandler::NotifyThreadsToGetToSafepointLevel(
       }
     }
   }
+  num_threads_requested_ = num_threads_not_parked_;
 }
 
 void SafepointHandler::ResumeThreads(Thread* T, SafepointLevel level) {
@@ -274,10 +324,65 @@ void SafepointHandler::LevelHandler::NotifyWeAreParked(Thread* T) {
   ASSERT(num_threads_not_parked_ > 0);
   num_threads_not_parked_ -= 1;
   if (num_threads_not_parked_ == 0) {
+    RecordStraggler(T);
     sl.Notify();
   }
 }
 
+void SafepointHandler::LevelHandler::RecordStraggler(Thread* T) {
+  ASSERT(parked_lock_.IsOwnedByCurrentThread());
+  OSThread* os_thread = T->os_thread();
+  const char* name = (os_thread != nullptr) ? os_thread->name() : nullptr;
+  Utils::SNPrint(straggler_name_, kMaxThreadNameLength, "%s (%s)",
+                 (name != nullptr) ? name : "unnamed",
+                 Thread::TaskKindToCString(T->task_kind()));
+  straggler_frame_count_ = 0;
+  if ((FLAG_slow_safepoint_micros <= 0) || (T != Thread::Current()) ||
+      (OS::GetCurrentMonotonicMicros() - request_micros_ <
+       FLAG_slow_safepoint_micros)) {
+    return;
+  }
+  // Only raw pointers can be recorded here, as this thread holds locks the
+  // owner of the operation needs. They are resolved by PrintStraggler before
+  // the operation starts.
+  StackFrameIterator frames(ValidationPolicy::kDontValidateFrames, T,
+                            StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = frames.NextFrame();
+       (frame != nullptr) && (straggler_frame_count_ < kMaxStragglerFrames);
+       frame = frames.NextFrame()) {
+    if (frame->IsDartFrame()) {
+      straggler_code_[straggler_frame_count_] = frame->LookupDartCode();
+      straggler_pcs_[straggler_frame_count_] = frame->pc();
+      straggler_frame_count_++;
+    }
+  }
+}
+
+void SafepointHandler::LevelHandler::PrintStraggler(Thread* T,
+                                                    int64_t micros) {
+  OS::PrintErr("Slow %s safepoint: waited %" Pd64 "us for %" Pd32
+               " threads, the last was %s\n",
+               SafepointLevelToCString(level_), micros, num_threads_requested_,
+               straggler_name_);
+  if (straggler_frame_count_ == 0) {
+    return;
+  }
+  StackZone zone(T);
+  HandleScope handle_scope(T);
+  Code& code = Code::Handle(zone.GetZone());
+  for (intptr_t i = 0; i < straggler_frame_count_; i++) {
+    code = straggler_code_[i];
+    if (code.IsNull()) {
+      OS::PrintErr("  [%" Pd "] pc 0x%" Px "\n", i, straggler_pcs_[i]);
+    } else {
+      OS::PrintErr("  [%" Pd "] %s+0x%" Px "\n", i,
+                   code.QualifiedName(
+                       NameFormattingParams(Object::kUserVisibleName)),
+                   straggler_pcs_[i] - code.PayloadStart());
+    }
+  }
+}
+
 void SafepointHandler::ExitSafepointLocked(Thread* T, MonitorLocker* tl) {
   while (T->IsSafepointRequestedLocked()) {
     T->SetBlockedForSafepoint(true);
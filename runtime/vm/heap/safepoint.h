@@ -94,6 +94,20 @@ class SafepointHandler {
     return false;
   }
 
+  // Exposed for unit test in safepoint_test.cc: the last thread to check in
+  // for the most recent operation at [level] and the Dart frames recorded for
+  // it.
+  const char* straggler_name(SafepointLevel level) const {
+    return handlers_[level]->straggler_name_;
+  }
+  intptr_t straggler_frame_count(SafepointLevel level) const {
+    return handlers_[level]->straggler_frame_count_;
+  }
+  CodePtr straggler_code(SafepointLevel level, intptr_t index) const {
+    ASSERT((index >= 0) && (index < straggler_frame_count(level)));
+    return handlers_[level]->straggler_code_[index];
+  }
+
  private:
   class LevelHandler {
    public:
@@ -127,10 +141,19 @@ class SafepointHandler {
    private:
     friend class SafepointHandler;
 
+    static constexpr intptr_t kMaxThreadNameLength = 64;
+    static constexpr intptr_t kMaxStragglerFrames = 32;
+
     // Helper methods for [SafepointThreads]
     void NotifyThreadsToGetToSafepointLevel(Thread* T);
     void WaitUntilThreadsReachedSafepointLevel();
 
+    // Records the last thread to check in, and its Dart stack if it was
+    // later than --slow_safepoint_micros. Runs on that thread.
+    void RecordStraggler(Thread* T);
+    // Prints the thread which delayed the current operation the most.
+    void PrintStraggler(Thread* T, int64_t micros);
+
     // Helper methods for [ResumeThreads]
     void NotifyThreadsToContinue(Thread* T);
 
@@ -151,6 +174,19 @@ class SafepointHandler {
     // Count the number of threads the currently in-progress safepoint operation
     // is waiting for to check-in.
     int32_t num_threads_not_parked_ = 0;
+
+    // When the in-progress operation asked threads to check in, and how many
+    // it had to wait for.
+    int64_t request_micros_ = 0;
+    int32_t num_threads_requested_ = 0;
+
+    // The last thread to check in for the in-progress operation. The code
+    // objects are only valid until the operation starts, as they are not
+    // visited by the GC.
+    char straggler_name_[kMaxThreadNameLength] = {};
+    intptr_t straggler_frame_count_ = 0;
+    CodePtr straggler_code_[kMaxStragglerFrames];
+    uword straggler_pcs_[kMaxStragglerFrames];
   };
 
   void SafepointThreads(Thread* T, SafepointLevel level);
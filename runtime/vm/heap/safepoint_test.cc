@@ -10,9 +10,11 @@
 
 #include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
+#include "vm/json_stream.h"
 #include "vm/lockers.h"
 #include "vm/random.h"
 #include "vm/thread_pool.h"
+#include "vm/timeline.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -436,6 +438,198 @@ ISOLATE_UNIT_TEST_CASE(SafepointOperation_SafepointPointTest) {
   }
 }
 
+DECLARE_FLAG(int, slow_safepoint_micros);
+
+class SlowCheckinTask : public StateMachineTask {
+ public:
+  enum State {
+    kStartLoop = StateMachineTask::kNext,
+  };
+
+  static constexpr int64_t kDelayMicros = 20 * 1000;
+
+  explicit SlowCheckinTask(std::shared_ptr<Data> data)
+      : StateMachineTask(std::move(data)) {}
+
+ protected:
+  virtual void RunInternal() {
+    data_->WaitUntil(kStartLoop);
+    while (!thread_->IsSafepointRequested()) {
+      OS::SleepMicros(100);
+    }
+    // Keep the safepoint operation waiting, e.g. like a long loop without
+    // stack overflow checks would.
+    OS::SleepMicros(kDelayMicros);
+    thread_->BlockForSafepoint();
+  }
+};
+
+ISOLATE_UNIT_TEST_CASE(SafepointOperation_TimeToSafepoint) {
+  SetFlagScope<int> sfs(&FLAG_slow_safepoint_micros, 1000);
+  auto isolate_group = thread->isolate_group();
+  HistogramMetric* histogram = isolate_group->GetTimeToSafepointHistogram();
+  Dart_MetricHistogram before;
+  histogram->Read(&before);
+
+  auto data = std::make_shared<StateMachineTask::Data>(isolate_group);
+  {
+    // Will join outstanding threads on destruction.
+    ThreadPool pool;
+    pool.Run<SlowCheckinTask>(data);
+    data->WaitUntil(SlowCheckinTask::kEntered);
+    data->MarkAndNotify(SlowCheckinTask::kStartLoop);
+    { GcSafepointOperationScope safepoint_operation(thread); }
+    data->MarkAndNotify(SlowCheckinTask::kPleaseExit);
+    data->WaitUntil(SlowCheckinTask::kExited);
+  }
+
+  Dart_MetricHistogram after;
+  histogram->Read(&after);
+  EXPECT(after.count > before.count);
+  EXPECT(after.max >= SlowCheckinTask::kDelayMicros);
+}
+
+ISOLATE_UNIT_TEST_CASE(SafepointOperation_Straggler) {
+  SetFlagScope<int> sfs(&FLAG_slow_safepoint_micros, 1000);
+#if !defined(PRODUCT)
+  TimelineStream* stream = Timeline::GetGCStream();
+  const bool stream_was_enabled = stream->enabled();
+  stream->set_enabled(true);
+#endif
+  auto isolate_group = thread->isolate_group();
+  SafepointHandler* handler = isolate_group->safepoint_handler();
+
+  auto data = std::make_shared<StateMachineTask::Data>(isolate_group);
+  {
+    // Will join outstanding threads on destruction.
+    ThreadPool pool;
+    pool.Run<SlowCheckinTask>(data);
+    data->WaitUntil(SlowCheckinTask::kEntered);
+    data->MarkAndNotify(SlowCheckinTask::kStartLoop);
+    {
+      GcSafepointOperationScope safepoint_operation(thread);
+      EXPECT_STREQ("DartWorker (kUnknownTask)",
+                   handler->straggler_name(SafepointLevel::kGC));
+      // The helper has no Dart frames.
+      EXPECT_EQ(0, handler->straggler_frame_count(SafepointLevel::kGC));
+    }
+    data->MarkAndNotify(SlowCheckinTask::kPleaseExit);
+    data->WaitUntil(SlowCheckinTask::kExited);
+  }
+
+#if !defined(PRODUCT)
+  Timeline::ReclaimCachedBlocksFromThreads();
+  JSONStream js;
+  TimelineEventFilter filter;
+  Timeline::recorder()->PrintJSON(&js, &filter);
+  EXPECT_SUBSTRING("\"name\":\"WaitForSafepoint\"", js.ToCString());
+  EXPECT_SUBSTRING(
+      "\"level\":\"GC\",\"threads\":\"1\","
+      "\"lastThread\":\"DartWorker (kUnknownTask)\"",
+      js.ToCString());
+  stream->set_enabled(stream_was_enabled);
+#endif
+}
+
+// Starts a GC safepoint operation while the mutator is in a native called
+// from Dart, and records what the operation knows about the mutator.
+class StragglerOperationTask : public StateMachineTask {
+ public:
+  enum State {
+    kStartSafepointOperation = StateMachineTask::kNext,
+    kEndSafepointOperation,
+  };
+
+  explicit StragglerOperationTask(std::shared_ptr<Data> data)
+      : StateMachineTask(std::move(data)) {}
+
+  static char straggler_name[64];
+  static bool found_main_frame;
+
+ protected:
+  virtual void RunInternal() {
+    data_->WaitUntil(kStartSafepointOperation);
+    {
+      GcSafepointOperationScope safepoint_operation(thread_);
+      // The recorded code objects are only valid inside the operation.
+      SafepointHandler* handler =
+          thread_->isolate_group()->safepoint_handler();
+      Utils::SNPrint(straggler_name, sizeof(straggler_name), "%s",
+                     handler->straggler_name(SafepointLevel::kGC));
+      StackZone zone(thread_);
+      HandleScope handle_scope(thread_);
+      Code& code = Code::Handle(zone.GetZone());
+      const intptr_t count =
+          handler->straggler_frame_count(SafepointLevel::kGC);
+      for (intptr_t i = 0; i < count; i++) {
+        code = handler->straggler_code(SafepointLevel::kGC, i);
+        if (!code.IsNull() &&
+            strstr(code.QualifiedName(
+                       NameFormattingParams(Object::kUserVisibleName)),
+                   "main") != nullptr) {
+          found_main_frame = true;
+        }
+      }
+    }
+    data_->MarkAndNotify(kEndSafepointOperation);
+  }
+};
+
+char StragglerOperationTask::straggler_name[64];
+bool StragglerOperationTask::found_main_frame = false;
+
+static void SlowCheckin(Dart_NativeArguments args) {
+  Thread* thread = Thread::Current();
+  TransitionNativeToVM transition(thread);
+  auto data =
+      std::make_shared<StateMachineTask::Data>(thread->isolate_group());
+  {
+    // Will join outstanding threads on destruction.
+    ThreadPool pool;
+    pool.Run<StragglerOperationTask>(data);
+    data->WaitUntil(StragglerOperationTask::kEntered);
+    data->MarkAndNotify(StragglerOperationTask::kStartSafepointOperation);
+    while (!thread->IsSafepointRequested()) {
+      OS::SleepMicros(100);
+    }
+    OS::SleepMicros(SlowCheckinTask::kDelayMicros);
+    thread->BlockForSafepoint();
+    data->WaitUntil(StragglerOperationTask::kEndSafepointOperation);
+    data->MarkAndNotify(StragglerOperationTask::kPleaseExit);
+    data->WaitUntil(StragglerOperationTask::kExited);
+  }
+}
+
+static Dart_NativeFunction SlowCheckinResolver(Dart_Handle name,
+                                               int argument_count,
+                                               bool* auto_setup_scope) {
+  ASSERT(auto_setup_scope != nullptr);
+  *auto_setup_scope = true;
+  return SlowCheckin;
+}
+
+TEST_CASE(SafepointOperation_StragglerDartFrames) {
+  SetFlagScope<int> sfs(&FLAG_slow_safepoint_micros, 1000);
+  const char* kScriptChars = R"(
+@pragma("vm:external-name", "SlowCheckin")
+external void slowCheckin();
+
+void main() {
+  slowCheckin();
+}
+)";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, SlowCheckinResolver);
+  EXPECT_VALID(lib);
+
+  StragglerOperationTask::straggler_name[0] = '\0';
+  StragglerOperationTask::found_main_frame = false;
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, nullptr);
+  EXPECT_VALID(result);
+
+  EXPECT_SUBSTRING(" (kMutatorTask)", StragglerOperationTask::straggler_name);
+  EXPECT(StragglerOperationTask::found_main_frame);
+}
+
 class StressTask : public StateMachineTask {
  public:
   enum State {
@@ -0,0 +1,162 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(PRODUCT)
+
+#include "vm/heap/sampler.h"
+
+#include <math.h>
+
+#include "platform/atomic.h"
+#include "vm/heap/heap.h"
+#include "vm/isolate.h"
+#include "vm/random.h"
+#include "vm/stack_frame.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            heap_profile_sampling_interval,
+            0,
+            "Record the stack of one allocation for every this many bytes "
+            "allocated on average, and write a heap profile of the sampled "
+            "allocations to --profile_export_dir. 0 disables sampling.");
+
+static RelaxedAtomic<intptr_t> next_sample_id = {1};
+
+intptr_t HeapProfileSampler::NextSamplingInterval() {
+  // Draw from an exponential distribution with the requested mean. The
+  // uniform sample is in (0, 1], so the logarithm is finite.
+  const double uniform =
+      (static_cast<double>(thread_->random()->NextUInt32()) + 1.0) /
+      4294967296.0;
+  const double interval = -log(uniform) * FLAG_heap_profile_sampling_interval;
+  // Keep the interval object aligned, so the TLAB end derived from it is too.
+  return Utils::RoundUp(static_cast<intptr_t>(interval) + 1, kObjectAlignment);
+}
+
+void HeapProfileSampler::UpdateBytesUntilSample() {
+  if (tlab_start_ == 0) {
+    return;
+  }
+  const uword top = thread_->top();
+  // May go past the sampling point when the TLAB is filled for debugging.
+  bytes_until_sample_ =
+      Utils::Maximum<intptr_t>(bytes_until_sample_ - (top - tlab_start_), 0);
+  tlab_start_ = top;
+}
+
+void HeapProfileSampler::UpdateTLABEnd() {
+  const uword top = thread_->top();
+  const uword true_end = thread_->true_end();
+  if (static_cast<uword>(bytes_until_sample_) < true_end - top) {
+    thread_->set_end(top + bytes_until_sample_);
+  } else {
+    thread_->set_end(true_end);
+  }
+}
+
+void HeapProfileSampler::HandleNewTLAB() {
+  ASSERT(tlab_start_ == 0);
+  if (!enabled() || !thread_->IsMutatorThread() || (thread_->top() == 0)) {
+    return;
+  }
+  if (bytes_until_sample_ < 0) {
+    bytes_until_sample_ = NextSamplingInterval();
+  }
+  tlab_start_ = thread_->top();
+  UpdateTLABEnd();
+}
+
+void HeapProfileSampler::HandleReleasedTLAB() {
+  UpdateBytesUntilSample();
+  tlab_start_ = 0;
+}
+
+void HeapProfileSampler::SampleNewSpaceAllocation(intptr_t size) {
+  if (!enabled() || !thread_->IsMutatorThread()) {
+    return;
+  }
+  if (bytes_until_sample_ < 0) {
+    bytes_until_sample_ = NextSamplingInterval();
+  }
+  if (size <= bytes_until_sample_) {
+    // The TLAB was exhausted before the sampling point.
+    return;
+  }
+  // Recorded by Object::Allocate, see HasOutstandingSample.
+  outstanding_sample_ = true;
+  // The allocation is accounted for in the next TLAB, so add it to the
+  // interval to keep it from counting towards the next sample.
+  bytes_until_sample_ = NextSamplingInterval() + size;
+}
+
+void HeapProfileSampler::SampleOldSpaceAllocation(intptr_t size) {
+  ASSERT(enabled());
+  if (!thread_->IsMutatorThread()) {
+    return;
+  }
+  if (bytes_until_sample_ < 0) {
+    bytes_until_sample_ = NextSamplingInterval();
+  }
+  UpdateBytesUntilSample();
+  if (size > bytes_until_sample_) {
+    outstanding_sample_ = true;
+    bytes_until_sample_ = NextSamplingInterval();
+  } else {
+    bytes_until_sample_ -= size;
+  }
+  if (tlab_start_ != 0) {
+    UpdateTLABEnd();
+  }
+}
+
+void HeapProfileSampler::RecordSample(ObjectPtr object, intptr_t size) {
+  ASSERT(outstanding_sample_);
+  outstanding_sample_ = false;
+  Isolate* isolate = thread_->isolate();
+  ASSERT(isolate != nullptr);
+  if (Isolate::IsSystemIsolate(isolate)) {
+    // Profiles are only written for user isolates.
+    return;
+  }
+
+  HeapSample* sample =
+      reinterpret_cast<HeapSample*>(malloc(sizeof(HeapSample)));
+  if (sample == nullptr) {
+    return;
+  }
+  sample->id = next_sample_id.fetch_add(1);
+  sample->cid = object->GetClassId();
+  sample->size = size;
+  sample->stack = -1;
+  sample->reported = false;
+  sample->live = true;
+  sample->length = 0;
+  // Only return addresses are recorded here, as symbolizing them could
+  // allocate. They are resolved when the heap profile is written.
+  DartFrameIterator frames(thread_,
+                           StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = frames.NextFrame();
+       (frame != nullptr) && (sample->length < HeapSample::kMaxFrames);
+       frame = frames.NextFrame()) {
+    sample->pcs[sample->length++] = frame->pc();
+  }
+
+  // The list is only consumed at a safepoint, and this runs in a
+  // NoSafepointScope together with the allocation.
+  sample->next = isolate->heap_samples();
+  isolate->set_heap_samples(sample);
+  thread_->heap()->SetHeapSampleId(object, sample->id);
+  // Samples are rare, so this is a cheap place to check whether the profile
+  // is due. It is written when the mutator handles the interrupt.
+  if (isolate->IsHeapProfileFlushDue()) {
+    thread_->ScheduleInterrupts(Thread::kVMInterrupt);
+  }
+}
+
+}  // namespace dart
+
+#endif  // !defined(PRODUCT)
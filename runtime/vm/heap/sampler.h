@@ -0,0 +1,114 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_SAMPLER_H_
+#define RUNTIME_VM_HEAP_SAMPLER_H_
+
+#if !defined(PRODUCT)
+
+#include "vm/flags.h"
+#include "vm/globals.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class Thread;
+
+DECLARE_FLAG(int, heap_profile_sampling_interval);
+DECLARE_FLAG(charp, profile_export_dir);
+
+// A sampled allocation, owned by the isolate which allocated it. While the
+// sampled object is alive, the Heap::kHeapSamples weak table maps it to the
+// id of its sample, so liveness is maintained by the GC and samples never
+// have to be updated when objects move or die.
+struct HeapSample {
+  static constexpr intptr_t kMaxFrames = 64;
+
+  HeapSample* next;
+  // Unique across isolates, so stale weak table entries of other isolates
+  // can never match a sample.
+  intptr_t id;
+  intptr_t cid;
+  intptr_t size;
+  // Index of the symbolized stack in the heap profile, or -1.
+  intptr_t stack;
+  // Whether the allocation has been reported in a profile.
+  bool reported;
+  // Whether the object was alive when the profile was last updated.
+  bool live;
+  // Return addresses of the Dart frames of the allocation, innermost first.
+  intptr_t length;
+  uword pcs[kMaxFrames];
+};
+
+// Samples the allocations of a mutator thread, on average once every
+// --heap_profile_sampling_interval bytes. The distances between samples are
+// drawn from an exponential distribution, so every allocated byte is equally
+// likely to be sampled and the allocation size can be used to unbias the
+// samples (as in tcmalloc).
+//
+// New-space allocations are sampled without adding work to the allocation
+// fast path: while sampling, Thread::end() is moved down to the next sampling
+// point, so the allocation crossing it fails the inline bump allocation in
+// generated code and in Scavenger::TryAllocateFromTLAB and reaches
+// Scavenger::TryAllocateNewTLAB, which picks it as the sample. The actual end
+// of the TLAB is kept in Thread::true_end().
+class HeapProfileSampler {
+ public:
+  explicit HeapProfileSampler(Thread* thread) : thread_(thread) {}
+
+  // Samples are only taken when there is somewhere to export them to.
+  static bool enabled() {
+    return (FLAG_heap_profile_sampling_interval > 0) &&
+           (FLAG_profile_export_dir != nullptr);
+  }
+
+  // Called after the thread acquired a TLAB.
+  void HandleNewTLAB();
+  // Called before the thread releases its TLAB.
+  void HandleReleasedTLAB();
+
+  // Called when an allocation of |size| bytes didn't fit into the TLAB,
+  // after the TLAB was released.
+  void SampleNewSpaceAllocation(intptr_t size);
+  // Called for allocations of |size| bytes which bypassed the TLAB.
+  void SampleOldSpaceAllocation(intptr_t size);
+
+  // Whether the next object allocated should be recorded.
+  //
+  // Only Object::Allocate records samples. If the allocation which picked the
+  // sample was made by another path (e.g. the object graph copy allocating
+  // from the TLAB directly), the sample is attributed to the next object
+  // allocated by Object::Allocate instead, with that object's class, size and
+  // stack. Such paths are rare enough that this doesn't skew profiles much.
+  bool HasOutstandingSample() const { return outstanding_sample_; }
+
+  // Records the stack of the allocation of |object| in its isolate and
+  // registers the object in the Heap::kHeapSamples weak table.
+  void RecordSample(ObjectPtr object, intptr_t size);
+
+ private:
+  intptr_t NextSamplingInterval();
+  // Accounts for the bytes allocated in the TLAB so far.
+  void UpdateBytesUntilSample();
+  // Moves the end of the TLAB to the next sampling point.
+  void UpdateTLABEnd();
+
+  Thread* const thread_;
+  // The position in the TLAB up to which allocations have been accounted
+  // for, or 0 if the thread has no TLAB or isn't sampling.
+  uword tlab_start_ = 0;
+  // Bytes to allocate before the next sample, or -1 before the first
+  // interval has been drawn.
+  intptr_t bytes_until_sample_ = -1;
+  bool outstanding_sample_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapProfileSampler);
+};
+
+}  // namespace dart
+
+#endif  // !defined(PRODUCT)
+
+#endif  // RUNTIME_VM_HEAP_SAMPLER_H_
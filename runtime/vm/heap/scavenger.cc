@@ -1678,6 +1678,11 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread,
   ASSERT(!scavenging_);
 
   AbandonRemainingTLAB(thread);
+#if !defined(PRODUCT)
+  // Allocations which don't fit below a lowered TLAB end end up here, so
+  // this is where new-space allocations are picked for heap sampling.
+  thread->heap_sampler().SampleNewSpaceAllocation(min_size);
+#endif
 
   if (can_safepoint && !thread->force_growth()) {
     ASSERT(thread->no_safepoint_scope_depth() == 0);
@@ -1705,7 +1710,7 @@ void Scavenger::AbandonRemainingTLABForDebugging(Thread* thread) {
   // Allocate any remaining space so the TLAB won't be reused. Write a filler
   // object so it remains iterable.
   uword top = thread->top();
-  intptr_t size = thread->end() - thread->top();
+  intptr_t size = thread->true_end() - thread->top();
   if (size > 0) {
     thread->set_top(top + size);
     ForwardingCorpse::AsForwarder(top, size);
@@ -109,9 +109,17 @@ class NewPage {
     owner_ = thread;
     thread->set_top(top_);
     thread->set_end(end_);
+#if !defined(PRODUCT)
+    thread->set_true_end(end_);
+    thread->heap_sampler().HandleNewTLAB();
+#endif
   }
   void Release(Thread* thread) {
     ASSERT(owner_ == thread);
+#if !defined(PRODUCT)
+    thread->heap_sampler().HandleReleasedTLAB();
+    thread->set_true_end(0);
+#endif
     owner_ = nullptr;
     top_ = thread->top();
     thread->set_top(0);
@@ -249,6 +257,8 @@ class ScavengeStats {
   }
 
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
+  intptr_t UsedAfterInWords() const { return after_.used_in_words; }
+  intptr_t PromotedInWords() const { return promoted_in_words_; }
 
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
 
@@ -331,6 +341,10 @@ class Scavenger {
 
   intptr_t collections() const { return collections_; }
 
+  // Statistics of the most recent scavenge. Requires a scavenge to have
+  // happened.
+  const ScavengeStats& last_stats() const { return stats_history_.Get(0); }
+
 #ifndef PRODUCT
   void PrintToJSONObject(JSONObject* object) const;
 #endif  // !PRODUCT
@@ -49,6 +49,7 @@ class WeakTable {
   intptr_t size() const { return size_; }
   intptr_t used() const { return used_; }
   intptr_t count() const { return count_; }
+  intptr_t SizeInBytes() const { return size_ * kEntrySize * kWordSize; }
 
   // The following methods can be called concurrently and are guarded by a lock.
 
@@ -26,6 +26,7 @@
 #include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
 #include "vm/image_snapshot.h"
+#include "vm/isolate_pool.h"
 #include "vm/isolate_reload.h"
 #include "vm/kernel_isolate.h"
 #include "vm/lockers.h"
@@ -38,6 +39,7 @@
 #include "vm/os_thread.h"
 #include "vm/port.h"
 #include "vm/profiler.h"
+#include "vm/profiler_pprof.h"
 #include "vm/reusable_handles.h"
 #include "vm/reverse_pc_lookup_cache.h"
 #include "vm/service.h"
@@ -62,6 +64,7 @@
 namespace dart {
 
 DECLARE_FLAG(bool, print_metrics);
+DECLARE_FLAG(charp, profile_export_dir);
 DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, trace_shutdown);
 DECLARE_FLAG(bool, warn_on_pause_with_no_debugger);
@@ -396,6 +399,7 @@ IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
         new MutatorThreadPool(this, FLAG_disable_thread_pool_limit
                                         ? 0
                                         : Scavenger::MaxMutatorThreadCount()));
+    isolate_pool_.reset(new IsolatePool(this));
   }
   {
     WriteRwLocker wl(ThreadState::Current(), isolate_groups_rwlock_);
@@ -483,6 +487,10 @@ void IsolateGroup::CreateHeap(bool is_vm_isolate,
   metric_##variable##_.InitInstance(this, name, nullptr, Metric::unit);
   ISOLATE_GROUP_METRIC_LIST(ISOLATE_GROUP_METRIC_CONSTRUCTORS)
 #undef ISOLATE_GROUP_METRIC_CONSTRUCTORS
+#define ISOLATE_GROUP_HISTOGRAM_CONSTRUCTORS(variable, name)                   \
+  histogram_##variable##_.InitInstance(this, name);
+  ISOLATE_GROUP_HISTOGRAM_LIST(ISOLATE_GROUP_HISTOGRAM_CONSTRUCTORS)
+#undef ISOLATE_GROUP_HISTOGRAM_CONSTRUCTORS
 }
 
 void IsolateGroup::Shutdown() {
@@ -507,6 +515,8 @@ void IsolateGroup::Shutdown() {
     ASSERT(thread_pool_ != nullptr);
     thread_pool_->Shutdown();
     thread_pool_.reset();
+    // Pooled isolates are refilled on the thread pool.
+    isolate_pool_.reset();
   }
 
   // Wait for any pending GC tasks.
@@ -667,6 +677,14 @@ void IsolateGroup::UnscheduleThreadLocked(MonitorLocker* ml,
   os_thread->set_thread(nullptr);
   OSThread::SetCurrent(os_thread);
 
+#if !defined(PRODUCT)
+  // With interrupts disabled the profiler can no longer reserve a block for
+  // this thread, so hand the current one to its isolate. Helper thread
+  // structures are reused for other isolates and the mutator might not be
+  // scheduled again before its isolate is deleted.
+  thread->ReleaseSampleBlock();
+#endif
+
   // Even if we unschedule the mutator thread, e.g. via calling
   // `Dart_ExitIsolate()` inside a native, we might still have one or more Dart
   // stacks active, which e.g. GC marker threads want to visit.  So we don't
@@ -935,12 +953,21 @@ void IsolateGroup::RegisterStaticField(const Field& field,
   ASSERT(program_lock()->IsCurrentThreadWriter());
 
   ASSERT(field.is_static());
-  const bool need_to_grow_backing_store =
-      initial_field_table()->Register(field);
+  bool need_to_grow_backing_store = initial_field_table()->Register(field);
   const intptr_t field_id = field.field_id();
   initial_field_table()->SetAt(field_id, initial_value.ptr());
 
   SafepointReadRwLocker ml(Thread::Current(), isolates_lock_.get());
+  // Isolates only copy the used part of the initial field table (see
+  // FieldTable::Clone), so their tables can be full even if the initial
+  // table still had room.
+  for (auto isolate : isolates_) {
+    auto field_table = isolate->field_table();
+    if (field_table->IsReadyToUse() && field_table->NeedsToGrowForRegister()) {
+      need_to_grow_backing_store = true;
+      break;
+    }
+  }
   if (need_to_grow_backing_store) {
     // We have to stop other isolates from accessing their field state, since
     // we'll have to grow the backing store.
@@ -1058,6 +1085,8 @@ class IsolateMessageHandler : public MessageHandler {
   const char* name() const;
   void MessageNotify(Message::Priority priority);
   MessageStatus HandleMessage(std::unique_ptr<Message> message);
+  bool IsBatchableMessage(const Message& message) const;
+  MessageStatus HandleMessageBatch(std::unique_ptr<Message> message);
 #ifndef PRODUCT
   void NotifyPauseOnStart();
   void NotifyPauseOnExit();
@@ -1437,6 +1466,49 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
   return status;
 }
 
+bool IsolateMessageHandler::IsBatchableMessage(const Message& message) const {
+  // Only messages for receive ports are dispatched through
+  // [DartLibraryCalls::HandleMessages].
+  return (message.priority() == Message::kNormalPriority) &&
+         !message.IsFinalizerInvocationRequest() &&
+         (message.dest_port() != Message::kIllegalPort);
+}
+
+MessageHandler::MessageStatus IsolateMessageHandler::HandleMessageBatch(
+    std::unique_ptr<Message> message) {
+  ASSERT(IsCurrentIsolate());
+  ASSERT(IsBatchableMessage(*message));
+  Thread* thread = Thread::Current();
+  StackZone stack_zone(thread);
+  Zone* zone = stack_zone.GetZone();
+  HandleScope handle_scope(thread);
+#if defined(SUPPORT_TIMELINE)
+  TimelineBeginEndScope tbes(thread, Timeline::GetIsolateStream(),
+                             "HandleMessages");
+  tbes.SetNumArguments(1);
+  tbes.CopyArgument(0, "isolateName", I->name());
+#endif
+
+  // Only the first message is parsed here, the Dart handler parses the
+  // remaining ones as it dequeues them (see
+  // RawReceivePortImpl_nextBatchMessage).
+  const Object& msg_obj =
+      Object::Handle(zone, ReadMessage(thread, message.get()));
+  if (msg_obj.IsError()) {
+    return ProcessUnhandledException(Error::Cast(msg_obj));
+  }
+  ASSERT(msg_obj.IsNull() || msg_obj.IsInstance());
+  Instance& msg = Instance::Handle(zone);
+  msg ^= msg_obj.ptr();  // Can't use Instance::Cast because may be null.
+
+  const Object& result = Object::Handle(
+      zone, DartLibraryCalls::HandleMessages(message->dest_port(), msg));
+  if (result.IsError()) {
+    return ProcessUnhandledException(Error::Cast(result));
+  }
+  return kOK;
+}
+
 #ifndef PRODUCT
 void IsolateMessageHandler::NotifyPauseOnStart() {
   if (Isolate::IsSystemIsolate(I)) {
@@ -1729,8 +1801,6 @@ Isolate::Isolate(IsolateGroup* isolate_group,
       tag_table_(GrowableObjectArray::null()),
       sticky_error_(Error::null()),
       spawn_count_monitor_(),
-      handler_info_cache_(),
-      catch_entry_moves_cache_(),
       wake_pause_event_handler_count_(0),
       loaded_prefixes_set_storage_(nullptr) {
   FlagsCopyFrom(api_flags);
@@ -1757,6 +1827,18 @@ Isolate::~Isolate() {
   object_id_ring_ = nullptr;
   delete pause_loop_monitor_;
   pause_loop_monitor_ = nullptr;
+  {
+    MutexLocker ml(&pprof_exporter_mutex_);
+    delete pprof_exporter_;
+    pprof_exporter_ = nullptr;
+  }
+  delete heap_profile_exporter_;
+  heap_profile_exporter_ = nullptr;
+  while (heap_samples_ != nullptr) {
+    HeapSample* next = heap_samples_->next;
+    free(heap_samples_);
+    heap_samples_ = next;
+  }
 #endif  // !defined(PRODUCT)
 
   free(name_);
@@ -1771,6 +1853,21 @@ Isolate::~Isolate() {
          nullptr);  // No deopt in progress when isolate deleted.
   ASSERT(spawn_count_ == 0);
 
+#if !defined(PRODUCT)
+  // Blocks released after the last processing pass, e.g. the one of the
+  // mutator when it exited the isolate, are returned unprocessed.
+  ASSERT(mutator_thread_->current_sample_block() == nullptr);
+  SampleBlockBuffer* sample_block_buffer = Profiler::sample_block_buffer();
+  SampleBlock* block = free_block_list_.exchange(nullptr);
+  while ((block != nullptr) && (sample_block_buffer != nullptr)) {
+    SampleBlock* next = block->next_free_;
+    block->next_free_ = nullptr;
+    block->evictable_ = true;
+    sample_block_buffer->FreeBlock(block);
+    block = next;
+  }
+#endif  // !defined(PRODUCT)
+
   // We have cached the mutator thread, delete it.
   ASSERT(scheduled_mutator_thread_ == nullptr);
   mutator_thread_->isolate_ = nullptr;
@@ -1797,7 +1894,18 @@ Isolate* Isolate::InitIsolate(const char* name_prefix,
                               IsolateGroup* isolate_group,
                               const Dart_IsolateFlags& api_flags,
                               bool is_vm_isolate) {
-  Isolate* result = new Isolate(isolate_group, api_flags);
+  IsolatePool* pool = isolate_group->isolate_pool();
+  Isolate* result = (pool != nullptr) ? pool->Take() : nullptr;
+  if (result != nullptr) {
+    // Allocated ahead of time with the flags of the group.
+    result->FlagsCopyFrom(api_flags);
+    result->start_time_micros_ = OS::GetCurrentMonotonicMicros();
+#if !defined(PRODUCT)
+    result->set_last_resume_timestamp();
+#endif
+  } else {
+    result = new Isolate(isolate_group, api_flags);
+  }
   result->BuildName(name_prefix);
   if (!is_vm_isolate) {
     // vm isolate object store is initialized later, after null instance
@@ -1864,6 +1972,15 @@ Isolate* Isolate::InitIsolate(const char* name_prefix,
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
   }
 
+#if !defined(PRODUCT)
+  // Created before the isolate starts running, so that it is never created
+  // while the sample block processor is using it.
+  if ((FLAG_profile_export_dir != nullptr) && !IsSystemIsolate(result)) {
+    MutexLocker ml(&result->pprof_exporter_mutex_);
+    result->pprof_exporter_ = new PprofExporter(result);
+  }
+#endif  // !defined(PRODUCT)
+
   if (FLAG_trace_isolates) {
     if (name_prefix == nullptr || strcmp(name_prefix, "vm-isolate") != 0) {
       OS::PrintErr(
@@ -1883,6 +2000,16 @@ Isolate* Isolate::InitIsolate(const char* name_prefix,
   return result;
 }
 
+Isolate* Isolate::AllocateForPool(IsolateGroup* isolate_group) {
+  Isolate* isolate = new Isolate(isolate_group, isolate_group->source()->flags);
+  // Otherwise created when the isolate is first entered, see
+  // [Isolate::ScheduleThread].
+  Thread* thread = new Thread(/*is_vm_isolate=*/false);
+  thread->is_mutator_thread_ = true;
+  isolate->mutator_thread_ = thread;
+  return isolate;
+}
+
 Thread* Isolate::mutator_thread() const {
   ASSERT(thread_registry() != nullptr);
   return mutator_thread_;
@@ -2374,15 +2501,6 @@ void Isolate::Run() {
 }
 
 #if !defined(PRODUCT)
-void Isolate::set_current_sample_block(SampleBlock* current) {
-  ASSERT(current_sample_block_lock_.IsOwnedByCurrentThread());
-  if (current != nullptr) {
-    current->set_is_allocation_block(false);
-    current->set_owner(this);
-  }
-  current_sample_block_ = current;
-}
-
 void Isolate::set_current_allocation_sample_block(SampleBlock* current) {
   if (current != nullptr) {
     current->set_is_allocation_block(true);
@@ -2417,10 +2535,53 @@ class StreamableSampleFilter : public SampleFilter {
   }
 };
 
+class CpuSampleFilter : public SampleFilter {
+ public:
+  explicit CpuSampleFilter(Dart_Port port)
+      : SampleFilter(port, kNoTaskFilter, -1, -1) {}
+
+  bool FilterSample(Sample* sample) override {
+    return !sample->is_allocation_sample();
+  }
+};
+
+bool Isolate::should_process_blocks() const {
+  if (free_block_list_.load(std::memory_order_relaxed) != nullptr) {
+    return true;
+  }
+  MutexLocker ml(&pprof_exporter_mutex_);
+  return (pprof_exporter_ != nullptr) && pprof_exporter_->IsFlushDue();
+}
+
+bool Isolate::IsHeapProfileFlushDue() const {
+  if (heap_profile_exporter_ == nullptr) {
+    // The exporter is created by the first flush after sampling started.
+    return heap_samples_ != nullptr;
+  }
+  return heap_profile_exporter_->IsFlushDue();
+}
+
+void Isolate::FlushHeapProfile(bool force) {
+  if (IsSystemIsolate(this) || (FLAG_profile_export_dir == nullptr)) {
+    return;
+  }
+  if (heap_profile_exporter_ == nullptr) {
+    if (heap_samples_ == nullptr) {
+      return;
+    }
+    heap_profile_exporter_ = new HeapProfileExporter(this);
+  }
+  heap_profile_exporter_->Flush(force);
+}
+
 void Isolate::ProcessFreeSampleBlocks(Thread* thread) {
   SampleBlock* head = free_block_list_.exchange(nullptr);
   if (head == nullptr) {
     // No sample blocks to process.
+    SafepointMutexLocker ml(thread, &pprof_exporter_mutex_);
+    if (pprof_exporter_ != nullptr) {
+      pprof_exporter_->Flush(/*force=*/false);
+    }
     return;
   }
   // Reverse the list before processing so older blocks are streamed and reused
@@ -2452,6 +2613,23 @@ void Isolate::ProcessFreeSampleBlocks(Thread* thread) {
       Service::HandleEvent(&event);
     }
   }
+  {
+    // Both the mutator and the sample block processor process blocks.
+    SafepointMutexLocker ml(thread, &pprof_exporter_mutex_);
+    if (pprof_exporter_ != nullptr) {
+      // Only the blocks completed since the last export are processed here,
+      // so the cost of exporting is proportional to the number of new
+      // samples.
+      StackZone zone(thread);
+      HandleScope handle_scope(thread);
+      SampleBlockListProcessor buffer(head);
+      CpuSampleFilter filter(main_port());
+      Profile profile;
+      profile.Build(thread, &filter, &buffer);
+      pprof_exporter_->AddProfile(&profile);
+      pprof_exporter_->Flush(/*force=*/false);
+    }
+  }
 
   do {
     SampleBlock* next = head->next_free_;
@@ -2559,6 +2737,10 @@ void Isolate::LowLevelShutdown() {
   OS::PrintErr("%s\n", isolate_group_->Get##variable##Metric()->ToString());
     ISOLATE_GROUP_METRIC_LIST(ISOLATE_GROUP_METRIC_PRINT)
 #undef ISOLATE_GROUP_METRIC_PRINT
+#define ISOLATE_GROUP_HISTOGRAM_PRINT(variable, name)                          \
+  OS::PrintErr("%s\n", isolate_group_->Get##variable##Histogram()->ToString());
+    ISOLATE_GROUP_HISTOGRAM_LIST(ISOLATE_GROUP_HISTOGRAM_PRINT)
+#undef ISOLATE_GROUP_HISTOGRAM_PRINT
 #define ISOLATE_METRIC_PRINT(type, variable, name, unit)                       \
   OS::PrintErr("%s\n", metric_##variable##_.ToString());
     ISOLATE_METRIC_LIST(ISOLATE_METRIC_PRINT)
@@ -2585,6 +2767,15 @@ void IsolateGroup::MaybeIncreaseReloadEveryNStackOverflowChecks() {
 }
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
+void Isolate::ClearHandlerCaches() {
+  if (handler_info_cache_ != nullptr) {
+    handler_info_cache_->Clear();
+  }
+  if (catch_entry_moves_cache_ != nullptr) {
+    catch_entry_moves_cache_->Clear();
+  }
+}
+
 void Isolate::set_forward_table_new(WeakTable* table) {
   std::unique_ptr<WeakTable> value(table);
   forward_table_new_ = std::move(value);
@@ -2607,14 +2798,16 @@ void Isolate::Shutdown() {
     ServiceIsolate::SendIsolateShutdownMessage();
 #if !defined(PRODUCT)
     debugger()->Shutdown();
-    // Cleanup profiler state.
-    SampleBlock* cpu_block = current_sample_block();
-    if (cpu_block != nullptr) {
-      cpu_block->release_block();
-    }
+    // Cleanup profiler state. Interrupts are still enabled, so the mutator
+    // might reserve another block before it exits the isolate, which releases
+    // it again (see IsolateGroup::UnscheduleThreadLocked).
+    SampleBlock* cpu_block = thread->current_sample_block();
+    thread->ReleaseSampleBlock();
     SampleBlock* allocation_block = current_allocation_sample_block();
     if (allocation_block != nullptr) {
       allocation_block->release_block();
+      set_current_allocation_sample_block(nullptr);
+      FreeSampleBlock(allocation_block);
     }
 
     // Process the previously assigned sample blocks if we're using the
@@ -2626,6 +2819,13 @@ void Isolate::Shutdown() {
       HandleScope handle_scope(thread);
       Profiler::sample_block_buffer()->ProcessCompletedBlocks();
     }
+    {
+      SafepointMutexLocker ml(thread, &pprof_exporter_mutex_);
+      if (pprof_exporter_ != nullptr) {
+        pprof_exporter_->Flush(/*force=*/true);
+      }
+    }
+    FlushHeapProfile(/*force=*/true);
 #endif
   }
 
@@ -3274,6 +3474,69 @@ void Isolate::PrintMemoryUsageJSON(JSONStream* stream) {
   group()->heap()->PrintMemoryUsageJSON(stream);
 }
 
+void Isolate::PrintMemoryBreakdownJSON(JSONStream* stream) {
+  intptr_t queued_messages = 0;
+  intptr_t queued_message_bytes = 0;
+  {
+    MessageHandler::AcquiredQueues aq(message_handler());
+    MessageQueue* queues[] = {aq.queue(), aq.oob_queue()};
+    for (MessageQueue* queue : queues) {
+      MessageQueue::Iterator it(queue);
+      while (it.HasNext()) {
+        Message* message = it.Next();
+        queued_messages++;
+        queued_message_bytes += sizeof(Message) + message->Size();
+      }
+    }
+  }
+
+  const intptr_t isolate_bytes = sizeof(Isolate);
+  const intptr_t mutator_thread_bytes =
+      mutator_thread_ != nullptr ? sizeof(Thread) : 0;
+  const intptr_t field_table_bytes = field_table_->Capacity() * kWordSize;
+  const intptr_t message_handler_bytes = sizeof(IsolateMessageHandler);
+  const intptr_t handler_caches_bytes =
+      (handler_info_cache_ != nullptr ? sizeof(HandlerInfoCache) : 0) +
+      (catch_entry_moves_cache_ != nullptr ? sizeof(CatchEntryMovesCache)
+                                           : 0);
+  intptr_t forward_tables_bytes = 0;
+  if (forward_table_new_ != nullptr) {
+    forward_tables_bytes += forward_table_new_->SizeInBytes();
+  }
+  if (forward_table_old_ != nullptr) {
+    forward_tables_bytes += forward_table_old_->SizeInBytes();
+  }
+  const intptr_t regexp_stack_bytes =
+      regexp_backtracking_stack_cache_ != nullptr
+          ? regexp_backtracking_stack_cache_->size()
+          : 0;
+  const intptr_t debugger_bytes = debugger_ != nullptr ? sizeof(Debugger) : 0;
+  const intptr_t object_id_ring_bytes =
+      object_id_ring_ != nullptr ? object_id_ring_->capacity() * kWordSize
+                                 : 0;
+
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_IsolateMemoryBreakdown");
+  jsobj.AddProperty64("isolate", isolate_bytes);
+  jsobj.AddProperty64("mutatorThread", mutator_thread_bytes);
+  jsobj.AddProperty64("fieldTable", field_table_bytes);
+  jsobj.AddProperty64("fieldTableLength", field_table_->NumFieldIds());
+  jsobj.AddProperty64("messageHandler", message_handler_bytes);
+  jsobj.AddProperty64("queuedMessages", queued_message_bytes);
+  jsobj.AddProperty64("queuedMessageCount", queued_messages);
+  jsobj.AddProperty64("exceptionHandlerCaches", handler_caches_bytes);
+  jsobj.AddProperty64("forwardTables", forward_tables_bytes);
+  jsobj.AddProperty64("regexpBacktrackingStack", regexp_stack_bytes);
+  jsobj.AddProperty64("debugger", debugger_bytes);
+  jsobj.AddProperty64("objectIdRing", object_id_ring_bytes);
+  jsobj.AddProperty64(
+      "total", isolate_bytes + mutator_thread_bytes + field_table_bytes +
+                   message_handler_bytes + queued_message_bytes +
+                   handler_caches_bytes + forward_tables_bytes +
+                   regexp_stack_bytes + debugger_bytes +
+                   object_id_ring_bytes);
+}
+
 #endif
 
 void Isolate::set_tag_table(const GrowableObjectArray& value) {
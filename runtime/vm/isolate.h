@@ -56,8 +56,11 @@ class GroupDebugger;
 class HandleScope;
 class HandleVisitor;
 class Heap;
+class HeapProfileExporter;
+struct HeapSample;
 class ICData;
 class IsolateObjectStore;
+class IsolatePool;
 class IsolateProfilerData;
 class ProgramReloadContext;
 class ReloadHandler;
@@ -71,6 +74,7 @@ class ObjectIdRing;
 class ObjectPointerVisitor;
 class ObjectStore;
 class PersistentHandle;
+class PprofExporter;
 class RwLock;
 class SafepointRwLock;
 class SafepointHandler;
@@ -357,6 +361,13 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   ISOLATE_GROUP_METRIC_LIST(ISOLATE_METRIC_ACCESSOR);
 #undef ISOLATE_METRIC_ACCESSOR
 
+#define ISOLATE_GROUP_HISTOGRAM_ACCESSOR(variable, name)                       \
+  HistogramMetric* Get##variable##Histogram() {                                \
+    return &histogram_##variable##_;                                           \
+  }
+  ISOLATE_GROUP_HISTOGRAM_LIST(ISOLATE_GROUP_HISTOGRAM_ACCESSOR);
+#undef ISOLATE_GROUP_HISTOGRAM_ACCESSOR
+
 #if !defined(PRODUCT)
   void UpdateLastAllocationProfileAccumulatorResetTimestamp() {
     last_allocationprofile_accumulator_reset_timestamp_ =
@@ -781,6 +792,7 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   }
 
   MutatorThreadPool* thread_pool() { return thread_pool_.get(); }
+  IsolatePool* isolate_pool() { return isolate_pool_.get(); }
 
   void RegisterClass(const Class& cls);
   void RegisterStaticField(const Field& field, const Object& initial_value);
@@ -836,6 +848,7 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
   IdleTimeHandler idle_time_handler_;
   std::unique_ptr<MutatorThreadPool> thread_pool_;
+  std::unique_ptr<IsolatePool> isolate_pool_;
   std::unique_ptr<SafepointRwLock> isolates_lock_;
   IntrusiveDList<Isolate> isolates_;
   intptr_t isolate_count_ = 0;
@@ -860,6 +873,11 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   ISOLATE_GROUP_METRIC_LIST(ISOLATE_METRIC_VARIABLE);
 #undef ISOLATE_METRIC_VARIABLE
 
+#define ISOLATE_GROUP_HISTOGRAM_VARIABLE(variable, name)                       \
+  HistogramMetric histogram_##variable##_;
+  ISOLATE_GROUP_HISTOGRAM_LIST(ISOLATE_GROUP_HISTOGRAM_VARIABLE);
+#undef ISOLATE_GROUP_HISTOGRAM_VARIABLE
+
 #if !defined(PRODUCT)
   // Timestamps of last operation via service.
   int64_t last_allocationprofile_accumulator_reset_timestamp_ = 0;
@@ -1116,23 +1134,13 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
 #if !defined(PRODUCT)
   Debugger* debugger() const { return debugger_; }
 
-  // NOTE: this lock should only be acquired within the profiler signal handler.
-  Mutex* current_sample_block_lock() const {
-    return const_cast<Mutex*>(&current_sample_block_lock_);
-  }
-
-  // Returns the current SampleBlock used to track CPU profiling samples.
-  //
-  // NOTE: current_sample_block_lock() should be held when accessing this
-  // block.
-  SampleBlock* current_sample_block() const { return current_sample_block_; }
-  void set_current_sample_block(SampleBlock* current);
-
+  // CPU profiling samples are tracked in per-thread SampleBlocks, see
+  // Thread::current_sample_block(). Full blocks are handed back to the
+  // isolate which owns them for processing.
   void FreeSampleBlock(SampleBlock* block);
   void ProcessFreeSampleBlocks(Thread* thread);
-  bool should_process_blocks() const {
-    return free_block_list_.load(std::memory_order_relaxed) != nullptr;
-  }
+  // Whether there are full blocks to process or profile samples to export.
+  bool should_process_blocks() const;
   std::atomic<SampleBlock*> free_block_list_ = nullptr;
 
   // Returns the current SampleBlock used to track Dart allocation samples.
@@ -1144,6 +1152,16 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   }
   void set_current_allocation_sample_block(SampleBlock* current);
 
+  // Allocations sampled by the heap profiler which haven't been taken by the
+  // HeapProfileExporter yet. Only accessed by the mutator while allocating and
+  // at safepoints.
+  HeapSample* heap_samples() const { return heap_samples_; }
+  void set_heap_samples(HeapSample* samples) { heap_samples_ = samples; }
+  // Whether the sampled allocations should be written to
+  // --profile_export_dir. The mutator checks this when handling interrupts.
+  bool IsHeapProfileFlushDue() const;
+  void FlushHeapProfile(bool force);
+
   void set_single_step(bool value) { single_step_ = value; }
   bool single_step() const { return single_step_; }
   static intptr_t single_step_offset() {
@@ -1294,6 +1312,10 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   // Creates an object with the total heap memory usage statistics for this
   // isolate.
   void PrintMemoryUsageJSON(JSONStream* stream);
+
+  // Creates an object with the malloc-ed memory held by this isolate's
+  // own (non-heap) data structures.
+  void PrintMemoryBreakdownJSON(JSONStream* stream);
 #endif
 
 #if !defined(PRODUCT)
@@ -1448,12 +1470,25 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   }
   static bool IsVMInternalIsolate(const Isolate* isolate);
 
-  HandlerInfoCache* handler_info_cache() { return &handler_info_cache_; }
+  // The exception handler caches are only allocated once the isolate throws,
+  // which most isolates never do. Only called by the mutator.
+  HandlerInfoCache* handler_info_cache() {
+    if (handler_info_cache_ == nullptr) {
+      handler_info_cache_.reset(new HandlerInfoCache());
+    }
+    return handler_info_cache_.get();
+  }
 
   CatchEntryMovesCache* catch_entry_moves_cache() {
-    return &catch_entry_moves_cache_;
+    if (catch_entry_moves_cache_ == nullptr) {
+      catch_entry_moves_cache_.reset(new CatchEntryMovesCache());
+    }
+    return catch_entry_moves_cache_.get();
   }
 
+  // Clears the exception handler caches, if they were allocated.
+  void ClearHandlerCaches();
+
   // The weak table used in the snapshot writer for the purpose of fast message
   // sending.
   WeakTable* forward_table_new() { return forward_table_new_.get(); }
@@ -1484,12 +1519,17 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
  private:
   friend class Dart;                  // Init, InitOnce, Shutdown.
   friend class IsolateKillerVisitor;  // Kill().
+  friend class IsolatePool;           // AllocateForPool().
   friend Isolate* CreateWithinExistingIsolateGroup(IsolateGroup* g,
                                                    const char* n,
                                                    char** e);
 
   Isolate(IsolateGroup* group, const Dart_IsolateFlags& api_flags);
 
+  // Allocates an isolate of [isolate_group] and its mutator thread structure
+  // without entering or registering either, see [IsolatePool].
+  static Isolate* AllocateForPool(IsolateGroup* isolate_group);
+
   static void InitVM();
   static Isolate* InitIsolate(const char* name_prefix,
                               IsolateGroup* isolate_group,
@@ -1622,12 +1662,13 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
 #if !defined(PRODUCT)
   Debugger* debugger_ = nullptr;
 
-  // SampleBlock containing CPU profiling samples.
-  //
-  // Can be accessed by multiple threads, so current_sample_block_lock_ should
-  // be acquired before accessing.
-  SampleBlock* current_sample_block_ = nullptr;
-  Mutex current_sample_block_lock_;
+  // Accumulates processed CPU samples for --profile_export_dir. Created
+  // when the isolate is initialized. Guarded by [pprof_exporter_mutex_],
+  // since both the mutator and the sample block processor export samples.
+  PprofExporter* pprof_exporter_ = nullptr;
+  mutable Mutex pprof_exporter_mutex_{"Isolate::pprof_exporter_mutex_"};
+  HeapProfileExporter* heap_profile_exporter_ = nullptr;
+  HeapSample* heap_samples_ = nullptr;
 
   // SampleBlock containing Dart allocation profiling samples.
   //
@@ -1696,8 +1737,8 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   Monitor spawn_count_monitor_;
   intptr_t spawn_count_ = 0;
 
-  HandlerInfoCache handler_info_cache_;
-  CatchEntryMovesCache catch_entry_moves_cache_;
+  std::unique_ptr<HandlerInfoCache> handler_info_cache_;
+  std::unique_ptr<CatchEntryMovesCache> catch_entry_moves_cache_;
 
   DispatchTable* dispatch_table_ = nullptr;
 
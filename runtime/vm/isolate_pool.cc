@@ -0,0 +1,105 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/isolate_pool.h"
+
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/os.h"
+#include "vm/thread_pool.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            isolate_pool_size,
+            0,
+            "Number of isolates each isolate group allocates ahead of time to "
+            "speed up Isolate.spawn.");
+DEFINE_FLAG(bool, trace_isolate_pool, false, "Trace the isolate pool.");
+
+class IsolatePool::RefillTask : public ThreadPool::Task {
+ public:
+  explicit RefillTask(IsolatePool* pool) : pool_(pool) {}
+
+  void Run() override { pool_->Refill(); }
+
+ private:
+  IsolatePool* const pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefillTask);
+};
+
+IsolatePool::IsolatePool(IsolateGroup* isolate_group)
+    : isolate_group_(isolate_group),
+      mutex_(NOT_IN_PRODUCT("IsolatePool::mutex_")) {}
+
+IsolatePool::~IsolatePool() {
+  // The group's thread pool is shut down first, so no refill is running.
+  ASSERT(!refill_scheduled_);
+  while (!isolates_.is_empty()) {
+    delete isolates_.RemoveLast();
+  }
+}
+
+Isolate* IsolatePool::Take() {
+  Isolate* isolate = nullptr;
+  {
+    MutexLocker ml(&mutex_);
+    if (isolates_.is_empty()) {
+      return nullptr;
+    }
+    isolate = isolates_.RemoveLast();
+  }
+  if (FLAG_trace_isolate_pool) {
+    OS::PrintErr("[isolate pool] Taking an isolate (%" Pd " left)\n",
+                 length());
+  }
+  ScheduleRefill();
+  return isolate;
+}
+
+void IsolatePool::ScheduleRefill() {
+  if (!IsEnabled()) {
+    return;
+  }
+  {
+    MutexLocker ml(&mutex_);
+    if (refill_scheduled_ || (isolates_.length() >= FLAG_isolate_pool_size)) {
+      return;
+    }
+    refill_scheduled_ = true;
+  }
+  if (!isolate_group_->thread_pool()->Run<RefillTask>(this)) {
+    // The group is shutting down.
+    MutexLocker ml(&mutex_);
+    refill_scheduled_ = false;
+  }
+}
+
+void IsolatePool::Refill() {
+  while (true) {
+    {
+      MutexLocker ml(&mutex_);
+      if (isolates_.length() >= FLAG_isolate_pool_size) {
+        refill_scheduled_ = false;
+        return;
+      }
+    }
+    // Only [Refill] adds isolates, so the pool cannot overflow meanwhile.
+    Isolate* isolate = Isolate::AllocateForPool(isolate_group_);
+    MutexLocker ml(&mutex_);
+    isolates_.Add(isolate);
+    if (FLAG_trace_isolate_pool) {
+      OS::PrintErr("[isolate pool] Allocated an isolate (%" Pd " pooled)\n",
+                   isolates_.length());
+    }
+  }
+}
+
+intptr_t IsolatePool::length() {
+  MutexLocker ml(&mutex_);
+  return isolates_.length();
+}
+
+}  // namespace dart
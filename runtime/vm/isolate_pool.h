@@ -0,0 +1,66 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_ISOLATE_POOL_H_
+#define RUNTIME_VM_ISOLATE_POOL_H_
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+#include "vm/growable_array.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class Isolate;
+class IsolateGroup;
+
+DECLARE_FLAG(int, isolate_pool_size);
+
+// Isolates of an isolate group which were allocated ahead of time (sized by
+// --isolate_pool_size), so that `Isolate.spawn` does not allocate and
+// construct the isolate and its mutator thread structure on its critical path.
+//
+// Pooled isolates are inert: they have never been entered, are not registered
+// with their group and own no port, field table values or heap objects. They
+// are handed out by [Isolate::InitIsolate] before it registers the isolate, so
+// a pooled isolate goes through the same initialization as a newly allocated
+// one. Isolates never return to the pool, so no state can leak from one
+// spawned isolate to the next.
+//
+// The pool is refilled on the group's thread pool, which is shut down before
+// the pool (and the isolates still in it) is deleted.
+class IsolatePool {
+ public:
+  explicit IsolatePool(IsolateGroup* isolate_group);
+  ~IsolatePool();
+
+  static bool IsEnabled() { return FLAG_isolate_pool_size > 0; }
+
+  // Takes an isolate out of the pool and schedules a refill. Returns nullptr
+  // if the pool is empty.
+  Isolate* Take();
+
+  // Schedules allocating isolates until the pool holds --isolate_pool_size
+  // isolates, unless it is full or a refill is already scheduled.
+  void ScheduleRefill();
+
+  intptr_t length();
+
+ private:
+  class RefillTask;
+
+  void Refill();
+
+  IsolateGroup* const isolate_group_;
+
+  Mutex mutex_;
+  MallocGrowableArray<Isolate*> isolates_;
+  bool refill_scheduled_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolatePool);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_ISOLATE_POOL_H_
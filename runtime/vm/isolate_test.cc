@@ -6,7 +6,12 @@
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "vm/globals.h"
+#include "vm/field_table.h"
+#include "vm/isolate_pool.h"
 #include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/symbols.h"
 #include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
 #include "vm/unit_test.h"
@@ -171,4 +176,82 @@ TEST_CASE(StackLimitInterrupts) {
   barrier->Release();
 }
 
+// Isolates copy only the used part of the group's initial field table and
+// a small spare capacity, so registering more static fields after an isolate
+// was created has to grow the field table of that isolate (inside a
+// safepoint).
+VM_UNIT_TEST_CASE(RegisterStaticFieldAfterIsolateCreation) {
+  Dart_Isolate parent = TestCase::CreateTestIsolate("parent");
+  Dart_ExitIsolate();
+  Dart_Isolate child = TestCase::CreateTestIsolateInGroup("child", parent);
+  EXPECT_EQ(child, Dart_CurrentIsolate());
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope handle_scope(thread);
+
+    IsolateGroup* isolate_group = thread->isolate_group();
+    FieldTable* field_table = thread->isolate()->field_table();
+    EXPECT_EQ(isolate_group->initial_field_table()->NumFieldIds(),
+              field_table->NumFieldIds());
+    EXPECT_EQ(field_table->NumFieldIds() + FieldTable::kCloneSpareCapacity,
+              field_table->Capacity());
+
+    const Class& owner =
+        Class::Handle(isolate_group->object_store()->object_class());
+    const String& value = String::Handle(String::New("value"));
+    Field& field = Field::Handle();
+    for (intptr_t i = 0; i < FieldTable::kCapacityIncrement + 1; i++) {
+      field = Field::NewTopLevel(Symbols::Value(), /*is_final=*/false,
+                                 /*is_const=*/false, /*is_late=*/false, owner,
+                                 TokenPosition::kMinSource,
+                                 TokenPosition::kMinSource);
+      SafepointWriteRwLocker locker(thread, isolate_group->program_lock());
+      isolate_group->RegisterStaticField(field, value);
+      EXPECT_EQ(isolate_group->initial_field_table()->NumFieldIds(),
+                field_table->NumFieldIds());
+      EXPECT_LE(field_table->NumFieldIds(), field_table->Capacity());
+      EXPECT_EQ(value.ptr(), field_table->At(field.field_id()));
+    }
+  }
+  Dart_ShutdownIsolate();
+  Dart_EnterIsolate(parent);
+  Dart_ShutdownIsolate();
+}
+
+
+VM_UNIT_TEST_CASE(IsolatePool_HandsOutPooledIsolates) {
+  SetFlagScope<int> sfs(&FLAG_isolate_pool_size, 1);
+  Dart_Isolate parent = TestCase::CreateTestIsolate("parent");
+  IsolatePool* pool = Isolate::Current()->group()->isolate_pool();
+  pool->ScheduleRefill();
+  while (pool->length() < 1) {
+    OS::Sleep(1);
+  }
+  Dart_ExitIsolate();
+
+  // Takes the pooled isolate, which is initialized like a new one.
+  Dart_Isolate child = TestCase::CreateTestIsolateInGroup("child", parent);
+  EXPECT_EQ(child, Dart_CurrentIsolate());
+  {
+    Thread* thread = Thread::Current();
+    Isolate* isolate = thread->isolate();
+    EXPECT_STREQ("child", isolate->name());
+    EXPECT_EQ(thread, isolate->mutator_thread());
+    EXPECT_NE(ILLEGAL_PORT, isolate->main_port());
+    EXPECT_EQ(isolate->group()->initial_field_table()->NumFieldIds(),
+              isolate->field_table()->NumFieldIds());
+  }
+  // Taking an isolate schedules a refill.
+  while (pool->length() < 1) {
+    OS::Sleep(1);
+  }
+  Dart_ShutdownIsolate();
+
+  // The isolate left in the pool is deleted with the group.
+  Dart_EnterIsolate(parent);
+  Dart_ShutdownIsolate();
+}
+
 }  // namespace dart
@@ -131,6 +131,13 @@ class Message {
 
   intptr_t Id() const;
 
+#if !defined(PRODUCT)
+  // When this message was posted to its handler, or 0 if unknown. Used to
+  // track how long messages are queued.
+  int64_t post_time_micros() const { return post_time_micros_; }
+  void set_post_time_micros(int64_t value) { post_time_micros_ = value; }
+#endif
+
   static const char* PriorityAsString(Priority priority);
 
  private:
@@ -154,6 +161,9 @@ class Message {
   intptr_t snapshot_length_ = 0;
   MessageFinalizableData* finalizable_data_ = nullptr;
   Priority priority_;
+#if !defined(PRODUCT)
+  int64_t post_time_micros_ = 0;
+#endif
 
   DISALLOW_COPY_AND_ASSIGN(Message);
 };
@@ -170,6 +180,10 @@ class MessageQueue {
   // message is available.  This function will not block.
   std::unique_ptr<Message> Dequeue();
 
+  // Returns the next message without removing it from the message queue or
+  // NULL if no message is available.
+  Message* Peek() const { return head_; }
+
   bool IsEmpty() { return head_ == NULL; }
 
   // Clear all messages from the message queue.
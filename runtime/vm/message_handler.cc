@@ -9,6 +9,7 @@
 #include "vm/dart.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate.h"
+#include "vm/json_stream.h"
 #include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -20,6 +21,25 @@ namespace dart {
 
 DECLARE_FLAG(bool, trace_service_pause_events);
 
+DEFINE_FLAG(int,
+            message_batch_size,
+            32,
+            "Maximum number of normal messages an isolate delivers to Dart in "
+            "a single call. Values <= 1 disable batching.");
+DEFINE_FLAG(int,
+            isolate_time_slice_micros,
+            0,
+            "If positive, an isolate gives up its thread pool thread after "
+            "handling messages for this many microseconds while more messages "
+            "are pending and other isolates wait for a thread. It is "
+            "rescheduled behind them.");
+DEFINE_FLAG(int,
+            isolate_time_slice_messages,
+            0,
+            "If positive, an isolate gives up its thread pool thread after "
+            "handling this many messages while more messages are pending and "
+            "other isolates wait for a thread. It is rescheduled behind them.");
+
 class MessageHandlerTask : public ThreadPool::Task {
  public:
   explicit MessageHandlerTask(MessageHandler* handler) : handler_(handler) {
@@ -37,6 +57,62 @@ class MessageHandlerTask : public ThreadPool::Task {
   DISALLOW_COPY_AND_ASSIGN(MessageHandlerTask);
 };
 
+#if !defined(PRODUCT)
+void QueueingDelayHistogram::Add(int64_t delay_micros) {
+  if (delay_micros < 0) {
+    delay_micros = 0;
+  }
+  intptr_t index =
+      (delay_micros == 0) ? 0 : Utils::HighestBit(delay_micros) + 1;
+  if (index >= kNumBuckets) {
+    index = kNumBuckets - 1;
+  }
+  buckets_[index]++;
+  count_++;
+  total_micros_ += delay_micros;
+  max_micros_ = Utils::Maximum(max_micros_, delay_micros);
+}
+
+void QueueingDelayHistogram::Reset() {
+  count_ = 0;
+  total_micros_ = 0;
+  max_micros_ = 0;
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    buckets_[i] = 0;
+  }
+}
+
+int64_t QueueingDelayHistogram::Percentile(intptr_t percentile) const {
+  ASSERT((percentile > 0) && (percentile <= 100));
+  if (count_ == 0) {
+    return 0;
+  }
+  const int64_t rank = (count_ * percentile + 99) / 100;
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets - 1; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      const int64_t upper_bound = (static_cast<int64_t>(1) << i) - 1;
+      return Utils::Minimum(upper_bound, max_micros_);
+    }
+  }
+  return max_micros_;
+}
+
+void QueueingDelayHistogram::PrintJSON(JSONObject* jsobj) const {
+  jsobj->AddProperty64("count", count_);
+  jsobj->AddProperty64("totalMicros", total_micros_);
+  jsobj->AddProperty64("maxMicros", max_micros_);
+  jsobj->AddProperty64("p50Micros", Percentile(50));
+  jsobj->AddProperty64("p90Micros", Percentile(90));
+  jsobj->AddProperty64("p99Micros", Percentile(99));
+  JSONArray buckets(jsobj, "buckets");
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    buckets.AddValue64(buckets_[i]);
+  }
+}
+#endif  // !defined(PRODUCT)
+
 // static
 const char* MessageHandler::MessageStatusString(MessageStatus status) {
   switch (status) {
@@ -68,6 +144,12 @@ MessageHandler::MessageHandler()
       is_paused_on_exit_(false),
       paused_timestamp_(-1),
 #endif
+      batch_budget_(0),
+      time_slice_active_(false),
+      time_slice_yielded_(false),
+      time_slice_start_micros_(0),
+      time_slice_messages_(0),
+      time_slice_yields_(0),
       task_running_(false),
       delete_me_(false),
       pool_(NULL),
@@ -132,6 +214,9 @@ bool MessageHandler::Run(ThreadPool* pool,
 void MessageHandler::PostMessage(std::unique_ptr<Message> message,
                                  bool before_events) {
   Message::Priority saved_priority;
+#if !defined(PRODUCT)
+  message->set_post_time_micros(OS::GetCurrentMonotonicMicros());
+#endif
 
   {
     MonitorLocker ml(&monitor_);
@@ -185,9 +270,99 @@ std::unique_ptr<Message> MessageHandler::DequeueMessage(
   if ((message == nullptr) && (min_priority < Message::kOOBPriority)) {
     message = queue_->Dequeue();
   }
+  if (message != nullptr) {
+    MessageDequeuedLocked(*message);
+  }
   return message;
 }
 
+void MessageHandler::MessageDequeuedLocked(const Message& message) {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  if (!message.IsOOB()) {
+    time_slice_messages_++;
+  }
+#if !defined(PRODUCT)
+  if (message.post_time_micros() != 0) {
+    queueing_delays_[message.priority()].Add(OS::GetCurrentMonotonicMicros() -
+                                             message.post_time_micros());
+  }
+#endif
+}
+
+bool MessageHandler::IsTimeSlicingEnabled() {
+  return (FLAG_isolate_time_slice_micros > 0) ||
+         (FLAG_isolate_time_slice_messages > 0);
+}
+
+void MessageHandler::StartTimeSliceLocked() {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  // Handlers owned by the port map may be deleted as soon as their task ends,
+  // so they always run until their queue is drained.
+  time_slice_active_ = IsTimeSlicingEnabled() && !OwnedByPortMap();
+  time_slice_yielded_ = false;
+  time_slice_start_micros_ =
+      time_slice_active_ ? OS::GetCurrentMonotonicMicros() : 0;
+  time_slice_messages_ = 0;
+}
+
+bool MessageHandler::TimeSliceExpiredLocked() const {
+  if (!time_slice_active_) {
+    return false;
+  }
+  if ((FLAG_isolate_time_slice_messages > 0) &&
+      (time_slice_messages_ >= FLAG_isolate_time_slice_messages)) {
+    return true;
+  }
+  return (FLAG_isolate_time_slice_micros > 0) &&
+         ((OS::GetCurrentMonotonicMicros() - time_slice_start_micros_) >=
+          FLAG_isolate_time_slice_micros);
+}
+
+bool MessageHandler::ShouldYieldLocked() {
+  if (!TimeSliceExpiredLocked()) {
+    return false;
+  }
+  if ((pool_ != nullptr) && pool_->HasTasksWaitingForWorker()) {
+    return true;
+  }
+  time_slice_start_micros_ = OS::GetCurrentMonotonicMicros();
+  time_slice_messages_ = 0;
+  return false;
+}
+
+intptr_t MessageHandler::time_slice_yields() {
+  MonitorLocker ml(&monitor_);
+  return time_slice_yields_;
+}
+
+#if !defined(PRODUCT)
+void MessageHandler::PrintQueueingDelaysJSON(JSONStream* stream, bool reset) {
+  QueueingDelayHistogram delays[Message::kNumPriorities];
+  intptr_t yields = 0;
+  {
+    MonitorLocker ml(&monitor_);
+    for (intptr_t i = 0; i < Message::kNumPriorities; i++) {
+      delays[i] = queueing_delays_[i];
+      if (reset) {
+        queueing_delays_[i].Reset();
+      }
+    }
+    yields = time_slice_yields_;
+  }
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_QueueingDelays");
+  jsobj.AddProperty64("timeSliceYields", yields);
+  {
+    JSONObject normal(&jsobj, "normal");
+    delays[Message::kNormalPriority].PrintJSON(&normal);
+  }
+  {
+    JSONObject oob(&jsobj, "oob");
+    delays[Message::kOOBPriority].PrintJSON(&oob);
+  }
+}
+#endif  // !defined(PRODUCT)
+
 void MessageHandler::ClearOOBQueue() {
   oob_queue_->Clear();
 }
@@ -229,6 +404,13 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
           message_len, name(), message->dest_port());
     }
 
+    // Normal messages which are queued behind this one may be delivered in
+    // the same call into Dart, see [DequeueBatchMessage].
+    const bool batch = allow_multiple_normal_messages &&
+                       (FLAG_message_batch_size > 1) &&
+                       IsBatchableMessage(*message);
+    batch_budget_ = batch ? FLAG_message_batch_size - 1 : 0;
+
     // Release the monitor_ temporarily while we handle the message.
     // The monitor was acquired in MessageHandler::TaskCallback().
     ml->Exit();
@@ -237,12 +419,14 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
     MessageStatus status = kOK;
     {
       DisableIdleTimerScope disable_idle_timer(idle_time_handler);
-      status = HandleMessage(std::move(message));
+      status = batch ? HandleMessageBatch(std::move(message))
+                     : HandleMessage(std::move(message));
     }
     if (status > max_status) {
       max_status = status;
     }
     ml->Enter();
+    batch_budget_ = 0;
     if (FLAG_trace_isolates) {
       OS::PrintErr(
           "[.] Message handled (%s):\n"
@@ -275,6 +459,15 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
       allow_normal_messages = false;
     }
 
+    // Once the time slice is used up, leave the remaining normal messages to
+    // a later task if other handlers are waiting for a thread. Pending OOB
+    // messages are still handled.
+    if (allow_normal_messages && !paused() && !queue_->IsEmpty() &&
+        ShouldYieldLocked()) {
+      allow_normal_messages = false;
+      time_slice_yielded_ = true;
+    }
+
     // Reevaluate the minimum allowable priority.  The paused state
     // may have changed as part of handling the message.  We may also
     // have encountered an error during message processing.
@@ -289,6 +482,36 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
   return max_status;
 }
 
+std::unique_ptr<Message> MessageHandler::DequeueBatchMessage() {
+  MonitorLocker ml(&monitor_);
+  if (batch_budget_ == 0) {
+    return nullptr;
+  }
+  // Pause requests and OOB messages take priority over the rest of the batch.
+  // Messages which are not batchable (e.g. isolate library control messages
+  // posted before the next event) end it, so that the order of delivery is the
+  // same as when handling one message at a time.
+  Message* next = queue_->Peek();
+  if (paused() || !oob_queue_->IsEmpty() || (next == nullptr) ||
+      !IsBatchableMessage(*next) || TimeSliceExpiredLocked()) {
+    batch_budget_ = 0;
+    return nullptr;
+  }
+  batch_budget_--;
+  if (FLAG_trace_isolates) {
+    OS::PrintErr(
+        "[<] Handling batched message:\n"
+        "\tlen:        %" Pd
+        "\n"
+        "\thandler:    %s\n"
+        "\tport:       %" Pd64 "\n",
+        next->Size(), name(), next->dest_port());
+  }
+  std::unique_ptr<Message> message = queue_->Dequeue();
+  MessageDequeuedLocked(*message);
+  return message;
+}
+
 MessageHandler::MessageStatus MessageHandler::HandleNextMessage() {
   // We can only call HandleNextMessage when this handler is not
   // assigned to a thread pool.
@@ -447,8 +670,32 @@ void MessageHandler::TaskCallback() {
 
       // Handle any pending messages for this message handler.
       if (status != kShutdown) {
+        StartTimeSliceLocked();
         status = HandleMessages(&ml, (status == kOK), true);
+        EndTimeSliceLocked();
+      }
+    }
+
+    // If the time slice expired before all messages were handled while other
+    // tasks were waiting for a thread, give up the thread. The new task is
+    // queued behind the tasks which are already waiting.
+    if ((status == kOK) && time_slice_yielded_ && HasLivePorts() &&
+        !queue_->IsEmpty()) {
+      time_slice_yielded_ = false;
+      ASSERT(oob_queue_->IsEmpty());
+      if (FLAG_trace_isolates) {
+        OS::PrintErr(
+            "[~] Yielding message handler:\n"
+            "\thandler:    %s\n",
+            name());
+      }
+      if (pool_->Run<MessageHandlerTask>(this)) {
+        time_slice_yields_++;
+        // [task_running_] stays set for the new task.
+        return;
       }
+      // The pool is shutting down. Keep handling messages on this thread.
+      status = HandleMessages(&ml, true, true);
     }
 
     // The isolate exits when it encounters an error or when it no
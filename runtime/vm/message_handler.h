@@ -16,6 +16,45 @@
 
 namespace dart {
 
+class JSONObject;
+class JSONStream;
+
+#if !defined(PRODUCT)
+// Distribution of how long messages stay queued before they are handled.
+//
+// Bucket 0 counts delays below 1us and bucket i > 0 counts delays in
+// [2^(i-1), 2^i) microseconds. The last bucket also counts all longer delays.
+class QueueingDelayHistogram {
+ public:
+  static constexpr intptr_t kNumBuckets = 32;
+
+  QueueingDelayHistogram() { Reset(); }
+
+  void Add(int64_t delay_micros);
+  void Reset();
+
+  int64_t count() const { return count_; }
+  int64_t total_micros() const { return total_micros_; }
+  int64_t max_micros() const { return max_micros_; }
+  int64_t bucket(intptr_t index) const {
+    ASSERT((index >= 0) && (index < kNumBuckets));
+    return buckets_[index];
+  }
+
+  // Returns an upper bound of the given percentile (0 < [percentile] <= 100)
+  // of all recorded delays, in microseconds.
+  int64_t Percentile(intptr_t percentile) const;
+
+  void PrintJSON(JSONObject* jsobj) const;
+
+ private:
+  int64_t count_;
+  int64_t total_micros_;
+  int64_t max_micros_;
+  int64_t buckets_[kNumBuckets];
+};
+#endif  // !defined(PRODUCT)
+
 // A MessageHandler is an entity capable of accepting messages.
 class MessageHandler {
  protected:
@@ -81,6 +120,14 @@ class MessageHandler {
   // handler.
   bool HasMessages();
 
+  // Dequeues the next normal message of the batch started by
+  // [HandleMessageBatch].
+  //
+  // Returns NULL once the batch is exhausted, or earlier if the next pending
+  // message must not be delivered as part of the batch: the handler was
+  // paused, an OOB message is waiting or the next message is not batchable.
+  std::unique_ptr<Message> DequeueBatchMessage();
+
   // A message handler tracks how many live ports it has.
   bool HasLivePorts() const { return live_ports_ > 0; }
 
@@ -94,6 +141,20 @@ class MessageHandler {
     paused_--;
   }
 
+  // Whether handlers running on a thread pool yield their thread after a time
+  // slice (see --isolate_time_slice_micros and --isolate_time_slice_messages).
+  static bool IsTimeSlicingEnabled();
+
+  // The number of times this handler gave up its thread pool thread because
+  // its time slice expired while messages were still pending.
+  intptr_t time_slice_yields();
+
+#if !defined(PRODUCT)
+  // Prints the distribution of queueing delays of handled messages, per
+  // priority, and optionally resets it afterwards.
+  void PrintQueueingDelaysJSON(JSONStream* stream, bool reset);
+#endif
+
 #if !defined(PRODUCT)
   void DebugDump();
 
@@ -204,6 +265,23 @@ class MessageHandler {
   // Returns true on success.
   virtual MessageStatus HandleMessage(std::unique_ptr<Message> message) = 0;
 
+  // Whether [message] may be delivered as part of a batch of normal messages
+  // (see --message_batch_size).  Optionally provided by subclass.
+  //
+  // Called while holding the message handler's monitor.
+  virtual bool IsBatchableMessage(const Message& message) const {
+    return false;
+  }
+
+  // Handles [message] and then up to --message_batch_size - 1 further
+  // messages obtained from [DequeueBatchMessage].  Only called for messages
+  // accepted by [IsBatchableMessage].
+  //
+  // The default implementation only handles [message].
+  virtual MessageStatus HandleMessageBatch(std::unique_ptr<Message> message) {
+    return HandleMessage(std::move(message));
+  }
+
   virtual void NotifyPauseOnStart() {}
   virtual void NotifyPauseOnExit() {}
 
@@ -242,9 +320,27 @@ class MessageHandler {
   // messages from the queue_.
   std::unique_ptr<Message> DequeueMessage(Message::Priority min_priority);
 
+  // Bookkeeping for a message which was just dequeued for handling.
+  void MessageDequeuedLocked(const Message& message);
+
+  // Starts a time slice for the current task, if time slicing is enabled
+  // and applies to this handler.
+  void StartTimeSliceLocked();
+  void EndTimeSliceLocked() { time_slice_active_ = false; }
+  // Whether the current time slice is used up.
+  bool TimeSliceExpiredLocked() const;
+  // Whether the current time slice is used up and other tasks are waiting for
+  // a thread of the pool. If nothing is waiting, starts a new time slice, so
+  // the pool is checked at most once per slice.
+  bool ShouldYieldLocked();
+
   void ClearOOBQueue();
 
   // Handles any pending messages.
+  //
+  // Stops handling normal messages early and sets [time_slice_yielded_] if
+  // the time slice started by the caller expires while other tasks are
+  // waiting for a thread of the pool.
   MessageStatus HandleMessages(MonitorLocker* ml,
                                bool allow_normal_messages,
                                bool allow_multiple_normal_messages);
@@ -266,6 +362,17 @@ class MessageHandler {
   bool is_paused_on_start_;
   bool is_paused_on_exit_;
   int64_t paused_timestamp_;
+#endif
+  // The number of messages [DequeueBatchMessage] may still return.
+  intptr_t batch_budget_;
+  // The time slice of the running task, see [StartTimeSliceLocked].
+  bool time_slice_active_;
+  bool time_slice_yielded_;
+  int64_t time_slice_start_micros_;
+  intptr_t time_slice_messages_;
+  intptr_t time_slice_yields_;
+#if !defined(PRODUCT)
+  QueueingDelayHistogram queueing_delays_[Message::kNumPriorities];
 #endif
   bool task_running_;
   bool delete_me_;
@@ -10,6 +10,9 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, message_batch_size);
+DECLARE_FLAG(int, isolate_time_slice_messages);
+
 class MessageHandlerTestPeer {
  public:
   explicit MessageHandlerTestPeer(MessageHandler* handler)
@@ -27,6 +30,11 @@ class MessageHandlerTestPeer {
   MessageQueue* queue() const { return handler_->queue_; }
   MessageQueue* oob_queue() const { return handler_->oob_queue_; }
 
+  MessageHandler::MessageStatus HandleAllMessages() {
+    MonitorLocker ml(&handler_->monitor_);
+    return handler_->HandleMessages(&ml, true, true);
+  }
+
  private:
   MessageHandler* handler_;
 
@@ -137,6 +145,41 @@ static std::unique_ptr<Message> BlankMessage(Dart_Port dest,
                       priority);
 }
 
+// Batches normal messages, except for those sent to [unbatched_port], and
+// pauses itself after handling a message sent to [pausing_port].
+class BatchingTestMessageHandler : public TestMessageHandler {
+ public:
+  BatchingTestMessageHandler() {}
+
+  bool IsBatchableMessage(const Message& message) const {
+    return (message.priority() == Message::kNormalPriority) &&
+           (message.dest_port() != unbatched_port_);
+  }
+
+  MessageStatus HandleMessageBatch(std::unique_ptr<Message> message) {
+    batch_count_++;
+    while (message != nullptr) {
+      const bool pause = message->dest_port() == pausing_port_;
+      MessageStatus status = HandleMessage(std::move(message));
+      if (status != kOK) return status;
+      if (pause) increment_paused();
+      message = DequeueBatchMessage();
+    }
+    return kOK;
+  }
+
+  void set_unbatched_port(Dart_Port port) { unbatched_port_ = port; }
+  void set_pausing_port(Dart_Port port) { pausing_port_ = port; }
+  int batch_count() const { return batch_count_; }
+
+ private:
+  Dart_Port unbatched_port_ = ILLEGAL_PORT;
+  Dart_Port pausing_port_ = ILLEGAL_PORT;
+  int batch_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchingTestMessageHandler);
+};
+
 VM_UNIT_TEST_CASE(MessageHandler_PostMessage) {
   TestMessageHandler handler;
   MessageHandlerTestPeer handler_peer(&handler);
@@ -308,6 +351,64 @@ VM_UNIT_TEST_CASE(MessageHandler_HandleNextMessage_Shutdown) {
   handler_peer.CloseAllPorts();
 }
 
+VM_UNIT_TEST_CASE(MessageHandler_HandleMessageBatch) {
+  const intptr_t saved_batch_size = FLAG_message_batch_size;
+  FLAG_message_batch_size = 3;
+  BatchingTestMessageHandler handler;
+  MessageHandlerTestPeer handler_peer(&handler);
+  Dart_Port port1 = PortMap::CreatePort(&handler);
+  Dart_Port port2 = PortMap::CreatePort(&handler);
+  Dart_Port port3 = PortMap::CreatePort(&handler);
+  handler.set_unbatched_port(port2);
+  for (intptr_t i = 0; i < 4; i++) {
+    handler_peer.PostMessage(BlankMessage(port1, Message::kNormalPriority));
+  }
+  handler_peer.PostMessage(BlankMessage(port2, Message::kNormalPriority));
+  handler_peer.PostMessage(BlankMessage(port3, Message::kNormalPriority));
+
+  // Batches are limited by --message_batch_size and end before messages which
+  // are not batchable.
+  EXPECT_EQ(MessageHandler::kOK, handler_peer.HandleAllMessages());
+  EXPECT_EQ(6, handler.message_count());
+  EXPECT_EQ(3, handler.batch_count());
+  Dart_Port* ports = handler.port_buffer();
+  for (intptr_t i = 0; i < 4; i++) {
+    EXPECT_EQ(port1, ports[i]);
+  }
+  EXPECT_EQ(port2, ports[4]);
+  EXPECT_EQ(port3, ports[5]);
+
+  handler_peer.CloseAllPorts();
+  FLAG_message_batch_size = saved_batch_size;
+}
+
+VM_UNIT_TEST_CASE(MessageHandler_HandleMessageBatch_Pause) {
+  const intptr_t saved_batch_size = FLAG_message_batch_size;
+  FLAG_message_batch_size = 10;
+  BatchingTestMessageHandler handler;
+  MessageHandlerTestPeer handler_peer(&handler);
+  Dart_Port port1 = PortMap::CreatePort(&handler);
+  Dart_Port port2 = PortMap::CreatePort(&handler);
+  handler.set_pausing_port(port1);
+  handler_peer.PostMessage(BlankMessage(port1, Message::kNormalPriority));
+  handler_peer.PostMessage(BlankMessage(port2, Message::kNormalPriority));
+
+  // Pausing the handler ends the batch and leaves the remaining messages in
+  // the queue.
+  EXPECT_EQ(MessageHandler::kOK, handler_peer.HandleAllMessages());
+  EXPECT_EQ(1, handler.message_count());
+  EXPECT_EQ(1, handler.batch_count());
+  EXPECT(handler.HasMessages());
+
+  handler.decrement_paused();
+  EXPECT_EQ(MessageHandler::kOK, handler_peer.HandleAllMessages());
+  EXPECT_EQ(2, handler.message_count());
+  EXPECT_EQ(port2, handler.port_buffer()[1]);
+
+  handler_peer.CloseAllPorts();
+  FLAG_message_batch_size = saved_batch_size;
+}
+
 VM_UNIT_TEST_CASE(MessageHandler_HandleOOBMessages) {
   TestMessageHandler handler;
   MessageHandlerTestPeer handler_peer(&handler);
@@ -329,6 +430,37 @@ VM_UNIT_TEST_CASE(MessageHandler_HandleOOBMessages) {
   handler_peer.CloseAllPorts();
 }
 
+#if !defined(PRODUCT)
+VM_UNIT_TEST_CASE(MessageHandler_QueueingDelayHistogram) {
+  QueueingDelayHistogram histogram;
+  EXPECT_EQ(0, histogram.count());
+  EXPECT_EQ(0, histogram.Percentile(50));
+
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(1000);
+  EXPECT_EQ(4, histogram.count());
+  EXPECT_EQ(1004, histogram.total_micros());
+  EXPECT_EQ(1000, histogram.max_micros());
+  EXPECT_EQ(1, histogram.bucket(0));
+  EXPECT_EQ(1, histogram.bucket(1));
+  EXPECT_EQ(1, histogram.bucket(2));
+  EXPECT_EQ(1, histogram.bucket(10));
+  EXPECT_EQ(1, histogram.Percentile(50));
+  EXPECT_EQ(3, histogram.Percentile(75));
+  EXPECT_EQ(1000, histogram.Percentile(100));
+
+  // Very long delays end up in the last bucket.
+  histogram.Add(kMaxInt64 / 2);
+  EXPECT_EQ(1, histogram.bucket(QueueingDelayHistogram::kNumBuckets - 1));
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.count());
+  EXPECT_EQ(0, histogram.max_micros());
+}
+#endif  // !defined(PRODUCT)
+
 struct ThreadStartInfo {
   MessageHandler* handler;
   Dart_Port* ports;
@@ -409,4 +541,120 @@ VM_UNIT_TEST_CASE(MessageHandler_Run) {
   OSThread::Join(info.join_id);
 }
 
+// Blocks the only worker of a pool until released.
+class BlockingTask : public ThreadPool::Task {
+ public:
+  BlockingTask(Monitor* monitor, bool* released)
+      : monitor_(monitor), released_(released) {}
+
+  virtual void Run() {
+    MonitorLocker ml(monitor_);
+    while (!*released_) {
+      ml.Wait();
+    }
+  }
+
+ private:
+  Monitor* monitor_;
+  bool* released_;
+};
+
+// Records how many messages [handler] had handled when the task ran.
+class RecordMessageCountTask : public ThreadPool::Task {
+ public:
+  RecordMessageCountTask(TestMessageHandler* handler, int* message_count)
+      : handler_(handler), message_count_(message_count) {}
+
+  virtual void Run() {
+    MonitorLocker ml(handler_->monitor());
+    *message_count_ = handler_->message_count();
+    ml.Notify();
+  }
+
+ private:
+  TestMessageHandler* handler_;
+  int* message_count_;
+};
+
+VM_UNIT_TEST_CASE(MessageHandler_Run_TimeSlice) {
+  const intptr_t saved_time_slice_messages = FLAG_isolate_time_slice_messages;
+  FLAG_isolate_time_slice_messages = 2;
+  TestMessageHandler handler;
+  ThreadPool pool(/*max_pool_size=*/1);
+  MessageHandlerTestPeer handler_peer(&handler);
+  handler_peer.increment_live_ports();
+
+  // Queue all messages before the handler starts, so that a single task
+  // would handle all of them.
+  Dart_Port ports[5];
+  for (int i = 0; i < 5; i++) {
+    ports[i] = PortMap::CreatePort(&handler);
+    handler_peer.PostMessage(BlankMessage(ports[i], Message::kNormalPriority));
+  }
+
+  // Keep the only worker busy until both the handler and another task are
+  // waiting for it.
+  Monitor blocking_monitor;
+  bool released = false;
+  EXPECT(pool.Run<BlockingTask>(&blocking_monitor, &released));
+  handler.Run(&pool, TestStartFunction, TestEndFunction,
+              reinterpret_cast<uword>(&handler));
+  int recorded_message_count = -1;
+  EXPECT(pool.Run<RecordMessageCountTask>(&handler, &recorded_message_count));
+  {
+    MonitorLocker ml(&blocking_monitor);
+    released = true;
+    ml.Notify();
+  }
+
+  {
+    MonitorLocker ml(handler.monitor());
+    while (handler.message_count() < 5 || recorded_message_count < 0) {
+      ml.Wait();
+    }
+    // The handler gave up its thread to the waiting task after the 2nd
+    // message. Once nothing else was waiting it kept its thread, and it
+    // handled all messages in order.
+    EXPECT_EQ(2, recorded_message_count);
+    Dart_Port* handler_ports = handler.port_buffer();
+    for (int i = 0; i < 5; i++) {
+      EXPECT_EQ(ports[i], handler_ports[i]);
+    }
+  }
+  EXPECT_EQ(1, handler.time_slice_yields());
+  EXPECT(!handler.end_called());
+
+  handler_peer.decrement_live_ports();
+  FLAG_isolate_time_slice_messages = saved_time_slice_messages;
+}
+
+VM_UNIT_TEST_CASE(MessageHandler_Run_TimeSliceNothingWaiting) {
+  const intptr_t saved_time_slice_messages = FLAG_isolate_time_slice_messages;
+  FLAG_isolate_time_slice_messages = 2;
+  TestMessageHandler handler;
+  ThreadPool pool;
+  MessageHandlerTestPeer handler_peer(&handler);
+  handler_peer.increment_live_ports();
+
+  Dart_Port ports[5];
+  for (int i = 0; i < 5; i++) {
+    ports[i] = PortMap::CreatePort(&handler);
+    handler_peer.PostMessage(BlankMessage(ports[i], Message::kNormalPriority));
+  }
+  handler.Run(&pool, TestStartFunction, TestEndFunction,
+              reinterpret_cast<uword>(&handler));
+
+  {
+    MonitorLocker ml(handler.monitor());
+    while (handler.message_count() < 5) {
+      ml.Wait();
+    }
+  }
+  // No other task waited for a thread, so the handler never yielded.
+  EXPECT_EQ(0, handler.time_slice_yields());
+
+  handler_peer.decrement_live_ports();
+  FLAG_isolate_time_slice_messages = saved_time_slice_messages;
+}
+
 }  // namespace dart
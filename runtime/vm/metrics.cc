@@ -221,6 +221,70 @@ void Metric::Cleanup() {
 
 #endif  // !defined(PRODUCT)
 
+void HistogramMetric::InitInstance(IsolateGroup* isolate_group,
+                                   const char* name) {
+  // Only called once.
+  ASSERT(name != nullptr);
+  isolate_group_ = isolate_group;
+  name_ = name;
+}
+
+intptr_t HistogramMetric::BucketIndex(int64_t micros) {
+  if (micros <= 0) {
+    return 0;
+  }
+  return Utils::Minimum<intptr_t>(Utils::BitLength(micros), kNumBuckets - 1);
+}
+
+void HistogramMetric::Add(int64_t micros) {
+  if (micros < 0) {
+    micros = 0;  // The monotonic clock may be coarse.
+  }
+  buckets_[BucketIndex(micros)].fetch_add(1);
+  sum_.fetch_add(micros);
+  int64_t max = max_.load();
+  while ((micros > max) && !max_.compare_exchange_weak(max, micros)) {
+  }
+  count_.fetch_add(1);
+}
+
+void HistogramMetric::Read(Dart_MetricHistogram* histogram) const {
+  histogram->count = count_.load();
+  histogram->sum = sum_.load();
+  histogram->max = max_.load();
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    histogram->buckets[i] = buckets_[i].load();
+  }
+}
+
+char* HistogramMetric::ToString() const {
+  Thread* thread = Thread::Current();
+  ASSERT(thread != nullptr);
+  Zone* zone = thread->zone();
+  ASSERT(zone != nullptr);
+  Dart_MetricHistogram histogram;
+  Read(&histogram);
+  // Estimate the 99th percentile by the upper bound of its bucket.
+  const int64_t rank = histogram.count - histogram.count / 100;
+  int64_t p99 = 0;
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    seen += histogram.buckets[i];
+    if (seen >= rank) {
+      p99 = (i == kNumBuckets - 1) ? histogram.max
+                                   : Utils::Minimum<int64_t>(
+                                         (int64_t{1} << i) - 1, histogram.max);
+      break;
+    }
+  }
+  return zone->PrintToString(
+      "%s %" Pd64 " samples, total %s, p99 %s, max %s", name(),
+      histogram.count,
+      Metric::ValueToString(histogram.sum, Metric::kMicrosecond),
+      Metric::ValueToString(p99, Metric::kMicrosecond),
+      Metric::ValueToString(histogram.max, Metric::kMicrosecond));
+}
+
 MaxMetric::MaxMetric() : Metric() {
   set_value(kMinInt64);
 }
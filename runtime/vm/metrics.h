@@ -5,6 +5,8 @@
 #ifndef RUNTIME_VM_METRICS_H_
 #define RUNTIME_VM_METRICS_H_
 
+#include "include/dart_tools_api.h"
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 
 namespace dart {
@@ -26,7 +28,21 @@ class JSONStream;
   V(MaxMetric, HeapNewCapacityMax, "heap.new.capacity.max", kByte)             \
   V(MetricHeapNewExternal, HeapNewExternal, "heap.new.external", kByte)        \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
-  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)
+  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(Metric, HeapAllocated, "heap.allocated", kByte)                            \
+  V(Metric, GCScavengeCount, "gc.scavenge.count", kCounter)                    \
+  V(Metric, GCScavengeTime, "gc.scavenge.time", kMicrosecond)                  \
+  V(Metric, GCScavengeCopied, "gc.scavenge.copied", kByte)                     \
+  V(Metric, GCScavengePromoted, "gc.scavenge.promoted", kByte)                 \
+  V(Metric, GCMarkSweepCount, "gc.marksweep.count", kCounter)                  \
+  V(Metric, GCMarkSweepTime, "gc.marksweep.time", kMicrosecond)
+
+// Histograms of pause times for each isolate group, in microseconds.
+#define ISOLATE_GROUP_HISTOGRAM_LIST(V)                                        \
+  V(GCScavengePause, "gc.scavenge.pause")                                      \
+  V(GCMarkSweepPause, "gc.marksweep.pause")                                    \
+  V(TimeToSafepoint, "safepoint.latency")                                      \
+  V(HeapSnapshotPause, "heap_snapshot.pause")
 
 // Metrics for each isolate.
 #define ISOLATE_METRIC_LIST(V)                                                 \
@@ -131,6 +147,39 @@ class MinMetric : public Metric {
   void SetValue(int64_t new_value);
 };
 
+// A histogram of durations in microseconds with power of two buckets (see
+// Dart_MetricHistogram). Updates are lock free, so it can be read by other
+// threads at any time, but a reader may see an update only partially.
+class HistogramMetric {
+ public:
+  static constexpr intptr_t kNumBuckets = DART_METRIC_HISTOGRAM_BUCKETS;
+
+  HistogramMetric() {}
+
+  void InitInstance(IsolateGroup* isolate_group, const char* name);
+
+  void Add(int64_t micros);
+  void Read(Dart_MetricHistogram* histogram) const;
+
+  // The index of the bucket counting |micros|.
+  static intptr_t BucketIndex(int64_t micros);
+
+  const char* name() const { return name_; }
+
+  // Returns a zone allocated string.
+  char* ToString() const;
+
+ private:
+  IsolateGroup* isolate_group_ = nullptr;
+  const char* name_ = nullptr;
+  RelaxedAtomic<int64_t> count_ = {0};
+  RelaxedAtomic<int64_t> sum_ = {0};
+  RelaxedAtomic<int64_t> max_ = {0};
+  RelaxedAtomic<int64_t> buckets_[kNumBuckets] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramMetric);
+};
+
 class MetricHeapOldUsed : public Metric {
  public:
   virtual int64_t Value() const;
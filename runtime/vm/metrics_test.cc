@@ -113,9 +113,49 @@ ISOLATE_UNIT_TEST_CASE(Metric_EmbedderAPI) {
     EXPECT(Dart_IsolateGroupHeapNewCapacityMaxMetric(isolate_group) > 0);
     EXPECT(Dart_IsolateGroupHeapGlobalUsedMetric(isolate_group) > 0);
     EXPECT(Dart_IsolateGroupHeapGlobalUsedMaxMetric(isolate_group) > 0);
+    EXPECT(Dart_IsolateGroupHeapAllocatedMetric(isolate_group) > 0);
+    EXPECT(Dart_IsolateGroupGCScavengeCountMetric(isolate_group) > 0);
+    EXPECT(Dart_IsolateGroupGCScavengeTimeMetric(isolate_group) >= 0);
+    EXPECT(Dart_IsolateGroupGCMarkSweepCountMetric(isolate_group) > 0);
+    EXPECT(Dart_IsolateGroupGCMarkSweepTimeMetric(isolate_group) >= 0);
+
+    Dart_MetricHistogram histogram;
+    Dart_IsolateGroupGCScavengePauseHistogram(isolate_group, &histogram);
+    EXPECT(histogram.count > 0);
+    Dart_IsolateGroupGCMarkSweepPauseHistogram(isolate_group, &histogram);
+    EXPECT(histogram.count > 0);
+    Dart_IsolateGroupTimeToSafepointHistogram(isolate_group, &histogram);
+    EXPECT(histogram.count > 0);
+    int64_t bucket_total = 0;
+    for (intptr_t i = 0; i < DART_METRIC_HISTOGRAM_BUCKETS; i++) {
+      bucket_total += histogram.buckets[i];
+    }
+    EXPECT_EQ(histogram.count, bucket_total);
   }
 }
 
+VM_UNIT_TEST_CASE(Metric_Histogram) {
+  HistogramMetric metric;
+  metric.InitInstance(nullptr, "a.b.c");
+  metric.Add(0);
+  metric.Add(1);
+  metric.Add(3);
+  metric.Add(4);
+  metric.Add(kMaxInt64 / 2);
+
+  Dart_MetricHistogram histogram;
+  metric.Read(&histogram);
+  EXPECT_EQ(5, histogram.count);
+  EXPECT_EQ(8 + kMaxInt64 / 2, histogram.sum);
+  EXPECT_EQ(kMaxInt64 / 2, histogram.max);
+  // Bucket i counts [2^(i-1), 2^i).
+  EXPECT_EQ(1, histogram.buckets[0]);
+  EXPECT_EQ(1, histogram.buckets[1]);
+  EXPECT_EQ(1, histogram.buckets[2]);
+  EXPECT_EQ(1, histogram.buckets[3]);
+  EXPECT_EQ(1, histogram.buckets[DART_METRIC_HISTOGRAM_BUCKETS - 1]);
+}
+
 static uintptr_t event_counter;
 static const char* last_gcevent_type;
 static const char* last_gcevent_reason;
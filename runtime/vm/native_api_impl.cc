@@ -71,15 +71,20 @@ DART_EXPORT bool Dart_PostInteger(Dart_Port port_id, int64_t message) {
   return PostCObjectHelper(port_id, &cobj);
 }
 
-DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
-                                         Dart_NativeMessageHandler handler,
-                                         bool handle_concurrently) {
+static Dart_Port NewNativePortHelper(const char* name,
+                                     Dart_NativeMessageHandler handler,
+                                     intptr_t max_concurrency,
+                                     const char* api_name) {
   if (name == NULL) {
     name = "<UnnamedNativePort>";
   }
   if (handler == NULL) {
-    OS::PrintErr("%s expects argument 'handler' to be non-null.\n",
-                 CURRENT_FUNC);
+    OS::PrintErr("%s expects argument 'handler' to be non-null.\n", api_name);
+    return ILLEGAL_PORT;
+  }
+  if (max_concurrency <= 0) {
+    OS::PrintErr("%s expects argument 'max_concurrency' to be positive.\n",
+                 api_name);
     return ILLEGAL_PORT;
   }
   if (!Dart::SetActiveApiCall()) {
@@ -88,7 +93,10 @@ DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
   // Start the native port without a current isolate.
   IsolateLeaveScope saver(Isolate::Current());
 
-  NativeMessageHandler* nmh = new NativeMessageHandler(name, handler);
+  NativeMessageHandler* nmh =
+      max_concurrency == 1
+          ? new NativeMessageHandler(name, handler)
+          : new ConcurrentNativeMessageHandler(name, handler, max_concurrency);
   Dart_Port port_id = PortMap::CreatePort(nmh);
   if (port_id != ILLEGAL_PORT) {
     PortMap::SetPortState(port_id, PortMap::kLivePort);
@@ -101,6 +109,21 @@ DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
   return port_id;
 }
 
+DART_EXPORT Dart_Port Dart_NewNativePort(const char* name,
+                                         Dart_NativeMessageHandler handler,
+                                         bool handle_concurrently) {
+  // Messages are handled one at a time, regardless of [handle_concurrently].
+  return NewNativePortHelper(name, handler, /*max_concurrency=*/1,
+                             CURRENT_FUNC);
+}
+
+DART_EXPORT Dart_Port
+Dart_NewConcurrentNativePort(const char* name,
+                             Dart_NativeMessageHandler handler,
+                             intptr_t max_concurrency) {
+  return NewNativePortHelper(name, handler, max_concurrency, CURRENT_FUNC);
+}
+
 DART_EXPORT bool Dart_CloseNativePort(Dart_Port native_port_id) {
   // Close the native port without a current isolate.
   IsolateLeaveScope saver(Isolate::Current());
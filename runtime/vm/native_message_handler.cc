@@ -6,11 +6,14 @@
 
 #include <memory>
 
+#include "vm/dart.h"
 #include "vm/dart_api_message.h"
 #include "vm/isolate.h"
+#include "vm/lockers.h"
 #include "vm/message.h"
 #include "vm/message_snapshot.h"
 #include "vm/snapshot.h"
+#include "vm/thread_pool.h"
 
 namespace dart {
 
@@ -34,12 +37,104 @@ MessageHandler::MessageStatus NativeMessageHandler::HandleMessage(
     // We currently do not use OOB messages for native ports.
     UNREACHABLE();
   }
+  Dispatch(func(), message.get());
+  return kOK;
+}
+
+void NativeMessageHandler::Dispatch(Dart_NativeMessageHandler func,
+                                    Message* message) {
   // We create a native scope for handling the message.
   // All allocation of objects for decoding the message is done in the
   // zone associated with this scope.
   ApiNativeScope scope;
-  Dart_CObject* object = ReadApiMessage(scope.zone(), message.get());
-  (*func())(message->dest_port(), object);
+  Dart_CObject* object = ReadApiMessage(scope.zone(), message);
+  (*func)(message->dest_port(), object);
+}
+
+struct ConcurrentNativeMessageHandler::WorkQueue {
+  WorkQueue(Dart_NativeMessageHandler func, intptr_t max_concurrency)
+      : func(func), max_concurrency(max_concurrency) {}
+
+  const Dart_NativeMessageHandler func;
+  const intptr_t max_concurrency;
+
+  Mutex mutex;
+  // The messages which are not yet picked up by a worker.
+  MessageQueue messages;
+  // The number of workers started and not yet finished.
+  intptr_t active_workers = 0;
+  // Set once the handler is deleted, i.e. its port was closed.
+  bool closed = false;
+};
+
+// Handles queued messages until there are none left.
+class ConcurrentNativeMessageHandler::Worker : public ThreadPool::Task {
+ public:
+  explicit Worker(std::shared_ptr<WorkQueue> work_queue)
+      : work_queue_(std::move(work_queue)) {}
+
+  void Run() override {
+    while (true) {
+      std::unique_ptr<Message> message;
+      {
+        MutexLocker ml(&work_queue_->mutex);
+        if (!work_queue_->closed) {
+          message = work_queue_->messages.Dequeue();
+        }
+        if (message == nullptr) {
+          work_queue_->active_workers--;
+          return;
+        }
+      }
+      Dispatch(work_queue_->func, message.get());
+    }
+  }
+
+ private:
+  std::shared_ptr<WorkQueue> work_queue_;
+};
+
+ConcurrentNativeMessageHandler::ConcurrentNativeMessageHandler(
+    const char* name,
+    Dart_NativeMessageHandler func,
+    intptr_t max_concurrency)
+    : NativeMessageHandler(name, func),
+      work_queue_(std::make_shared<WorkQueue>(func, max_concurrency)) {
+  ASSERT(max_concurrency > 0);
+}
+
+ConcurrentNativeMessageHandler::~ConcurrentNativeMessageHandler() {
+  // Like for any other closed port, messages which were not picked up yet
+  // are dropped. Messages being handled complete on their workers.
+  MutexLocker ml(&work_queue_->mutex);
+  work_queue_->closed = true;
+  work_queue_->messages.Clear();
+}
+
+intptr_t ConcurrentNativeMessageHandler::max_concurrency() const {
+  return work_queue_->max_concurrency;
+}
+
+MessageHandler::MessageStatus ConcurrentNativeMessageHandler::HandleMessage(
+    std::unique_ptr<Message> message) {
+  if (message->IsOOB()) {
+    // We currently do not use OOB messages for native ports.
+    UNREACHABLE();
+  }
+  bool start_worker = false;
+  {
+    MutexLocker ml(&work_queue_->mutex);
+    work_queue_->messages.Enqueue(std::move(message), /*before_events=*/false);
+    if (work_queue_->active_workers < work_queue_->max_concurrency) {
+      work_queue_->active_workers++;
+      start_worker = true;
+    }
+  }
+  if (start_worker && !Dart::thread_pool()->Run<Worker>(work_queue_)) {
+    // The VM is shutting down.
+    MutexLocker ml(&work_queue_->mutex);
+    work_queue_->active_workers--;
+  }
   return kOK;
 }
 
@@ -5,6 +5,8 @@
 #ifndef RUNTIME_VM_NATIVE_MESSAGE_HANDLER_H_
 #define RUNTIME_VM_NATIVE_MESSAGE_HANDLER_H_
 
+#include <memory>
+
 #include "include/dart_api.h"
 #include "include/dart_native_api.h"
 #include "vm/message_handler.h"
@@ -21,7 +23,7 @@ class NativeMessageHandler : public MessageHandler {
   const char* name() const { return name_; }
   Dart_NativeMessageHandler func() const { return func_; }
 
-  MessageStatus HandleMessage(std::unique_ptr<Message> message);
+  MessageStatus HandleMessage(std::unique_ptr<Message> message) override;
 
 #if defined(DEBUG)
   // Check that it is safe to access this handler.
@@ -31,11 +33,42 @@ class NativeMessageHandler : public MessageHandler {
   // Delete this handlers when its last live port is closed.
   virtual bool OwnedByPortMap() const { return true; }
 
+ protected:
+  // Decodes [message] and passes it to [func].
+  static void Dispatch(Dart_NativeMessageHandler func, Message* message);
+
  private:
   char* name_;
   Dart_NativeMessageHandler func_;
 };
 
+// A NativeMessageHandler which dispatches up to [max_concurrency] messages at
+// a time to its C handler, each on its own thread of the VM's thread pool.
+//
+// Messages arriving while [max_concurrency] messages are being handled wait in
+// a queue of this handler, so bursts of messages neither serialize on a single
+// thread nor start an unbounded number of threads.
+class ConcurrentNativeMessageHandler : public NativeMessageHandler {
+ public:
+  ConcurrentNativeMessageHandler(const char* name,
+                                 Dart_NativeMessageHandler func,
+                                 intptr_t max_concurrency);
+  ~ConcurrentNativeMessageHandler();
+
+  intptr_t max_concurrency() const;
+
+  // Queues [message] for the next available worker.
+  MessageStatus HandleMessage(std::unique_ptr<Message> message) override;
+
+ private:
+  class Worker;
+  struct WorkQueue;
+
+  // Shared with the workers, which may still be running when the port is
+  // closed and this handler is deleted.
+  std::shared_ptr<WorkQueue> work_queue_;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_NATIVE_MESSAGE_HANDLER_H_
@@ -2772,6 +2772,15 @@ ObjectPtr Object::Allocate(intptr_t cls_id,
         HeapSnapshotWriter::GetHeapSnapshotIdentityHash(thread, raw_obj);
     Profiler::SampleAllocation(thread, cls_id, hash);
   }
+  if (UNLIKELY(HeapProfileSampler::enabled())) {
+    HeapProfileSampler& heap_sampler = thread->heap_sampler();
+    if (raw_obj->IsOldObject()) {
+      heap_sampler.SampleOldSpaceAllocation(size);
+    }
+    if (heap_sampler.HasOutstandingSample()) {
+      heap_sampler.RecordSample(raw_obj, size);
+    }
+  }
 #endif  // !PRODUCT
   return raw_obj;
 }
@@ -17601,7 +17610,7 @@ void Code::NotifyCodeObservers(const char* name,
     const auto& instrs = Instructions::Handle(code.instructions());
     CodeObservers::NotifyAll(name, instrs.PayloadStart(),
                              code.GetPrologueOffset(), instrs.Size(), optimized,
-                             &code.comments());
+                             &code.comments(), &code);
   }
 #endif
 }
@@ -23131,6 +23140,20 @@ bool String::Equals(const String& str,
     return false;  // Lengths don't match.
   }
 
+  // Compare strings of the same representation as raw memory, which lets the
+  // C library use its vectorized implementation.
+  if (len > 0 && IsOneByteString() && str.IsOneByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(OneByteString::DataStart(*this),
+                  OneByteString::CharAddr(str, begin_index), len) == 0;
+  }
+  if (len > 0 && IsTwoByteString() && str.IsTwoByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(TwoByteString::DataStart(*this),
+                  TwoByteString::CharAddr(str, begin_index),
+                  len * sizeof(uint16_t)) == 0;
+  }
+
   for (intptr_t i = 0; i < len; i++) {
     if (CharAt(i) != str.CharAt(begin_index + i)) {
       return false;
@@ -23167,6 +23190,11 @@ bool String::Equals(const uint8_t* latin1_array, intptr_t len) const {
     return false;
   }
 
+  if (len > 0 && IsOneByteString()) {
+    NoSafepointScope no_safepoint;
+    return memcmp(OneByteString::DataStart(*this), latin1_array, len) == 0;
+  }
+
   for (intptr_t i = 0; i < len; i++) {
     if (this->CharAt(i) != latin1_array[i]) {
       return false;
@@ -23266,6 +23294,67 @@ bool String::EndsWith(const String& other) const {
   return true;
 }
 
+// Scans [data] for candidates with memchr, which is vectorized by the C
+// library, and verifies them one character at a time.
+static intptr_t IndexOfInOneByteData(const uint8_t* data,
+                                     intptr_t data_length,
+                                     const uint16_t* characters,
+                                     intptr_t length,
+                                     intptr_t start) {
+  for (intptr_t i = 0; i < length; i++) {
+    if (characters[i] > 0xFF) return -1;
+  }
+  const uint8_t* last = data + data_length - length;
+  for (const uint8_t* cursor = data + start; cursor <= last; cursor++) {
+    cursor = reinterpret_cast<const uint8_t*>(
+        memchr(cursor, characters[0], last - cursor + 1));
+    if (cursor == nullptr) {
+      return -1;
+    }
+    intptr_t i = 1;
+    while ((i < length) && (cursor[i] == characters[i])) {
+      i++;
+    }
+    if (i == length) {
+      return cursor - data;
+    }
+  }
+  return -1;
+}
+
+intptr_t String::IndexOf(const uint16_t* characters,
+                         intptr_t length,
+                         intptr_t start) const {
+  const intptr_t this_length = Length();
+  ASSERT((start >= 0) && (start <= this_length));
+  if (length == 0) {
+    return start;
+  }
+  if (length > this_length - start) {
+    return -1;
+  }
+  NoSafepointScope no_safepoint;
+  if (IsOneByteString()) {
+    return IndexOfInOneByteData(OneByteString::DataStart(*this), this_length,
+                                characters, length, start);
+  }
+  if (IsExternalOneByteString()) {
+    return IndexOfInOneByteData(ExternalOneByteString::DataStart(*this),
+                                this_length, characters, length, start);
+  }
+  const intptr_t last = this_length - length;
+  for (intptr_t position = start; position <= last; position++) {
+    intptr_t i = 0;
+    while ((i < length) && (CharAt(position + i) == characters[i])) {
+      i++;
+    }
+    if (i == length) {
+      return position;
+    }
+  }
+  return -1;
+}
+
 InstancePtr String::CanonicalizeLocked(Thread* thread) const {
   if (IsCanonical()) {
     return this->ptr();
@@ -24181,6 +24270,39 @@ OneByteStringPtr OneByteString::Transform(int32_t (*mapping)(int32_t ch),
   return OneByteString::raw(result);
 }
 
+intptr_t OneByteString::IndexOf(const String& str,
+                                const String& pattern,
+                                intptr_t start) {
+  ASSERT(str.IsOneByteString() && pattern.IsOneByteString());
+  const intptr_t length = str.Length();
+  const intptr_t pattern_length = pattern.Length();
+  ASSERT((start >= 0) && (start <= length));
+  if (pattern_length == 0) {
+    return start;
+  }
+  if (pattern_length > length - start) {
+    return -1;
+  }
+
+  // Find candidates with memchr and verify them with memcmp, both of which
+  // are vectorized by the C library.
+  NoSafepointScope no_safepoint;
+  const uint8_t* data = DataStart(str);
+  const uint8_t* needle = DataStart(pattern);
+  const uint8_t* last = data + length - pattern_length;
+  for (const uint8_t* cursor = data + start; cursor <= last; cursor++) {
+    cursor = reinterpret_cast<const uint8_t*>(
+        memchr(cursor, needle[0], last - cursor + 1));
+    if (cursor == nullptr) {
+      return -1;
+    }
+    if (memcmp(cursor + 1, needle + 1, pattern_length - 1) == 0) {
+      return cursor - data;
+    }
+  }
+  return -1;
+}
+
 OneByteStringPtr OneByteString::SubStringUnchecked(const String& str,
                                                    intptr_t begin_index,
                                                    intptr_t length,
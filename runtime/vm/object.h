@@ -317,6 +317,8 @@ class Object {
   bool IsImmutable() const { return ptr()->untag()->IsImmutable(); }
   void SetImmutable() const { ptr()->untag()->SetImmutable(); }
   void ClearImmutable() const { ptr()->untag()->ClearImmutable(); }
+  bool IsShared() const { return ptr()->untag()->IsShared(); }
+  void SetShared() const { ptr()->untag()->SetShared(); }
   intptr_t GetClassId() const {
     return !ptr()->IsHeapObject() ? static_cast<intptr_t>(kSmiCid)
                                   : ptr()->untag()->GetClassId();
@@ -9554,6 +9556,12 @@ class String : public Instance {
   static bool StartsWith(StringPtr str, StringPtr prefix);
   bool EndsWith(const String& other) const;
 
+  // Returns the index of the first occurrence of the UTF-16 [characters] in
+  // this string at or after [start], or -1 if there is none.
+  intptr_t IndexOf(const uint16_t* characters,
+                   intptr_t length,
+                   intptr_t start) const;
+
   // Strings are canonicalized using the symbol table.
   // Caller must hold IsolateGroup::constant_canonicalization_mutex_.
   virtual InstancePtr CanonicalizeLocked(Thread* thread) const;
@@ -9886,6 +9894,12 @@ class OneByteString : public AllStatic {
                                     const String& str,
                                     Heap::Space space);
 
+  // Returns the index of the first occurrence of the one-byte string
+  // [pattern] in [str] at or after [start], or -1 if there is none.
+  static intptr_t IndexOf(const String& str,
+                          const String& pattern,
+                          intptr_t start);
+
   // High performance version of substring for one-byte strings.
   // "str" must be OneByteString.
   static OneByteStringPtr SubStringUnchecked(const String& str,
@@ -6,6 +6,7 @@
 
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
+#include "vm/flags.h"
 #include "vm/growable_array.h"
 #include "vm/isolate.h"
 #include "vm/native_symbol.h"
@@ -15,12 +16,21 @@
 #include "vm/raw_object.h"
 #include "vm/raw_object_fields.h"
 #include "vm/reusable_handles.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
+#include "vm/timeline.h"
 #include "vm/visitor.h"
 
 namespace dart {
 
 #if !defined(PRODUCT)
 
+DEFINE_FLAG(int,
+            heap_snapshot_tasks,
+            2,
+            "The number of tasks to spawn to enumerate and encode the objects "
+            "of a heap snapshot. 0 writes it on the requesting thread only.");
+
 static bool IsUserClass(intptr_t cid) {
   if (cid == kContextCid) return true;
   if (cid == kTypeArgumentsCid) return false;
@@ -714,6 +724,9 @@ intptr_t ObjectGraph::InboundReferences(Object* obj, const Array& references) {
 // iteration order. A bitvector is computed that indicates the number of objects
 // in each block, so the id of any object in the block can be found be adding
 // the number of bits set before the object to the block's first id.
+// When helper tasks enumerate the pages in parallel, ids are first assigned
+// relative to the start of the page and then rebased once the ids of the
+// preceding pages are known.
 // Compare ForwardingBlock used for heap compaction.
 class CountingBlock {
  public:
@@ -743,6 +756,12 @@ class CountingBlock {
     count_bitvector_ |= static_cast<uword>(1) << bitvector_shift;
   }
 
+  void Rebase(intptr_t base) {
+    if (count_bitvector_ != 0) {
+      base_count_ += base;
+    }
+  }
+
  private:
   intptr_t base_count_;
   uword count_bitvector_;
@@ -763,6 +782,11 @@ class CountingPage {
   void Record(uword addr, intptr_t id) {
     return BlockFor(addr)->Record(addr, id);
   }
+  void Rebase(intptr_t base) {
+    for (intptr_t i = 0; i < kBlocksPerPage; i++) {
+      blocks_[i].Rebase(base);
+    }
+  }
 
   CountingBlock* BlockFor(uword addr) {
     intptr_t page_offset = addr & ~kOldPageMask;
@@ -779,12 +803,7 @@ class CountingPage {
   DISALLOW_IMPLICIT_CONSTRUCTORS(CountingPage);
 };
 
-void HeapSnapshotWriter::EnsureAvailable(intptr_t needed) {
-  intptr_t available = capacity_ - size_;
-  if (available >= needed) {
-    return;
-  }
-
+void HeapSnapshotWriter::Reserve(intptr_t needed) {
   if (buffer_ != nullptr) {
     Flush();
   }
@@ -838,13 +857,17 @@ void HeapSnapshotWriter::SetupCountingPages() {
     next_offset++;
   }
 
-  OldPage* page = isolate_group()->heap()->old_space()->pages_;
+  PageSpace* old_space = isolate_group()->heap()->old_space();
+  MutexLocker ml(&old_space->pages_lock_);
+  old_space->MakeIterable();
+  data_pages_.Clear();
+  OldPage* page = old_space->pages_;
   while (page != NULL) {
-    page->forwarding_page();
     CountingPage* counting_page =
         reinterpret_cast<CountingPage*>(page->forwarding_page());
     ASSERT(counting_page != NULL);
     counting_page->Clear();
+    data_pages_.Add(page);
     page = page->next();
   }
 }
@@ -875,7 +898,7 @@ void HeapSnapshotWriter::AssignObjectId(ObjectPtr obj) {
 
   CountingPage* counting_page = FindCountingPage(obj);
   if (counting_page != nullptr) {
-    // Likely: object on an ordinary page.
+    // Likely: object on an ordinary page, unless helper tasks enumerate them.
     counting_page->Record(UntaggedObject::ToAddr(obj), ++object_count_);
   } else {
     // Unlikely: new space object, or object on a large or image page.
@@ -899,8 +922,14 @@ intptr_t HeapSnapshotWriter::GetObjectId(ObjectPtr obj) const {
     // Likely: object on an ordinary page.
     id = counting_page->Lookup(UntaggedObject::ToAddr(obj));
   } else {
-    // Unlikely: new space object, or object on a large or image page.
-    id = thread()->heap()->GetObjectId(obj);
+    // Unlikely: new space object, or object on a large or image page. Ids
+    // are only looked up once all have been assigned, so the table is read
+    // without locking, possibly by several threads.
+    id = thread()
+             ->heap()
+             ->GetWeakTable(obj->IsNewObject() ? Heap::kNew : Heap::kOld,
+                            Heap::kObjectIds)
+             ->GetValueExclusive(obj);
   }
   ASSERT(id != 0);
   return id;
@@ -1036,141 +1065,148 @@ enum ExtraCids {
   kNumExtraCids = 3,
 };
 
+// Encodes objects into [out], which is the writer itself or the segment of a
+// data page.
 class Pass2Visitor : public ObjectVisitor,
                      public ObjectPointerVisitor,
                      public HandleVisitor {
  public:
-  explicit Pass2Visitor(HeapSnapshotWriter* writer, ObjectSlots* object_slots)
+  Pass2Visitor(HeapSnapshotWriter* writer,
+               HeapSnapshotBuffer* out,
+               ObjectSlots* object_slots)
       : ObjectVisitor(),
         ObjectPointerVisitor(IsolateGroup::Current()),
         HandleVisitor(Thread::Current()),
         isolate_group_(thread()->isolate_group()),
         writer_(writer),
+        out_(out),
         object_slots_(object_slots) {}
+  Pass2Visitor(HeapSnapshotWriter* writer, ObjectSlots* object_slots)
+      : Pass2Visitor(writer, writer, object_slots) {}
 
   void VisitObject(ObjectPtr obj) {
     if (obj->IsPseudoObject()) return;
 
     intptr_t cid = obj->GetClassId();
-    writer_->WriteUnsigned(cid + kNumExtraCids);
-    writer_->WriteUnsigned(discount_sizes_ ? 0 : obj->untag()->HeapSize());
+    out_->WriteUnsigned(cid + kNumExtraCids);
+    out_->WriteUnsigned(discount_sizes_ ? 0 : obj->untag()->HeapSize());
 
     if (cid == kNullCid) {
-      writer_->WriteUnsigned(kNullData);
+      out_->WriteUnsigned(kNullData);
     } else if (cid == kBoolCid) {
-      writer_->WriteUnsigned(kBoolData);
-      writer_->WriteUnsigned(
+      out_->WriteUnsigned(kBoolData);
+      out_->WriteUnsigned(
           static_cast<uintptr_t>(static_cast<BoolPtr>(obj)->untag()->value_));
     } else if (cid == kSentinelCid) {
       if (obj == Object::sentinel().ptr()) {
-        writer_->WriteUnsigned(kNameData);
-        writer_->WriteUtf8("uninitialized");
+        out_->WriteUnsigned(kNameData);
+        out_->WriteUtf8("uninitialized");
       } else if (obj == Object::transition_sentinel().ptr()) {
-        writer_->WriteUnsigned(kNameData);
-        writer_->WriteUtf8("initializing");
+        out_->WriteUnsigned(kNameData);
+        out_->WriteUtf8("initializing");
       } else {
-        writer_->WriteUnsigned(kNoData);
+        out_->WriteUnsigned(kNoData);
       }
     } else if (cid == kSmiCid) {
       UNREACHABLE();
     } else if (cid == kMintCid) {
-      writer_->WriteUnsigned(kIntData);
-      writer_->WriteSigned(static_cast<MintPtr>(obj)->untag()->value_);
+      out_->WriteUnsigned(kIntData);
+      out_->WriteSigned(static_cast<MintPtr>(obj)->untag()->value_);
     } else if (cid == kDoubleCid) {
-      writer_->WriteUnsigned(kDoubleData);
-      writer_->WriteBytes(&(static_cast<DoublePtr>(obj)->untag()->value_),
+      out_->WriteUnsigned(kDoubleData);
+      out_->WriteBytes(&(static_cast<DoublePtr>(obj)->untag()->value_),
                           sizeof(double));
     } else if (cid == kOneByteStringCid) {
       OneByteStringPtr str = static_cast<OneByteStringPtr>(obj);
       intptr_t len = Smi::Value(str->untag()->length());
       intptr_t trunc_len = Utils::Minimum(len, kMaxStringElements);
-      writer_->WriteUnsigned(kLatin1Data);
-      writer_->WriteUnsigned(len);
-      writer_->WriteUnsigned(trunc_len);
-      writer_->WriteBytes(&str->untag()->data()[0], trunc_len);
+      out_->WriteUnsigned(kLatin1Data);
+      out_->WriteUnsigned(len);
+      out_->WriteUnsigned(trunc_len);
+      out_->WriteBytes(&str->untag()->data()[0], trunc_len);
     } else if (cid == kExternalOneByteStringCid) {
       ExternalOneByteStringPtr str = static_cast<ExternalOneByteStringPtr>(obj);
       intptr_t len = Smi::Value(str->untag()->length());
       intptr_t trunc_len = Utils::Minimum(len, kMaxStringElements);
-      writer_->WriteUnsigned(kLatin1Data);
-      writer_->WriteUnsigned(len);
-      writer_->WriteUnsigned(trunc_len);
-      writer_->WriteBytes(&str->untag()->external_data_[0], trunc_len);
+      out_->WriteUnsigned(kLatin1Data);
+      out_->WriteUnsigned(len);
+      out_->WriteUnsigned(trunc_len);
+      out_->WriteBytes(&str->untag()->external_data_[0], trunc_len);
     } else if (cid == kTwoByteStringCid) {
       TwoByteStringPtr str = static_cast<TwoByteStringPtr>(obj);
       intptr_t len = Smi::Value(str->untag()->length());
       intptr_t trunc_len = Utils::Minimum(len, kMaxStringElements);
-      writer_->WriteUnsigned(kUTF16Data);
-      writer_->WriteUnsigned(len);
-      writer_->WriteUnsigned(trunc_len);
-      writer_->WriteBytes(&str->untag()->data()[0], trunc_len * 2);
+      out_->WriteUnsigned(kUTF16Data);
+      out_->WriteUnsigned(len);
+      out_->WriteUnsigned(trunc_len);
+      out_->WriteBytes(&str->untag()->data()[0], trunc_len * 2);
     } else if (cid == kExternalTwoByteStringCid) {
       ExternalTwoByteStringPtr str = static_cast<ExternalTwoByteStringPtr>(obj);
       intptr_t len = Smi::Value(str->untag()->length());
       intptr_t trunc_len = Utils::Minimum(len, kMaxStringElements);
-      writer_->WriteUnsigned(kUTF16Data);
-      writer_->WriteUnsigned(len);
-      writer_->WriteUnsigned(trunc_len);
-      writer_->WriteBytes(&str->untag()->external_data_[0], trunc_len * 2);
+      out_->WriteUnsigned(kUTF16Data);
+      out_->WriteUnsigned(len);
+      out_->WriteUnsigned(trunc_len);
+      out_->WriteBytes(&str->untag()->external_data_[0], trunc_len * 2);
     } else if (cid == kArrayCid || cid == kImmutableArrayCid) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(
           Smi::Value(static_cast<ArrayPtr>(obj)->untag()->length()));
     } else if (cid == kGrowableObjectArrayCid) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(Smi::Value(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(Smi::Value(
           static_cast<GrowableObjectArrayPtr>(obj)->untag()->length()));
     } else if (cid == kLinkedHashMapCid || cid == kImmutableLinkedHashMapCid) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(
           Smi::Value(static_cast<LinkedHashMapPtr>(obj)->untag()->used_data()));
     } else if (cid == kLinkedHashSetCid || cid == kImmutableLinkedHashSetCid) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(
           Smi::Value(static_cast<LinkedHashSetPtr>(obj)->untag()->used_data()));
     } else if (cid == kObjectPoolCid) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(static_cast<ObjectPoolPtr>(obj)->untag()->length_);
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(static_cast<ObjectPoolPtr>(obj)->untag()->length_);
     } else if (IsTypedDataClassId(cid)) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(
           Smi::Value(static_cast<TypedDataPtr>(obj)->untag()->length()));
     } else if (IsExternalTypedDataClassId(cid)) {
-      writer_->WriteUnsigned(kLengthData);
-      writer_->WriteUnsigned(Smi::Value(
+      out_->WriteUnsigned(kLengthData);
+      out_->WriteUnsigned(Smi::Value(
           static_cast<ExternalTypedDataPtr>(obj)->untag()->length()));
     } else if (cid == kFunctionCid) {
-      writer_->WriteUnsigned(kNameData);
+      out_->WriteUnsigned(kNameData);
       ScrubAndWriteUtf8(static_cast<FunctionPtr>(obj)->untag()->name());
     } else if (cid == kCodeCid) {
       ObjectPtr owner = static_cast<CodePtr>(obj)->untag()->owner_;
       if (!owner->IsHeapObject()) {
         // Precompiler removed owner object from the snapshot,
         // only leaving Smi classId.
-        writer_->WriteUnsigned(kNoData);
+        out_->WriteUnsigned(kNoData);
       } else if (owner->IsFunction()) {
-        writer_->WriteUnsigned(kNameData);
+        out_->WriteUnsigned(kNameData);
         ScrubAndWriteUtf8(static_cast<FunctionPtr>(owner)->untag()->name());
       } else if (owner->IsClass()) {
-        writer_->WriteUnsigned(kNameData);
+        out_->WriteUnsigned(kNameData);
         ScrubAndWriteUtf8(static_cast<ClassPtr>(owner)->untag()->name());
       } else {
-        writer_->WriteUnsigned(kNoData);
+        out_->WriteUnsigned(kNoData);
       }
     } else if (cid == kFieldCid) {
-      writer_->WriteUnsigned(kNameData);
+      out_->WriteUnsigned(kNameData);
       ScrubAndWriteUtf8(static_cast<FieldPtr>(obj)->untag()->name());
     } else if (cid == kClassCid) {
-      writer_->WriteUnsigned(kNameData);
+      out_->WriteUnsigned(kNameData);
       ScrubAndWriteUtf8(static_cast<ClassPtr>(obj)->untag()->name());
     } else if (cid == kLibraryCid) {
-      writer_->WriteUnsigned(kNameData);
+      out_->WriteUnsigned(kNameData);
       ScrubAndWriteUtf8(static_cast<LibraryPtr>(obj)->untag()->url());
     } else if (cid == kScriptCid) {
-      writer_->WriteUnsigned(kNameData);
+      out_->WriteUnsigned(kNameData);
       ScrubAndWriteUtf8(static_cast<ScriptPtr>(obj)->untag()->url());
     } else {
-      writer_->WriteUnsigned(kNoData);
+      out_->WriteUnsigned(kNoData);
     }
 
     if (object_slots_->ContainsOnlyTaggedPointers(cid)) {
@@ -1189,7 +1225,7 @@ class Pass2Visitor : public ObjectVisitor,
               UntaggedObject::ToAddr(obj->untag()) + slot.offset);
           VisitCompressedPointers(obj->heap_base(), target, target);
         } else {
-          writer_->WriteUnsigned(0);
+          out_->WriteUnsigned(0);
         }
         written_++;
         total_++;
@@ -1199,12 +1235,12 @@ class Pass2Visitor : public ObjectVisitor,
 
   void ScrubAndWriteUtf8(StringPtr str) {
     if (str == String::null()) {
-      writer_->WriteUtf8("null");
+      out_->WriteUtf8("null");
     } else {
       String handle;
       handle = str;
       char* value = handle.ToMallocCString();
-      writer_->ScrubAndWriteUtf8(value);
+      out_->ScrubAndWriteUtf8(value);
       free(value);
     }
   }
@@ -1218,7 +1254,7 @@ class Pass2Visitor : public ObjectVisitor,
   }
   void DoWrite() {
     writing_ = true;
-    writer_->WriteUnsigned(counted_);
+    out_->WriteUnsigned(counted_);
   }
 
   void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
@@ -1227,7 +1263,7 @@ class Pass2Visitor : public ObjectVisitor,
         ObjectPtr target = *ptr;
         written_++;
         total_++;
-        writer_->WriteUnsigned(writer_->GetObjectId(target));
+        out_->WriteUnsigned(writer_->GetObjectId(target));
       }
     } else {
       intptr_t count = to - from + 1;
@@ -1244,7 +1280,7 @@ class Pass2Visitor : public ObjectVisitor,
         ObjectPtr target = ptr->Decompress(heap_base);
         written_++;
         total_++;
-        writer_->WriteUnsigned(writer_->GetObjectId(target));
+        out_->WriteUnsigned(writer_->GetObjectId(target));
       }
     } else {
       intptr_t count = to - from + 1;
@@ -1260,12 +1296,12 @@ class Pass2Visitor : public ObjectVisitor,
       return;  // Free handle.
     }
 
-    writer_->WriteUnsigned(writer_->GetObjectId(weak_persistent_handle->ptr()));
-    writer_->WriteUnsigned(weak_persistent_handle->external_size());
+    out_->WriteUnsigned(writer_->GetObjectId(weak_persistent_handle->ptr()));
+    out_->WriteUnsigned(weak_persistent_handle->external_size());
     // Attempt to include a native symbol name.
     auto const name = NativeSymbolResolver::LookupSymbolName(
         reinterpret_cast<uword>(weak_persistent_handle->callback()), nullptr);
-    writer_->WriteUtf8((name == nullptr) ? "Unknown native function" : name);
+    out_->WriteUtf8((name == nullptr) ? "Unknown native function" : name);
     if (name != nullptr) {
       NativeSymbolResolver::FreeSymbolName(name);
     }
@@ -1278,12 +1314,13 @@ class Pass2Visitor : public ObjectVisitor,
   void WriteExtraRef(intptr_t oid) {
     ASSERT(writing_);
     written_++;
-    writer_->WriteUnsigned(oid);
+    out_->WriteUnsigned(oid);
   }
 
  private:
   IsolateGroup* isolate_group_;
   HeapSnapshotWriter* const writer_;
+  HeapSnapshotBuffer* const out_;
   ObjectSlots* object_slots_;
   bool writing_ = false;
   intptr_t counted_ = 0;
@@ -1314,6 +1351,313 @@ class Pass3Visitor : public ObjectVisitor {
   DISALLOW_COPY_AND_ASSIGN(Pass3Visitor);
 };
 
+// Assigns ids relative to the start of the page to the objects on a data page
+// and counts their references.
+class Pass1PageVisitor : public ObjectVisitor, public ObjectPointerVisitor {
+ public:
+  Pass1PageVisitor(ObjectSlots* object_slots, CountingPage* counting_page)
+      : ObjectVisitor(),
+        ObjectPointerVisitor(IsolateGroup::Current()),
+        object_slots_(object_slots),
+        counting_page_(counting_page) {}
+
+  void VisitObject(ObjectPtr obj) {
+    if (obj->IsPseudoObject()) return;
+
+    counting_page_->Record(UntaggedObject::ToAddr(obj), ++object_count_);
+    const auto cid = obj->GetClassId();
+
+    if (object_slots_->ContainsOnlyTaggedPointers(cid)) {
+      obj->untag()->VisitPointersPrecise(isolate_group(), this);
+    } else {
+      reference_count_ += object_slots_->ObjectSlotsFor(cid)->length();
+    }
+  }
+
+  void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
+    intptr_t count = to - from + 1;
+    ASSERT(count >= 0);
+    reference_count_ += count;
+  }
+
+  void VisitCompressedPointers(uword heap_base,
+                               CompressedObjectPtr* from,
+                               CompressedObjectPtr* to) {
+    intptr_t count = to - from + 1;
+    ASSERT(count >= 0);
+    reference_count_ += count;
+  }
+
+  intptr_t object_count() const { return object_count_; }
+  intptr_t reference_count() const { return reference_count_; }
+
+ private:
+  ObjectSlots* object_slots_;
+  CountingPage* counting_page_;
+  intptr_t object_count_ = 0;
+  intptr_t reference_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Pass1PageVisitor);
+};
+
+// The encoded objects of one data page.
+class HeapSnapshotSegment : public HeapSnapshotBuffer {
+ public:
+  HeapSnapshotSegment() {}
+  ~HeapSnapshotSegment() { free(buffer_); }
+
+  const uint8_t* data() const { return buffer_; }
+  intptr_t length() const { return size_; }
+
+ protected:
+  virtual void Reserve(intptr_t needed) {
+    capacity_ = Utils::Maximum(2 * capacity_, size_ + needed);
+    capacity_ = Utils::Maximum(capacity_, kInitialCapacity);
+    buffer_ = reinterpret_cast<uint8_t*>(realloc(buffer_, capacity_));
+  }
+
+ private:
+  static const intptr_t kInitialCapacity = 64 * KB;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotSegment);
+};
+
+// Enumerates or encodes the objects on the data pages of a heap snapshot.
+// Threads claim one page at a time, so a page with many objects doesn't hold
+// up the others.
+class DataPageWork {
+ public:
+  enum Phase { kEnumerate, kEncode };
+
+  DataPageWork(HeapSnapshotWriter* writer,
+               ObjectSlots* object_slots,
+               const MallocGrowableArray<OldPage*>& pages,
+               Phase phase)
+      : writer_(writer),
+        object_slots_(object_slots),
+        pages_(pages),
+        phase_(phase),
+        object_counts_(new intptr_t[pages.length()]),
+        reference_counts_(new intptr_t[pages.length()]),
+        segments_(new HeapSnapshotSegment*[pages.length()]) {
+    for (intptr_t i = 0; i < pages.length(); i++) {
+      object_counts_[i] = 0;
+      reference_counts_[i] = 0;
+      segments_[i] = nullptr;
+    }
+  }
+
+  ~DataPageWork() {
+    for (intptr_t i = 0; i < pages_.length(); i++) {
+      delete segments_[i];
+    }
+  }
+
+  // Processes pages until all have been claimed.
+  void Work() {
+    while (true) {
+      const intptr_t index = next_page_.fetch_add(1);
+      if (index >= pages_.length()) break;
+      if (phase_ == kEnumerate) {
+        EnumeratePage(index);
+      } else {
+        EncodePage(index);
+      }
+    }
+  }
+
+  // Takes the segment of the page at [index], which must be the page after
+  // the last one taken. Encodes the page on this thread if no helper has
+  // claimed it yet, and otherwise waits for the helper to finish it.
+  HeapSnapshotSegment* TakeSegment(intptr_t index) {
+    ASSERT(phase_ == kEncode);
+    // Pages are claimed in order, so all pages before [index] are claimed.
+    intptr_t unclaimed = index;
+    if (next_page_.compare_exchange_strong(unclaimed, index + 1)) {
+      EncodePage(index);
+    }
+    MonitorLocker ml(&monitor_);
+    while (segments_[index] == nullptr) {
+      ml.Wait();
+    }
+    HeapSnapshotSegment* segment = segments_[index];
+    segments_[index] = nullptr;
+    num_taken_ = index + 1;
+    ml.NotifyAll();
+    return segment;
+  }
+
+  intptr_t object_count(intptr_t index) const { return object_counts_[index]; }
+  intptr_t reference_count(intptr_t index) const {
+    return reference_counts_[index];
+  }
+
+ private:
+  // Bounds the memory held by segments which haven't been written yet.
+  static const intptr_t kMaxPendingSegments = 64;
+
+  void EnumeratePage(intptr_t index) {
+    OldPage* page = pages_[index];
+    CountingPage* counting_page =
+        reinterpret_cast<CountingPage*>(page->forwarding_page());
+    Pass1PageVisitor visitor(object_slots_, counting_page);
+    page->VisitObjects(&visitor);
+    object_counts_[index] = visitor.object_count();
+    reference_counts_[index] = visitor.reference_count();
+  }
+
+  void EncodePage(intptr_t index) {
+    {
+      MonitorLocker ml(&monitor_);
+      while (index >= num_taken_ + kMaxPendingSegments) {
+        ml.Wait();
+      }
+    }
+    HeapSnapshotSegment* segment = new HeapSnapshotSegment();
+    Pass2Visitor visitor(writer_, segment, object_slots_);
+    pages_[index]->VisitObjects(&visitor);
+    MonitorLocker ml(&monitor_);
+    segments_[index] = segment;
+    ml.NotifyAll();
+  }
+
+  HeapSnapshotWriter* const writer_;
+  ObjectSlots* const object_slots_;
+  const MallocGrowableArray<OldPage*>& pages_;
+  const Phase phase_;
+  RelaxedAtomic<intptr_t> next_page_ = {0};
+  std::unique_ptr<intptr_t[]> object_counts_;
+  std::unique_ptr<intptr_t[]> reference_counts_;
+
+  Monitor monitor_;
+  std::unique_ptr<HeapSnapshotSegment*[]> segments_;  // Guarded by monitor_.
+  intptr_t num_taken_ = 0;                            // Guarded by monitor_.
+
+  DISALLOW_COPY_AND_ASSIGN(DataPageWork);
+};
+
+class HeapSnapshotTask : public ThreadPool::Task {
+ public:
+  HeapSnapshotTask(IsolateGroup* isolate_group,
+                   DataPageWork* work,
+                   ThreadBarrier* barrier)
+      : isolate_group_(isolate_group), work_(work), barrier_(barrier) {}
+
+  void Run() {
+    if (!barrier_->TryEnter()) {
+      barrier_->Release();
+      return;
+    }
+
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kHeapSnapshotTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+
+    work_->Work();
+
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Sync();
+    barrier_->Release();
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  DataPageWork* work_;
+  ThreadBarrier* barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotTask);
+};
+
+static intptr_t NumHeapSnapshotTasks(intptr_t num_pages) {
+  return Utils::Minimum<intptr_t>(Utils::Maximum(FLAG_heap_snapshot_tasks, 0),
+                                  num_pages);
+}
+
+// Returns a barrier for this thread and the helpers, which process [work]
+// together with this thread.
+static ThreadBarrier* StartHeapSnapshotTasks(IsolateGroup* isolate_group,
+                                             DataPageWork* work,
+                                             intptr_t num_tasks) {
+  ThreadBarrier* barrier = new ThreadBarrier(num_tasks + 1, /*initial=*/1);
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    if (!Dart::thread_pool()->Run<HeapSnapshotTask>(isolate_group, work,
+                                                    barrier)) {
+      // The pool is shutting down. The task never enters the barrier and
+      // this thread claims its pages instead.
+      barrier->Release();
+    }
+  }
+  return barrier;
+}
+
+void HeapSnapshotWriter::EnumerateDataPages(ObjectVisitor* visitor,
+                                            ObjectSlots* object_slots) {
+  TIMELINE_FUNCTION_GC_DURATION(thread(), "EnumerateDataPages");
+  const intptr_t num_tasks = NumHeapSnapshotTasks(data_pages_.length());
+  if (num_tasks == 0) {
+    for (intptr_t i = 0; i < data_pages_.length(); i++) {
+      data_pages_[i]->VisitObjects(visitor);
+    }
+    return;
+  }
+
+  DataPageWork work(this, object_slots, data_pages_, DataPageWork::kEnumerate);
+  ThreadBarrier* barrier =
+      StartHeapSnapshotTasks(isolate_group(), &work, num_tasks);
+  // This thread enumerates pages too.
+  work.Work();
+  barrier->Sync();
+  barrier->Release();
+
+  for (intptr_t i = 0; i < data_pages_.length(); i++) {
+    CountingPage* counting_page =
+        reinterpret_cast<CountingPage*>(data_pages_[i]->forwarding_page());
+    counting_page->Rebase(object_count_);
+    object_count_ += work.object_count(i);
+    reference_count_ += work.reference_count(i);
+  }
+}
+
+void HeapSnapshotWriter::WriteDataPages(ObjectVisitor* visitor,
+                                        ObjectSlots* object_slots) {
+  TIMELINE_FUNCTION_GC_DURATION(thread(), "WriteDataPages");
+  const intptr_t num_tasks = NumHeapSnapshotTasks(data_pages_.length());
+  if (num_tasks == 0) {
+    for (intptr_t i = 0; i < data_pages_.length(); i++) {
+      data_pages_[i]->VisitObjects(visitor);
+    }
+    return;
+  }
+
+  // The helpers encode the pages, while this thread writes them in order and
+  // encodes the pages it would otherwise wait for.
+  DataPageWork work(this, object_slots, data_pages_, DataPageWork::kEncode);
+  ThreadBarrier* barrier =
+      StartHeapSnapshotTasks(isolate_group(), &work, num_tasks);
+  for (intptr_t i = 0; i < data_pages_.length(); i++) {
+    HeapSnapshotSegment* segment = work.TakeSegment(i);
+    WriteBytes(segment->data(), segment->length());
+    delete segment;
+  }
+  barrier->Sync();
+  barrier->Release();
+}
+
+void HeapSnapshotWriter::VisitOtherOldObjects(ObjectVisitor* visitor) {
+  PageSpace* old_space = isolate_group()->heap()->old_space();
+  MutexLocker ml(&old_space->pages_lock_);
+  old_space->MakeIterable();
+  OldPage* lists[] = {old_space->exec_pages_, old_space->large_pages_,
+                      old_space->image_pages_};
+  for (OldPage* page : lists) {
+    for (; page != nullptr; page = page->next()) {
+      page->VisitObjects(visitor);
+    }
+  }
+}
+
 class CollectStaticFieldNames : public ObjectVisitor {
  public:
   CollectStaticFieldNames(intptr_t field_table_size,
@@ -1399,6 +1743,8 @@ void FileHeapSnapshotWriter::WriteChunk(uint8_t* buffer,
 }
 
 void HeapSnapshotWriter::Write() {
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  TIMELINE_FUNCTION_GC_DURATION(thread(), "WriteHeapSnapshot");
   HeapIterationScope iteration(thread());
 
   WriteBytes("dartheap", 8);  // Magic value.
@@ -1555,9 +1901,11 @@ void HeapSnapshotWriter::Write() {
     CountReferences(1);             // Root -> Image Pages
     CountReferences(num_isolates);  // Root -> Isolate
 
-    // Heap objects.
+    // Heap objects, in the order of HeapIterationScope::IterateObjects.
     iteration.IterateVMIsolateObjects(&visitor);
-    iteration.IterateObjects(&visitor);
+    H->new_space()->VisitObjects(&visitor);
+    EnumerateDataPages(&visitor, &object_slots);
+    VisitOtherOldObjects(&visitor);
 
     // External properties.
     isolate()->group()->VisitWeakPersistentHandles(&visitor);
@@ -1618,7 +1966,9 @@ void HeapSnapshotWriter::Write() {
     visitor.set_discount_sizes(true);
     iteration.IterateVMIsolateObjects(&visitor);
     visitor.set_discount_sizes(false);
-    iteration.IterateObjects(&visitor);
+    H->new_space()->VisitObjects(&visitor);
+    WriteDataPages(&visitor, &object_slots);
+    VisitOtherOldObjects(&visitor);
 
     // External properties.
     WriteUnsigned(external_property_count_);
@@ -1644,6 +1994,9 @@ void HeapSnapshotWriter::Write() {
 
   ClearObjectIds();
   Flush(true);
+
+  isolate_group()->GetHeapSnapshotPauseHistogram()->Add(
+      OS::GetCurrentMonotonicMicros() - start);
 }
 
 uint32_t HeapSnapshotWriter::GetHeapSnapshotIdentityHash(Thread* thread,
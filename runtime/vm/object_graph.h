@@ -9,12 +9,15 @@
 
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
+#include "vm/growable_array.h"
 #include "vm/thread_stack_resource.h"
 
 namespace dart {
 
 class Array;
 class Object;
+class ObjectSlots;
+class OldPage;
 class CountingPage;
 
 #if !defined(PRODUCT)
@@ -150,12 +153,11 @@ class VmServiceHeapSnapshotChunkedWriter : public ChunkedWriter {
   static const intptr_t kMetadataReservation = 512;
 };
 
-// Generates a dump of the heap, whose format is described in
-// runtime/vm/service/heap_snapshot.md.
-class HeapSnapshotWriter : public ThreadStackResource {
+// Encodes the values of a heap snapshot into a buffer. Subclasses make room
+// when the buffer is full.
+class HeapSnapshotBuffer {
  public:
-  HeapSnapshotWriter(Thread* thread, ChunkedWriter* writer)
-      : ThreadStackResource(thread), writer_(writer) {}
+  virtual ~HeapSnapshotBuffer() {}
 
   void WriteSigned(int64_t value) {
     EnsureAvailable((sizeof(value) * kBitsPerByte) / 7 + 1);
@@ -212,6 +214,33 @@ class HeapSnapshotWriter : public ThreadStackResource {
     WriteBytes(value, len);
   }
 
+ protected:
+  void EnsureAvailable(intptr_t needed) {
+    if ((capacity_ - size_) < needed) {
+      Reserve(needed);
+    }
+  }
+
+  // Makes room for at least [needed] more bytes.
+  virtual void Reserve(intptr_t needed) = 0;
+
+  uint8_t* buffer_ = nullptr;
+  intptr_t size_ = 0;
+  intptr_t capacity_ = 0;
+};
+
+// Generates a dump of the heap, whose format is described in
+// runtime/vm/service/heap_snapshot.md.
+//
+// The objects on the regular data pages of old space, which hold most of a
+// large heap, are enumerated and encoded by up to --heap_snapshot_tasks
+// helper threads, while this thread writes the encoded pages in heap order.
+class HeapSnapshotWriter : public ThreadStackResource,
+                           public HeapSnapshotBuffer {
+ public:
+  HeapSnapshotWriter(Thread* thread, ChunkedWriter* writer)
+      : ThreadStackResource(thread), writer_(writer) {}
+
   void AssignObjectId(ObjectPtr obj);
   intptr_t GetObjectId(ObjectPtr obj) const;
   void ClearObjectIds();
@@ -231,14 +260,23 @@ class HeapSnapshotWriter : public ThreadStackResource {
   bool OnImagePage(ObjectPtr obj) const;
   CountingPage* FindCountingPage(ObjectPtr obj) const;
 
-  void EnsureAvailable(intptr_t needed);
+  // Assigns the next ids to the objects on the data pages. Without helper
+  // tasks, [visitor] visits them on this thread instead.
+  void EnumerateDataPages(ObjectVisitor* visitor, ObjectSlots* object_slots);
+  // Writes the objects on the data pages. Without helper tasks, [visitor]
+  // visits them on this thread instead.
+  void WriteDataPages(ObjectVisitor* visitor, ObjectSlots* object_slots);
+  // Visits the objects of old space which are not on data pages, in heap
+  // iteration order.
+  void VisitOtherOldObjects(ObjectVisitor* visitor);
+
+  virtual void Reserve(intptr_t needed);
   void Flush(bool last = false);
 
   ChunkedWriter* writer_ = nullptr;
 
-  uint8_t* buffer_ = nullptr;
-  intptr_t size_ = 0;
-  intptr_t capacity_ = 0;
+  // The regular data pages of old space.
+  MallocGrowableArray<OldPage*> data_pages_;
 
   intptr_t class_count_ = 0;
   intptr_t object_count_ = 0;
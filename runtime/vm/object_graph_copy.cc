@@ -98,6 +98,12 @@ DEFINE_FLAG(bool,
             gc_on_foc_slow_path,
             false,
             "Cause a GC when falling off the fast path for fast object copy.");
+DEFINE_FLAG(bool,
+            share_deeply_immutable_objects,
+            false,
+            "Mark maps created by Map.unmodifiable as deeply immutable when "
+            "possible so that messages within an isolate group pass them by "
+            "reference.");
 
 const char* kFastAllocationFailed = "fast allocation failed";
 
@@ -149,6 +155,18 @@ static bool CanShareObject(ObjectPtr obj, uword tags) {
     return true;
   }
   const auto cid = UntaggedObject::ClassIdTag::decode(tags);
+  if ((tags & UntaggedObject::ImmutableBit::mask_in_place()) != 0 &&
+      !IsUnmodifiableTypedDataViewClassId(cid)) {
+    // Immutable typed data backing stores and graphs marked by
+    // [MakeDeeplyImmutable].
+    return true;
+  }
+  if ((tags & UntaggedObject::SharedBit::mask_in_place()) != 0) {
+    // Buffers allocated by [SharedTypedData] are deliberately aliased by all
+    // receivers.
+    ASSERT(cid == kExternalTypedDataUint8ArrayCid);
+    return true;
+  }
   if (cid == kOneByteStringCid) return true;
   if (cid == kTwoByteStringCid) return true;
   if (cid == kExternalOneByteStringCid) return true;
@@ -2270,6 +2288,191 @@ class ObjectGraphCopier : public StackResource {
   intptr_t allocated_bytes_ = 0;
 };
 
+// Marks an object graph as deeply immutable, see [MakeDeeplyImmutable].
+//
+// Objects are marked as soon as they are discovered, so the mark doubles as
+// the visited set. The marks are rolled back if the graph turns out to
+// contain a modifiable object.
+class DeeplyImmutableMarker : public ObjectPointerVisitor {
+ public:
+  DeeplyImmutableMarker(Thread* thread,
+                        ObjectPtr owned_collection,
+                        intptr_t max_objects)
+      : ObjectPointerVisitor(thread->isolate_group()),
+        zone_(thread->zone()),
+        class_table_(thread->isolate_group()->class_table()),
+        owned_collection_(owned_collection),
+        remaining_objects_(max_objects),
+        class_states_(zone_, 0),
+        klass_(Class::Handle(zone_)),
+        fields_(Array::Handle(zone_)),
+        field_(Field::Handle(zone_)) {}
+
+  bool Mark(ObjectPtr root) {
+    Push(root);
+    while (succeeded_ && !working_set_.is_empty()) {
+      ObjectPtr object = working_set_.RemoveLast();
+      if (object == owned_collection_) {
+        VisitOwnedCollection(static_cast<LinkedHashBasePtr>(object));
+      } else {
+        object->untag()->VisitPointers(this);
+      }
+    }
+    if (!succeeded_) {
+      for (intptr_t i = 0; i < marked_.length(); i++) {
+        marked_[i]->untag()->ClearImmutable();
+      }
+    }
+    return succeeded_;
+  }
+
+  void VisitPointers(ObjectPtr* from, ObjectPtr* to) override {
+    for (ObjectPtr* ptr = from; ptr <= to; ptr++) {
+      Push(*ptr);
+    }
+  }
+
+  void VisitCompressedPointers(uword heap_base,
+                               CompressedObjectPtr* from,
+                               CompressedObjectPtr* to) override {
+    for (CompressedObjectPtr* ptr = from; ptr <= to; ptr++) {
+      Push(ptr->Decompress(heap_base));
+    }
+  }
+
+ private:
+  enum ClassState : uint8_t { kUnknown, kFreezable, kNotFreezable };
+
+  void Push(ObjectPtr object) {
+    if (!succeeded_ || !object->IsHeapObject()) return;
+    const uword tags = TagsFromUntaggedObject(object.untag());
+    const intptr_t cid = UntaggedObject::ClassIdTag::decode(tags);
+    if (UntaggedObject::CanonicalBit::decode(tags)) return;
+    if (UntaggedObject::ImmutableBit::decode(tags) &&
+        !IsUnmodifiableTypedDataViewClassId(cid)) {
+      // Already deeply immutable or marked earlier during this traversal.
+      return;
+    }
+    if (--remaining_objects_ < 0) {
+      succeeded_ = false;
+      return;
+    }
+
+    if (object == owned_collection_ || cid == kImmutableArrayCid ||
+        IsFreezableInstance(cid)) {
+      object->untag()->SetImmutable();
+      marked_.Add(object);
+      working_set_.Add(object);
+      return;
+    }
+    // Number boxes are only shareable in AOT mode (see CanShareObject).
+    if (!CanShareObject(object, tags)) {
+      succeeded_ = false;
+    }
+  }
+
+  void VisitOwnedCollection(LinkedHashBasePtr collection) {
+    UntaggedLinkedHashBase* untagged = collection.untag();
+    const intptr_t used_data = Smi::Value(untagged->used_data());
+    if (used_data == 0 || Smi::Value(untagged->deleted_keys()) != 0) {
+      // Empty collections use the isolate's placeholder backing store, and
+      // deleted entries are overwritten with a marker object.
+      succeeded_ = false;
+      return;
+    }
+    Push(untagged->type_arguments());
+    ArrayPtr data = untagged->data();
+    // Other isolates read the backing store of a shared collection directly.
+    MarkBackingStore(data);
+    MarkBackingStore(untagged->index());
+    const intptr_t stride =
+        collection->GetClassId() == kLinkedHashMapCid ? 2 : 1;
+    for (intptr_t i = 0; i < used_data && succeeded_; i++) {
+      ObjectPtr element = data->untag()->element(i);
+      if ((i % stride) == 0 && MightNeedReHashing(element)) {
+        succeeded_ = false;
+        return;
+      }
+      Push(element);
+    }
+  }
+
+  void MarkBackingStore(ObjectPtr store) {
+    if (!store->IsHeapObject() || store->untag()->IsCanonical() ||
+        store->untag()->IsImmutable()) {
+      return;
+    }
+    store->untag()->SetImmutable();
+    marked_.Add(store);
+  }
+
+  bool IsFreezableInstance(intptr_t cid) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+    // Instance fields of AOT compiled classes might have been dropped, so
+    // we cannot check whether they are all final.
+    return false;
+#else
+    if (cid < kNumPredefinedCids) return false;
+    class_states_.EnsureLength(cid + 1, kUnknown);
+    if (class_states_[cid] == kUnknown) {
+      class_states_[cid] =
+          HasOnlyFinalFields(cid) ? kFreezable : kNotFreezable;
+    }
+    return class_states_[cid] == kFreezable;
+#endif
+  }
+
+  bool HasOnlyFinalFields(intptr_t cid) {
+    klass_ = class_table_->At(cid);
+    if (klass_.num_native_fields() != 0 || klass_.implements_finalizable()) {
+      return false;
+    }
+#if !defined(PRODUCT)
+    // Hot reload can make the fields of user classes mutable after their
+    // instances were shared. Platform libraries are never reloaded.
+    if (!Library::Handle(zone_, klass_.library()).is_dart_scheme()) {
+      return false;
+    }
+#endif
+    for (; !klass_.IsNull(); klass_ = klass_.SuperClass()) {
+      fields_ = klass_.fields();
+      for (intptr_t i = 0; i < fields_.Length(); i++) {
+        field_ ^= fields_.At(i);
+        if (field_.is_instance() && (!field_.is_final() || field_.is_late())) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  Zone* zone_;
+  ClassTable* class_table_;
+  ObjectPtr owned_collection_;
+  intptr_t remaining_objects_;
+  GrowableArray<ClassState> class_states_;
+  MallocGrowableArray<ObjectPtr> working_set_;
+  MallocGrowableArray<ObjectPtr> marked_;
+  Class& klass_;
+  Array& fields_;
+  Field& field_;
+  bool succeeded_ = true;
+};
+
+bool MakeDeeplyImmutable(Thread* thread,
+                         const Object& root,
+                         const Object& owned_collection,
+                         intptr_t max_objects) {
+  if (!FLAG_share_deeply_immutable_objects) return false;
+  ASSERT(owned_collection.IsNull() ||
+         owned_collection.GetClassId() == kLinkedHashMapCid ||
+         owned_collection.GetClassId() == kLinkedHashSetCid);
+  TIMELINE_DURATION(thread, Isolate, "MakeDeeplyImmutable");
+  NoSafepointScope no_safepoint_scope(thread);
+  DeeplyImmutableMarker marker(thread, owned_collection.ptr(), max_objects);
+  return marker.Mark(root.ptr());
+}
+
 ObjectPtr CopyMutableObjectGraph(const Object& object) {
   auto thread = Thread::Current();
   TIMELINE_DURATION(thread, Isolate, "CopyMutableObjectGraph");
@@ -5,10 +5,13 @@
 #ifndef RUNTIME_VM_OBJECT_GRAPH_COPY_H_
 #define RUNTIME_VM_OBJECT_GRAPH_COPY_H_
 
+#include "platform/globals.h"
+
 namespace dart {
 
 class Object;
 class ObjectPtr;
+class Thread;
 
 // Makes a transitive copy of the object graph referenced by [object]. Will not
 // copy objects that can be safely shared - due to being immutable.
@@ -25,6 +28,36 @@ class ObjectPtr;
 // those objects.
 ObjectPtr CopyMutableObjectGraph(const Object& root);
 
+// Marks the object graph referenced by [root] as deeply immutable, so that
+// [CopyMutableObjectGraph] passes it by reference instead of copying it.
+//
+// Succeeds only if every reachable object is unmodifiable: already shareable
+// objects, immutable arrays and (in JIT mode) instances of classes whose
+// instance fields are all final and not late. Outside of product mode only
+// platform classes qualify, because hot reload could make the fields of other
+// classes mutable. Nothing is marked if the graph contains any other object,
+// or if more than [max_objects] objects have to be checked: the traversal runs
+// without safepoints, so callers bound it by the work they already did to
+// build the graph.
+//
+// Double, Float32x4 and Float64x2 boxes are shareable in AOT mode only. In
+// JIT mode they may be the mutable boxes of unboxed fields, so graphs
+// containing them are never marked.
+//
+// [owned_collection] may be a default LinkedHashMap or LinkedHashSet which is
+// only reachable through [root] (e.g. the map wrapped by `Map.unmodifiable`)
+// and therefore can no longer be modified either. Its keys must have value
+// based hash codes, so that its index stays valid in every isolate. Its
+// backing store is marked along with it.
+//
+// Does nothing unless --share_deeply_immutable_objects is given.
+//
+// Returns whether the graph is now deeply immutable.
+bool MakeDeeplyImmutable(Thread* thread,
+                         const Object& root,
+                         const Object& owned_collection,
+                         intptr_t max_objects);
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_OBJECT_GRAPH_COPY_H_
@@ -0,0 +1,184 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/object_graph_copy.h"
+#include "platform/assert.h"
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, share_deeply_immutable_objects);
+
+// Returns the object the message [object] is received as.
+static ObjectPtr SendAndReceive(const Object& object) {
+  const auto& result =
+      Array::Handle(Array::RawCast(CopyMutableObjectGraph(object)));
+  return result.At(0);
+}
+
+ISOLATE_UNIT_TEST_CASE(MakeDeeplyImmutable_Arrays) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const auto& str = String::Handle(String::New("value"));
+  const auto& inner = Array::Handle(Array::New(2));
+  inner.SetAt(0, str);
+  inner.SetAt(1, Smi::Handle(Smi::New(42)));
+  inner.MakeImmutable();
+  const auto& outer = Array::Handle(Array::New(1));
+  outer.SetAt(0, inner);
+  outer.MakeImmutable();
+
+  EXPECT(MakeDeeplyImmutable(thread, outer, Object::null_object(), 100));
+  EXPECT(outer.ptr()->untag()->IsImmutable());
+  EXPECT(inner.ptr()->untag()->IsImmutable());
+  EXPECT(SendAndReceive(outer) == outer.ptr());
+
+  // Marking an already deeply immutable graph again is a no-op.
+  EXPECT(MakeDeeplyImmutable(thread, outer, Object::null_object(), 100));
+}
+
+ISOLATE_UNIT_TEST_CASE(MakeDeeplyImmutable_RollsBackOnModifiableObject) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const auto& mutable_list =
+      GrowableObjectArray::Handle(GrowableObjectArray::New());
+  const auto& inner = Array::Handle(Array::New(1));
+  inner.MakeImmutable();
+  const auto& outer = Array::Handle(Array::New(2));
+  outer.SetAt(0, inner);
+  outer.SetAt(1, mutable_list);
+  outer.MakeImmutable();
+
+  EXPECT(!MakeDeeplyImmutable(thread, outer, Object::null_object(), 100));
+  EXPECT(!outer.ptr()->untag()->IsImmutable());
+  EXPECT(!inner.ptr()->untag()->IsImmutable());
+  EXPECT(!MakeDeeplyImmutable(thread, mutable_list, Object::null_object(),
+                              100));
+}
+
+ISOLATE_UNIT_TEST_CASE(MakeDeeplyImmutable_ObjectLimit) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const auto& outer = Array::Handle(Array::New(10));
+  auto& inner = Array::Handle();
+  for (intptr_t i = 0; i < outer.Length(); i++) {
+    inner = Array::New(1);
+    inner.MakeImmutable();
+    outer.SetAt(i, inner);
+  }
+  outer.MakeImmutable();
+
+  // The outer array and 10 inner arrays have to be checked.
+  EXPECT(!MakeDeeplyImmutable(thread, outer, Object::null_object(), 10));
+  EXPECT(!outer.ptr()->untag()->IsImmutable());
+  EXPECT(!inner.ptr()->untag()->IsImmutable());
+  EXPECT(MakeDeeplyImmutable(thread, outer, Object::null_object(), 11));
+  EXPECT(outer.ptr()->untag()->IsImmutable());
+  EXPECT(inner.ptr()->untag()->IsImmutable());
+}
+
+ISOLATE_UNIT_TEST_CASE(MakeDeeplyImmutable_NumberBoxes) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const auto& value = Double::Handle(Double::New(1.5));
+  const auto& array = Array::Handle(Array::New(1));
+  array.SetAt(0, value);
+  array.MakeImmutable();
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+  EXPECT(MakeDeeplyImmutable(thread, array, Object::null_object(), 100));
+  EXPECT(array.ptr()->untag()->IsImmutable());
+#else
+  // Boxes may be mutable boxes of unboxed fields in JIT mode.
+  EXPECT(!MakeDeeplyImmutable(thread, array, Object::null_object(), 100));
+  EXPECT(!array.ptr()->untag()->IsImmutable());
+#endif
+  EXPECT(!value.ptr()->untag()->IsImmutable());
+}
+
+TEST_CASE(MakeDeeplyImmutable_UnmodifiableMap) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const char* kScriptChars = R"(
+    class Point {
+      final int x;
+      final int y;
+      Point(this.x, this.y);
+    }
+    class Counter {
+      int count = 0;
+    }
+    frozenMap() => Map<String, Object>.unmodifiable({
+      'a': 'b',
+      'c': List<String>.unmodifiable(['d', 'e']),
+    });
+    userInstanceMap() => Map<String, Object>.unmodifiable({'a': Point(1, 2)});
+    mutableValueMap() => Map<String, Object>.unmodifiable({'a': Counter()});
+    identityKeyMap() => Map<Object, String>.unmodifiable({Point(1, 2): 'a'});
+  )";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, nullptr);
+  EXPECT_VALID(lib);
+  Dart_Handle frozen = Dart_Invoke(lib, NewString("frozenMap"), 0, nullptr);
+  EXPECT_VALID(frozen);
+  Dart_Handle user_instance =
+      Dart_Invoke(lib, NewString("userInstanceMap"), 0, nullptr);
+  EXPECT_VALID(user_instance);
+  Dart_Handle mutable_value =
+      Dart_Invoke(lib, NewString("mutableValueMap"), 0, nullptr);
+  EXPECT_VALID(mutable_value);
+  Dart_Handle identity_key =
+      Dart_Invoke(lib, NewString("identityKeyMap"), 0, nullptr);
+  EXPECT_VALID(identity_key);
+
+  TransitionNativeToVM transition(thread);
+  const auto& frozen_map = Object::Handle(Api::UnwrapHandle(frozen));
+  EXPECT(frozen_map.ptr()->untag()->IsImmutable());
+  EXPECT(SendAndReceive(frozen_map) == frozen_map.ptr());
+
+  // Hot reload could make the fields of user classes mutable.
+  const auto& user_instance_map =
+      Object::Handle(Api::UnwrapHandle(user_instance));
+#if defined(PRODUCT)
+  EXPECT(user_instance_map.ptr()->untag()->IsImmutable());
+#else
+  EXPECT(!user_instance_map.ptr()->untag()->IsImmutable());
+#endif
+
+  const auto& mutable_value_map =
+      Object::Handle(Api::UnwrapHandle(mutable_value));
+  EXPECT(!mutable_value_map.ptr()->untag()->IsImmutable());
+  EXPECT(SendAndReceive(mutable_value_map) != mutable_value_map.ptr());
+
+  // Keys hashed by identity might hash differently in another isolate.
+  const auto& identity_key_map =
+      Object::Handle(Api::UnwrapHandle(identity_key));
+  EXPECT(!identity_key_map.ptr()->untag()->IsImmutable());
+}
+
+TEST_CASE(MakeDeeplyImmutable_OwnedCollectionBackingStore) {
+  SetFlagScope<bool> sfs(&FLAG_share_deeply_immutable_objects, true);
+  const char* kScriptChars = R"(
+    ownedMap() => <String, Object>{'a': 'b', 'c': 1};
+    emptyMap() => <String, Object>{};
+  )";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, nullptr);
+  EXPECT_VALID(lib);
+  Dart_Handle owned = Dart_Invoke(lib, NewString("ownedMap"), 0, nullptr);
+  EXPECT_VALID(owned);
+  Dart_Handle empty = Dart_Invoke(lib, NewString("emptyMap"), 0, nullptr);
+  EXPECT_VALID(empty);
+
+  TransitionNativeToVM transition(thread);
+  const auto& owned_map =
+      LinkedHashMap::Handle(LinkedHashMap::RawCast(Api::UnwrapHandle(owned)));
+  EXPECT(MakeDeeplyImmutable(thread, owned_map, owned_map, 100));
+  EXPECT(owned_map.ptr()->untag()->IsImmutable());
+  EXPECT(owned_map.data()->untag()->IsImmutable());
+  EXPECT(owned_map.index()->untag()->IsImmutable());
+
+  // Empty maps share their backing store with other maps of the isolate.
+  const auto& empty_map =
+      LinkedHashMap::Handle(LinkedHashMap::RawCast(Api::UnwrapHandle(empty)));
+  EXPECT(!MakeDeeplyImmutable(thread, empty_map, empty_map, 100));
+  EXPECT(!empty_map.ptr()->untag()->IsImmutable());
+  EXPECT(!empty_map.data()->untag()->IsImmutable());
+}
+
+}  // namespace dart
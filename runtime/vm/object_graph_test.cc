@@ -3,6 +3,7 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "vm/object_graph.h"
+#include "include/dart_tools_api.h"
 #include "platform/assert.h"
 #include "vm/unit_test.h"
 
@@ -190,6 +191,71 @@ ISOLATE_UNIT_TEST_CASE(RetainingPathGCRoot) {
   EXPECT_STREQ(result.gc_root_type, "local handle");
 }
 
+class MemoryChunkedWriter : public ChunkedWriter {
+ public:
+  explicit MemoryChunkedWriter(Thread* thread) : ChunkedWriter(thread) {}
+  ~MemoryChunkedWriter() { free(buffer_); }
+
+  virtual void WriteChunk(uint8_t* buffer, intptr_t size, bool last) {
+    buffer_ = reinterpret_cast<uint8_t*>(realloc(buffer_, size_ + size));
+    memmove(&buffer_[size_], buffer, size);
+    size_ += size;
+    free(buffer);
+  }
+
+  const uint8_t* buffer() const { return buffer_; }
+  intptr_t size() const { return size_; }
+
+ private:
+  uint8_t* buffer_ = nullptr;
+  intptr_t size_ = 0;
+};
+
+DECLARE_FLAG(int, heap_snapshot_tasks);
+
+static void WriteHeapSnapshot(Thread* thread,
+                              intptr_t num_tasks,
+                              MemoryChunkedWriter* out) {
+  SetFlagScope<int> sfs(&FLAG_heap_snapshot_tasks, num_tasks);
+  HeapSnapshotWriter writer(thread, out);
+  writer.Write();
+}
+
+ISOLATE_UNIT_TEST_CASE(HeapSnapshot_ParallelWriter) {
+  // Fill several old-space pages.
+  const intptr_t kLength = 50000;
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  String& str = String::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    str = String::New("a string on an old-space page", Heap::kOld);
+    array.SetAt(i, str);
+  }
+
+  // Without helper tasks the data pages are enumerated and written by the
+  // same visitors as all other objects, one object at a time.
+  MemoryChunkedWriter serial(thread);
+  WriteHeapSnapshot(thread, 0, &serial);
+  // With a single helper, the requesting thread also encodes the pages which
+  // it needs before the helper claims them.
+  MemoryChunkedWriter one_task(thread);
+  WriteHeapSnapshot(thread, 1, &one_task);
+  MemoryChunkedWriter four_tasks(thread);
+  WriteHeapSnapshot(thread, 4, &four_tasks);
+
+  // Writing the data pages in parallel doesn't change the snapshot.
+  EXPECT(serial.size() > kLength);
+  EXPECT_EQ(serial.size(), one_task.size());
+  EXPECT(memcmp(serial.buffer(), one_task.buffer(), serial.size()) == 0);
+  EXPECT_EQ(serial.size(), four_tasks.size());
+  EXPECT(memcmp(serial.buffer(), four_tasks.buffer(), serial.size()) == 0);
+
+  Dart_MetricHistogram histogram;
+  Dart_IsolateGroupHeapSnapshotPauseHistogram(
+      reinterpret_cast<Dart_IsolateGroup>(thread->isolate_group()),
+      &histogram);
+  EXPECT_EQ(3, histogram.count);
+}
+
 #endif  // !defined(PRODUCT)
 
 }  // namespace dart
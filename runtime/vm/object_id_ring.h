@@ -53,6 +53,8 @@ class ObjectIdRing {
 
   void PrintJSON(JSONStream* js);
 
+  int32_t capacity() const { return capacity_; }
+
  private:
   friend class ObjectIdRingTestHelper;
 
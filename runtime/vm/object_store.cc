@@ -579,6 +579,10 @@ void ObjectStore::LazyInitIsolateMembers() {
     function = cls.LookupFunctionAllowPrivate(Symbols::_handleMessage());
     ASSERT(!function.IsNull());
     handle_message_function_.store(function.ptr());
+
+    function = cls.LookupFunctionAllowPrivate(Symbols::_handleMessages());
+    ASSERT(!function.IsNull());
+    handle_messages_function_.store(function.ptr());
   }
 }
 
@@ -63,6 +63,7 @@ class ObjectPointerVisitor;
   LAZY_ISOLATE(Function, lookup_port_handler)                                  \
   LAZY_ISOLATE(Function, lookup_open_ports)                                    \
   LAZY_ISOLATE(Function, handle_message_function)                              \
+  LAZY_ISOLATE(Function, handle_messages_function)                             \
   RW(Class, object_class)                                                      \
   RW(Type, object_type)                                                        \
   RW(Type, legacy_object_type)                                                 \
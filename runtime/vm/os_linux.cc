@@ -23,6 +23,7 @@
 #include "platform/memory_sanitizer.h"
 #include "platform/utils.h"
 #include "vm/code_comments.h"
+#include "vm/code_descriptors.h"
 #include "vm/code_observers.h"
 #include "vm/dart.h"
 #include "vm/flags.h"
@@ -48,6 +49,12 @@ DEFINE_FLAG(bool,
             "Generate jitdump file to use with perf-inject (disables dual code "
             "mapping)");
 
+DEFINE_FLAG(bool,
+            generate_perf_jitdump_source_positions,
+            true,
+            "Annotate Dart code in the jitdump file with its source positions "
+            "rather than with code comments");
+
 DECLARE_FLAG(bool, write_protect_code);
 DECLARE_FLAG(bool, write_protect_vm_isolate);
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -92,7 +99,8 @@ class PerfCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const Code* code) {
     Dart_FileWriteCallback file_write = Dart::file_write_callback();
     if ((file_write == NULL) || (out_file_ == NULL)) {
       return;
@@ -123,6 +131,15 @@ class PerfCodeObserver : public CodeObserver {
 //   $ perf inject -j -i perf.data -o perf.data.jitted
 //   $ perf report -i perf.data.jitted
 //
+// perf-annotate shows the Dart source lines of code compiled from Dart
+// functions (see --generate-perf-jitdump-source-positions) and the code
+// comments of all other code.
+//
+// Code objects are never moved, because code pages are not compacted, so no
+// JIT_CODE_MOVE records are needed. Instructions of collected code objects
+// may be reused for new ones, in which case perf attributes samples to the
+// most recent JIT_CODE_LOAD record for the address.
+//
 // [1] see linux/tools/perf/Documentation/jitdump-specification.txt for
 //     JITDUMP binary format.
 class JitDumpCodeObserver : public CodeObserver {
@@ -178,6 +195,14 @@ class JitDumpCodeObserver : public CodeObserver {
   }
 
   ~JitDumpCodeObserver() {
+    if (out_file_ != nullptr) {
+      BaseEvent ev;
+      ev.event = BaseEvent::kClose;
+      ev.size = sizeof(ev);
+      ev.time_stamp = OS::GetCurrentMonotonicTicks();
+      WriteFully(&ev, sizeof(ev));
+    }
+
     if (mapped_ != nullptr) {
       munmap(mapped_, mapped_size_);
       mapped_ = nullptr;
@@ -198,14 +223,29 @@ class JitDumpCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
-    MutexLocker ml(CodeObservers::mutex());
-
+                      const CodeComments* comments,
+                      const Code* code) {
+    Zone* zone = Thread::Current()->zone();
     const char* marker = optimized ? "*" : "";
-    char* buffer = OS::SCreate(Thread::Current()->zone(), "%s%s", marker, name);
+    char* buffer = OS::SCreate(zone, "%s%s", marker, name);
     const size_t name_length = strlen(buffer);
 
-    WriteDebugInfo(base, comments);
+    // Resolving source positions may allocate, so it has to happen before
+    // taking the lock.
+    GrowableArray<SourceLine> lines(zone, 0);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    if (FLAG_generate_perf_jitdump_source_positions && (code != nullptr)) {
+      CollectSourceLines(zone, *code, &lines);
+    }
+#endif
+
+    MutexLocker ml(CodeObservers::mutex());
+
+    if (lines.is_empty()) {
+      WriteDebugInfo(base, comments);
+    } else {
+      WriteDebugInfo(base, lines);
+    }
 
     CodeLoadEvent ev;
     ev.event = BaseEvent::kLoad;
@@ -271,6 +311,14 @@ class JitDumpCodeObserver : public CodeObserver {
     // Followed by nul-terminated name.
   };
 
+  // The source line of the instructions from |pc_offset| up to the next
+  // source line.
+  struct SourceLine {
+    intptr_t pc_offset;
+    const char* file_name;
+    int32_t line_number;
+  };
+
   // ELF machine architectures
   // From linux/include/uapi/linux/elf-em.h
   static const uint32_t EM_386 = 3;
@@ -364,6 +412,91 @@ class JitDumpCodeObserver : public CodeObserver {
     free(comments_file_name);
   }
 
+  void WriteDebugInfo(uword base, const GrowableArray<SourceLine>& lines) {
+    DebugInfoEvent info;
+    info.event = BaseEvent::kDebugInfo;
+    info.time_stamp = OS::GetCurrentMonotonicTicks();
+    info.address = base;
+    info.entry_count = lines.length();
+    info.size = sizeof(info);
+    for (intptr_t i = 0; i < lines.length(); i++) {
+      info.size += sizeof(DebugInfoEntry) + strlen(lines[i].file_name) + 1;
+    }
+    const int32_t padding = Utils::RoundUp(info.size, 8) - info.size;
+    info.size += padding;
+
+    WriteFully(&info, sizeof(info));
+    for (intptr_t i = 0; i < lines.length(); i++) {
+      DebugInfoEntry entry;
+      entry.address = base + lines[i].pc_offset + kElfHeaderSize;
+      entry.line_number = lines[i].line_number;
+      entry.column = 0;
+      WriteFully(&entry, sizeof(entry));
+      WriteFully(lines[i].file_name, strlen(lines[i].file_name) + 1);
+    }
+
+    const char padding_bytes[8] = {0};
+    WriteFully(padding_bytes, padding);
+  }
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Collects the source lines of the innermost (possibly inlined) functions
+  // the instructions of |code| were compiled from.
+  static void CollectSourceLines(Zone* zone,
+                                 const Code& code,
+                                 GrowableArray<SourceLine>* lines) {
+    const auto& map = CodeSourceMap::Handle(zone, code.code_source_map());
+    if (map.IsNull() || !code.IsFunctionCode()) {
+      return;  // VM stub, allocation stub, or type testing stub.
+    }
+    const auto& root = Function::Handle(zone, code.function());
+    if (root.IsNull()) {
+      return;
+    }
+    const auto& functions = Array::Handle(zone, code.inlined_id_to_function());
+    CodeSourceMapReader reader(map, functions, root);
+    GrowableArray<CodeSourceMapReader::SourcePositionInterval> intervals(zone,
+                                                                         0);
+    reader.GetSourcePositionIntervals(&intervals);
+
+    auto& script = Script::Handle(zone);
+    auto& last_script = Script::Handle(zone);
+    auto& url = String::Handle(zone);
+    const char* file_name = nullptr;
+    for (intptr_t i = 0; i < intervals.length(); i++) {
+      const auto& interval = intervals[i];
+      script = interval.function->script();
+      intptr_t line = -1;
+      intptr_t column = -1;
+      if (script.IsNull() ||
+          !script.GetTokenLocation(interval.token_pos, &line, &column)) {
+        continue;
+      }
+      if (script.ptr() != last_script.ptr()) {
+        last_script = script.ptr();
+        url = script.url();
+        file_name = FileNameFromUrl(url.ToCString());
+      }
+      if (!lines->is_empty() && (lines->Last().line_number == line) &&
+          (lines->Last().file_name == file_name)) {
+        continue;
+      }
+      SourceLine source_line = {interval.pc_offset, file_name,
+                                static_cast<int32_t>(line)};
+      lines->Add(source_line);
+    }
+  }
+
+  // perf-annotate looks up the sources of file: URLs on the local file system.
+  static const char* FileNameFromUrl(const char* url) {
+    static const char kFileScheme[] = "file://";
+    if (strncmp(url, kFileScheme, strlen(kFileScheme)) == 0) {
+      return url + strlen(kFileScheme);
+    }
+    return url;
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
   void WriteHeader() {
     Header header;
     header.elf_mach_target = GetElfMachineArchitecture();
@@ -75,6 +75,9 @@ OSThread::~OSThread() {
     FATAL("Thread exited without calling Dart_ExitIsolate");
   }
   RemoveThreadFromList(this);
+#if !defined(PRODUCT)
+  ThreadInterrupter::RemoveThread(this);
+#endif
   delete log_;
   log_ = NULL;
 #if defined(SUPPORT_TIMELINE)
@@ -293,6 +293,11 @@ class OSThread : public BaseThread {
   // started by a ThreadPool it will be nullptr. This TLS value is not
   // protected and should only be read/written by the OSThread itself.
   void* owning_thread_pool_worker_ = nullptr;
+#if !defined(PRODUCT) && defined(DART_HOST_OS_LINUX)
+  // The performance counter interrupting this thread when the profiler
+  // samples a hardware event, or -1. Protected by |thread_list_lock_|.
+  int perf_event_fd_ = -1;
+#endif
 
   // thread_list_lock_ cannot have a static lifetime because the order in which
   // destructors run is undefined. At the moment this lock cannot be deleted
@@ -307,6 +312,7 @@ class OSThread : public BaseThread {
 
   friend class IsolateGroup;  // to access set_thread(Thread*).
   friend class OSThreadIterator;
+  friend class ThreadInterrupter;  // to access perf_event_fd_
   friend class ThreadInterrupterFuchsia;
   friend class ThreadInterrupterMacOS;
   friend class ThreadInterrupterWin;
@@ -40,6 +40,17 @@ DEFINE_FLAG(int,
             profile_period,
             1000,
             "Time between profiler samples in microseconds. Minimum 50.");
+DEFINE_FLAG(charp,
+            profile_event,
+            "timer",
+            "Event which triggers profiler samples: timer, cycles, "
+            "instructions, cache-misses or branch-misses. Hardware events "
+            "are only supported on Linux.");
+DEFINE_FLAG(int,
+            profile_event_period,
+            0,
+            "Number of hardware events between profiler samples of a thread. "
+            "If 0, a default for --profile_event is used.");
 DEFINE_FLAG(int,
             max_profile_depth,
             Sample::kPCArraySizeInWords* kMaxSamplesPerTick,
@@ -583,9 +594,10 @@ class SampleBlockCleanupVisitor : public IsolateVisitor {
 
   void VisitIsolate(Isolate* isolate) {
     isolate->set_current_allocation_sample_block(nullptr);
-    {
-      MutexLocker ml(isolate->current_sample_block_lock());
-      isolate->set_current_sample_block(nullptr);
+    // Helper threads release their blocks when they exit the isolate.
+    Thread* mutator = isolate->mutator_thread();
+    if (mutator != nullptr) {
+      mutator->set_current_sample_block(nullptr);
     }
   }
 };
@@ -673,11 +685,18 @@ SampleBlockBuffer::SampleBlockBuffer(intptr_t blocks,
   }
   capacity_ = blocks;
   cursor_ = 0;
-  free_list_head_ = nullptr;
-  free_list_tail_ = nullptr;
+  free_slots_ = new FreeBlockSlot[blocks];
+  for (intptr_t i = 0; i < blocks; ++i) {
+    free_slots_[i].sequence.store(i, std::memory_order_relaxed);
+    free_slots_[i].block = nullptr;
+  }
+  free_head_ = 0;
+  free_tail_ = 0;
 }
 
 SampleBlockBuffer::~SampleBlockBuffer() {
+  delete[] free_slots_;
+  free_slots_ = nullptr;
   delete[] blocks_;
   blocks_ = nullptr;
   delete memory_;
@@ -707,6 +726,53 @@ SampleBlock* SampleBlockBuffer::ReserveSampleBlock() {
   return block;
 }
 
+// The free block queue is a bounded multi-producer multi-consumer queue in
+// the style of D. Vyukov: each slot carries a sequence number telling
+// producers and consumers whether it is free to write or ready to read for
+// a given position.
+void SampleBlockBuffer::FreeBlock(SampleBlock* block) {
+  ASSERT(block->next_free_ == nullptr);
+  intptr_t position = free_tail_.load(std::memory_order_relaxed);
+  while (true) {
+    FreeBlockSlot* slot = &free_slots_[position % capacity_];
+    const intptr_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (free_tail_.compare_exchange_weak(position, position + 1,
+                                           std::memory_order_relaxed)) {
+        slot->block = block;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return;
+      }
+    } else {
+      // Another producer claimed this position first.
+      ASSERT(sequence > position);
+      position = free_tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+SampleBlock* SampleBlockBuffer::GetFreeBlock() {
+  intptr_t position = free_head_.load(std::memory_order_relaxed);
+  while (true) {
+    FreeBlockSlot* slot = &free_slots_[position % capacity_];
+    const intptr_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == position + 1) {
+      if (free_head_.compare_exchange_weak(position, position + 1,
+                                           std::memory_order_relaxed)) {
+        SampleBlock* block = slot->block;
+        slot->sequence.store(position + capacity_, std::memory_order_release);
+        return block;
+      }
+    } else if (sequence < position + 1) {
+      // The queue is empty, or the block at its head is still being freed.
+      return nullptr;
+    } else {
+      // Another consumer claimed this position first.
+      position = free_head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
 void SampleBlockBuffer::ProcessCompletedBlocks() {
   Thread* thread = Thread::Current();
   DisableThreadInterruptsScope dtis(thread);
@@ -798,9 +864,10 @@ Sample* SampleBlock::ReserveSampleAndLink(Sample* previous) {
   SampleBlockBuffer* buffer = Profiler::sample_block_buffer();
   Isolate* isolate = owner_;
   ASSERT(isolate != nullptr);
+  ASSERT(previous->is_allocation_sample() || (thread_ != nullptr));
   Sample* next = previous->is_allocation_sample()
                      ? buffer->ReserveAllocationSample(isolate)
-                     : buffer->ReserveCPUSample(isolate);
+                     : buffer->ReserveCPUSample(thread_);
   if (next == nullptr) {
     return nullptr;  // No blocks left, so drop sample.
   }
@@ -811,54 +878,57 @@ Sample* SampleBlock::ReserveSampleAndLink(Sample* previous) {
   return next;
 }
 
-Sample* SampleBlockBuffer::ReserveCPUSample(Isolate* isolate) {
-  return ReserveSampleImpl(isolate, false);
+Sample* SampleBlockBuffer::ReserveCPUSample(Thread* thread) {
+  SampleBlock* block = thread->current_sample_block();
+  if (block != nullptr) {
+    Sample* sample = block->ReserveSample();
+    if (sample != nullptr) {
+      return sample;
+    }
+  }
+  SampleBlock* next = ReserveSampleBlock();
+  if (next == nullptr) {
+    // We're out of blocks to reserve. Drop the sample.
+    return nullptr;
+  }
+  Isolate* isolate = thread->isolate();
+  next->set_is_allocation_block(false);
+  next->set_owner(isolate);
+  next->set_thread(thread);
+  thread->set_current_sample_block(next);
+  if (block != nullptr) {
+    block->owner()->FreeSampleBlock(block);
+  }
+  ScheduleBlockProcessing(isolate);
+  return next->ReserveSample();
 }
 
 Sample* SampleBlockBuffer::ReserveAllocationSample(Isolate* isolate) {
-  return ReserveSampleImpl(isolate, true);
-}
-
-Sample* SampleBlockBuffer::ReserveSampleImpl(Isolate* isolate,
-                                             bool allocation_sample) {
-  SampleBlock* block = allocation_sample
-                           ? isolate->current_allocation_sample_block()
-                           : isolate->current_sample_block();
-  Sample* sample = nullptr;
+  SampleBlock* block = isolate->current_allocation_sample_block();
   if (block != nullptr) {
-    sample = block->ReserveSample();
-  }
-  if (sample != nullptr) {
-    return sample;
-  }
-  SampleBlock* next = nullptr;
-  if (allocation_sample) {
-    // We only need to be locked while accessing the CPU sample block since
-    // Dart allocations can only occur on the mutator thread.
-    next = ReserveSampleBlock();
-    if (next == nullptr) {
-      // We're out of blocks to reserve. Drop the sample.
-      return nullptr;
-    }
-    isolate->set_current_allocation_sample_block(next);
-    isolate->FreeSampleBlock(block);
-  } else {
-    MutexLocker locker(isolate->current_sample_block_lock());
-    next = ReserveSampleBlock();
-    if (next == nullptr) {
-      // We're out of blocks to reserve. Drop the sample.
-      return nullptr;
+    Sample* sample = block->ReserveSample();
+    if (sample != nullptr) {
+      return sample;
     }
-    isolate->set_current_sample_block(next);
-    isolate->FreeSampleBlock(block);
   }
-  next->set_is_allocation_block(allocation_sample);
+  // Dart allocations can only occur on the mutator thread, so the current
+  // allocation block is never contended.
+  SampleBlock* next = ReserveSampleBlock();
+  if (next == nullptr) {
+    // We're out of blocks to reserve. Drop the sample.
+    return nullptr;
+  }
+  isolate->set_current_allocation_sample_block(next);
+  isolate->FreeSampleBlock(block);
+  ScheduleBlockProcessing(isolate);
+  return next->ReserveSample();
+}
 
+void SampleBlockBuffer::ScheduleBlockProcessing(Isolate* isolate) {
   bool scheduled = can_process_block_.exchange(true);
   if (!scheduled) {
     isolate->mutator_thread()->ScheduleInterrupts(Thread::kVMInterrupt);
   }
-  return ReserveSampleImpl(isolate, allocation_sample);
 }
 
 AllocationSampleBuffer::AllocationSampleBuffer(intptr_t capacity) {
@@ -1314,7 +1384,7 @@ static Sample* SetupSample(Thread* thread,
   Isolate* isolate = thread->isolate();
   SampleBlockBuffer* buffer = Profiler::sample_block_buffer();
   Sample* sample = allocation_sample ? buffer->ReserveAllocationSample(isolate)
-                                     : buffer->ReserveCPUSample(isolate);
+                                     : buffer->ReserveCPUSample(thread);
   if (sample == nullptr) {
     return nullptr;
   }
@@ -1611,11 +1681,11 @@ void Profiler::SampleThread(Thread* thread,
 
   ProfilerNativeStackWalker native_stack_walker(
       &counters_, (isolate != NULL) ? isolate->main_port() : ILLEGAL_PORT,
-      sample, isolate->current_sample_block(), stack_lower, stack_upper, pc, fp,
+      sample, thread->current_sample_block(), stack_lower, stack_upper, pc, fp,
       sp);
   const bool exited_dart_code = thread->HasExitedDartCode();
   ProfilerDartStackWalker dart_stack_walker(
-      thread, sample, isolate->current_sample_block(), pc, fp, sp, lr,
+      thread, sample, thread->current_sample_block(), pc, fp, sp, lr,
       /* allocation_sample*/ false);
 
   // All memory access is done inside CollectSample.
@@ -720,6 +720,7 @@ class SampleBlock : public SampleBuffer {
 
   void Clear() {
     allocation_block_ = false;
+    thread_ = nullptr;
     cursor_ = 0;
     full_ = false;
     evictable_ = false;
@@ -738,6 +739,11 @@ class SampleBlock : public SampleBuffer {
   Isolate* owner() const { return owner_; }
   void set_owner(Isolate* isolate) { owner_ = isolate; }
 
+  // The thread writing its CPU samples into this block, or nullptr for
+  // allocation blocks.
+  Thread* thread() const { return thread_; }
+  void set_thread(Thread* thread) { thread_ = thread; }
+
   // Manually marks the block as full so it can be processed and added back to
   // the pool of available blocks.
   void release_block() { full_.store(true); }
@@ -759,6 +765,7 @@ class SampleBlock : public SampleBuffer {
   bool HasStreamableSamples(const GrowableObjectArray& tag_table, UserTag* tag);
 
   Isolate* owner_ = nullptr;
+  Thread* thread_ = nullptr;
   bool allocation_block_ = false;
 
   intptr_t index_;
@@ -810,10 +817,12 @@ class SampleBlockBuffer : public ProcessedSampleBufferBuilder {
   // (i.e., safe to be re-allocated and re-used).
   void ProcessCompletedBlocks();
 
-  // Reserves a sample for a CPU profile.
+  // Reserves a sample for a CPU profile in the current sample block of
+  // |thread|. Every thread fills its own block, so this neither takes locks
+  // nor contends with other threads until the block is full.
   //
   // Returns nullptr when a sample can't be reserved.
-  Sample* ReserveCPUSample(Isolate* isolate);
+  Sample* ReserveCPUSample(Thread* thread);
 
   // Reserves a sample for a Dart object allocation profile.
   //
@@ -827,46 +836,32 @@ class SampleBlockBuffer : public ProcessedSampleBufferBuilder {
       ProcessedSampleBuffer* buffer = nullptr);
 
  private:
-  Sample* ReserveSampleImpl(Isolate* isolate, bool allocation_sample);
-
   // Returns nullptr if there are no available blocks.
   SampleBlock* ReserveSampleBlock();
 
-  void FreeBlock(SampleBlock* block) {
-    ASSERT(block->next_free_ == nullptr);
-    MutexLocker ml(&free_block_lock_);
-    if (free_list_head_ == nullptr) {
-      free_list_head_ = block;
-      free_list_tail_ = block;
-      return;
-    }
-    free_list_tail_->next_free_ = block;
-    free_list_tail_ = block;
-  }
+  // Requests |isolate| to process its completed blocks.
+  void ScheduleBlockProcessing(Isolate* isolate);
 
-  SampleBlock* GetFreeBlock() {
-    MutexLocker ml(&free_block_lock_);
-    if (free_list_head_ == nullptr) {
-      return nullptr;
-    }
-    SampleBlock* block = free_list_head_;
-    free_list_head_ = block->next_free_;
-    if (free_list_head_ == nullptr) {
-      free_list_tail_ = nullptr;
-    }
-    block->next_free_ = nullptr;
-    return block;
-  }
+  // Processed blocks are recycled oldest first through a bounded lock-free
+  // FIFO queue, as blocks are reserved from within signal handlers. Every
+  // block is queued at most once, so the queue never overflows.
+  void FreeBlock(SampleBlock* block);
+  SampleBlock* GetFreeBlock();
+
+  struct FreeBlockSlot {
+    std::atomic<intptr_t> sequence;
+    SampleBlock* block;
+  };
 
-  Mutex free_block_lock_;
   RelaxedAtomic<bool> can_process_block_ = false;
 
   // Sample block management.
   RelaxedAtomic<int> cursor_;
   SampleBlock* blocks_;
   intptr_t capacity_;
-  SampleBlock* free_list_head_;
-  SampleBlock* free_list_tail_;
+  FreeBlockSlot* free_slots_;
+  std::atomic<intptr_t> free_head_;
+  std::atomic<intptr_t> free_tail_;
 
   // Sample buffer management.
   VirtualMemory* memory_;
@@ -0,0 +1,761 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/profiler_pprof.h"
+
+#include <math.h>
+
+#include "vm/dart.h"
+#include "vm/datastream.h"
+#include "vm/flags.h"
+#include "vm/hash.h"
+#include "vm/heap/heap.h"
+#include "vm/heap/safepoint.h"
+#include "vm/heap/sampler.h"
+#include "vm/heap/weak_table.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/profiler.h"
+#include "vm/profiler_service.h"
+#include "vm/reverse_pc_lookup_cache.h"
+#include "vm/thread_interrupter.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DEFINE_FLAG(charp,
+            profile_export_dir,
+            nullptr,
+            "Continuously write the CPU samples and sampled allocations of "
+            "each isolate to pprof files in this directory.");
+DEFINE_FLAG(int,
+            profile_export_interval,
+            10,
+            "Seconds covered by each file written to --profile_export_dir.");
+
+DECLARE_FLAG(int, profile_period);
+
+// Field numbers of the messages in profile.proto.
+enum ProfileField {
+  kProfileSampleType = 1,
+  kProfileSample = 2,
+  kProfileLocation = 4,
+  kProfileFunction = 5,
+  kProfileStringTable = 6,
+  kProfileTimeNanos = 9,
+  kProfileDurationNanos = 10,
+  kProfilePeriodType = 11,
+  kProfilePeriod = 12,
+};
+
+enum ValueTypeField {
+  kValueTypeType = 1,
+  kValueTypeUnit = 2,
+};
+
+enum SampleField {
+  kSampleLocationId = 1,
+  kSampleValue = 2,
+};
+
+enum LocationField {
+  kLocationId = 1,
+  kLocationLine = 4,
+};
+
+enum LineField {
+  kLineFunctionId = 1,
+  kLineLine = 2,
+};
+
+enum FunctionField {
+  kFunctionId = 1,
+  kFunctionName = 2,
+  kFunctionSystemName = 3,
+  kFunctionFilename = 4,
+  kFunctionStartLine = 5,
+};
+
+// Writes protocol buffer fields. Nested messages are encoded into a separate
+// stream first, since they are prefixed with their length.
+class ProtobufWriter : public ValueObject {
+ public:
+  explicit ProtobufWriter(MallocWriteStream* stream) : stream_(stream) {}
+
+  void WriteInt(intptr_t field, int64_t value) {
+    // Zero is the default value, which is not encoded.
+    if (value == 0) return;
+    WriteTag(field, kVarint);
+    WriteVarint(static_cast<uint64_t>(value));
+  }
+
+  void WriteString(intptr_t field, const char* value) {
+    const intptr_t length = strlen(value);
+    WriteTag(field, kLengthDelimited);
+    WriteVarint(length);
+    stream_->WriteBytes(value, length);
+  }
+
+  void WriteMessage(intptr_t field, const MallocWriteStream& message) {
+    WriteTag(field, kLengthDelimited);
+    WriteVarint(message.bytes_written());
+    stream_->WriteBytes(message.buffer(), message.bytes_written());
+  }
+
+  void WritePacked(intptr_t field, const int64_t* values, intptr_t length) {
+    intptr_t size = 0;
+    for (intptr_t i = 0; i < length; i++) {
+      size += VarintSize(static_cast<uint64_t>(values[i]));
+    }
+    WriteTag(field, kLengthDelimited);
+    WriteVarint(size);
+    for (intptr_t i = 0; i < length; i++) {
+      WriteVarint(static_cast<uint64_t>(values[i]));
+    }
+  }
+
+ private:
+  enum WireType {
+    kVarint = 0,
+    kLengthDelimited = 2,
+  };
+
+  void WriteTag(intptr_t field, WireType type) {
+    WriteVarint((static_cast<uint64_t>(field) << 3) | type);
+  }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      stream_->WriteByte(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    stream_->WriteByte(static_cast<uint8_t>(value));
+  }
+
+  static intptr_t VarintSize(uint64_t value) {
+    intptr_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      size++;
+    }
+    return size;
+  }
+
+  MallocWriteStream* const stream_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtobufWriter);
+};
+
+uword PprofProfile::IdPairTrait::Hash(const Key& key) {
+  return FinalizeHash(CombineHashes(static_cast<uint32_t>(key.first),
+                                    static_cast<uint32_t>(key.second)));
+}
+
+bool PprofProfile::StackTrait::IsKeyEqual(const Pair& pair, const Key& key) {
+  if ((pair.key.hash != key.hash) || (pair.key.length != key.length)) {
+    return false;
+  }
+  return memcmp(pair.key.locations, key.locations,
+                key.length * sizeof(intptr_t)) == 0;
+}
+
+PprofProfile::PprofProfile() {
+  Clear();
+}
+
+PprofProfile::~PprofProfile() {
+  Clear();
+}
+
+void PprofProfile::Clear() {
+  for (intptr_t i = 0; i < strings_.length(); i++) {
+    free(strings_[i]);
+  }
+  strings_.Clear();
+  string_ids_.Clear();
+  functions_.Clear();
+  function_ids_.Clear();
+  locations_.Clear();
+  location_ids_.Clear();
+  for (intptr_t i = 0; i < stacks_.length(); i++) {
+    free(stacks_[i].locations);
+  }
+  stacks_.Clear();
+  stack_ids_.Clear();
+  // The first entry of the string table has to be the empty string.
+  InternString("");
+}
+
+void PprofProfile::ClearValues() {
+  for (intptr_t i = 0; i < stacks_.length(); i++) {
+    memset(stacks_[i].values, 0, sizeof(stacks_[i].values));
+  }
+}
+
+intptr_t PprofProfile::InternString(const char* str) {
+  intptr_t id = string_ids_.LookupValue(str);
+  if (id != CStringIntMapKeyValueTrait::kNoValue) {
+    return id;
+  }
+  char* copy = Utils::StrDup(str);
+  id = strings_.length();
+  strings_.Add(copy);
+  string_ids_.Insert({copy, id});
+  return id;
+}
+
+intptr_t PprofProfile::FunctionId(const char* name,
+                                  const char* filename,
+                                  intptr_t line) {
+  const IdPairTrait::Key key = {InternString(name), InternString(filename)};
+  intptr_t id = function_ids_.LookupValue(key);
+  if (id != 0) {
+    return id;
+  }
+  functions_.Add(key.first);
+  functions_.Add(key.second);
+  functions_.Add(line);
+  id = functions_.length() / 3;
+  function_ids_.Insert({key, id});
+  return id;
+}
+
+static intptr_t LineOf(const Function& function, TokenPosition token_pos) {
+  if (function.IsNull() || !token_pos.IsReal()) {
+    return 0;
+  }
+  const Script& script = Script::Handle(function.script());
+  intptr_t line = 0;
+  if (script.IsNull() || !script.GetTokenLocation(token_pos, &line)) {
+    return 0;
+  }
+  return line;
+}
+
+intptr_t PprofProfile::LocationId(const char* name,
+                                  const char* filename,
+                                  const Function& function,
+                                  TokenPosition token_pos) {
+  const intptr_t function_id = FunctionId(
+      name, filename,
+      function.IsNull() ? 0 : LineOf(function, function.token_pos()));
+  const IdPairTrait::Key key = {function_id, LineOf(function, token_pos)};
+  intptr_t id = location_ids_.LookupValue(key);
+  if (id != 0) {
+    return id;
+  }
+  locations_.Add(key.first);
+  locations_.Add(key.second);
+  id = locations_.length() / 2;
+  location_ids_.Insert({key, id});
+  return id;
+}
+
+intptr_t PprofProfile::LocationId(const Function& function,
+                                  TokenPosition token_pos) {
+  const Script& script = Script::Handle(function.script());
+  const char* url =
+      script.IsNull() ? "" : String::Handle(script.url()).ToCString();
+  return LocationId(function.QualifiedUserVisibleNameCString(), url, function,
+                    token_pos);
+}
+
+intptr_t PprofProfile::StackIndex(const GrowableArray<intptr_t>& locations) {
+  uint32_t hash = 0;
+  for (intptr_t i = 0; i < locations.length(); i++) {
+    hash = CombineHashes(hash, static_cast<uint32_t>(locations[i]));
+  }
+  StackTrait::Key key = {locations.data(), locations.length(),
+                         FinalizeHash(hash)};
+  const intptr_t index = stack_ids_.LookupValue(key);
+  if (index >= 0) {
+    return index;
+  }
+  const intptr_t size = locations.length() * sizeof(intptr_t);
+  intptr_t* copy = reinterpret_cast<intptr_t*>(malloc(size));
+  memmove(copy, locations.data(), size);
+  key.locations = copy;
+  Stack stack = {copy, locations.length(), key.hash, {}};
+  stacks_.Add(stack);
+  stack_ids_.Insert({key, stacks_.length() - 1});
+  return stacks_.length() - 1;
+}
+
+void PprofProfile::AddValues(intptr_t stack_index, const int64_t* values) {
+  Stack& stack = stacks_[stack_index];
+  for (intptr_t i = 0; i < kMaxValues; i++) {
+    stack.values[i] += values[i];
+  }
+}
+
+void PprofProfile::Serialize(MallocWriteStream* stream,
+                             const ValueType* sample_types,
+                             intptr_t value_count,
+                             const ValueType& period_type,
+                             int64_t period,
+                             int64_t start_micros,
+                             int64_t end_micros) {
+  ASSERT(value_count <= kMaxValues);
+  ProtobufWriter writer(stream);
+  MallocWriteStream message(64);
+  MallocWriteStream nested(64);
+  ProtobufWriter message_writer(&message);
+  ProtobufWriter nested_writer(&nested);
+
+  // The string table is written last, so the type names can be interned
+  // while writing.
+  for (intptr_t i = 0; i < value_count; i++) {
+    message.SetPosition(0);
+    message_writer.WriteInt(kValueTypeType,
+                            InternString(sample_types[i].type));
+    message_writer.WriteInt(kValueTypeUnit,
+                            InternString(sample_types[i].unit));
+    writer.WriteMessage(kProfileSampleType, message);
+  }
+
+  GrowableArray<int64_t> location_ids;
+  for (intptr_t i = 0; i < stacks_.length(); i++) {
+    const Stack& stack = stacks_[i];
+    bool is_empty = true;
+    for (intptr_t j = 0; j < value_count; j++) {
+      if (stack.values[j] != 0) {
+        is_empty = false;
+        break;
+      }
+    }
+    if (is_empty) {
+      continue;
+    }
+    location_ids.Clear();
+    for (intptr_t j = 0; j < stack.length; j++) {
+      location_ids.Add(stack.locations[j]);
+    }
+    message.SetPosition(0);
+    message_writer.WritePacked(kSampleLocationId, location_ids.data(),
+                               location_ids.length());
+    message_writer.WritePacked(kSampleValue, stack.values, value_count);
+    writer.WriteMessage(kProfileSample, message);
+  }
+
+  for (intptr_t i = 0; i < locations_.length() / 2; i++) {
+    nested.SetPosition(0);
+    nested_writer.WriteInt(kLineFunctionId, locations_[2 * i]);
+    nested_writer.WriteInt(kLineLine, locations_[2 * i + 1]);
+    message.SetPosition(0);
+    message_writer.WriteInt(kLocationId, i + 1);
+    message_writer.WriteMessage(kLocationLine, nested);
+    writer.WriteMessage(kProfileLocation, message);
+  }
+
+  for (intptr_t i = 0; i < functions_.length() / 3; i++) {
+    message.SetPosition(0);
+    message_writer.WriteInt(kFunctionId, i + 1);
+    message_writer.WriteInt(kFunctionName, functions_[3 * i]);
+    message_writer.WriteInt(kFunctionSystemName, functions_[3 * i]);
+    message_writer.WriteInt(kFunctionFilename, functions_[3 * i + 1]);
+    message_writer.WriteInt(kFunctionStartLine, functions_[3 * i + 2]);
+    writer.WriteMessage(kProfileFunction, message);
+  }
+
+  const intptr_t period_type_id = InternString(period_type.type);
+  const intptr_t period_unit_id = InternString(period_type.unit);
+  for (intptr_t i = 0; i < strings_.length(); i++) {
+    writer.WriteString(kProfileStringTable, strings_[i]);
+  }
+
+  writer.WriteInt(kProfileTimeNanos, start_micros * kNanosecondsPerMicrosecond);
+  writer.WriteInt(kProfileDurationNanos,
+                  (end_micros - start_micros) * kNanosecondsPerMicrosecond);
+  message.SetPosition(0);
+  message_writer.WriteInt(kValueTypeType, period_type_id);
+  message_writer.WriteInt(kValueTypeUnit, period_unit_id);
+  writer.WriteMessage(kProfilePeriodType, message);
+  writer.WriteInt(kProfilePeriod, period);
+}
+
+static bool IsIntervalElapsed(int64_t start_micros, int64_t now) {
+  return (now - start_micros) >=
+         FLAG_profile_export_interval * kMicrosecondsPerSecond;
+}
+
+// Writes |stream| to <dir>/dart-<kind>-<pid>-<port>-<index>.pb.
+static void WriteProfileFile(const char* kind,
+                             Dart_Port port,
+                             intptr_t index,
+                             const MallocWriteStream& stream) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.\n");
+    return;
+  }
+  char* path =
+      OS::SCreate(nullptr, "%s/dart-%s-%" Pd "-%" Px64 "-%" Pd ".pb",
+                  FLAG_profile_export_dir, kind, OS::ProcessId(),
+                  static_cast<uint64_t>(port), index);
+  void* file = (*file_open)(path, true);
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to open profile file: %s\n", path);
+    free(path);
+    return;
+  }
+  (*file_write)(stream.buffer(), stream.bytes_written(), file);
+  (*file_close)(file);
+  free(path);
+}
+
+PprofExporter::PprofExporter(Isolate* isolate)
+    : port_(isolate->main_port()),
+      mutex_(NOT_IN_PRODUCT("PprofExporter::mutex_")),
+      interval_start_micros_(OS::GetCurrentTimeMicros()) {}
+
+PprofExporter::~PprofExporter() {}
+
+// The type of the second value of every CPU sample, and the number of units
+// of that type a sample stands for.
+static PprofProfile::ValueType CpuValueType(int64_t* period) {
+  const ThreadInterrupter::SampleEvent event =
+      ThreadInterrupter::sample_event();
+  if (event == ThreadInterrupter::SampleEvent::kTimer) {
+    *period =
+        static_cast<int64_t>(FLAG_profile_period) * kNanosecondsPerMicrosecond;
+    return {"cpu", "nanoseconds"};
+  }
+  *period = ThreadInterrupter::sample_event_period();
+  return {ThreadInterrupter::SampleEventToCString(event), "count"};
+}
+
+// Maps (function, token position) pairs of a Profile to location ids.
+struct FrameLocationTrait {
+  struct Key {
+    intptr_t function;
+    intptr_t position;
+  };
+  typedef intptr_t Value;
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key({0, 0}), value(0) {}
+    Pair(const Key& key, Value value) : key(key), value(value) {}
+  };
+  static Key KeyOf(const Pair& pair) { return pair.key; }
+  static Value ValueOf(const Pair& pair) { return pair.value; }
+  static uword Hash(const Key& key) {
+    return FinalizeHash(CombineHashes(static_cast<uint32_t>(key.function),
+                                      static_cast<uint32_t>(key.position)));
+  }
+  static bool IsKeyEqual(const Pair& pair, const Key& key) {
+    return (pair.key.function == key.function) &&
+           (pair.key.position == key.position);
+  }
+};
+
+void PprofExporter::AddProfile(Profile* profile) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  MutexLocker ml(&mutex_);
+
+  int64_t period;
+  CpuValueType(&period);
+  const int64_t values[PprofProfile::kMaxValues] = {1, period};
+
+  // Caches the location ids of the (function, token position) pairs of this
+  // profile, which avoids computing line numbers for every frame.
+  ZoneDirectChainedHashMap<FrameLocationTrait> frame_locations(zone);
+  auto* cache = new ProfileCodeInlinedFunctionsCache();
+  GrowableArray<ProfileFunction*> functions;
+  GrowableArray<TokenPosition> positions;
+  GrowableArray<intptr_t> locations;
+  for (intptr_t i = 0; i < profile->sample_count(); i++) {
+    ProcessedSample* sample = profile->SampleAt(i);
+    functions.Clear();
+    positions.Clear();
+    for (intptr_t frame_index = 0; frame_index < sample->length();
+         frame_index++) {
+      profile->GetFrameFunctions(cache, sample, frame_index, &functions,
+                                 &positions);
+    }
+    if (functions.is_empty()) {
+      continue;
+    }
+    locations.Clear();
+    for (intptr_t j = 0; j < functions.length(); j++) {
+      ProfileFunction* function = functions[j];
+      const FrameLocationTrait::Key key = {function->table_index(),
+                                           positions[j].Serialize()};
+      intptr_t location = frame_locations.LookupValue(key);
+      if (location == 0) {
+        const char* url = function->ResolvedScriptUrl();
+        location = profile_.LocationId(function->Name(),
+                                       (url != nullptr) ? url : "",
+                                       *function->function(), positions[j]);
+        frame_locations.Insert({key, location});
+      }
+      locations.Add(location);
+    }
+    profile_.AddValues(profile_.StackIndex(locations), values);
+    sample_count_++;
+  }
+}
+
+bool PprofExporter::IsFlushDue() const {
+  return IsFlushDueLocked(OS::GetCurrentTimeMicros());
+}
+
+bool PprofExporter::IsFlushDueLocked(int64_t now) const {
+  return IsIntervalElapsed(interval_start_micros_, now);
+}
+
+void PprofExporter::Serialize(MallocWriteStream* stream) {
+  int64_t period;
+  const PprofProfile::ValueType value_type = CpuValueType(&period);
+  const PprofProfile::ValueType sample_types[] = {{"samples", "count"},
+                                                  value_type};
+  profile_.Serialize(stream, sample_types, ARRAY_SIZE(sample_types),
+                     value_type, period, interval_start_micros_,
+                     OS::GetCurrentTimeMicros());
+}
+
+void PprofExporter::Flush(bool force) {
+  MallocWriteStream stream(KB);
+  intptr_t file_index;
+  {
+    MutexLocker ml(&mutex_);
+    if (!force && !IsFlushDueLocked(OS::GetCurrentTimeMicros())) {
+      return;
+    }
+    if (sample_count_ == 0) {
+      // Don't write empty files, e.g. for idle isolates.
+      interval_start_micros_ = OS::GetCurrentTimeMicros();
+      return;
+    }
+    Serialize(&stream);
+    profile_.Clear();
+    sample_count_ = 0;
+    interval_start_micros_ = OS::GetCurrentTimeMicros();
+    file_index = file_count_++;
+  }
+  WriteProfileFile("cpu", port_, file_index, stream);
+}
+
+HeapProfileExporter::HeapProfileExporter(Isolate* isolate)
+    : isolate_(isolate),
+      mutex_(NOT_IN_PRODUCT("HeapProfileExporter::mutex_")),
+      interval_start_micros_(OS::GetCurrentTimeMicros()) {}
+
+HeapProfileExporter::~HeapProfileExporter() {
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    free(samples_[i]);
+  }
+}
+
+bool HeapProfileExporter::IsFlushDue() const {
+  return IsIntervalElapsed(interval_start_micros_, OS::GetCurrentTimeMicros());
+}
+
+void HeapProfileExporter::Flush(bool force) {
+  Thread* thread = Thread::Current();
+  MallocWriteStream stream(KB);
+  intptr_t file_index;
+  {
+    // Updating the profile enters a safepoint operation, which mutators
+    // waiting for the lock must not block.
+    SafepointMutexLocker ml(&mutex_);
+    if (!force && !IsFlushDue()) {
+      return;
+    }
+    StackZone zone(thread);
+    HandleScope handle_scope(thread);
+    Update(thread);
+    if (samples_.is_empty()) {
+      // Nothing was allocated or is alive, e.g. for idle isolates.
+      interval_start_micros_ = OS::GetCurrentTimeMicros();
+      return;
+    }
+    Serialize(&stream);
+    RetireSamples();
+    interval_start_micros_ = OS::GetCurrentTimeMicros();
+    file_index = file_count_++;
+  }
+  WriteProfileFile("heap", isolate_->main_port(), file_index, stream);
+}
+
+void HeapProfileExporter::Update(Thread* thread) {
+  CollectSamples(thread);
+  SymbolizeSamples(thread);
+
+  profile_.ClearValues();
+  const double interval = FLAG_heap_profile_sampling_interval;
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    HeapSample* sample = samples_[i];
+    // An allocation of |size| bytes is sampled with probability
+    // 1 - e^(-size / interval), so each sample stands for the inverse of
+    // that many allocations.
+    const double size = sample->size;
+    const double scale =
+        (interval > 0) ? 1.0 / (1.0 - exp(-size / interval)) : 1.0;
+    const int64_t objects = static_cast<int64_t>(scale + 0.5);
+    const int64_t bytes = static_cast<int64_t>(scale * size + 0.5);
+    const int64_t values[PprofProfile::kMaxValues] = {
+        sample->reported ? 0 : objects,
+        sample->reported ? 0 : bytes,
+        sample->live ? objects : 0,
+        sample->live ? bytes : 0,
+    };
+    profile_.AddValues(sample->stack, values);
+  }
+}
+
+void HeapProfileExporter::CollectSamples(Thread* thread) {
+  // The sample list is only modified by the mutator while allocating, and
+  // the weak tables by the GC, so both are read in a safepoint operation.
+  GcSafepointOperationScope safepoint(thread);
+
+  HeapSample* sample = isolate_->heap_samples();
+  isolate_->set_heap_samples(nullptr);
+  while (sample != nullptr) {
+    HeapSample* next = sample->next;
+    sample->next = nullptr;
+    samples_.Add(sample);
+    sample_ids_.Insert({sample->id, sample});
+    sample = next;
+  }
+
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    samples_[i]->live = false;
+  }
+  Heap* heap = isolate_->group()->heap();
+  const Heap::Space spaces[] = {Heap::kNew, Heap::kOld};
+  for (intptr_t i = 0; i < ARRAY_SIZE(spaces); i++) {
+    WeakTable* table = heap->GetWeakTable(spaces[i], Heap::kHeapSamples);
+    for (intptr_t j = 0; j < table->size(); j++) {
+      if (!table->IsValidEntryAtExclusive(j)) {
+        continue;
+      }
+      HeapSample* live_sample =
+          sample_ids_.LookupValue(table->ValueAtExclusive(j));
+      if (live_sample != nullptr) {
+        live_sample->live = true;
+      }
+    }
+  }
+}
+
+void HeapProfileExporter::SymbolizeSamples(Thread* thread) {
+  Zone* zone = thread->zone();
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  CodeLookupTable* code_table = nullptr;
+#endif
+  ClassTable* class_table = isolate_->group()->class_table();
+  Class& cls = Class::Handle(zone);
+  Code& code = Code::Handle(zone);
+  GrowableArray<const Function*> functions;
+  GrowableArray<TokenPosition> positions;
+  GrowableArray<intptr_t> locations;
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    HeapSample* sample = samples_[i];
+    if (sample->stack >= 0) {
+      continue;
+    }
+    locations.Clear();
+    // The allocated class is the leaf of the stack.
+    const char* class_name = "[Unknown class]";
+    if (class_table->HasValidClassAt(sample->cid)) {
+      cls = class_table->At(sample->cid);
+      class_name = cls.UserVisibleNameCString();
+    }
+    locations.Add(profile_.LocationId(class_name, "", Function::null_function(),
+                                      TokenPosition::kNoSource));
+    for (intptr_t j = 0; j < sample->length; j++) {
+      const uword pc = sample->pcs[j];
+      code = Code::null();
+#if defined(DART_PRECOMPILED_RUNTIME)
+      code = ReversePc::Lookup(isolate_->group(), pc,
+                               /*is_return_address=*/true);
+#else
+      if (code_table == nullptr) {
+        code_table = new (zone) CodeLookupTable(thread);
+      }
+      // The frame may end with the call, so look up the call instruction.
+      const CodeDescriptor* descriptor = code_table->FindCode(pc - 1);
+      if ((descriptor != nullptr) && descriptor->code().IsCode()) {
+        code ^= descriptor->code().ptr();
+      }
+#endif
+      if (code.IsNull()) {
+        // The code was collected before the profile was written.
+        locations.Add(profile_.LocationId("[Unknown code]", "",
+                                          Function::null_function(),
+                                          TokenPosition::kNoSource));
+        continue;
+      }
+      functions.Clear();
+      positions.Clear();
+      code.GetInlinedFunctionsAtReturnAddress(pc - code.PayloadStart(),
+                                              &functions, &positions);
+      if (functions.is_empty()) {
+        const Function& function = Function::Handle(zone, code.function());
+        if (function.IsNull()) {
+          locations.Add(profile_.LocationId(code.Name(), "", function,
+                                            TokenPosition::kNoSource));
+        } else {
+          locations.Add(
+              profile_.LocationId(function, TokenPosition::kNoSource));
+        }
+        continue;
+      }
+      // Inlined functions are listed outermost first.
+      for (intptr_t k = functions.length() - 1; k >= 0; k--) {
+        locations.Add(profile_.LocationId(*functions[k], positions[k]));
+      }
+    }
+    sample->stack = profile_.StackIndex(locations);
+  }
+}
+
+void HeapProfileExporter::Serialize(MallocWriteStream* stream) {
+  const PprofProfile::ValueType sample_types[] = {
+      {"alloc_objects", "count"},
+      {"alloc_space", "bytes"},
+      {"inuse_objects", "count"},
+      {"inuse_space", "bytes"},
+  };
+  profile_.Serialize(stream, sample_types, ARRAY_SIZE(sample_types),
+                     {"space", "bytes"}, FLAG_heap_profile_sampling_interval,
+                     interval_start_micros_, OS::GetCurrentTimeMicros());
+}
+
+void HeapProfileExporter::RetireSamples() {
+  intptr_t length = 0;
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    HeapSample* sample = samples_[i];
+    if (!sample->live) {
+      sample_ids_.Remove(sample->id);
+      free(sample);
+      continue;
+    }
+    sample->reported = true;
+    samples_[length++] = sample;
+  }
+  samples_.TruncateTo(length);
+}
+
+intptr_t HeapProfileExporter::live_sample_count() const {
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < samples_.length(); i++) {
+    if (samples_[i]->live) {
+      count++;
+    }
+  }
+  return count;
+}
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
@@ -0,0 +1,225 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_PROFILER_PPROF_H_
+#define RUNTIME_VM_PROFILER_PPROF_H_
+
+#include "include/dart_api.h"
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class Function;
+struct HeapSample;
+class Isolate;
+class MallocWriteStream;
+class Profile;
+class Thread;
+class TokenPosition;
+
+#if !defined(PRODUCT)
+
+// An in-memory pprof Profile message (see
+// https://github.com/google/pprof/blob/main/proto/profile.proto).
+//
+// Functions, locations and stacks are interned by name, so the memory used
+// is bounded by the number of distinct stacks, and every stack carries one
+// value per sample type.
+class PprofProfile {
+ public:
+  static constexpr intptr_t kMaxValues = 4;
+
+  struct ValueType {
+    const char* type;
+    const char* unit;
+  };
+
+  PprofProfile();
+  ~PprofProfile();
+
+  // Drops all functions, locations and stacks.
+  void Clear();
+  // Resets the values of all stacks to 0.
+  void ClearValues();
+
+  // The location of |token_pos| in |function|, which may be null for frames
+  // without a Dart function.
+  intptr_t LocationId(const char* name,
+                      const char* filename,
+                      const Function& function,
+                      TokenPosition token_pos);
+  intptr_t LocationId(const Function& function, TokenPosition token_pos);
+
+  // Returns the index of the stack with the given locations, leaf first.
+  intptr_t StackIndex(const GrowableArray<intptr_t>& locations);
+  void AddValues(intptr_t stack_index, const int64_t* values);
+
+  // Encodes the stacks with non-zero values. |sample_types| has one entry
+  // per value.
+  void Serialize(MallocWriteStream* stream,
+                 const ValueType* sample_types,
+                 intptr_t value_count,
+                 const ValueType& period_type,
+                 int64_t period,
+                 int64_t start_micros,
+                 int64_t end_micros);
+
+ private:
+  // Maps pairs of integers to 1-based ids, as id 0 means "none" in pprof.
+  struct IdPairTrait {
+    struct Key {
+      intptr_t first;
+      intptr_t second;
+    };
+    typedef intptr_t Value;
+    struct Pair {
+      Key key;
+      Value value;
+      Pair() : key({0, 0}), value(0) {}
+      Pair(const Key& key, Value value) : key(key), value(value) {}
+    };
+    static Key KeyOf(const Pair& pair) { return pair.key; }
+    static Value ValueOf(const Pair& pair) { return pair.value; }
+    static uword Hash(const Key& key);
+    static bool IsKeyEqual(const Pair& pair, const Key& key) {
+      return (pair.key.first == key.first) && (pair.key.second == key.second);
+    }
+  };
+
+  struct Stack {
+    intptr_t* locations;
+    intptr_t length;
+    uword hash;
+    int64_t values[kMaxValues];
+  };
+
+  // Maps stacks (leaf first) to their index in |stacks_|.
+  struct StackTrait {
+    struct Key {
+      const intptr_t* locations;
+      intptr_t length;
+      uword hash;
+    };
+    typedef intptr_t Value;
+    struct Pair {
+      Key key;
+      Value value;
+      Pair() : key({nullptr, 0, 0}), value(-1) {}
+      Pair(const Key& key, Value value) : key(key), value(value) {}
+    };
+    static Key KeyOf(const Pair& pair) { return pair.key; }
+    static Value ValueOf(const Pair& pair) { return pair.value; }
+    static uword Hash(const Key& key) { return key.hash; }
+    static bool IsKeyEqual(const Pair& pair, const Key& key);
+  };
+
+  intptr_t InternString(const char* str);
+  intptr_t FunctionId(const char* name, const char* filename, intptr_t line);
+
+  MallocGrowableArray<char*> strings_;
+  MallocDirectChainedHashMap<CStringIntMapKeyValueTrait> string_ids_;
+  // Per function: name, file name and start line.
+  MallocGrowableArray<intptr_t> functions_;
+  MallocDirectChainedHashMap<IdPairTrait> function_ids_;
+  // Per location: function id and line.
+  MallocGrowableArray<intptr_t> locations_;
+  MallocDirectChainedHashMap<IdPairTrait> location_ids_;
+  MallocGrowableArray<Stack> stacks_;
+  MallocDirectChainedHashMap<StackTrait> stack_ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(PprofProfile);
+};
+
+// Accumulates the CPU samples of an isolate and writes them to
+// --profile_export_dir every --profile_export_interval seconds.
+//
+// Samples are added as Profiles built from sample blocks which have not been
+// exported before, so every sample is symbolized exactly once. All state is
+// dropped after each interval.
+class PprofExporter {
+ public:
+  explicit PprofExporter(Isolate* isolate);
+  ~PprofExporter();
+
+  void AddProfile(Profile* profile);
+
+  // Whether the current interval has elapsed.
+  bool IsFlushDue() const;
+
+  // Writes the samples of the current interval to a new file in
+  // --profile_export_dir and starts a new interval. Does nothing before the
+  // interval has elapsed unless |force| is true.
+  void Flush(bool force);
+
+  // Encodes the samples of the current interval as a Profile message.
+  void Serialize(MallocWriteStream* stream);
+
+  intptr_t sample_count() const { return sample_count_; }
+
+ private:
+  bool IsFlushDueLocked(int64_t now) const;
+
+  const Dart_Port port_;
+  Mutex mutex_;
+  int64_t interval_start_micros_;
+  intptr_t file_count_ = 0;
+  intptr_t sample_count_ = 0;
+  PprofProfile profile_;
+
+  DISALLOW_COPY_AND_ASSIGN(PprofExporter);
+};
+
+// Writes the allocations sampled by HeapProfileSampler for an isolate to
+// --profile_export_dir every --profile_export_interval seconds.
+//
+// Each file reports the sampled allocations of its interval (alloc_*) and
+// the sampled objects which are still alive (inuse_*), with the sample
+// weights unbiased by the allocation size. Samples of dead objects are freed
+// once they have been reported.
+class HeapProfileExporter {
+ public:
+  explicit HeapProfileExporter(Isolate* isolate);
+  ~HeapProfileExporter();
+
+  bool IsFlushDue() const;
+
+  // Updates the profile and writes it to a new file in --profile_export_dir.
+  // Does nothing before the interval has elapsed unless |force| is true.
+  void Flush(bool force);
+
+  // Takes the new samples of the isolate, finds out which sampled objects
+  // are alive and computes the values of the profile.
+  void Update(Thread* thread);
+
+  // Encodes the profile computed by the last Update as a Profile message.
+  void Serialize(MallocWriteStream* stream);
+
+  intptr_t live_sample_count() const;
+
+ private:
+  void CollectSamples(Thread* thread);
+  void SymbolizeSamples(Thread* thread);
+  // Drops the samples of dead objects which have been reported.
+  void RetireSamples();
+
+  Isolate* const isolate_;
+  Mutex mutex_;
+  int64_t interval_start_micros_;
+  intptr_t file_count_ = 0;
+  MallocGrowableArray<HeapSample*> samples_;
+  MallocDirectChainedHashMap<IntKeyRawPointerValueTrait<HeapSample*>>
+      sample_ids_;
+  PprofProfile profile_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapProfileExporter);
+};
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_PROFILER_PPROF_H_
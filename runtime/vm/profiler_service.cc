@@ -1556,6 +1556,16 @@ void Profile::PrintHeaderJSON(JSONObject* obj) {
   intptr_t pid = OS::ProcessId();
 
   obj->AddProperty("samplePeriod", static_cast<intptr_t>(FLAG_profile_period));
+  // Each sample of a hardware event stands for _sampleEventPeriod events, so
+  // tick counts are proportional to e.g. the cache misses in a function.
+  const ThreadInterrupter::SampleEvent event =
+      ThreadInterrupter::sample_event();
+  obj->AddProperty("_sampleEvent",
+                   ThreadInterrupter::SampleEventToCString(event));
+  if (event != ThreadInterrupter::SampleEvent::kTimer) {
+    obj->AddProperty("_sampleEventPeriod",
+                     ThreadInterrupter::sample_event_period());
+  }
   obj->AddProperty("maxStackDepth",
                    static_cast<intptr_t>(FLAG_max_profile_depth));
   obj->AddProperty("sampleCount", sample_count());
@@ -1589,10 +1599,13 @@ void Profile::PrintHeaderJSON(JSONObject* obj) {
   }
 }
 
-void Profile::ProcessSampleFrameJSON(JSONArray* stack,
-                                     ProfileCodeInlinedFunctionsCache* cache_,
-                                     ProcessedSample* sample,
-                                     intptr_t frame_index) {
+ProfileFunction* Profile::ResolveSampleFrame(
+    ProfileCodeInlinedFunctionsCache* cache,
+    ProcessedSample* sample,
+    intptr_t frame_index,
+    GrowableArray<const Function*>** inlined_functions,
+    GrowableArray<TokenPosition>** inlined_token_positions,
+    TokenPosition* token_position) {
   const uword pc = sample->At(frame_index);
   ProfileCode* profile_code = GetCodeFromPC(pc, sample->timestamp());
   ASSERT(profile_code != NULL);
@@ -1602,46 +1615,67 @@ void Profile::ProcessSampleFrameJSON(JSONArray* stack,
   // Don't show stubs in stack traces.
   if (!function->is_visible() ||
       (function->kind() == ProfileFunction::kStubFunction)) {
-    return;
+    return NULL;
   }
 
-  GrowableArray<const Function*>* inlined_functions = NULL;
-  GrowableArray<TokenPosition>* inlined_token_positions = NULL;
-  TokenPosition token_position = TokenPosition::kNoSource;
+  *inlined_functions = NULL;
+  *inlined_token_positions = NULL;
+  *token_position = TokenPosition::kNoSource;
   Code& code = Code::ZoneHandle();
 
   if (profile_code->code().IsCode()) {
     code ^= profile_code->code().ptr();
-    cache_->Get(pc, code, sample, frame_index, &inlined_functions,
-                &inlined_token_positions, &token_position);
-    if (FLAG_trace_profiler_verbose && (inlined_functions != NULL)) {
-      for (intptr_t i = 0; i < inlined_functions->length(); i++) {
-        const String& name =
-            String::Handle((*inlined_functions)[i]->QualifiedScrubbedName());
+    cache->Get(pc, code, sample, frame_index, inlined_functions,
+               inlined_token_positions, token_position);
+    if (FLAG_trace_profiler_verbose && (*inlined_functions != NULL)) {
+      for (intptr_t i = 0; i < (*inlined_functions)->length(); i++) {
+        const String& name = String::Handle(
+            (**inlined_functions)[i]->QualifiedScrubbedName());
         THR_Print("InlinedFunction[%" Pd "] = {%s, %s}\n", i, name.ToCString(),
-                  (*inlined_token_positions)[i].ToCString());
+                  (**inlined_token_positions)[i].ToCString());
       }
     }
   }
 
-  if (code.IsNull() || (inlined_functions == NULL) ||
-      (inlined_functions->length() <= 1)) {
-    PrintFunctionFrameIndexJSON(stack, function);
-    return;
+  if (code.IsNull() || (*inlined_functions == NULL) ||
+      ((*inlined_functions)->length() <= 1)) {
+    *inlined_functions = NULL;
+    return function;
   }
 
   if (!code.is_optimized()) {
     OS::PrintErr("Code that should be optimized is not. Please file a bug\n");
     OS::PrintErr("Code object: %s\n", code.ToCString());
     OS::PrintErr("Inlined functions length: %" Pd "\n",
-                 inlined_functions->length());
-    for (intptr_t i = 0; i < inlined_functions->length(); i++) {
+                 (*inlined_functions)->length());
+    for (intptr_t i = 0; i < (*inlined_functions)->length(); i++) {
       OS::PrintErr("IF[%" Pd "] = %s\n", i,
-                   (*inlined_functions)[i]->ToFullyQualifiedCString());
+                   (**inlined_functions)[i]->ToFullyQualifiedCString());
     }
   }
 
   ASSERT(code.is_optimized());
+  return function;
+}
+
+void Profile::ProcessSampleFrameJSON(JSONArray* stack,
+                                     ProfileCodeInlinedFunctionsCache* cache_,
+                                     ProcessedSample* sample,
+                                     intptr_t frame_index) {
+  GrowableArray<const Function*>* inlined_functions = NULL;
+  GrowableArray<TokenPosition>* inlined_token_positions = NULL;
+  TokenPosition token_position = TokenPosition::kNoSource;
+  ProfileFunction* function =
+      ResolveSampleFrame(cache_, sample, frame_index, &inlined_functions,
+                         &inlined_token_positions, &token_position);
+  if (function == NULL) {
+    return;
+  }
+
+  if (inlined_functions == NULL) {
+    PrintFunctionFrameIndexJSON(stack, function);
+    return;
+  }
 
   for (intptr_t i = inlined_functions->length() - 1; i >= 0; i--) {
     const Function* inlined_function = (*inlined_functions)[i];
@@ -1651,6 +1685,33 @@ void Profile::ProcessSampleFrameJSON(JSONArray* stack,
   }
 }
 
+void Profile::GetFrameFunctions(ProfileCodeInlinedFunctionsCache* cache,
+                                ProcessedSample* sample,
+                                intptr_t frame_index,
+                                GrowableArray<ProfileFunction*>* functions,
+                                GrowableArray<TokenPosition>* positions) {
+  GrowableArray<const Function*>* inlined_functions = NULL;
+  GrowableArray<TokenPosition>* inlined_token_positions = NULL;
+  TokenPosition token_position = TokenPosition::kNoSource;
+  ProfileFunction* function =
+      ResolveSampleFrame(cache, sample, frame_index, &inlined_functions,
+                         &inlined_token_positions, &token_position);
+  if (function == NULL) {
+    return;
+  }
+
+  if (inlined_functions == NULL) {
+    functions->Add(function);
+    positions->Add(token_position);
+    return;
+  }
+
+  for (intptr_t i = inlined_functions->length() - 1; i >= 0; i--) {
+    functions->Add(functions_->LookupOrAdd(*(*inlined_functions)[i]));
+    positions->Add((*inlined_token_positions)[i]);
+  }
+}
+
 void Profile::ProcessInlinedFunctionFrameJSON(
     JSONArray* stack,
     const Function* inlined_function) {
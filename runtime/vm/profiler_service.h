@@ -391,8 +391,28 @@ class Profile : public ValueObject {
 
   ProfileFunction* FindFunction(const Function& function);
 
+  // Appends the functions executing in the frame at |frame_index| of
+  // |sample| to |functions|, innermost inlined function first, and their
+  // token positions to |positions|. Appends nothing for frames which are
+  // hidden from stack traces, such as stubs.
+  void GetFrameFunctions(ProfileCodeInlinedFunctionsCache* cache,
+                         ProcessedSample* sample,
+                         intptr_t frame_index,
+                         GrowableArray<ProfileFunction*>* functions,
+                         GrowableArray<TokenPosition>* positions);
+
  private:
   void PrintHeaderJSON(JSONObject* obj);
+  // Returns the function of the code frame at |frame_index| of |sample|, or
+  // NULL for frames hidden from stack traces. |inlined_functions| is set if
+  // the frame has to be expanded into its inlined functions.
+  ProfileFunction* ResolveSampleFrame(
+      ProfileCodeInlinedFunctionsCache* cache,
+      ProcessedSample* sample,
+      intptr_t frame_index,
+      GrowableArray<const Function*>** inlined_functions,
+      GrowableArray<TokenPosition>** inlined_token_positions,
+      TokenPosition* token_position);
   void ProcessSampleFrameJSON(JSONArray* stack,
                               ProfileCodeInlinedFunctionsCache* cache,
                               ProcessedSample* sample,
@@ -6,8 +6,10 @@
 
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_state.h"
+#include "vm/datastream.h"
 #include "vm/globals.h"
 #include "vm/profiler.h"
+#include "vm/profiler_pprof.h"
 #include "vm/profiler_service.h"
 #include "vm/source_report.h"
 #include "vm/symbols.h"
@@ -21,6 +23,7 @@ DECLARE_FLAG(bool, profile_vm);
 DECLARE_FLAG(bool, profile_vm_allocation);
 DECLARE_FLAG(int, max_profile_depth);
 DECLARE_FLAG(int, optimization_counter_threshold);
+DECLARE_FLAG(int, profile_period);
 
 // SampleVisitor ignores samples with timestamp == 0.
 const int64_t kValidTimeStamp = 1;
@@ -121,8 +124,6 @@ class SampleBlockBufferOverrideScope {
 };
 
 TEST_CASE(Profiler_SampleBufferWrapTest) {
-  Isolate* isolate = Isolate::Current();
-
   SampleBlockBufferOverrideScope sbbos(new SampleBlockBuffer(3, 1));
   SampleBlockBuffer* sample_buffer = Profiler::sample_block_buffer();
 
@@ -133,19 +134,19 @@ TEST_CASE(Profiler_SampleBufferWrapTest) {
   EXPECT_EQ(0, visitor.sum());
   Sample* s;
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, 2);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(2, visitor.sum());
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, 4);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(6, visitor.sum());
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, 6);
   VisitSamples(sample_buffer, &visitor);
@@ -154,20 +155,15 @@ TEST_CASE(Profiler_SampleBufferWrapTest) {
   // Mark the completed blocks as free so they can be re-used.
   sample_buffer->ProcessCompletedBlocks();
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, 8);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(18, visitor.sum());
-  {
-    MutexLocker ml(isolate->current_sample_block_lock());
-    isolate->set_current_sample_block(nullptr);
-  }
+  thread->set_current_sample_block(nullptr);
 }
 
 TEST_CASE(Profiler_SampleBufferIterateTest) {
-  Isolate* isolate = Isolate::Current();
-
   SampleBlockBufferOverrideScope sbbos(new SampleBlockBuffer(3, 1));
   SampleBlockBuffer* sample_buffer = Profiler::sample_block_buffer();
 
@@ -177,34 +173,31 @@ TEST_CASE(Profiler_SampleBufferIterateTest) {
   sample_buffer->VisitSamples(&visitor);
   EXPECT_EQ(0, visitor.visited());
   Sample* s;
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, kValidPc);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(1, visitor.visited());
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, kValidPc);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(2, visitor.visited());
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, kValidPc);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(3, visitor.visited());
 
-  s = sample_buffer->ReserveCPUSample(isolate);
+  s = sample_buffer->ReserveCPUSample(thread);
   s->Init(i, kValidTimeStamp, 0);
   s->SetAt(0, kValidPc);
   VisitSamples(sample_buffer, &visitor);
   EXPECT_EQ(3, visitor.visited());
 
-  {
-    MutexLocker ml(isolate->current_sample_block_lock());
-    isolate->set_current_sample_block(nullptr);
-  }
+  thread->set_current_sample_block(nullptr);
 }
 
 TEST_CASE(Profiler_AllocationSampleTest) {
@@ -540,6 +533,141 @@ ISOLATE_UNIT_TEST_CASE(Profiler_TrivialRecordAllocation) {
   }
 }
 
+static bool ContainsString(const MallocWriteStream& stream, const char* str) {
+  const intptr_t length = strlen(str);
+  for (intptr_t i = 0; i + length <= stream.bytes_written(); i++) {
+    if (memcmp(stream.buffer() + i, str, length) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Isolates are created and shut down while the profiler samples their
+// mutators, which must hand their sample blocks back before the isolates are
+// deleted and their thread structures are reused.
+VM_UNIT_TEST_CASE(Profiler_SpawnAndKillIsolates) {
+  EnableProfiler();
+  const intptr_t saved_period = FLAG_profile_period;
+  Profiler::SetSamplePeriod(50);
+  const intptr_t kNumIsolates = 20;
+  const int64_t kRunMicros = 5 * 1000;
+
+  Dart_Isolate parent = TestCase::CreateTestIsolate("parent");
+  Dart_ExitIsolate();
+  for (intptr_t i = 0; i < kNumIsolates; i++) {
+    Dart_Isolate child = TestCase::CreateTestIsolateInGroup("child", parent);
+    EXPECT_EQ(child, Dart_CurrentIsolate());
+    {
+      Thread* thread = Thread::Current();
+      TransitionNativeToVM transition(thread);
+      // Take samples until the isolate is shut down.
+      const int64_t end = OS::GetCurrentMonotonicMicros() + kRunMicros;
+      while (OS::GetCurrentMonotonicMicros() < end) {
+      }
+    }
+    Dart_ShutdownIsolate();
+  }
+  Dart_EnterIsolate(parent);
+  Dart_ShutdownIsolate();
+  Profiler::SetSamplePeriod(saved_period);
+}
+
+ISOLATE_UNIT_TEST_CASE(Profiler_PprofExport) {
+  EnableProfiler();
+  DisableNativeProfileScope dnps;
+  DisableBackgroundCompilationScope dbcs;
+  const char* kScript =
+      "class A {\n"
+      "  var a;\n"
+      "}\n"
+      "class B {\n"
+      "  static boo() {\n"
+      "    return new A();\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  return B.boo();\n"
+      "}\n";
+
+  const Library& root_library = Library::Handle(LoadTestScript(kScript));
+
+  const int64_t before_allocations_micros = Dart_TimelineGetMicros();
+  const Class& class_a = Class::Handle(GetClass(root_library, "A"));
+  EXPECT(!class_a.IsNull());
+  class_a.SetTraceAllocation(true);
+
+  Invoke(root_library, "main");
+
+  const int64_t allocation_extent_micros =
+      Dart_TimelineGetMicros() - before_allocations_micros;
+  {
+    Thread* thread = Thread::Current();
+    Isolate* isolate = thread->isolate();
+    StackZone zone(thread);
+    Profile profile;
+    AllocationFilter filter(isolate->main_port(), class_a.id(),
+                            before_allocations_micros,
+                            allocation_extent_micros);
+    profile.Build(thread, &filter, Profiler::sample_block_buffer());
+    EXPECT_EQ(1, profile.sample_count());
+
+    PprofExporter exporter(isolate);
+    exporter.AddProfile(&profile);
+    // Adding the same stack twice only bumps its count.
+    exporter.AddProfile(&profile);
+    EXPECT_EQ(2, exporter.sample_count());
+
+    MallocWriteStream stream(KB);
+    exporter.Serialize(&stream);
+    EXPECT(stream.bytes_written() > 0);
+    EXPECT(ContainsString(stream, "B.boo"));
+    EXPECT(ContainsString(stream, "main"));
+    EXPECT(ContainsString(stream, "samples"));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(Profiler_HeapProfileExport) {
+  SetFlagScope<int> sfs1(&FLAG_heap_profile_sampling_interval, 1);
+  SetFlagScope<charp> sfs2(&FLAG_profile_export_dir, "heap-profile-test");
+  const char* kScript =
+      "class A {\n"
+      "  var a;\n"
+      "}\n"
+      "class B {\n"
+      "  static boo() {\n"
+      "    return new A();\n"
+      "  }\n"
+      "}\n"
+      "var list;\n"
+      "main() {\n"
+      "  list = [];\n"
+      "  for (var i = 0; i < 1000; i++) {\n"
+      "    list.add(B.boo());\n"
+      "  }\n"
+      "}\n";
+
+  const Library& root_library = Library::Handle(LoadTestScript(kScript));
+  // Start sampling with a new TLAB.
+  thread->heap()->new_space()->AbandonRemainingTLAB(thread);
+  Invoke(root_library, "main");
+
+  StackZone zone(thread);
+  HandleScope handle_scope(thread);
+  HeapProfileExporter exporter(thread->isolate());
+  // Nothing is written before the export interval has elapsed.
+  EXPECT(!exporter.IsFlushDue());
+  exporter.Update(thread);
+  // The objects are kept alive by |list|.
+  EXPECT(exporter.live_sample_count() > 0);
+
+  MallocWriteStream stream(KB);
+  exporter.Serialize(&stream);
+  EXPECT(ContainsString(stream, "alloc_space"));
+  EXPECT(ContainsString(stream, "inuse_space"));
+  EXPECT(ContainsString(stream, "B.boo"));
+}
+
 #if defined(DART_USE_TCMALLOC) && defined(DART_HOST_OS_LINUX) &&               \
     defined(DEBUG) && defined(HOST_ARCH_X64)
 
@@ -2272,7 +2400,8 @@ ISOLATE_UNIT_TEST_CASE(Profiler_BinaryOperatorSourcePositionOptimized) {
 static void InsertFakeSample(uword* pc_offsets) {
   Isolate* isolate = Isolate::Current();
   ASSERT(Profiler::sample_block_buffer() != nullptr);
-  Sample* sample = Profiler::sample_block_buffer()->ReserveCPUSample(isolate);
+  Sample* sample = Profiler::sample_block_buffer()->ReserveCPUSample(
+      Thread::Current());
   ASSERT(sample != NULL);
   sample->Init(isolate->main_port(), OS::GetCurrentMonotonicMicros(),
                OSThread::Current()->trace_id());
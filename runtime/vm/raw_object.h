@@ -164,9 +164,9 @@ class UntaggedObject {
     kOldBit = 4,                  // Incremental barrier source.
     kOldAndNotRememberedBit = 5,  // Generational barrier source.
     kImmutableBit = 6,
-    kReservedBit = 7,
+    kSharedBit = 7,  // Shared (not copied) between isolates of a group.
 
-    kSizeTagPos = kReservedBit + 1,  // = 8
+    kSizeTagPos = kSharedBit + 1,  // = 8
     kSizeTagSize = 8,
     kClassIdTagPos = kSizeTagPos + kSizeTagSize,  // = 16
     kClassIdTagSize = 16,
@@ -254,7 +254,7 @@ class UntaggedObject {
 
   class ImmutableBit : public BitField<uword, bool, kImmutableBit, 1> {};
 
-  class ReservedBit : public BitField<uword, intptr_t, kReservedBit, 1> {};
+  class SharedBit : public BitField<uword, bool, kSharedBit, 1> {};
 
   // Assumes this is a heap object.
   bool IsNewObject() const {
@@ -315,6 +315,9 @@ class UntaggedObject {
   void SetImmutable() { tags_.UpdateBool<ImmutableBit>(true); }
   void ClearImmutable() { tags_.UpdateBool<ImmutableBit>(false); }
 
+  bool IsShared() const { return tags_.Read<SharedBit>(); }
+  void SetShared() { tags_.UpdateBool<SharedBit>(true); }
+
   bool InVMIsolateHeap() const;
 
   // Support for GC remembered bit.
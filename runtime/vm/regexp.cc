@@ -33,6 +33,15 @@ static const bool kRegexpOptimization = true;
 // More makes code generation slower, less makes V8 benchmark score lower.
 static const intptr_t kMaxLookaheadForBoyerMoore = 8;
 
+// Longer literal prefixes do not make skipping ahead noticeably faster.
+static const intptr_t kMaxLiteralPrefixLength = 64;
+
+DEFINE_FLAG(bool,
+            regexp_literal_prefilter,
+            true,
+            "Skip ahead to the next occurrence of the literal prefix of a "
+            "regexp before matching it.");
+
 ContainedInLattice AddRange(ContainedInLattice containment,
                             const int32_t* ranges,
                             intptr_t ranges_length,
@@ -352,6 +361,19 @@ class RegExpCompiler : public ValueObject {
 
   Zone* zone() const { return zone_; }
 
+  // The .*? loop prepended to an unanchored regexp to find the start of a
+  // match, and the literal every match starts with (see LiteralPrefix). The
+  // loop skips ahead to the next occurrence of the literal on every
+  // iteration instead of stepping one character at a time.
+  void SetLiteralPrefix(RegExpNode* unanchored_search_loop,
+                        const ZoneGrowableArray<uint16_t>* literal_prefix) {
+    unanchored_search_loop_ = unanchored_search_loop;
+    literal_prefix_ = literal_prefix;
+  }
+  const ZoneGrowableArray<uint16_t>* LiteralPrefixFor(RegExpNode* loop) const {
+    return loop == unanchored_search_loop_ ? literal_prefix_ : nullptr;
+  }
+
   static const intptr_t kNoRegister = -1;
 
  private:
@@ -367,6 +389,8 @@ class RegExpCompiler : public ValueObject {
   bool read_backward_;
   intptr_t current_expansion_factor_;
   FrequencyCollator frequency_collator_;
+  RegExpNode* unanchored_search_loop_;
+  const ZoneGrowableArray<uint16_t>* literal_prefix_;
   Zone* zone_;
 };
 
@@ -397,6 +421,8 @@ RegExpCompiler::RegExpCompiler(intptr_t capture_count, bool is_one_byte)
       reg_exp_too_big_(false),
       read_backward_(false),
       current_expansion_factor_(1),
+      unanchored_search_loop_(nullptr),
+      literal_prefix_(nullptr),
       zone_(Thread::Current()->zone()) {
   accept_ = new (Z) EndNode(EndNode::ACCEPT, Z);
 }
@@ -3251,6 +3277,12 @@ intptr_t ChoiceNode::EmitOptimizedUnanchoredSearch(RegExpCompiler* compiler,
   ASSERT(trace->is_trivial());
 
   RegExpMacroAssembler* macro_assembler = compiler->macro_assembler();
+  // Every match starts with a known literal: skip ahead to its next
+  // occurrence, which is found with memchr/memcmp on the subject.
+  if (auto prefix = compiler->LiteralPrefixFor(this)) {
+    macro_assembler->SkipUntilLiteralPrefix(*prefix);
+    return eats_at_least;
+  }
   // At this point we know that we are at a non-greedy loop that will eat
   // any character one at a time.  Any non-anchored regexp has such a
   // loop prepended to it in order to find where it starts.  We look for
@@ -5288,6 +5320,73 @@ RegExpNode* OptionallyStepBackToLeadSurrogate(RegExpCompiler* compiler,
   return optional_step_back;
 }
 
+// Appends the characters every match of [tree] starts with to [prefix].
+// Returns true if all of [tree] is literal, so that the prefix may continue
+// with whatever follows [tree].
+static bool CollectLiteralPrefix(RegExpTree* tree,
+                                 ZoneGrowableArray<uint16_t>* prefix) {
+  if (tree->IsAtom()) {
+    RegExpAtom* atom = tree->AsAtom();
+    if (atom->ignore_case()) return false;
+    for (intptr_t i = 0; i < atom->length(); i++) {
+      prefix->Add(atom->data()->At(i));
+    }
+    return true;
+  }
+  if (tree->IsText()) {
+    GrowableArray<TextElement>* elements = tree->AsText()->elements();
+    for (intptr_t i = 0; i < elements->length(); i++) {
+      const TextElement& element = elements->At(i);
+      if (element.text_type() != TextElement::ATOM) return false;
+      if (!CollectLiteralPrefix(element.atom(), prefix)) return false;
+    }
+    return true;
+  }
+  if (tree->IsAlternative()) {
+    ZoneGrowableArray<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      if (!CollectLiteralPrefix(nodes->At(i), prefix)) return false;
+    }
+    return true;
+  }
+  if (tree->IsCapture()) {
+    return CollectLiteralPrefix(tree->AsCapture()->body(), prefix);
+  }
+  if (tree->IsQuantifier()) {
+    // The body is matched at least once, but may be followed by another
+    // iteration instead of the rest of the regexp.
+    RegExpQuantifier* quantifier = tree->AsQuantifier();
+    if (quantifier->min() > 0) {
+      CollectLiteralPrefix(quantifier->body(), prefix);
+    }
+    return false;
+  }
+  return tree->IsEmpty();
+}
+
+// Returns the literal string every match of the regexp has to start with, or
+// nullptr if there is none or the generated code would not benefit from
+// skipping ahead to it (see SkipUntilLiteralPrefix).
+static ZoneGrowableArray<uint16_t>* LiteralPrefix(RegExpCompileData* data,
+                                                  RegExpFlags flags,
+                                                  bool is_sticky,
+                                                  Zone* zone) {
+  if (!FLAG_regexp_literal_prefilter) return nullptr;
+  if (is_sticky || data->contains_anchor || data->tree->IsAnchoredAtStart()) {
+    return nullptr;
+  }
+  // Unicode regexps may step back into a surrogate pair on entry.
+  if (flags.IgnoreCase() || flags.IsUnicode()) return nullptr;
+
+  auto prefix = new (zone) ZoneGrowableArray<uint16_t>(zone, 8);
+  CollectLiteralPrefix(data->tree, prefix);
+  if (prefix->is_empty()) return nullptr;
+  if (prefix->length() > kMaxLiteralPrefixLength) {
+    prefix->TruncateTo(kMaxLiteralPrefixLength);
+  }
+  return prefix;
+}
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
 RegExpEngine::CompilationResult RegExpEngine::CompileIR(
     RegExpCompileData* data,
@@ -5327,13 +5426,14 @@ RegExpEngine::CompilationResult RegExpEngine::CompileIR(
       RegExpCapture::ToNode(data->tree, 0, &compiler, compiler.accept());
 
   RegExpNode* node = captured_body;
+  RegExpNode* loop_node = nullptr;
   const bool is_end_anchored = data->tree->IsAnchoredAtEnd();
   const bool is_start_anchored = data->tree->IsAnchoredAtStart();
   intptr_t max_length = data->tree->max_match();
   if (!is_start_anchored && !is_sticky) {
     // Add a .*? at the beginning, outside the body capture, unless
     // this expression is anchored at the beginning or is sticky.
-    RegExpNode* loop_node = RegExpQuantifier::ToNode(
+    loop_node = RegExpQuantifier::ToNode(
         0, RegExpTree::kInfinity, false,
         new (zone) RegExpCharacterClass('*', RegExpFlags()), &compiler,
         captured_body, data->contains_anchor);
@@ -5383,6 +5483,10 @@ RegExpEngine::CompilationResult RegExpEngine::CompileIR(
   if (is_end_anchored && !is_start_anchored && !is_sticky &&
       max_length < kMaxBacksearchLimit) {
     macro_assembler->SetCurrentPositionFromEnd(max_length);
+  } else if (auto prefix =
+                 LiteralPrefix(data, regexp.flags(), is_sticky, zone)) {
+    ASSERT(loop_node != nullptr);
+    compiler.SetLiteralPrefix(loop_node, prefix);
   }
 
   if (is_global) {
@@ -5437,13 +5541,14 @@ RegExpEngine::CompilationResult RegExpEngine::CompileBytecode(
       RegExpCapture::ToNode(data->tree, 0, &compiler, compiler.accept());
 
   RegExpNode* node = captured_body;
+  RegExpNode* loop_node = nullptr;
   bool is_end_anchored = data->tree->IsAnchoredAtEnd();
   bool is_start_anchored = data->tree->IsAnchoredAtStart();
   intptr_t max_length = data->tree->max_match();
   if (!is_start_anchored && !is_sticky) {
     // Add a .*? at the beginning, outside the body capture, unless
     // this expression is anchored at the beginning.
-    RegExpNode* loop_node = RegExpQuantifier::ToNode(
+    loop_node = RegExpQuantifier::ToNode(
         0, RegExpTree::kInfinity, false,
         new (zone) RegExpCharacterClass('*', RegExpFlags()), &compiler,
         captured_body, data->contains_anchor);
@@ -5493,6 +5598,10 @@ RegExpEngine::CompilationResult RegExpEngine::CompileBytecode(
   if (is_end_anchored && !is_start_anchored && !is_sticky &&
       max_length < kMaxBacksearchLimit) {
     macro_assembler->SetCurrentPositionFromEnd(max_length);
+  } else if (auto prefix =
+                 LiteralPrefix(data, regexp.flags(), is_sticky, zone)) {
+    ASSERT(loop_node != nullptr);
+    compiler.SetLiteralPrefix(loop_node, prefix);
   }
 
   if (is_global) {
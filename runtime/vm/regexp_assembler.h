@@ -226,6 +226,12 @@ class RegExpMacroAssembler : public ZoneAllocated {
   virtual void ReadCurrentPositionFromRegister(intptr_t reg) = 0;
   virtual void ReadStackPointerFromRegister(intptr_t reg) = 0;
   virtual void SetCurrentPositionFromEnd(intptr_t by) = 0;
+  // Advances the current position to the next occurrence of [prefix], which
+  // every match has to start with, and fails if there is none. Emitted at
+  // the head of the loop which looks for the start of a match, so it runs on
+  // entry and after every failed attempt.
+  virtual void SkipUntilLiteralPrefix(
+      const ZoneGrowableArray<uint16_t>& prefix) = 0;
   virtual void SetRegister(intptr_t register_index, intptr_t to) = 0;
   // Return whether the matching (with a global regexp) will be restarted.
   virtual bool Succeed() = 0;
@@ -116,6 +116,25 @@ void BytecodeRegExpMacroAssembler::SetCurrentPositionFromEnd(intptr_t by) {
   Emit(BC_SET_CURRENT_POSITION_FROM_END, by);
 }
 
+void BytecodeRegExpMacroAssembler::SkipUntilLiteralPrefix(
+    const ZoneGrowableArray<uint16_t>& prefix) {
+  const intptr_t length = prefix.length();
+  ASSERT(length > 0 && Utils::IsUint(24, length));
+  BlockLabel found, not_found;
+  Emit(BC_SKIP_UNTIL_LITERAL, length);
+  EmitOrLink(&not_found);
+  for (intptr_t i = 0; i < length; i++) {
+    Emit16(prefix[i]);
+  }
+  if ((length & 1) != 0) {
+    Emit16(0);  // Keep the following bytecode aligned.
+  }
+  GoTo(&found);
+  BindBlock(&not_found);
+  Fail();
+  BindBlock(&found);
+}
+
 void BytecodeRegExpMacroAssembler::SetRegister(intptr_t register_index,
                                                intptr_t to) {
   ASSERT(register_index >= 0);
@@ -44,6 +44,8 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
   virtual void PushRegister(intptr_t register_index);
   virtual void AdvanceRegister(intptr_t reg, intptr_t by);  // r[reg] += by.
   virtual void SetCurrentPositionFromEnd(intptr_t by);
+  virtual void SkipUntilLiteralPrefix(
+      const ZoneGrowableArray<uint16_t>& prefix);
   virtual void SetRegister(intptr_t register_index, intptr_t to);
   virtual void WriteCurrentPositionToRegister(intptr_t reg, intptr_t cp_offset);
   virtual void ClearRegisters(intptr_t reg_from, intptr_t reg_to);
@@ -1531,6 +1531,45 @@ void IRRegExpMacroAssembler::SetCurrentPositionFromEnd(intptr_t by) {
   BindBlock(&after_position);
 }
 
+void IRRegExpMacroAssembler::SkipUntilLiteralPrefix(
+    const ZoneGrowableArray<uint16_t>& prefix) {
+  TAG();
+
+  // String.indexOf of a one-byte subject is backed by memchr.
+  Thread* thread = Thread::Current();
+  const String& literal = String::ZoneHandle(
+      Z, Symbols::FromUTF16(thread, prefix.data(), prefix.length()));
+  const String& index_of =
+      String::ZoneHandle(Z, Symbols::New(thread, "indexOf"));
+
+  Value* string_push = PushLocal(string_param_);
+  Value* literal_push = Bind(new (Z) ConstantInstr(literal));
+  Value* pos_push = PushLocal(current_position_);
+  Value* len_push = PushLocal(string_param_length_);
+  Value* start_push = Bind(Add(pos_push, len_push));
+  StoreLocal(index_temp_,
+             Bind(InstanceCall(InstanceCallDescriptor(index_of), string_push,
+                               literal_push, start_push)));
+
+  BlockLabel found, after_position;
+  BranchOrBacktrack(
+      Comparison(kGTE, LoadLocal(index_temp_), Int64Constant(0)), &found);
+  Fail();
+
+  BindBlock(&found);
+  Value* index_push = PushLocal(index_temp_);
+  len_push = PushLocal(string_param_length_);
+  StoreLocal(current_position_, Bind(Sub(index_push, len_push)));
+
+  // As on code entry (see SetCurrentPositionFromEnd), the character before
+  // the new position is loaded.
+  BranchOrBacktrack(Comparison(kLTE, LoadLocal(index_temp_), Int64Constant(0)),
+                    &after_position);
+  LoadCurrentCharacterUnchecked(-1, 1);
+
+  BindBlock(&after_position);
+}
+
 void IRRegExpMacroAssembler::SetRegister(intptr_t reg, intptr_t to) {
   TAG();
   // Reserved for positions!
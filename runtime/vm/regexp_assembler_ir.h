@@ -113,6 +113,8 @@ class IRRegExpMacroAssembler : public RegExpMacroAssembler {
   virtual void ReadCurrentPositionFromRegister(intptr_t reg);
   virtual void ReadStackPointerFromRegister(intptr_t reg);
   virtual void SetCurrentPositionFromEnd(intptr_t by);
+  virtual void SkipUntilLiteralPrefix(
+      const ZoneGrowableArray<uint16_t>& prefix);
   virtual void SetRegister(intptr_t register_index, intptr_t to);
   virtual bool Succeed();
   virtual void WriteCurrentPositionToRegister(intptr_t reg, intptr_t cp_offset);
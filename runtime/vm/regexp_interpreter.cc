@@ -676,6 +676,23 @@ static ObjectPtr RawMatch(const TypedData& bytecode,
           pc += BC_SET_CURRENT_POSITION_FROM_END_LENGTH;
           break;
         }
+        BYTECODE(SKIP_UNTIL_LITERAL) {
+          const intptr_t length = static_cast<uint32_t>(insn) >> BYTECODE_SHIFT;
+          const uint16_t* literal = reinterpret_cast<const uint16_t*>(
+              pc + BC_SKIP_UNTIL_LITERAL_LENGTH);
+          const intptr_t found = subject.IndexOf(literal, length, current);
+          if (found < 0) {
+            pc = code_base + Load32Aligned(pc + 4);
+            break;
+          }
+          if (found > current) {
+            current = found;
+            current_char = subject.CharAt(current - 1);
+          }
+          pc += BC_SKIP_UNTIL_LITERAL_LENGTH +
+                Utils::RoundUp(length * sizeof(uint16_t), 4);
+          break;
+        }
         default:
           UNREACHABLE();
           break;
@@ -7,11 +7,14 @@
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/regexp.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/regexp_assembler_ir.h"
 #include "vm/unit_test.h"
 
 namespace dart {
 
+DECLARE_FLAG(bool, regexp_literal_prefilter);
+
 static ArrayPtr Match(const String& pat, const String& str) {
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
@@ -108,4 +111,92 @@ ISOLATE_UNIT_TEST_CASE(RegExp_ExternalTwoByteString) {
   EXPECT_EQ(3, smi_2.Value());
 }
 
+ISOLATE_UNIT_TEST_CASE(RegExp_LiteralPrefix) {
+  struct {
+    const char* pattern;
+    const char* subject;
+    intptr_t start;  // -1 if there is no match.
+    intptr_t end;
+  } cases[] = {
+      {"abc", "xxabxabcx", 5, 8},
+      {"abc", "xxabxabx", -1, -1},
+      {"a(b)c", "xxabxabcx", 5, 8},
+      {"ab+c", "abxabbbc", 3, 8},
+      {"(ab)+c", "abxababc", 3, 8},
+      {"ab\\b", "abc ab c", 4, 6},
+      {"\\bab", "cab ab", 4, 6},
+      {"ab|cd", "xxcd", 2, 4},
+      {"a$", "abaa", 3, 4},
+      {"x(?=y)", "xzxy", 2, 3},
+  };
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(cases)); i++) {
+    const String& pat = String::Handle(String::New(cases[i].pattern));
+    const String& str = String::Handle(String::New(cases[i].subject));
+    const Array& res = Array::Handle(Match(pat, str));
+    if (cases[i].start < 0) {
+      EXPECT(res.IsNull());
+      continue;
+    }
+    EXPECT(!res.IsNull());
+    EXPECT_EQ(cases[i].start, Smi::Value(Smi::RawCast(res.At(0))));
+    EXPECT_EQ(cases[i].end, Smi::Value(Smi::RawCast(res.At(1))));
+  }
+}
+
+#if !defined(PRODUCT)
+static ArrayPtr Interpret(const String& pat, const String& str) {
+  Thread* thread = Thread::Current();
+  // Constant in product mode.
+  SetFlagScope<bool> sfs(&FLAG_interpret_irregexp, true);
+  const RegExp& regexp =
+      RegExp::Handle(RegExpEngine::CreateRegExp(thread, pat, RegExpFlags()));
+  const Smi& idx = Object::smi_zero();
+  return Array::RawCast(BytecodeRegExpMacroAssembler::Interpret(
+      regexp, str, idx, /*sticky=*/false, thread->zone()));
+}
+#endif  // !defined(PRODUCT)
+
+// The literal prefix is searched for again after every failed attempt, so
+// these only match if skipping ahead does not jump over the real match.
+ISOLATE_UNIT_TEST_CASE(RegExp_LiteralPrefixRetry) {
+  struct {
+    const char* pattern;
+    const char* subject;
+    intptr_t start;  // -1 if there is no match.
+    intptr_t end;
+  } cases[] = {
+      {"abcd", "xabcxabcd", 5, 9},
+      {"abcd", "abcxabc", -1, -1},
+      {"aab", "aaab", 1, 4},
+      {"ab+c", "xabxabbxabbc", 8, 12},
+      {"ab\\d", "abxabyab7", 6, 9},
+      {"a(b|c)d", "abxacxacd", 6, 9},
+  };
+  for (intptr_t prefilter = 0; prefilter < 2; prefilter++) {
+    SetFlagScope<bool> sfs(&FLAG_regexp_literal_prefilter, prefilter != 0);
+    for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(cases)); i++) {
+      const String& pat = String::Handle(String::New(cases[i].pattern));
+      const String& str = String::Handle(String::New(cases[i].subject));
+      Array& res = Array::Handle(Match(pat, str));
+      if (cases[i].start < 0) {
+        EXPECT(res.IsNull());
+      } else {
+        EXPECT(!res.IsNull());
+        EXPECT_EQ(cases[i].start, Smi::Value(Smi::RawCast(res.At(0))));
+        EXPECT_EQ(cases[i].end, Smi::Value(Smi::RawCast(res.At(1))));
+      }
+#if !defined(PRODUCT)
+      res = Interpret(pat, str);
+      if (cases[i].start < 0) {
+        EXPECT(res.IsNull());
+      } else {
+        EXPECT(!res.IsNull());
+        EXPECT_EQ(cases[i].start, Smi::Value(Smi::RawCast(res.At(0))));
+        EXPECT_EQ(cases[i].end, Smi::Value(Smi::RawCast(res.At(1))));
+      }
+#endif  // !defined(PRODUCT)
+    }
+  }
+}
+
 }  // namespace dart
@@ -17,6 +17,9 @@
 #include "vm/canonical_tables.h"
 #include "vm/closure_functions_cache.h"
 #include "vm/compiler/jit/compiler.h"
+#if !defined(DART_PRECOMPILED_RUNTIME)
+#include "vm/compiler/jit/jit_function_stats.h"
+#endif
 #include "vm/cpu.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_message.h"
@@ -1613,6 +1616,42 @@ static void GetMemoryUsage(Thread* thread, JSONStream* js) {
   thread->isolate()->PrintMemoryUsageJSON(js);
 }
 
+static const MethodParameter* const get_isolate_memory_breakdown_params[] = {
+    ISOLATE_PARAMETER,
+    NULL,
+};
+
+static void GetIsolateMemoryBreakdown(Thread* thread, JSONStream* js) {
+  thread->isolate()->PrintMemoryBreakdownJSON(js);
+}
+
+static const MethodParameter* const get_isolate_queueing_delays_params[] = {
+    ISOLATE_PARAMETER,
+    new BoolParameter("reset", false),
+    NULL,
+};
+
+static void GetIsolateQueueingDelays(Thread* thread, JSONStream* js) {
+  const bool reset = BoolParameter::Parse(js->LookupParam("reset"), false);
+  thread->isolate()->message_handler()->PrintQueueingDelaysJSON(js, reset);
+}
+
+static const MethodParameter* const get_jit_function_stats_params[] = {
+    ISOLATE_PARAMETER,
+    new BoolParameter("reset", false),
+    NULL,
+};
+
+static void GetJITFunctionStats(Thread* thread, JSONStream* js) {
+  if (CheckCompilerDisabled(thread, js)) {
+    return;
+  }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  const bool reset = BoolParameter::Parse(js->LookupParam("reset"), false);
+  JitFunctionStats::PrintJSON(js, reset);
+#endif
+}
+
 static const MethodParameter* const get_isolate_group_memory_usage_params[] = {
     ISOLATE_GROUP_PARAMETER,
     NULL,
@@ -5791,6 +5830,12 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_memory_usage_params },
   { "getIsolateGroupMemoryUsage", GetIsolateGroupMemoryUsage,
     get_isolate_group_memory_usage_params },
+  { "_getJITFunctionStats", GetJITFunctionStats,
+    get_jit_function_stats_params },
+  { "_getIsolateMemoryBreakdown", GetIsolateMemoryBreakdown,
+    get_isolate_memory_breakdown_params },
+  { "_getIsolateQueueingDelays", GetIsolateQueueingDelays,
+    get_isolate_queueing_delays_params },
   { "_getIsolateMetric", GetIsolateMetric,
     get_isolate_metric_params },
   { "_getIsolateMetricList", GetIsolateMetricList,
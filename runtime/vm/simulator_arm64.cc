@@ -2284,7 +2284,7 @@ void Simulator::DecodeLoadRegLiteral(Instr* instr) {
 }
 
 void Simulator::DecodeLoadStoreExclusive(Instr* instr) {
-  if (instr->Bit(21) != 0 || instr->Bit(23) != instr->Bit(15)) {
+  if (instr->Bit(21) != 0 || (instr->Bit(23) == 1 && instr->Bit(15) == 0)) {
     UNIMPLEMENTED();
   }
   const int32_t size = instr->Bits(30, 2);
@@ -2310,9 +2310,13 @@ void Simulator::DecodeLoadStoreExclusive(Instr* instr) {
     } else {
       ASSERT(rs == R31);  // Should-Be-One
       // Format(instr, "ldxr 'rt, 'rn");
+      // Format(instr, "ldaxr 'rt, 'rn");
       const int64_t addr = get_register(rn, R31IsSP);
       const intptr_t value = (size == 3) ? ReadExclusiveX(addr, instr)
                                          : ReadExclusiveW(addr, instr);
+      if (is_ordered) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+      }
       set_register(instr, rt, value, R31IsSP);
     }
   } else {
@@ -2329,8 +2333,12 @@ void Simulator::DecodeLoadStoreExclusive(Instr* instr) {
       }
     } else {
       // Format(instr, "stxr 'rs, 'rt, 'rn");
+      // Format(instr, "stlxr 'rs, 'rt, 'rn");
       const uword value = get_register(rt, R31IsSP);
       const uword addr = get_register(rn, R31IsSP);
+      if (is_ordered) {
+        std::atomic_thread_fence(std::memory_order_release);
+      }
       const intptr_t status =
           (size == 3)
               ? WriteExclusiveX(addr, value, instr)
@@ -422,6 +422,7 @@ class ObjectPointerVisitor;
   V(_future, "_future")                                                        \
   V(_handleException, "_handleException")                                      \
   V(_handleMessage, "_handleMessage")                                          \
+  V(_handleMessages, "_handleMessages")                                        \
   V(_handleFinalizerMessage, "_handleFinalizerMessage")                        \
   V(_handleNativeFinalizerMessage, "_handleNativeFinalizerMessage")            \
   V(_hasValue, "_hasValue")                                                    \
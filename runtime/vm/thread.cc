@@ -104,6 +104,9 @@ Thread::Thread(bool is_vm_isolate)
       stack_overflow_count_(0),
       hierarchy_info_(nullptr),
       type_usage_info_(nullptr),
+#if !defined(PRODUCT)
+      heap_sampler_(this),
+#endif
       sticky_error_(Error::null()),
       REUSABLE_HANDLE_LIST(REUSABLE_HANDLE_INITIALIZERS)
           REUSABLE_HANDLE_LIST(REUSABLE_HANDLE_SCOPE_INIT)
@@ -272,6 +275,14 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kCompactorTask:
+      return "kCompactorTask";
+    case kScavengerTask:
+      return "kScavengerTask";
+    case kSampleBlockTask:
+      return "kSampleBlockTask";
+    case kHeapSnapshotTask:
+      return "kHeapSnapshotTask";
     default:
       UNREACHABLE();
       return "";
@@ -467,6 +478,11 @@ ErrorPtr Thread::HandleInterrupts() {
       if (sample_buffer != nullptr && sample_buffer->process_blocks()) {
         sample_buffer->ProcessCompletedBlocks();
       }
+      // Writes the sampled allocations to --profile_export_dir, see
+      // HeapProfileSampler::RecordSample.
+      if (isolate()->IsHeapProfileFlushDue()) {
+        isolate()->FlushHeapProfile(/*force=*/false);
+      }
     }
 #endif  // !defined(PRODUCT)
   }
@@ -488,6 +504,17 @@ ErrorPtr Thread::HandleInterrupts() {
   return Error::null();
 }
 
+#if !defined(PRODUCT)
+void Thread::ReleaseSampleBlock() {
+  SampleBlock* block = current_sample_block_.exchange(nullptr);
+  if (block == nullptr) {
+    return;
+  }
+  block->release_block();
+  block->owner()->FreeSampleBlock(block);
+}
+#endif  // !defined(PRODUCT)
+
 uword Thread::GetAndClearStackOverflowFlags() {
   uword stack_overflow_flags = stack_overflow_flags_;
   stack_overflow_flags_ = 0;
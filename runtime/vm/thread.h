@@ -21,6 +21,7 @@
 #include "vm/globals.h"
 #include "vm/handles.h"
 #include "vm/heap/pointer_block.h"
+#include "vm/heap/sampler.h"
 #include "vm/os_thread.h"
 #include "vm/pending_deopts.h"
 #include "vm/random.h"
@@ -55,6 +56,7 @@ class OSThread;
 class JSONObject;
 class PcDescriptors;
 class RuntimeEntry;
+class SampleBlock;
 class Smi;
 class StackResource;
 class StackTrace;
@@ -338,6 +340,7 @@ class Thread : public ThreadState {
     kCompactorTask = 0x10,
     kScavengerTask = 0x20,
     kSampleBlockTask = 0x40,
+    kHeapSnapshotTask = 0x80,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -663,6 +666,13 @@ class Thread : public ThreadState {
   uword end() const { return end_; }
   void set_top(uword top) { top_ = top; }
   void set_end(uword end) { end_ = end; }
+#if !defined(PRODUCT)
+  // The end of the TLAB. end() may be lower while heap sampling is active.
+  uword true_end() const { return true_end_; }
+  void set_true_end(uword end) { true_end_ = end; }
+#else
+  uword true_end() const { return end_; }
+#endif
   static intptr_t top_offset() { return OFFSET_OF(Thread, top_); }
   static intptr_t end_offset() { return OFFSET_OF(Thread, end_); }
 
@@ -1118,6 +1128,21 @@ class Thread : public ThreadState {
 
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream) const;
+
+  // The SampleBlock receiving the CPU profiling samples of this thread. It is
+  // only written by the profiler interrupt for this thread and by the thread
+  // itself while interrupts are disabled, so no locking is needed.
+  SampleBlock* current_sample_block() const {
+    return current_sample_block_.load();
+  }
+  void set_current_sample_block(SampleBlock* block) {
+    current_sample_block_.store(block);
+  }
+
+  // Hands the current sample block back to its isolate for processing.
+  void ReleaseSampleBlock();
+
+  HeapProfileSampler& heap_sampler() { return heap_sampler_; }
 #endif
 
   PendingDeopts& pending_deopts() { return pending_deopts_; }
@@ -1256,6 +1281,12 @@ class Thread : public ThreadState {
 
   CompilerTimings* compiler_timings_ = nullptr;
 
+#ifndef PRODUCT
+  RelaxedAtomic<SampleBlock*> current_sample_block_ = nullptr;
+  uword true_end_ = 0;
+  HeapProfileSampler heap_sampler_;
+#endif
+
   ErrorPtr sticky_error_;
 
   intptr_t ffi_marshalled_arguments_size_ = 0;
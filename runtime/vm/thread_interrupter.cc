@@ -36,8 +36,16 @@ namespace dart {
 // The ThreadInterrupter has a single monitor (monitor_). This monitor is used
 // to synchronize startup, shutdown, and waking up from a deep sleep.
 //
+// When sampling a hardware event (--profile_event), InterruptThread does not
+// signal the thread itself. Instead it arms a per-thread performance counter
+// the first time it sees the thread, and the kernel delivers the same signal
+// whenever that counter overflows. The interrupter thread then only picks up
+// new threads once per interrupt period.
+//
 
 DEFINE_FLAG(bool, trace_thread_interrupter, false, "Trace thread interrupter");
+DECLARE_FLAG(charp, profile_event);
+DECLARE_FLAG(int, profile_event_period);
 
 bool ThreadInterrupter::initialized_ = false;
 bool ThreadInterrupter::shutdown_ = false;
@@ -48,18 +56,75 @@ ThreadJoinId ThreadInterrupter::interrupter_thread_id_ =
 Monitor* ThreadInterrupter::monitor_ = NULL;
 intptr_t ThreadInterrupter::interrupt_period_ = 1000;
 intptr_t ThreadInterrupter::current_wait_time_ = Monitor::kNoTimeout;
+ThreadInterrupter::SampleEvent ThreadInterrupter::sample_event_ =
+    ThreadInterrupter::SampleEvent::kTimer;
+intptr_t ThreadInterrupter::sample_event_period_ = 0;
 // Note this initial state means there is one sample buffer reader. This
 // allows the EnterSampleReader during Cleanup (needed to ensure the buffer can
 // be safely freed) to be balanced by a ExitSampleReader during Init.
 std::atomic<intptr_t> ThreadInterrupter::sample_buffer_lock_ = {-1};
 std::atomic<intptr_t> ThreadInterrupter::sample_buffer_waiters_ = {1};
 
+static const struct {
+  const char* name;
+  ThreadInterrupter::SampleEvent event;
+  intptr_t default_period;
+} kSampleEvents[] = {
+    {"timer", ThreadInterrupter::SampleEvent::kTimer, 0},
+    {"cycles", ThreadInterrupter::SampleEvent::kCycles, 1000000},
+    {"instructions", ThreadInterrupter::SampleEvent::kInstructions, 1000000},
+    {"cache-misses", ThreadInterrupter::SampleEvent::kCacheMisses, 1000},
+    {"branch-misses", ThreadInterrupter::SampleEvent::kBranchMisses, 10000},
+};
+
+const char* ThreadInterrupter::SampleEventToCString(SampleEvent event) {
+  for (const auto& entry : kSampleEvents) {
+    if (entry.event == event) {
+      return entry.name;
+    }
+  }
+  UNREACHABLE();
+  return nullptr;
+}
+
 void ThreadInterrupter::Init() {
   ASSERT(!initialized_);
   if (monitor_ == NULL) {
     monitor_ = new Monitor();
   }
   ASSERT(monitor_ != NULL);
+
+  sample_event_ = SampleEvent::kTimer;
+  sample_event_period_ = 0;
+  if (FLAG_profile_event != nullptr) {
+    bool found = false;
+    for (const auto& entry : kSampleEvents) {
+      if (strcmp(FLAG_profile_event, entry.name) == 0) {
+        found = true;
+        if (entry.event == SampleEvent::kTimer) {
+          break;
+        }
+        if (!IsSampleEventSupported(entry.event)) {
+          OS::PrintErr(
+              "Warning: cannot sample %s on this system, the profiler will "
+              "fall back to timer interrupts.\n",
+              entry.name);
+          break;
+        }
+        sample_event_ = entry.event;
+        sample_event_period_ = FLAG_profile_event_period > 0
+                                   ? FLAG_profile_event_period
+                                   : entry.default_period;
+        break;
+      }
+    }
+    if (!found) {
+      OS::PrintErr("Warning: unknown --profile_event '%s', the profiler will "
+                   "fall back to timer interrupts.\n",
+                   FLAG_profile_event);
+    }
+  }
+
   initialized_ = true;
   shutdown_ = false;
 }
@@ -226,6 +291,13 @@ void ThreadInterrupter::ThreadMain(uword parameters) {
       ASSERT(current_wait_time_ != Monitor::kNoTimeout);
     }
   }
+  {
+    // Stop hardware performance counters before their signals are ignored.
+    OSThreadIterator it;
+    while (it.HasNext()) {
+      RemoveThread(it.Next());
+    }
+  }
   RemoveSignalHandler();
   if (FLAG_trace_thread_interrupter) {
     OS::PrintErr("ThreadInterrupter thread exiting.\n");
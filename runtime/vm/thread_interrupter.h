@@ -22,6 +22,18 @@ struct InterruptedThreadState {
 
 class ThreadInterrupter : public AllStatic {
  public:
+  // The event which triggers profiler samples (see --profile_event). Threads
+  // are interrupted every interrupt period for kTimer and by a per-thread
+  // hardware performance counter every sample_event_period() events for the
+  // other kinds.
+  enum class SampleEvent {
+    kTimer,
+    kCycles,
+    kInstructions,
+    kCacheMisses,
+    kBranchMisses,
+  };
+
   static void Init();
 
   static void Startup();
@@ -36,6 +48,14 @@ class ThreadInterrupter : public AllStatic {
   // Interrupt a thread.
   static void InterruptThread(OSThread* thread);
 
+  // Stops interrupting a thread. Called with the thread list lock held or
+  // after the thread has been removed from the thread list.
+  static void RemoveThread(OSThread* thread);
+
+  static SampleEvent sample_event() { return sample_event_; }
+  static intptr_t sample_event_period() { return sample_event_period_; }
+  static const char* SampleEventToCString(SampleEvent event);
+
   class SampleBufferWriterScope : public ValueObject {
    public:
     SampleBufferWriterScope() {
@@ -92,6 +112,8 @@ class ThreadInterrupter : public AllStatic {
   static Monitor* monitor_;
   static intptr_t interrupt_period_;
   static intptr_t current_wait_time_;
+  static SampleEvent sample_event_;
+  static intptr_t sample_event_period_;
 
   // Something like a reader-writer lock. Positive values indictate there are
   // outstanding signal handlers that can write to the sample buffer. Negative
@@ -108,6 +130,9 @@ class ThreadInterrupter : public AllStatic {
 
   static void ThreadMain(uword parameters);
 
+  // Whether this platform can deliver interrupts for |event|.
+  static bool IsSampleEventSupported(SampleEvent event);
+
   static void InstallSignalHandler();
 
   static void RemoveSignalHandler();
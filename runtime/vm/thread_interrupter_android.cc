@@ -77,6 +77,12 @@ extern "C" void ThreadInterruptSignalHandlerTrampoline(int signal,
                                                        void* context_);
 #endif
 
+void ThreadInterrupter::RemoveThread(OSThread* thread) {}
+
+bool ThreadInterrupter::IsSampleEventSupported(SampleEvent event) {
+  return event == SampleEvent::kTimer;
+}
+
 void ThreadInterrupter::InstallSignalHandler() {
 #if defined(USE_SIGNAL_HANDLER_TRAMPOLINE)
   SignalHandler::Install(&ThreadInterruptSignalHandlerTrampoline);
@@ -5,7 +5,12 @@
 #include "platform/globals.h"
 #if defined(DART_HOST_OS_LINUX)
 
-#include <errno.h>  // NOLINT
+#include <errno.h>             // NOLINT
+#include <fcntl.h>             // NOLINT
+#include <linux/perf_event.h>  // NOLINT
+#include <sys/ioctl.h>         // NOLINT
+#include <sys/syscall.h>       // NOLINT
+#include <unistd.h>            // NOLINT
 
 #include "vm/flags.h"
 #include "vm/os.h"
@@ -31,6 +36,11 @@ class ThreadInterrupterLinux : public AllStatic {
     if (thread == NULL) {
       return;
     }
+    if ((info->si_code == POLL_IN) &&
+        !thread->os_thread()->ThreadInterruptsEnabled()) {
+      // A performance counter overflowed while the thread is not profiled.
+      return;
+    }
     ThreadInterrupter::SampleBufferWriterScope scope;
     if (!scope.CanSample()) {
       return;
@@ -46,9 +56,78 @@ class ThreadInterrupterLinux : public AllStatic {
     its.lr = SignalHandler::GetLinkRegister(mcontext);
     Profiler::SampleThread(thread, its);
   }
+
+  // Opens a disabled counter for |event| in the thread with kernel id |tid|
+  // which overflows every |period| events. Returns -1 on failure.
+  static int OpenPerfEvent(ThreadInterrupter::SampleEvent event,
+                           intptr_t period,
+                           pid_t tid) {
+    struct perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+      case ThreadInterrupter::SampleEvent::kCycles:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case ThreadInterrupter::SampleEvent::kInstructions:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case ThreadInterrupter::SampleEvent::kCacheMisses:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      case ThreadInterrupter::SampleEvent::kBranchMisses:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+      default:
+        UNREACHABLE();
+    }
+    attr.sample_period = period;
+    attr.wakeup_events = 1;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, tid, /*cpu=*/-1,
+                   /*group_fd=*/-1, PERF_FLAG_FD_CLOEXEC);
+  }
+
+  // Makes every overflow of the counter |fd| queue SIGPROF for the thread with
+  // kernel id |tid| and starts counting.
+  static bool ArmPerfEvent(int fd, pid_t tid) {
+    struct f_owner_ex owner = {};
+    owner.type = F_OWNER_TID;
+    owner.pid = tid;
+    return (fcntl(fd, F_SETFL, O_ASYNC) == 0) &&
+           (fcntl(fd, F_SETSIG, SIGPROF) == 0) &&
+           (fcntl(fd, F_SETOWN_EX, &owner) == 0) &&
+           (ioctl(fd, PERF_EVENT_IOC_ENABLE, 0) == 0);
+  }
 };
 
 void ThreadInterrupter::InterruptThread(OSThread* thread) {
+  if (sample_event_ != SampleEvent::kTimer) {
+    if (thread->perf_event_fd_ != -1) {
+      // The counter interrupts the thread.
+      return;
+    }
+    const pid_t tid = static_cast<pid_t>(thread->trace_id());
+    int fd = ThreadInterrupterLinux::OpenPerfEvent(sample_event_,
+                                                   sample_event_period_, tid);
+    if ((fd != -1) && !ThreadInterrupterLinux::ArmPerfEvent(fd, tid)) {
+      close(fd);
+      fd = -1;
+    }
+    thread->perf_event_fd_ = fd;
+    if (FLAG_trace_thread_interrupter) {
+      OS::PrintErr("ThreadInterrupter counting %s in %p: %d\n",
+                   SampleEventToCString(sample_event_),
+                   reinterpret_cast<void*>(thread->id()),
+                   thread->perf_event_fd_);
+    }
+    if (thread->perf_event_fd_ != -1) {
+      return;
+    }
+    // Fall back to a timer interrupt and try again next period.
+  }
   if (FLAG_trace_thread_interrupter) {
     OS::PrintErr("ThreadInterrupter interrupting %p\n",
                  reinterpret_cast<void*>(thread->id()));
@@ -57,6 +136,28 @@ void ThreadInterrupter::InterruptThread(OSThread* thread) {
   ASSERT((result == 0) || (result == ESRCH));
 }
 
+void ThreadInterrupter::RemoveThread(OSThread* thread) {
+  if (thread->perf_event_fd_ != -1) {
+    close(thread->perf_event_fd_);
+    thread->perf_event_fd_ = -1;
+  }
+}
+
+bool ThreadInterrupter::IsSampleEventSupported(SampleEvent event) {
+  if (event == SampleEvent::kTimer) {
+    return true;
+  }
+  // Probe with a disabled counter for the current thread. This fails if the
+  // CPU has no PMU (e.g. in many VMs) or perf_event_paranoid forbids it.
+  int fd = ThreadInterrupterLinux::OpenPerfEvent(event, /*period=*/1,
+                                                 syscall(__NR_gettid));
+  if (fd == -1) {
+    return false;
+  }
+  close(fd);
+  return true;
+}
+
 void ThreadInterrupter::InstallSignalHandler() {
   SignalHandler::Install(&ThreadInterrupterLinux::ThreadInterruptSignalHandler);
 }
@@ -125,6 +125,12 @@ void ThreadInterrupter::InterruptThread(OSThread* os_thread) {
   interrupter.CollectSample();
 }
 
+void ThreadInterrupter::RemoveThread(OSThread* thread) {}
+
+bool ThreadInterrupter::IsSampleEventSupported(SampleEvent event) {
+  return event == SampleEvent::kTimer;
+}
+
 void ThreadInterrupter::InstallSignalHandler() {
   // Nothing to do on MacOS.
 }
@@ -113,6 +113,12 @@ void ThreadInterrupter::InterruptThread(OSThread* thread) {
   }
 }
 
+void ThreadInterrupter::RemoveThread(OSThread* thread) {}
+
+bool ThreadInterrupter::IsSampleEventSupported(SampleEvent event) {
+  return event == SampleEvent::kTimer;
+}
+
 void ThreadInterrupter::InstallSignalHandler() {
   // Nothing to do on Windows.
 }
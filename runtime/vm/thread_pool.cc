@@ -102,6 +102,12 @@ bool ThreadPool::CurrentThreadIsWorker() {
   return worker != nullptr && worker->pool_ == this;
 }
 
+bool ThreadPool::HasTasksWaitingForWorker() {
+  MonitorLocker ml(&pool_monitor_);
+  return max_pool_size_ > 0 && pending_tasks_ > count_idle_ &&
+         (count_idle_ + count_running_) >= max_pool_size_;
+}
+
 void ThreadPool::MarkCurrentWorkerAsBlocked() {
   auto worker =
       static_cast<Worker*>(OSThread::Current()->owning_thread_pool_worker_);
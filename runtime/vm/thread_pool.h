@@ -49,6 +49,10 @@ class ThreadPool {
   // Returns `true` if the current thread is runing on the [this] thread pool.
   bool CurrentThreadIsWorker();
 
+  // Returns `true` if tasks are waiting for a worker because the pool has
+  // reached its maximum size.
+  bool HasTasksWaitingForWorker();
+
   // Mark the current thread as being blocked (e.g. in native code). This might
   // temporarily increase the max thread pool size.
   void MarkCurrentWorkerAsBlocked();
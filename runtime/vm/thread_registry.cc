@@ -131,6 +131,10 @@ Thread* ThreadRegistry::GetFromFreelistLocked(bool is_vm_isolate) {
     thread = free_list_;
     free_list_ = thread->next_;
   }
+#if !defined(PRODUCT)
+  // The block's owner might have been deleted since the thread was last used.
+  thread->set_current_sample_block(nullptr);
+#endif
   return thread;
 }
 
@@ -140,6 +144,11 @@ void ThreadRegistry::ReturnToFreelistLocked(Thread* thread) {
   ASSERT(thread->isolate_ == NULL);
   ASSERT(thread->heap_ == NULL);
   ASSERT(threads_lock()->IsOwnedByCurrentThread());
+#if !defined(PRODUCT)
+  // Released when the thread was unscheduled.
+  ASSERT(thread->current_sample_block() == nullptr);
+  thread->set_current_sample_block(nullptr);
+#endif
   // Add thread to the free list.
   thread->next_ = free_list_;
   free_list_ = thread;
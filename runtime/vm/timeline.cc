@@ -47,7 +47,8 @@ DEFINE_FLAG(charp,
             timeline_recorder,
             "ring",
             "Select the timeline recorder used. "
-            "Valid values: ring, endless, startup, and systrace.")
+            "Valid values: ring, endless, startup, systrace, file[:path] "
+            "and binary[:path].")
 
 // Implementation notes:
 //
@@ -141,6 +142,13 @@ static TimelineEventRecorder* CreateTimelineRecorder() {
       Utils::StrStartsWith(flag, "file=")) {
     return new TimelineEventFileRecorder(&flag[5]);
   }
+  if (strcmp("binary", flag) == 0) {
+    return new TimelineEventBinaryFileRecorder("dart-timeline.bin");
+  }
+  if (Utils::StrStartsWith(flag, "binary:") ||
+      Utils::StrStartsWith(flag, "binary=")) {
+    return new TimelineEventBinaryFileRecorder(&flag[7]);
+  }
 
   // Always fall back to the ring recorder.
   return new TimelineEventRingRecorder();
@@ -631,11 +639,16 @@ void TimelineEvent::PrintJSON(JSONStream* stream) const {
 #endif
 
 void TimelineEvent::PrintJSON(JSONWriter* writer) const {
+  PrintJSON(writer, OS::ProcessId(), stream_ != NULL ? stream_->name() : NULL);
+}
+
+void TimelineEvent::PrintJSON(JSONWriter* writer,
+                              int64_t pid,
+                              const char* category) const {
   writer->OpenObject();
-  int64_t pid = OS::ProcessId();
   int64_t tid = OSThread::ThreadIdToIntPtr(thread_);
   writer->PrintProperty("name", label_);
-  writer->PrintProperty("cat", stream_ != NULL ? stream_->name() : NULL);
+  writer->PrintProperty("cat", category);
   writer->PrintProperty64("tid", tid);
   writer->PrintProperty64("pid", pid);
   writer->PrintProperty64("ts", TimeOrigin());
@@ -37,6 +37,7 @@ class JSONArray;
 class JSONObject;
 class JSONStream;
 class JSONWriter;
+class MallocWriteStream;
 class Object;
 class ObjectPointerVisitor;
 class Isolate;
@@ -48,6 +49,7 @@ class TimelineStream;
 class VirtualMemory;
 class Zone;
 
+#define BINARY_RECORDER_NAME "Binary"
 #define CALLBACK_RECORDER_NAME "Callback"
 #define ENDLESS_RECORDER_NAME "Endless"
 #define FILE_RECORDER_NAME "File"
@@ -492,6 +494,10 @@ class TimelineEvent {
   void StreamInit(TimelineStream* stream) { stream_ = stream; }
   void Init(EventType event_type, const char* label);
 
+  // Prints this event as if it had been recorded by process |pid| in the
+  // stream named |category|.
+  void PrintJSON(JSONWriter* writer, int64_t pid, const char* category) const;
+
   void set_event_type(EventType event_type) {
     // We only reserve 4 bits to hold the event type.
     COMPILE_ASSERT(kNumEventTypes < 16);
@@ -559,6 +565,8 @@ class TimelineEvent {
   friend class TimelineEventPlatformRecorder;
   friend class TimelineEventFuchsiaRecorder;
   friend class TimelineEventMacosRecorder;
+  friend class TimelineEventBinaryFileRecorder;
+  friend class TimelineBinaryTraceReader;
   friend class TimelineStream;
   friend class TimelineTestHelper;
   DISALLOW_COPY_AND_ASSIGN(TimelineEvent);
@@ -1065,6 +1073,117 @@ class TimelineEventFileRecorder : public TimelineEventPlatformRecorder {
   ThreadJoinId thread_id_;
 };
 
+// A recorder that streams events to a file in the compact binary format
+// described by |TimelineBinaryTrace|.
+//
+// Unlike |TimelineEventFileRecorder|, recording threads take no lock after
+// their first event: each thread serializes its events into its own
+// single-producer single-consumer ring buffer, which a background thread
+// drains to the file. Stream names, static labels and argument names are
+// interned per thread, so in the steady state an event only costs its fixed
+// size fields and the recorder does not allocate for it. Events which do not
+// fit into the ring buffer are dropped and counted.
+class TimelineEventBinaryFileRecorder : public TimelineEventPlatformRecorder {
+ public:
+  static constexpr intptr_t kThreadBufferSize = 256 * KB;
+
+  explicit TimelineEventBinaryFileRecorder(const char* path);
+  // Writes the trace with |write| to |stream| instead of to a file.
+  TimelineEventBinaryFileRecorder(Dart_FileWriteCallback write, void* stream);
+  virtual ~TimelineEventBinaryFileRecorder();
+
+  const char* name() const { return BINARY_RECORDER_NAME; }
+  intptr_t Size() { return 0; }
+
+  // The number of events dropped so far because a thread's buffer was full.
+  intptr_t dropped_events() const { return dropped_events_; }
+
+  void Drain();
+
+ private:
+  class ThreadBuffer;
+
+  TimelineEvent* StartEvent();
+  void CompleteEvent(TimelineEvent* event);
+  void OnEvent(TimelineEvent* event) { UNREACHABLE(); }
+
+  void Start();
+  ThreadBuffer* GetThreadBuffer();
+  void NotifyWriter();
+  // Writes the pending contents of all thread buffers. Must be called by the
+  // writer thread only.
+  void DrainBuffers(MallocWriteStream* chunk);
+  void Write(const void* buffer, intptr_t len);
+
+  // Called when a thread with a buffer exits.
+  static void ThreadExited(void* buffer);
+
+  Dart_FileWriteCallback write_;
+  void* stream_;
+  bool owns_stream_;
+  ThreadLocalKey buffer_key_;
+
+  // Protects |buffers_| and |next_buffer_id_|.
+  Mutex buffers_mutex_;
+  ThreadBuffer* buffers_;
+  uint32_t next_buffer_id_;
+  RelaxedAtomic<intptr_t> dropped_events_;
+
+  Monitor monitor_;
+  bool shutting_down_;
+  ThreadJoinId thread_id_;
+};
+
+// The binary trace format written by |TimelineEventBinaryFileRecorder|. All
+// integers are in host byte order.
+//
+//   trace  := "DARTTLB1" u64:pid chunk*
+//   chunk  := u32:buffer_id u32:length record*
+//   record := u32:length u8:kind payload
+//
+// A record's length includes its header. Each recording thread has its own
+// buffer, and records of one buffer appear in the order they were recorded.
+// Record kinds and their payloads are:
+//
+//   kThread:  i64:tid str:name
+//   kString:  u32:id bytes
+//   kEvent:   u8:type u8:flags u16:argc str:stream str:label i64:tid
+//             i64:isolate_id u64:isolate_group_id i64:timestamp0
+//             i64:timestamp1 i64:thread_timestamp0 i64:thread_timestamp1
+//             (str:name str:value)*
+//   kDropped: u64:count
+//
+//   str := u32:id | u32:0 u32:length bytes
+//
+// A non-zero string id refers to the string defined by an earlier kString
+// record of the same buffer. String bytes are not NUL terminated.
+class TimelineBinaryTrace : public AllStatic {
+ public:
+  static constexpr char kMagic[] = "DARTTLB1";
+  static constexpr intptr_t kMagicLength = 8;
+  static constexpr intptr_t kRecordHeaderSize =
+      sizeof(uint32_t) + sizeof(uint8_t);
+
+  enum RecordKind {
+    kThread = 1,
+    kString = 2,
+    kEvent = 3,
+    kDropped = 4,
+  };
+
+  enum EventFlags {
+    kPreSerializedArgs = 1 << 0,
+  };
+
+  // Converts the binary trace in |data| into the array form of the Chrome
+  // trace event format. Sets |*dropped_events| to the number of events the
+  // recorder had to drop. Returns false if |data| is malformed.
+  static bool ConvertToChromeJSON(const uint8_t* data,
+                                  intptr_t length,
+                                  JSONWriter* writer,
+                                  intptr_t* dropped_events = nullptr);
+};
+
 class DartTimelineEventHelpers : public AllStatic {
  public:
   static void ReportTaskEvent(Thread* thread,
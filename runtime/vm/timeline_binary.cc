@@ -0,0 +1,801 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/globals.h"
+#if defined(SUPPORT_TIMELINE)
+
+#include "vm/timeline.h"
+
+#include <atomic>
+
+#include "platform/atomic.h"
+#include "platform/hashmap.h"
+#include "vm/dart.h"
+#include "vm/datastream.h"
+#include "vm/json_writer.h"
+#include "vm/lockers.h"
+
+namespace dart {
+
+// Implementation notes:
+//
+// Each recording thread owns a |ThreadBuffer|, found through a thread local
+// created by the recorder. The thread is the only producer of its buffer's
+// ring and the writer thread is the only consumer: the producer publishes
+// whole records by advancing |write_pos_| with release semantics, and the
+// consumer frees space by advancing |read_pos_|. Neither side ever waits for
+// the other. The producer only wakes up the writer (which otherwise polls)
+// once its ring is more than half full.
+//
+// Buffers are linked into the recorder's list under |buffers_mutex_|, which is
+// only taken when a thread records its first event and by the writer thread.
+// Buffers of exited threads are freed by the writer thread once drained.
+//
+// String ids are scoped to a buffer, so interning does not need any
+// synchronization either. A string is interned by its address, which relies
+// on stream names, labels not owned by their event and argument names being
+// compile time constants (see |TimelineEvent::SetArgument|).
+//
+// Recording allocates when a thread records its first event, when a string is
+// interned for the first time (which may grow the intern table), when an
+// event is larger than any event before it and when more than |kNumEvents|
+// events of a thread are in flight at once. Otherwise the recorder does not
+// allocate.
+
+static constexpr intptr_t kDrainIntervalMillis = 100;
+
+constexpr char TimelineBinaryTrace::kMagic[];
+
+class TimelineEventBinaryFileRecorder::ThreadBuffer {
+ public:
+  explicit ThreadBuffer(uint32_t id)
+      : id_(id),
+        ring_(reinterpret_cast<uint8_t*>(malloc(kThreadBufferSize))),
+        write_pos_(0),
+        read_pos_(0),
+        dropped_(0),
+        thread_exited_(false),
+        wakeup_requested_(false),
+        strings_(SimpleHashMap::SamePointerValue, 64),
+        next_string_id_(1),
+        pending_strings_(kInitialPendingStrings),
+        scratch_(1 * KB),
+        events_in_use_(0),
+        next_(nullptr) {
+    COMPILE_ASSERT(Utils::IsPowerOfTwo(kThreadBufferSize));
+    COMPILE_ASSERT(kNumEvents <= kBitsPerByte * sizeof(events_in_use_));
+    if (ring_ == nullptr) {
+      OUT_OF_MEMORY();
+    }
+  }
+  ~ThreadBuffer() { free(ring_); }
+
+  uint32_t id() const { return id_; }
+
+  // Producer side.
+
+  // Appends |length| bytes of whole records. Returns false if they do not fit.
+  bool Append(const uint8_t* data, intptr_t length) {
+    const uword write = write_pos_.load(std::memory_order_relaxed);
+    const uword read = read_pos_.load(std::memory_order_acquire);
+    if (static_cast<uword>(length) > kThreadBufferSize - (write - read)) {
+      return false;
+    }
+    const intptr_t offset = write & kMask;
+    const intptr_t first =
+        Utils::Minimum<intptr_t>(length, kThreadBufferSize - offset);
+    memmove(ring_ + offset, data, first);
+    memmove(ring_, data + first, length - first);
+    write_pos_.store(write + length, std::memory_order_release);
+    return true;
+  }
+
+  // Whether the writer should be woken up early. Returns true at most once
+  // per drain.
+  bool NeedsWakeup() {
+    const uword write = write_pos_.load(std::memory_order_relaxed);
+    const uword read = read_pos_.load(std::memory_order_relaxed);
+    if ((write - read) < (kThreadBufferSize / 2)) {
+      return false;
+    }
+    return !wakeup_requested_.exchange(true);
+  }
+
+  void Drop() { dropped_.fetch_add(1); }
+
+  // Defines |str| for this buffer unless it was defined before.
+  void Intern(MallocWriteStream* stream, const char* str) {
+    SimpleHashMap::Entry* entry =
+        strings_.Lookup(const_cast<char*>(str), StringHash(str), true);
+    if (entry->value != nullptr) {
+      return;
+    }
+    const uint32_t id = next_string_id_++;
+    entry->value = reinterpret_cast<void*>(static_cast<uword>(id));
+    pending_strings_.Add(str);
+    const uint32_t length = strlen(str);
+    stream->WriteFixed<uint32_t>(TimelineBinaryTrace::kRecordHeaderSize +
+                                 sizeof(uint32_t) + length);
+    stream->WriteByte(TimelineBinaryTrace::kString);
+    stream->WriteFixed<uint32_t>(id);
+    stream->WriteBytes(str, length);
+  }
+
+  uint32_t InternedId(const char* str) {
+    SimpleHashMap::Entry* entry =
+        strings_.Lookup(const_cast<char*>(str), StringHash(str), false);
+    ASSERT(entry != nullptr);
+    return static_cast<uint32_t>(reinterpret_cast<uword>(entry->value));
+  }
+
+  // Makes the strings interned since the last call permanent.
+  void CommitStrings() { pending_strings_.Clear(); }
+
+  // Forgets the strings interned since the last commit, because their
+  // definitions were not written.
+  void RollbackStrings() {
+    for (intptr_t i = 0; i < pending_strings_.length(); i++) {
+      const char* str = pending_strings_[i];
+      strings_.Remove(const_cast<char*>(str), StringHash(str));
+    }
+    next_string_id_ -= pending_strings_.length();
+    pending_strings_.Clear();
+  }
+
+  MallocWriteStream* scratch() { return &scratch_; }
+
+  // Returns an event to be handed out by |StartEvent|, or nullptr if all
+  // events of this buffer are in use.
+  TimelineEvent* AcquireEvent() {
+    for (intptr_t i = 0; i < kNumEvents; i++) {
+      const uint32_t bit = 1u << i;
+      if ((events_in_use_ & bit) == 0) {
+        events_in_use_ |= bit;
+        return &events_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns whether |event| is one of this buffer's events and releases it if
+  // so.
+  bool ReleaseEvent(TimelineEvent* event) {
+    if (event < &events_[0] || event >= &events_[kNumEvents]) {
+      return false;
+    }
+    event->Reset();
+    events_in_use_ &= ~(1u << (event - &events_[0]));
+    return true;
+  }
+
+  // Consumer side.
+
+  // Appends all published records to |stream|. Returns the number of events
+  // dropped since the last call.
+  uint64_t CopyTo(MallocWriteStream* stream) {
+    const uword read = read_pos_.load(std::memory_order_relaxed);
+    const uword write = write_pos_.load(std::memory_order_acquire);
+    const intptr_t length = write - read;
+    const intptr_t offset = read & kMask;
+    const intptr_t first =
+        Utils::Minimum<intptr_t>(length, kThreadBufferSize - offset);
+    stream->WriteBytes(ring_ + offset, first);
+    stream->WriteBytes(ring_, length - first);
+    read_pos_.store(write, std::memory_order_release);
+    wakeup_requested_.store(false);
+    return dropped_.exchange(0);
+  }
+
+  bool thread_exited() const {
+    return thread_exited_.load(std::memory_order_acquire);
+  }
+  void set_thread_exited() {
+    thread_exited_.store(true, std::memory_order_release);
+  }
+
+  ThreadBuffer* next() const { return next_; }
+  void set_next(ThreadBuffer* next) { next_ = next; }
+
+ private:
+  static constexpr uword kMask = kThreadBufferSize - 1;
+  // Events started but not completed at the same time, e.g. nested
+  // |TimelineBeginEndScope|s.
+  static constexpr intptr_t kNumEvents = 8;
+  static constexpr intptr_t kInitialPendingStrings = 16;
+
+  static uint32_t StringHash(const char* str) {
+    return Utils::WordHash(reinterpret_cast<intptr_t>(str));
+  }
+
+  const uint32_t id_;
+  uint8_t* const ring_;
+  AcqRelAtomic<uword> write_pos_;
+  AcqRelAtomic<uword> read_pos_;
+  RelaxedAtomic<uint64_t> dropped_;
+  std::atomic<bool> thread_exited_;
+  RelaxedAtomic<bool> wakeup_requested_;
+
+  // Only accessed by the producer.
+  SimpleHashMap strings_;
+  uint32_t next_string_id_;
+  MallocGrowableArray<const char*> pending_strings_;
+  MallocWriteStream scratch_;
+  TimelineEvent events_[kNumEvents];
+  uint32_t events_in_use_;
+
+  // Protected by the recorder's |buffers_mutex_|.
+  ThreadBuffer* next_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+static void WriteInlineString(MallocWriteStream* stream, const char* str) {
+  if (str == nullptr) {
+    str = "";
+  }
+  const uint32_t length = strlen(str);
+  stream->WriteFixed<uint32_t>(0);
+  stream->WriteFixed<uint32_t>(length);
+  stream->WriteBytes(str, length);
+}
+
+static void PatchRecordLength(MallocWriteStream* stream, intptr_t start) {
+  const uint32_t length = stream->bytes_written() - start;
+  memmove(stream->buffer() + start, &length, sizeof(length));
+}
+
+static void TimelineEventBinaryFileRecorderStart(uword parameter) {
+  reinterpret_cast<TimelineEventBinaryFileRecorder*>(parameter)->Drain();
+}
+
+TimelineEventBinaryFileRecorder::TimelineEventBinaryFileRecorder(
+    const char* path)
+    : TimelineEventPlatformRecorder(),
+      write_(nullptr),
+      stream_(nullptr),
+      owns_stream_(true),
+      buffer_key_(kUnsetThreadLocalKey),
+      buffers_mutex_(),
+      buffers_(nullptr),
+      next_buffer_id_(1),
+      dropped_events_(0),
+      monitor_(),
+      shutting_down_(false),
+      thread_id_(OSThread::kInvalidThreadJoinId) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.");
+    return;
+  }
+  void* file = (*file_open)(path, true);
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to open timeline file: %s\n", path);
+    return;
+  }
+  write_ = file_write;
+  stream_ = file;
+  Start();
+}
+
+TimelineEventBinaryFileRecorder::TimelineEventBinaryFileRecorder(
+    Dart_FileWriteCallback write,
+    void* stream)
+    : TimelineEventPlatformRecorder(),
+      write_(write),
+      stream_(stream),
+      owns_stream_(false),
+      buffer_key_(kUnsetThreadLocalKey),
+      buffers_mutex_(),
+      buffers_(nullptr),
+      next_buffer_id_(1),
+      dropped_events_(0),
+      monitor_(),
+      shutting_down_(false),
+      thread_id_(OSThread::kInvalidThreadJoinId) {
+  ASSERT(write_ != nullptr);
+  Start();
+}
+
+void TimelineEventBinaryFileRecorder::Start() {
+  Write(TimelineBinaryTrace::kMagic, TimelineBinaryTrace::kMagicLength);
+  const uint64_t pid = OS::ProcessId();
+  Write(&pid, sizeof(pid));
+  buffer_key_ = OSThread::CreateThreadLocal(ThreadExited);
+  OSThread::Start("TimelineEventBinaryFileRecorder",
+                  TimelineEventBinaryFileRecorderStart,
+                  reinterpret_cast<uword>(this));
+}
+
+TimelineEventBinaryFileRecorder::~TimelineEventBinaryFileRecorder() {
+  if (write_ == nullptr) return;
+
+  {
+    MonitorLocker ml(&monitor_);
+    shutting_down_ = true;
+    ml.NotifyAll();
+    // Wait for the writer thread to have started.
+    while (thread_id_ == OSThread::kInvalidThreadJoinId) {
+      ml.Wait();
+    }
+  }
+  OSThread::Join(thread_id_);
+  thread_id_ = OSThread::kInvalidThreadJoinId;
+
+  // No thread can record events with this recorder anymore, and the writer
+  // thread has drained all buffers.
+  OSThread::DeleteThreadLocal(buffer_key_);
+  buffer_key_ = kUnsetThreadLocalKey;
+  ThreadBuffer* buffer = buffers_;
+  while (buffer != nullptr) {
+    ThreadBuffer* next = buffer->next();
+    delete buffer;
+    buffer = next;
+  }
+  buffers_ = nullptr;
+
+  if (owns_stream_) {
+    Dart_FileCloseCallback file_close = Dart::file_close_callback();
+    (*file_close)(stream_);
+  }
+  stream_ = nullptr;
+  write_ = nullptr;
+}
+
+void TimelineEventBinaryFileRecorder::ThreadExited(void* buffer) {
+  reinterpret_cast<ThreadBuffer*>(buffer)->set_thread_exited();
+}
+
+TimelineEventBinaryFileRecorder::ThreadBuffer*
+TimelineEventBinaryFileRecorder::GetThreadBuffer() {
+  ThreadBuffer* buffer =
+      reinterpret_cast<ThreadBuffer*>(OSThread::GetThreadLocal(buffer_key_));
+  if (buffer != nullptr) {
+    return buffer;
+  }
+  {
+    MutexLocker ml(&buffers_mutex_);
+    buffer = new ThreadBuffer(next_buffer_id_++);
+    buffer->set_next(buffers_);
+    buffers_ = buffer;
+  }
+  OSThread::SetThreadLocal(buffer_key_, reinterpret_cast<uword>(buffer));
+
+  // Identify the thread in the buffer's first record. It always fits.
+  OSThread* thread = OSThread::Current();
+  ASSERT(thread != nullptr);
+  MallocWriteStream* stream = buffer->scratch();
+  stream->SetPosition(0);
+  stream->WriteFixed<uint32_t>(0);
+  stream->WriteByte(TimelineBinaryTrace::kThread);
+  stream->WriteFixed<int64_t>(OSThread::ThreadIdToIntPtr(thread->trace_id()));
+  WriteInlineString(stream, thread->name());
+  PatchRecordLength(stream, 0);
+  const bool appended = buffer->Append(stream->buffer(), stream->Position());
+  ASSERT(appended);
+  return buffer;
+}
+
+TimelineEvent* TimelineEventBinaryFileRecorder::StartEvent() {
+  if (write_ == nullptr) {
+    return nullptr;
+  }
+  TimelineEvent* event = GetThreadBuffer()->AcquireEvent();
+  if (event == nullptr) {
+    // More events of this thread are in flight than its buffer holds.
+    event = new TimelineEvent();
+  }
+  return event;
+}
+
+void TimelineEventBinaryFileRecorder::CompleteEvent(TimelineEvent* event) {
+  if (event == nullptr) {
+    return;
+  }
+  ThreadBuffer* buffer = GetThreadBuffer();
+  MallocWriteStream* stream = buffer->scratch();
+  stream->SetPosition(0);
+
+  const char* stream_name =
+      event->stream_ != nullptr ? event->stream_->name() : "";
+  const bool intern_label = !event->owns_label();
+  const intptr_t argc =
+      Utils::Minimum<intptr_t>(event->arguments_length(), kMaxUint16);
+
+  // Definitions of new strings precede the event referring to them.
+  buffer->Intern(stream, stream_name);
+  if (intern_label) {
+    buffer->Intern(stream, event->label());
+  }
+  for (intptr_t i = 0; i < argc; i++) {
+    buffer->Intern(stream, event->arguments()[i].name);
+  }
+
+  const intptr_t start = stream->Position();
+  stream->WriteFixed<uint32_t>(0);
+  stream->WriteByte(TimelineBinaryTrace::kEvent);
+  stream->WriteByte(event->event_type());
+  stream->WriteByte(event->pre_serialized_args()
+                        ? TimelineBinaryTrace::kPreSerializedArgs
+                        : 0);
+  stream->WriteFixed<uint16_t>(argc);
+  stream->WriteFixed<uint32_t>(buffer->InternedId(stream_name));
+  if (intern_label) {
+    stream->WriteFixed<uint32_t>(buffer->InternedId(event->label()));
+  } else {
+    WriteInlineString(stream, event->label());
+  }
+  stream->WriteFixed<int64_t>(OSThread::ThreadIdToIntPtr(event->thread()));
+  stream->WriteFixed<int64_t>(event->isolate_id());
+  stream->WriteFixed<uint64_t>(event->isolate_group_id());
+  stream->WriteFixed<int64_t>(event->timestamp0_);
+  stream->WriteFixed<int64_t>(event->timestamp1_);
+  stream->WriteFixed<int64_t>(event->thread_timestamp0_);
+  stream->WriteFixed<int64_t>(event->thread_timestamp1_);
+  for (intptr_t i = 0; i < argc; i++) {
+    const TimelineEventArgument& arg = event->arguments()[i];
+    stream->WriteFixed<uint32_t>(buffer->InternedId(arg.name));
+    WriteInlineString(stream, arg.value);
+  }
+  PatchRecordLength(stream, start);
+
+  if (buffer->Append(stream->buffer(), stream->Position())) {
+    buffer->CommitStrings();
+    if (buffer->NeedsWakeup()) {
+      NotifyWriter();
+    }
+  } else {
+    buffer->RollbackStrings();
+    buffer->Drop();
+    dropped_events_.fetch_add(1);
+  }
+
+  if (!buffer->ReleaseEvent(event)) {
+    delete event;
+  }
+}
+
+void TimelineEventBinaryFileRecorder::NotifyWriter() {
+  MonitorLocker ml(&monitor_);
+  ml.Notify();
+}
+
+void TimelineEventBinaryFileRecorder::Drain() {
+  MallocWriteStream chunk(kThreadBufferSize);
+  {
+    MonitorLocker ml(&monitor_);
+    thread_id_ = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    ml.NotifyAll();
+    while (!shutting_down_) {
+      ml.Wait(kDrainIntervalMillis);
+      ml.Exit();
+      DrainBuffers(&chunk);
+      ml.Enter();
+    }
+  }
+  // Events recorded before the shutdown started.
+  DrainBuffers(&chunk);
+}
+
+void TimelineEventBinaryFileRecorder::DrainBuffers(MallocWriteStream* chunk) {
+  MutexLocker ml(&buffers_mutex_);
+  ThreadBuffer* previous = nullptr;
+  ThreadBuffer* buffer = buffers_;
+  while (buffer != nullptr) {
+    ThreadBuffer* next = buffer->next();
+    // Read before draining, so that no event can be recorded afterwards.
+    const bool thread_exited = buffer->thread_exited();
+
+    chunk->SetPosition(0);
+    chunk->WriteFixed<uint32_t>(buffer->id());
+    chunk->WriteFixed<uint32_t>(0);
+    const intptr_t header_size = chunk->Position();
+    const uint64_t dropped = buffer->CopyTo(chunk);
+    if (dropped > 0) {
+      const intptr_t start = chunk->Position();
+      chunk->WriteFixed<uint32_t>(0);
+      chunk->WriteByte(TimelineBinaryTrace::kDropped);
+      chunk->WriteFixed<uint64_t>(dropped);
+      PatchRecordLength(chunk, start);
+    }
+    const uint32_t length = chunk->Position() - header_size;
+    if (length > 0) {
+      memmove(chunk->buffer() + sizeof(uint32_t), &length, sizeof(length));
+      Write(chunk->buffer(), chunk->Position());
+    }
+
+    if (thread_exited) {
+      if (previous == nullptr) {
+        buffers_ = next;
+      } else {
+        previous->set_next(next);
+      }
+      delete buffer;
+    } else {
+      previous = buffer;
+    }
+    buffer = next;
+  }
+}
+
+void TimelineEventBinaryFileRecorder::Write(const void* buffer, intptr_t len) {
+  (*write_)(buffer, len, stream_);
+}
+
+// Reads a binary trace, see |TimelineBinaryTrace|.
+class TimelineBinaryTraceReader : public ValueObject {
+ public:
+  TimelineBinaryTraceReader(const uint8_t* data,
+                            intptr_t length,
+                            JSONWriter* writer)
+      : stream_(data, length), writer_(writer), pid_(0), dropped_events_(0) {}
+
+  ~TimelineBinaryTraceReader() {
+    for (intptr_t i = 0; i < tables_.length(); i++) {
+      MallocGrowableArray<char*>* table = tables_[i];
+      if (table == nullptr) continue;
+      for (intptr_t j = 0; j < table->length(); j++) {
+        free(table->At(j));
+      }
+      delete table;
+    }
+    FreeTemporaries();
+  }
+
+  bool Read() {
+    char magic[TimelineBinaryTrace::kMagicLength];
+    if (!ReadBytes(magic, sizeof(magic)) ||
+        (memcmp(magic, TimelineBinaryTrace::kMagic, sizeof(magic)) != 0) ||
+        !ReadFixed(&pid_)) {
+      return false;
+    }
+    writer_->OpenArray();
+    bool result = true;
+    while (result && (stream_.PendingBytes() > 0)) {
+      result = ReadChunk();
+    }
+    writer_->CloseArray();
+    return result;
+  }
+
+  intptr_t dropped_events() const { return dropped_events_; }
+
+ private:
+  template <typename T>
+  bool ReadFixed(T* value) {
+    return ReadBytes(value, sizeof(T));
+  }
+
+  bool ReadBytes(void* addr, intptr_t length) {
+    if ((length < 0) || (stream_.PendingBytes() < length)) {
+      return false;
+    }
+    stream_.ReadBytes(addr, length);
+    return true;
+  }
+
+  bool ReadChunk() {
+    uint32_t buffer_id;
+    uint32_t length;
+    if (!ReadFixed(&buffer_id) || !ReadFixed(&length) ||
+        (stream_.PendingBytes() < static_cast<intptr_t>(length))) {
+      return false;
+    }
+    const intptr_t end = stream_.Position() + length;
+    while (stream_.Position() < end) {
+      if (!ReadRecord(buffer_id, end)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ReadRecord(uint32_t buffer_id, intptr_t chunk_end) {
+    const intptr_t start = stream_.Position();
+    uint32_t length;
+    uint8_t kind;
+    if (!ReadFixed(&length) || !ReadFixed(&kind) ||
+        (length < TimelineBinaryTrace::kRecordHeaderSize) ||
+        (length > static_cast<uword>(chunk_end - start))) {
+      return false;
+    }
+    const intptr_t end = start + length;
+    bool result = true;
+    switch (kind) {
+      case TimelineBinaryTrace::kThread:
+        result = ReadThread(buffer_id);
+        break;
+      case TimelineBinaryTrace::kString:
+        result = ReadStringDefinition(buffer_id, end);
+        break;
+      case TimelineBinaryTrace::kEvent:
+        result = ReadEvent(buffer_id);
+        break;
+      case TimelineBinaryTrace::kDropped: {
+        uint64_t count;
+        result = ReadFixed(&count);
+        dropped_events_ += count;
+        break;
+      }
+      default:
+        // Unknown records are skipped.
+        break;
+    }
+    FreeTemporaries();
+    if (!result || (stream_.Position() > end)) {
+      return false;
+    }
+    stream_.SetPosition(end);
+    return true;
+  }
+
+  bool ReadThread(uint32_t buffer_id) {
+    int64_t tid;
+    const char* name;
+    if (!ReadFixed(&tid) || !ReadString(buffer_id, &name)) {
+      return false;
+    }
+    if (name[0] == '\0') {
+      // Only emit a thread name if one was set.
+      return true;
+    }
+    writer_->OpenObject();
+    writer_->PrintProperty("name", "thread_name");
+    writer_->PrintProperty("ph", "M");
+    writer_->PrintProperty64("pid", pid_);
+    writer_->PrintProperty64("tid", tid);
+    writer_->OpenObject("args");
+    writer_->PrintfProperty("name", "%s (%" Pd64 ")", name, tid);
+    writer_->PrintProperty("mode", "basic");
+    writer_->CloseObject();
+    writer_->CloseObject();
+    return true;
+  }
+
+  bool ReadStringDefinition(uint32_t buffer_id, intptr_t end) {
+    uint32_t id;
+    if (!ReadFixed(&id) || (id == 0) || (stream_.Position() > end)) {
+      return false;
+    }
+    const intptr_t length = end - stream_.Position();
+    char* str = Utils::StrNDup(
+        reinterpret_cast<const char*>(stream_.AddressOfCurrentPosition()),
+        length);
+    stream_.Advance(length);
+    MallocGrowableArray<char*>* table = Table(buffer_id);
+    while (table->length() <= static_cast<intptr_t>(id)) {
+      table->Add(nullptr);
+    }
+    free(table->At(id));
+    (*table)[id] = str;
+    return true;
+  }
+
+  bool ReadEvent(uint32_t buffer_id) {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t argc;
+    const char* category;
+    const char* label;
+    int64_t tid;
+    if (!ReadFixed(&type) || !ReadFixed(&flags) || !ReadFixed(&argc) ||
+        !ReadString(buffer_id, &category) || !ReadString(buffer_id, &label) ||
+        !ReadFixed(&tid)) {
+      return false;
+    }
+    if ((type <= TimelineEvent::kNone) ||
+        (type >= TimelineEvent::kNumEventTypes)) {
+      return false;
+    }
+    const bool pre_serialized_args =
+        (flags & TimelineBinaryTrace::kPreSerializedArgs) != 0;
+    if (pre_serialized_args && (argc != 1)) {
+      return false;
+    }
+
+    TimelineEvent* event = &event_;
+    event->Reset();
+    event->set_event_type(static_cast<TimelineEvent::EventType>(type));
+    event->set_pre_serialized_args(pre_serialized_args);
+    event->label_ = label;
+    event->thread_ = OSThread::ThreadIdFromIntPtr(tid);
+    if (!ReadFixed(&event->isolate_id_) ||
+        !ReadFixed(&event->isolate_group_id_) ||
+        !ReadFixed(&event->timestamp0_) || !ReadFixed(&event->timestamp1_) ||
+        !ReadFixed(&event->thread_timestamp0_) ||
+        !ReadFixed(&event->thread_timestamp1_)) {
+      event->Reset();
+      return false;
+    }
+    event->SetNumArguments(argc);
+    for (intptr_t i = 0; i < argc; i++) {
+      const char* name;
+      const char* value;
+      if (!ReadString(buffer_id, &name) || !ReadString(buffer_id, &value)) {
+        event->Reset();
+        return false;
+      }
+      event->CopyArgument(i, name, value);
+    }
+    event->PrintJSON(writer_, pid_, category);
+    event->Reset();
+    return true;
+  }
+
+  // Sets |*result| to a string which stays valid until the end of the
+  // current record.
+  bool ReadString(uint32_t buffer_id, const char** result) {
+    uint32_t id;
+    if (!ReadFixed(&id)) {
+      return false;
+    }
+    if (id != 0) {
+      MallocGrowableArray<char*>* table = Table(buffer_id);
+      if ((static_cast<intptr_t>(id) >= table->length()) ||
+          (table->At(id) == nullptr)) {
+        return false;
+      }
+      *result = table->At(id);
+      return true;
+    }
+    uint32_t length;
+    if (!ReadFixed(&length) ||
+        (stream_.PendingBytes() < static_cast<intptr_t>(length))) {
+      return false;
+    }
+    char* str = Utils::StrNDup(
+        reinterpret_cast<const char*>(stream_.AddressOfCurrentPosition()),
+        length);
+    stream_.Advance(length);
+    temporaries_.Add(str);
+    *result = str;
+    return true;
+  }
+
+  MallocGrowableArray<char*>* Table(uint32_t buffer_id) {
+    while (tables_.length() <= static_cast<intptr_t>(buffer_id)) {
+      tables_.Add(nullptr);
+    }
+    if (tables_[buffer_id] == nullptr) {
+      tables_[buffer_id] = new MallocGrowableArray<char*>();
+    }
+    return tables_[buffer_id];
+  }
+
+  void FreeTemporaries() {
+    for (intptr_t i = 0; i < temporaries_.length(); i++) {
+      free(temporaries_[i]);
+    }
+    temporaries_.Clear();
+  }
+
+  ReadStream stream_;
+  JSONWriter* writer_;
+  int64_t pid_;
+  intptr_t dropped_events_;
+  // String tables by buffer id.
+  MallocGrowableArray<MallocGrowableArray<char*>*> tables_;
+  MallocGrowableArray<char*> temporaries_;
+  TimelineEvent event_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimelineBinaryTraceReader);
+};
+
+bool TimelineBinaryTrace::ConvertToChromeJSON(const uint8_t* data,
+                                              intptr_t length,
+                                              JSONWriter* writer,
+                                              intptr_t* dropped_events) {
+  TimelineBinaryTraceReader reader(data, length, writer);
+  const bool result = reader.Read();
+  if (dropped_events != nullptr) {
+    *dropped_events = reader.dropped_events();
+  }
+  return result;
+}
+
+}  // namespace dart
+
+#endif  // defined(SUPPORT_TIMELINE)
@@ -8,7 +8,9 @@
 
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_state.h"
+#include "vm/datastream.h"
 #include "vm/globals.h"
+#include "vm/json_writer.h"
 #include "vm/timeline.h"
 #include "vm/unit_test.h"
 
@@ -375,6 +377,142 @@ TEST_CASE(TimelineRingRecorderJSONOrder) {
   EXPECT(alpha < beta);
 }
 
+static void CaptureTimelineBytes(const void* data,
+                                 intptr_t length,
+                                 void* stream) {
+  reinterpret_cast<MallocWriteStream*>(stream)->WriteBytes(data, length);
+}
+
+static void DiscardTimelineBytes(const void* data,
+                                 intptr_t length,
+                                 void* stream) {}
+
+static intptr_t CountSubstrings(const char* haystack, const char* needle) {
+  intptr_t count = 0;
+  for (const char* p = strstr(haystack, needle); p != nullptr;
+       p = strstr(p + 1, needle)) {
+    count++;
+  }
+  return count;
+}
+
+TEST_CASE(TimelineBinaryRecorderRoundTrip) {
+  TimelineStream stream("testStream", "testStream", false, true);
+  MallocWriteStream bytes(KB);
+  {
+    TimelineEventBinaryFileRecorder* recorder =
+        new TimelineEventBinaryFileRecorder(CaptureTimelineBytes, &bytes);
+    TimelineRecorderOverride<TimelineEventBinaryFileRecorder> override(
+        recorder);
+
+    TimelineEvent* event = stream.StartEvent();
+    event->DurationBegin("apple");
+    event->SetNumArguments(2);
+    event->CopyArgument(0, "arg1", "value1");
+    event->CopyArgument(1, "arg2", "value2");
+    event->DurationEnd();
+    event->Complete();
+
+    // Interned strings are only defined once.
+    for (intptr_t i = 0; i < 2; i++) {
+      event = stream.StartEvent();
+      event->Instant("banana");
+      event->Complete();
+    }
+
+    // Labels owned by the event are written out in full.
+    event = stream.StartEvent();
+    event->Instant(Utils::StrDup("cherry"));
+    event->set_owns_label(true);
+    event->Complete();
+
+    event = stream.StartEvent();
+    event->Instant("durian");
+    event->CompleteWithPreSerializedArgs(Utils::StrDup("{\"a\":1}"));
+
+    EXPECT_EQ(0, recorder->dropped_events());
+    // Deleting the recorder flushes all buffers.
+  }
+
+  const uint8_t* data = bytes.buffer();
+  const intptr_t length = bytes.bytes_written();
+  intptr_t definitions = 0;
+  for (intptr_t i = 0; i + 6 <= length; i++) {
+    if (memcmp(data + i, "banana", 6) == 0) definitions++;
+  }
+  EXPECT_EQ(1, definitions);
+
+  JSONWriter writer;
+  intptr_t dropped_events = -1;
+  EXPECT(TimelineBinaryTrace::ConvertToChromeJSON(data, length, &writer,
+                                                  &dropped_events));
+  EXPECT_EQ(0, dropped_events);
+  const char* json = writer.ToCString();
+  EXPECT_EQ('[', json[0]);
+  EXPECT_EQ(5, CountSubstrings(json, "\"cat\":\"testStream\""));
+  EXPECT_SUBSTRING("\"name\":\"apple\"", json);
+  EXPECT_SUBSTRING("\"ph\":\"X\"", json);
+  EXPECT_SUBSTRING("\"arg1\":\"value1\"", json);
+  EXPECT_SUBSTRING("\"arg2\":\"value2\"", json);
+  EXPECT_EQ(2, CountSubstrings(json, "\"name\":\"banana\""));
+  EXPECT_SUBSTRING("\"name\":\"cherry\"", json);
+  EXPECT_SUBSTRING("\"name\":\"durian\"", json);
+  EXPECT_SUBSTRING("\"args\":{\"a\":1", json);
+
+  // Truncated and corrupted traces are rejected.
+  JSONWriter truncated;
+  EXPECT(!TimelineBinaryTrace::ConvertToChromeJSON(data, length - 1,
+                                                   &truncated));
+  JSONWriter corrupted;
+  EXPECT(!TimelineBinaryTrace::ConvertToChromeJSON(
+      data + 1, length - 1, &corrupted));
+}
+
+static int64_t RecordTimelineEvents(TimelineStream* stream, intptr_t count) {
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  for (intptr_t i = 0; i < count; i++) {
+    TimelineEvent* event = stream->StartEvent();
+    event->Instant("overhead");
+    event->Complete();
+  }
+  return OS::GetCurrentMonotonicMicros() - start;
+}
+
+// Reports the cost of recording an event with different recorders. This does
+// not check any timings, which are too noisy on bots.
+TEST_CASE(TimelineRecorderOverhead) {
+  const intptr_t kEvents = 100000;
+  TimelineStream stream("testStream", "testStream", false, true);
+
+  {
+    TimelineRecorderOverride<TimelineEventRingRecorder> override;
+    const int64_t micros = RecordTimelineEvents(&stream, kEvents);
+    OS::PrintErr("Ring recorder: %" Pd64 " ns/event\n",
+                 (micros * 1000) / kEvents);
+  }
+
+  {
+    TimelineEventBinaryFileRecorder* recorder =
+        new TimelineEventBinaryFileRecorder(DiscardTimelineBytes, nullptr);
+    TimelineRecorderOverride<TimelineEventBinaryFileRecorder> override(
+        recorder);
+    const int64_t micros = RecordTimelineEvents(&stream, kEvents);
+    OS::PrintErr("Binary recorder: %" Pd64 " ns/event (%" Pd " dropped)\n",
+                 (micros * 1000) / kEvents, recorder->dropped_events());
+  }
+
+#if !defined(DART_HOST_OS_WINDOWS)
+  if (Dart::file_open_callback() != nullptr) {
+    TimelineEventFileRecorder* recorder =
+        new TimelineEventFileRecorder("/dev/null");
+    TimelineRecorderOverride<TimelineEventFileRecorder> override(recorder);
+    const int64_t micros = RecordTimelineEvents(&stream, kEvents);
+    OS::PrintErr("File recorder: %" Pd64 " ns/event\n",
+                 (micros * 1000) / kEvents);
+  }
+#endif  // !defined(DART_HOST_OS_WINDOWS)
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
@@ -5,40 +5,12 @@
 // part of "common_patch.dart";
 
 class _IOServicePorts {
-  // We limit the number of IO Service ports per isolate so that we don't
-  // spawn too many threads all at once, which can crash the VM on Windows.
-  static const int maxPorts = 32;
-  List<SendPort> _ports = <SendPort>[];
-  List<SendPort> _freePorts = <SendPort>[];
-  Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  // All requests of an isolate go through a single port. The VM handles them
+  // on a limited number of threads at a time, so that we don't spawn too many
+  // threads all at once, which can crash the VM on Windows.
+  static SendPort? _port;
 
-  _IOServicePorts();
-
-  SendPort _getPort(int forRequestId) {
-    if (_freePorts.isEmpty && _usedPorts.length < maxPorts) {
-      final SendPort port = _newServicePort();
-      _ports.add(port);
-      _freePorts.add(port);
-    }
-    if (!_freePorts.isEmpty) {
-      final SendPort port = _freePorts.removeLast();
-      assert(!_usedPorts.containsKey(forRequestId));
-      _usedPorts[forRequestId] = port;
-      return port;
-    }
-    // We have already allocated the max number of ports. Re-use an
-    // existing one.
-    final SendPort port = _ports[forRequestId % maxPorts];
-    _usedPorts[forRequestId] = port;
-    return port;
-  }
-
-  void _returnPort(int forRequestId) {
-    final SendPort port = _usedPorts.remove(forRequestId)!;
-    if (!_usedPorts.values.contains(port)) {
-      _freePorts.add(port);
-    }
-  }
+  static SendPort _getPort() => _port ??= _newServicePort();
 
   @pragma("vm:external-name", "IOService_NewServicePort")
   external static SendPort _newServicePort();
@@ -46,7 +18,6 @@ class _IOServicePorts {
 
 @patch
 class _IOService {
-  static _IOServicePorts _servicePorts = new _IOServicePorts();
   static RawReceivePort? _receivePort;
   static late SendPort _replyToPort;
   static HashMap<int, Completer> _messageMap = new HashMap<int, Completer>();
@@ -58,7 +29,7 @@ class _IOService {
     do {
       id = _getNextId();
     } while (_messageMap.containsKey(id));
-    final SendPort servicePort = _servicePorts._getPort(id);
+    final SendPort servicePort = _IOServicePorts._getPort();
     _ensureInitialize();
     final Completer completer = new Completer();
     _messageMap[id] = completer;
@@ -80,7 +51,6 @@ class _IOService {
       _receivePort!.handler = (data) {
         assert(data is List && data.length == 2);
         _messageMap.remove(data[0])!.complete(data[1]);
-        _servicePorts._returnPort(data[0]);
         if (_messageMap.length == 0) {
           _finalize();
         }
@@ -29,6 +29,7 @@ import "dart:_internal"
         SubListIterable,
         UnmodifiableListMixin,
         has63BitSmis,
+        makeDeeplyImmutable,
         makeFixedListUnmodifiable,
         makeListFixedLength,
         patch,
@@ -11,7 +11,7 @@ import "dart:async" show Timer;
 import "dart:core" hide Symbol;
 import "dart:ffi" show Pointer, Struct, Union, IntPtr, Handle, Void, FfiNative;
 import "dart:isolate" show SendPort;
-import "dart:typed_data" show Int32List, Uint8List;
+import "dart:typed_data" show ByteBuffer, Int32List, Uint8List;
 
 /// These are the additional parts of this patch library:
 // part "class_id_fasta.dart";
@@ -34,6 +34,108 @@ external List<T> makeListFixedLength<T>(List<T> growableList);
 @pragma("vm:exact-result-type", "dart:core#_ImmutableList")
 external List<T> makeFixedListUnmodifiable<T>(List<T> fixedLengthList);
 
+/// Marks [object] and everything reachable from it as deeply immutable, so
+/// that messages to isolates of the same group pass it by reference.
+///
+/// Only succeeds if the whole graph is unmodifiable and small: the number of
+/// objects checked is bounded by the size of [object] if it is an owned
+/// collection and by a small constant otherwise. If [ownsObject] is true,
+/// [object] may be a default [LinkedHashMap] or [LinkedHashSet] which is not
+/// reachable by anything but the caller, and will not be modified anymore.
+///
+/// Returns whether [object] is now deeply immutable.
+@pragma("vm:external-name", "Internal_makeDeeplyImmutable")
+external bool makeDeeplyImmutable(Object? object, bool ownsObject);
+
+/// A fixed-length sequence of bytes which can be accessed by several isolates
+/// at the same time.
+///
+/// Sending it to an isolate of the same isolate group takes constant time:
+/// the sender and all receivers see the same memory. An isolate of a different
+/// isolate group receives a copy of the bytes instead.
+///
+/// Plain reads and writes through views of [buffer] are not synchronized
+/// between isolates. The atomic operations can be used to coordinate access,
+/// e.g. to publish the positions of a single-producer single-consumer ring
+/// buffer. They operate on 64-bit signed integers in the platform's byte
+/// order, at offsets which are a multiple of 8.
+class SharedTypedData {
+  // An external Uint8List which the VM shares, rather than copies, when
+  // sending it within the isolate group.
+  final Uint8List _data;
+
+  SharedTypedData(int lengthInBytes) : _data = _allocate(lengthInBytes);
+
+  int get lengthInBytes => _data.lengthInBytes;
+
+  /// The bytes of this buffer. Views created from it in different isolates
+  /// alias the same memory.
+  ByteBuffer get buffer => _data.buffer;
+
+  /// Atomically reads the 64-bit integer at [byteOffset], with acquire
+  /// semantics.
+  @pragma("vm:prefer-inline")
+  int atomicLoad(int byteOffset) {
+    _checkOffset(byteOffset);
+    return _atomicLoad(_data, byteOffset);
+  }
+
+  /// Atomically writes [value] at [byteOffset], with release semantics: the
+  /// writes made before it are visible to an isolate which observes [value]
+  /// with [atomicLoad].
+  @pragma("vm:prefer-inline")
+  void atomicStore(int byteOffset, int value) {
+    _checkOffset(byteOffset);
+    _atomicStore(_data, byteOffset, value);
+  }
+
+  /// Atomically replaces the 64-bit integer at [byteOffset] with [newValue] if
+  /// it is equal to [expected], and returns the previous value.
+  int atomicCompareAndSwap(int byteOffset, int expected, int newValue) {
+    _checkOffset(byteOffset);
+    return _atomicCompareAndSwap(_data, byteOffset, expected, newValue);
+  }
+
+  /// Atomically adds [delta] to the 64-bit integer at [byteOffset], wrapping
+  /// around on overflow, and returns the previous value.
+  @pragma("vm:prefer-inline")
+  int atomicFetchAdd(int byteOffset, int delta) {
+    _checkOffset(byteOffset);
+    return _atomicFetchAdd(_data, byteOffset, delta);
+  }
+
+  // The recognized methods below access memory without any checks.
+  @pragma("vm:prefer-inline")
+  void _checkOffset(int byteOffset) {
+    RangeError.checkValueInInterval(
+        byteOffset, 0, _data.lengthInBytes - 8, "byteOffset");
+    if ((byteOffset & 7) != 0) {
+      throw ArgumentError.value(
+          byteOffset, "byteOffset", "Must be a multiple of 8");
+    }
+  }
+
+  @pragma("vm:external-name", "SharedTypedData_allocate")
+  external static Uint8List _allocate(int lengthInBytes);
+
+  @pragma("vm:recognized", "other")
+  @pragma("vm:external-name", "SharedTypedData_atomicLoad")
+  external static int _atomicLoad(Uint8List data, int byteOffset);
+
+  @pragma("vm:recognized", "other")
+  @pragma("vm:external-name", "SharedTypedData_atomicStore")
+  external static void _atomicStore(Uint8List data, int byteOffset, int value);
+
+  @pragma("vm:external-name", "SharedTypedData_atomicCompareAndSwap")
+  external static int _atomicCompareAndSwap(
+      Uint8List data, int byteOffset, int expected, int newValue);
+
+  @pragma("vm:recognized", "other")
+  @pragma("vm:external-name", "SharedTypedData_atomicFetchAdd")
+  external static int _atomicFetchAdd(
+      Uint8List data, int byteOffset, int delta);
+}
+
 @patch
 @pragma("vm:external-name", "Internal_extractTypeArguments")
 external Object? extractTypeArguments<T>(T instance, Function extract);
@@ -194,6 +194,29 @@ class _RawReceivePortImpl implements RawReceivePort {
     return handler;
   }
 
+  // Called from the VM to handle a message followed by the other messages
+  // which the VM delivers in the same batch. Each message is handled exactly
+  // as by [_handleMessage], including draining the microtask queue.
+  @pragma("vm:entry-point", "call")
+  static void _handleMessages(int id, var message) {
+    final entry = List<Object?>.filled(2, null);
+    while (true) {
+      final handler = _portMap[id]?['handler'];
+      if (handler != null) {
+        handler(message);
+        _runPendingImmediateCallback();
+      }
+      if (!_nextBatchMessage(entry)) return;
+      id = entry[0] as int;
+      message = entry[1];
+    }
+  }
+
+  // Dequeues the next message of the current batch into [entry] as
+  // `[port id, message]`. Returns false when the batch is over.
+  @pragma("vm:external-name", "RawReceivePortImpl_nextBatchMessage")
+  external static bool _nextBatchMessage(List<Object?> entry);
+
   // Call into the VM to close the VM maintained mappings.
   @pragma("vm:external-name", "RawReceivePortImpl_closeInternal")
   external int _closeInternal();
@@ -23,7 +23,16 @@ class Map<K, V> {
 
   @patch
   factory Map.unmodifiable(Map other) {
-    return new UnmodifiableMapView<K, V>(new Map<K, V>.from(other));
+    final map = new Map<K, V>.from(other);
+    final view = new UnmodifiableMapView<K, V>(map);
+    // Nothing but [view] can reach [map], so if all keys and values are
+    // deeply immutable, messages can share it instead of copying it. This
+    // returns false right away unless --share-deeply-immutable-objects is
+    // given, because the check visits every entry.
+    if (makeDeeplyImmutable(map, true)) {
+      makeDeeplyImmutable(view, false);
+    }
+    return view;
   }
 
   @patch
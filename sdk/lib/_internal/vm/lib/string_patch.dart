@@ -1064,9 +1064,23 @@ class _OneByteString extends _StringBase {
     return res;
   }
 
+  // Searches in at least this many characters are done by the runtime, which
+  // uses the vectorized memchr/memcmp of the C library. Below that the native
+  // call overhead outweighs the benefit.
+  static const int _nativeIndexOfThreshold = 64;
+
+  @pragma("vm:external-name", "OneByteString_indexOf")
+  external int _indexOfNative(_OneByteString pattern, int start);
+
   int indexOf(Pattern pattern, [int start = 0]) {
-    // Specialize for single character pattern.
     final pCid = ClassID.getID(pattern);
+    if (pCid == ClassID.cidOneByteString) {
+      final len = this.length;
+      if ((start >= 0) && (len - start >= _nativeIndexOfThreshold)) {
+        return _indexOfNative(unsafeCast<_OneByteString>(pattern), start);
+      }
+    }
+    // Specialize for single character pattern.
     if ((pCid == ClassID.cidOneByteString) ||
         (pCid == ClassID.cidTwoByteString) ||
         (pCid == ClassID.cidExternalOneByteString)) {
@@ -1090,6 +1104,12 @@ class _OneByteString extends _StringBase {
 
   bool contains(Pattern pattern, [int start = 0]) {
     final pCid = ClassID.getID(pattern);
+    if (pCid == ClassID.cidOneByteString) {
+      final len = this.length;
+      if ((start >= 0) && (len - start >= _nativeIndexOfThreshold)) {
+        return _indexOfNative(unsafeCast<_OneByteString>(pattern), start) >= 0;
+      }
+    }
     if ((pCid == ClassID.cidOneByteString) ||
         (pCid == ClassID.cidTwoByteString) ||
         (pCid == ClassID.cidExternalOneByteString)) {
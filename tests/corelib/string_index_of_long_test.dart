@@ -0,0 +1,61 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Dart test for String.indexOf, String.contains and == on long strings, which
+// some implementations handle with specialized code.
+
+import "package:expect/expect.dart";
+
+String repeat(String s, int count) => s * count;
+
+void testIndexOf() {
+  for (final length in [0, 1, 7, 8, 15, 16, 17, 63, 64, 65, 200, 4096]) {
+    final haystack = repeat("a", length) + "xyz" + repeat("a", 5);
+    Expect.equals(length, haystack.indexOf("x"));
+    Expect.equals(length, haystack.indexOf("xyz"));
+    Expect.equals(length + 1, haystack.indexOf("yz"));
+    Expect.equals(-1, haystack.indexOf("xz"));
+    Expect.equals(-1, haystack.indexOf("aaaaaaa", length));
+    Expect.equals(length + 3, haystack.indexOf("aaaaa", length));
+    Expect.equals(-1, haystack.indexOf("x", length + 1));
+    Expect.equals(haystack.length, haystack.indexOf("", haystack.length));
+    Expect.equals(3, haystack.indexOf("", 3));
+    Expect.equals(-1, haystack.indexOf("\u{1234}"));
+    Expect.isTrue(haystack.contains("xyz"));
+    Expect.isTrue(haystack.contains("xyz", length));
+    Expect.isFalse(haystack.contains("xyz", length + 1));
+    Expect.isFalse(haystack.contains("xyza" + repeat("a", 10)));
+    Expect.throws(() => haystack.indexOf("x", -1));
+    Expect.throws(() => haystack.indexOf("x", haystack.length + 1));
+  }
+  // Partial matches ending at the last character.
+  final s = repeat("ab", 100);
+  Expect.equals(-1, s.indexOf("abc"));
+  Expect.equals(198, s.indexOf("ab", 197));
+  Expect.equals(-1, s.indexOf("ba", 198));
+}
+
+void testEquality() {
+  for (final length in [1, 7, 8, 15, 16, 17, 31, 32, 33, 1000]) {
+    final a = repeat("a", length);
+    for (int i = 0; i < length; i++) {
+      final b = a.substring(0, i) + "b" + a.substring(i + 1);
+      Expect.notEquals(a, b);
+      Expect.equals(b, a.substring(0, i) + "b" + a.substring(i + 1));
+    }
+    final wide = repeat("\u{1234}", length);
+    for (int i = 0; i < length; i++) {
+      final other = wide.substring(0, i) + "\u{1235}" + wide.substring(i + 1);
+      Expect.notEquals(wide, other);
+    }
+    Expect.equals(wide, repeat("\u{1234}", length));
+  }
+}
+
+main() {
+  for (int i = 0; i < 20; i++) {
+    testIndexOf();
+    testEquality();
+  }
+}
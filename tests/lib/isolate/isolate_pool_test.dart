@@ -0,0 +1,58 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--isolate_pool_size=0
+// VMOptions=--isolate_pool_size=2
+
+// Isolates taken from the isolate pool behave like freshly created ones:
+// they get the requested debug name and start with pristine static state.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+int counter = 0;
+final List<int> initializedOnce = <int>[];
+
+void child(SendPort sendPort) {
+  counter++;
+  initializedOnce.add(counter);
+  sendPort.send([Isolate.current.debugName, counter, initializedOnce.length]);
+}
+
+Future<List> spawnChild(String name) async {
+  final port = ReceivePort();
+  final exitPort = ReceivePort();
+  await Isolate.spawn(child, port.sendPort,
+      debugName: name, onExit: exitPort.sendPort);
+  final result = await port.first as List;
+  await exitPort.first;
+  return result;
+}
+
+Future<void> testSequential() async {
+  for (int i = 0; i < 10; i++) {
+    final name = 'sequential-$i';
+    Expect.listEquals([name, 1, 1], await spawnChild(name));
+  }
+}
+
+Future<void> testConcurrent() async {
+  final results = await Future.wait(
+      List<Future<List>>.generate(10, (i) => spawnChild('concurrent-$i')));
+  for (int i = 0; i < results.length; i++) {
+    Expect.listEquals(['concurrent-$i', 1, 1], results[i]);
+  }
+}
+
+main() async {
+  asyncStart();
+  counter = 42;
+  await testSequential();
+  await testConcurrent();
+  Expect.equals(42, counter);
+  asyncEnd();
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--share-deeply-immutable-objects
+// VMOptions=--no-share-deeply-immutable-objects
+
+// Unmodifiable maps of deeply immutable values may be passed by reference,
+// but maps reaching modifiable objects must still be copied.
+
+import "dart:isolate";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+class Counter {
+  int count = 0;
+}
+
+main() {
+  final counter = new Counter();
+  final lookupTable = new Map<String, Object>.unmodifiable({
+    'a': 'b',
+    'c': new List<String>.unmodifiable(['d', 'e']),
+    'f': 1.5,
+  });
+  final withCounter = new Map<String, Object>.unmodifiable({'a': counter});
+
+  var port;
+  port = new RawReceivePort((message) {
+    port.close();
+    asyncEnd();
+
+    final receivedTable = message[0] as Map<String, Object>;
+    Expect.mapEquals(lookupTable, receivedTable);
+    Expect.throwsUnsupportedError(() => receivedTable['a'] = 'x');
+
+    final receivedCounter = (message[1] as Map<String, Object>)['a'] as Counter;
+    Expect.isFalse(identical(counter, receivedCounter));
+    counter.count++;
+    Expect.equals(0, receivedCounter.count);
+  });
+
+  asyncStart();
+  port.sendPort.send([lookupTable, withCounter]);
+}
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022, the Dart project authors.  Please see the AUTHORS file
+# for details. All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+#
+
+# Compares two runs of the VM microbenchmarks written by
+#
+#   run_vm_tests --benchmark_repetitions=<n> --benchmark_json=<file> ...
+#
+# and flags the benchmarks whose score changed significantly according to
+# Welch's t-test. Lower scores are better for all kinds of benchmarks. Exits
+# with 1 if any benchmark regressed, so it can be used to gate changes.
+#
+
+import argparse
+import json
+import math
+import sys
+
+
+def IncompleteBetaFraction(a, b, x):
+    # Continued fraction for the incomplete beta function, evaluated with the
+    # modified Lentz method (Numerical Recipes, section 6.4).
+    tiny = 1e-300
+    qab = a + b
+    qap = a + 1.0
+    qam = a - 1.0
+    c = 1.0
+    d = 1.0 - qab * x / qap
+    if abs(d) < tiny:
+        d = tiny
+    d = 1.0 / d
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1.0 + aa * d
+        if abs(d) < tiny:
+            d = tiny
+        c = 1.0 + aa / c
+        if abs(c) < tiny:
+            c = tiny
+        d = 1.0 / d
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1.0 + aa * d
+        if abs(d) < tiny:
+            d = tiny
+        c = 1.0 + aa / c
+        if abs(c) < tiny:
+            c = tiny
+        d = 1.0 / d
+        delta = d * c
+        h *= delta
+        if abs(delta - 1.0) < 1e-12:
+            break
+    return h
+
+
+def RegularizedIncompleteBeta(a, b, x):
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(
+        math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+        a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * IncompleteBetaFraction(a, b, x) / a
+    return 1.0 - front * IncompleteBetaFraction(b, a, 1.0 - x) / b
+
+
+def Mean(values):
+    return sum(values) / len(values)
+
+
+def Variance(values):
+    mean = Mean(values)
+    return sum((v - mean)**2 for v in values) / (len(values) - 1)
+
+
+def WelchTTest(base, new):
+    """Returns the two-sided p-value of the difference of the means."""
+    base_error = Variance(base) / len(base)
+    new_error = Variance(new) / len(new)
+    error = base_error + new_error
+    if error == 0.0:
+        return 1.0 if Mean(base) == Mean(new) else 0.0
+    t = (Mean(new) - Mean(base)) / math.sqrt(error)
+    # Welch-Satterthwaite approximation of the degrees of freedom.
+    df = error**2 / (base_error**2 / (len(base) - 1) + new_error**2 /
+                     (len(new) - 1))
+    return RegularizedIncompleteBeta(df / 2.0, 0.5, df / (df + t * t))
+
+
+def LoadScores(path):
+    with open(path) as f:
+        results = json.load(f)
+    return {
+        b['name']: (b['kind'], [float(s) for s in b['scores']])
+        for b in results['benchmarks']
+    }
+
+
+def Main():
+    parser = argparse.ArgumentParser(
+        description='Compares two runs of the VM microbenchmarks.')
+    parser.add_argument('base', help='JSON results of the baseline run')
+    parser.add_argument('new', help='JSON results of the run to check')
+    parser.add_argument(
+        '--alpha',
+        type=float,
+        default=0.05,
+        help='Significance level of the t-test (default: 0.05)')
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=1.0,
+        help='Smallest change of the mean in percent which is flagged '
+        '(default: 1.0)')
+    args = parser.parse_args()
+
+    base = LoadScores(args.base)
+    new = LoadScores(args.new)
+    regressions = 0
+    print('%-32s %-10s %14s %14s %9s %8s  %s' %
+          ('Benchmark', 'Kind', 'Base mean', 'New mean', 'Change', 'p',
+           'Verdict'))
+    for name in sorted(base):
+        if name not in new:
+            continue
+        kind, base_scores = base[name]
+        _, new_scores = new[name]
+        base_mean = Mean(base_scores)
+        new_mean = Mean(new_scores)
+        change = (100.0 * (new_mean - base_mean) /
+                  base_mean if base_mean != 0.0 else 0.0)
+        if len(base_scores) < 2 or len(new_scores) < 2:
+            p = None
+            verdict = 'needs more repetitions'
+        else:
+            p = WelchTTest(base_scores, new_scores)
+            if p >= args.alpha or abs(change) < args.threshold:
+                verdict = ''
+            elif change > 0:
+                verdict = 'REGRESSION'
+                regressions += 1
+            else:
+                verdict = 'improvement'
+        print('%-32s %-10s %14.1f %14.1f %+8.2f%% %8s  %s' %
+              (name, kind, base_mean, new_mean, change,
+               '-' if p is None else '%.4f' % p, verdict))
+
+    missing = sorted(set(base) ^ set(new))
+    if missing:
+        print('Only in one run: %s' % ', '.join(missing))
+    if regressions > 0:
+        print('%d significant regression(s).' % regressions)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(Main())